@@ -0,0 +1,111 @@
+/**
+ * Benchmark of page allocation in a database file.
+ *
+ * The database is filled by allocating --pages pages, by default as many as a database of a single file had
+ * room for, and the time per allocation is printed for every tenth of them, so a cost growing with the size of
+ * the database shows. Then --holes pages spread over it are freed and allocated again, each allocation has to
+ * find the lowest hole left, after the database is reopened. Only the bitmap pages are written, the segment
+ * files stay sparse.
+ *
+ * Usage: alloc_bench [--pages=N] [--holes=N] [--seed=N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "page/disk_file_meta_page.h"
+#include "storage/disk_manager.h"
+
+static const char *db_file_name = "alloc_bench.db";
+
+static double NanosPerOp(std::chrono::steady_clock::duration elapsed, size_t ops) {
+  return ops == 0 ? 0 : static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / ops;
+}
+
+int main(int argc, char **argv) {
+  size_t pages = static_cast<size_t>(SINGLE_FILE_MAX_EXTENTS) * DiskManager::BITMAP_SIZE;
+  size_t holes = 100000;
+  unsigned seed = 42;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--pages=", 8) == 0) {
+      pages = std::min<size_t>(strtoull(argv[i] + 8, nullptr, 10), MAX_VALID_PAGE_ID);
+    } else if (strncmp(argv[i], "--holes=", 8) == 0) {
+      holes = strtoull(argv[i] + 8, nullptr, 10);
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoul(argv[i] + 7, nullptr, 10);
+    } else {
+      fprintf(stderr, "usage: %s [--pages=N] [--holes=N] [--seed=N]\n", argv[0]);
+      return 1;
+    }
+  }
+  holes = std::min(holes, pages);
+  DiskManager::RemoveFiles(db_file_name);
+  auto disk_manager = new DiskManager(db_file_name);
+
+  printf("%12s %12s %12s %12s\n", "allocated", "extents", "segments", "ns/alloc");
+  size_t step = std::max<size_t>(pages / 10, 1);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t allocated = 0; allocated < pages;) {
+    size_t end = std::min(allocated + step, pages);
+    size_t count = end - allocated;
+    auto step_start = std::chrono::steady_clock::now();
+    for (; allocated < end; allocated++) {
+      if (disk_manager->AllocatePage() != static_cast<page_id_t>(allocated)) {
+        fprintf(stderr, "allocation %zu returned a wrong page\n", allocated);
+        return 1;
+      }
+    }
+    double alloc_ns = NanosPerOp(std::chrono::steady_clock::now() - step_start, count);
+    auto meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_manager->GetMetaData());
+    printf("%12zu %12u %12u %12.1f\n", allocated, meta_page->GetExtentNums(), disk_manager->GetSegmentCount(),
+           alloc_ns);
+  }
+  printf("filled %zu pages in %.2f s\n", pages,
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+  // The used page counts of the extents go through the meta page and meta directory.
+  delete disk_manager;
+  start = std::chrono::steady_clock::now();
+  disk_manager = new DiskManager(db_file_name);
+  if (reinterpret_cast<DiskFileMetaPage *>(disk_manager->GetMetaData())->GetAllocatedPages() != pages) {
+    fprintf(stderr, "the reopened database lost pages\n");
+    return 1;
+  }
+  printf("reopened in %.2f s\n\n", std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<page_id_t> page_dist(0, pages - 1);
+  std::vector<page_id_t> hole_ids;
+  while (hole_ids.size() < holes) {
+    hole_ids.push_back(page_dist(rng));
+    if (hole_ids.size() == holes) {
+      std::sort(hole_ids.begin(), hole_ids.end());
+      hole_ids.erase(std::unique(hole_ids.begin(), hole_ids.end()), hole_ids.end());
+    }
+  }
+  std::shuffle(hole_ids.begin(), hole_ids.end(), rng);
+  start = std::chrono::steady_clock::now();
+  for (page_id_t page_id : hole_ids) {
+    disk_manager->DeAllocatePage(page_id);
+  }
+  double free_ns = NanosPerOp(std::chrono::steady_clock::now() - start, holes);
+  std::sort(hole_ids.begin(), hole_ids.end());
+  start = std::chrono::steady_clock::now();
+  for (page_id_t page_id : hole_ids) {
+    if (disk_manager->AllocatePage() != page_id) {
+      fprintf(stderr, "the holes were not refilled lowest first\n");
+      return 1;
+    }
+  }
+  double refill_ns = NanosPerOp(std::chrono::steady_clock::now() - start, holes);
+  printf("%12s %12s %12s\n", "holes", "ns/free", "ns/refill");
+  printf("%12zu %12.1f %12.1f\n", holes, free_ns, refill_ns);
+
+  delete disk_manager;
+  DiskManager::RemoveFiles(db_file_name);
+  return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * Database open benchmark.
+ *
+ * A database with --tables tables, each with an index, is created once and then opened --runs
+ * times. For every open the time to open the database, to look up one table and one index, and to
+ * load every table (what opening used to cost) are reported in milliseconds. Like in the server, the
+ * database is opened on a buffer pool which is already set up.
+ *
+ * Usage: catalog_open_bench [--tables=N] [--runs=N]
+ */
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+
+static const char *db_name = "catalog_open_bench";
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  int tables = 5000;
+  int runs = 5;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--tables=", 9) == 0) {
+      tables = atoi(argv[i] + 9);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  BufferPool buffer_pool(DEFAULT_BUFFER_POOL_SIZE);
+  auto db = new DBStorageEngine(db_name, true, &buffer_pool);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  for (int i = 0; i < tables; i++) {
+    TableInfo *table_info = nullptr;
+    IndexInfo *index_info = nullptr;
+    std::string table_name = "t" + std::to_string(i);
+    if (db->catalog_mgr_->CreateTable(table_name, schema.get(), nullptr, table_info) != DB_SUCCESS ||
+        db->catalog_mgr_->CreateIndex(table_name, table_name + "_id", {"id"}, nullptr, index_info, "bptree") !=
+            DB_SUCCESS) {
+      fprintf(stderr, "failed to create table %s\n", table_name.c_str());
+      return 1;
+    }
+  }
+  delete db;
+
+  std::string table_name = "t" + std::to_string(tables / 2);
+  printf("%8s %12s %12s %12s\n", "run", "open_ms", "lookup_ms", "load_all_ms");
+  for (int run = 0; run < runs; run++) {
+    auto start = std::chrono::steady_clock::now();
+    db = new DBStorageEngine(db_name, false, &buffer_pool);
+    double open_ms = ElapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    IndexInfo *index_info = nullptr;
+    if (db->catalog_mgr_->GetIndex(table_name, table_name + "_id", index_info) != DB_SUCCESS) {
+      fprintf(stderr, "index of %s not found\n", table_name.c_str());
+      return 1;
+    }
+    double lookup_ms = ElapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    std::vector<TableInfo *> table_infos;
+    db->catalog_mgr_->GetTables(table_infos);
+    double load_all_ms = ElapsedMs(start);
+    printf("%8d %12.2f %12.3f %12.2f\n", run, open_ms, lookup_ms, load_all_ms);
+    delete db;
+  }
+  remove(("./databases/" + std::string(db_name)).c_str());
+  return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * Ingest benchmark.
+ *
+ * Rows are loaded into a table with a primary key by INSERT statements carrying --rows rows in
+ * total, first one row per statement, then 10, 100 and 1000 rows per statement. Each round starts
+ * on a fresh database. Statements are parsed and run in process, the time reported covers parsing,
+ * planning and execution. Keys are inserted in random order so the index sees scattered inserts.
+ *
+ * Usage: insert_bench [--rows=N]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executor/execute_engine.h"
+#include "parser/parsed_statement.h"
+
+static const char *db_name = "insert_bench";
+
+static void Run(ExecuteEngine *engine, Session *session, const std::string &sql) {
+  auto statement = ParsedStatement::Parse(sql);
+  if (statement->HasError()) {
+    fprintf(stderr, "%s: %s\n", sql.substr(0, 64).c_str(), statement->GetErrorMessage().c_str());
+    exit(1);
+  }
+  engine->Execute(statement->GetRoot(), session);
+}
+
+int main(int argc, char **argv) {
+  int rows = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  std::vector<int> keys(rows);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+  auto engine = new ExecuteEngine();
+  std::ostringstream out;
+  Session session(out);
+  printf("%10s %12s %12s\n", "batch", "seconds", "rows/sec");
+  for (int batch : {1, 10, 100, 1000}) {
+    Run(engine, &session, "drop database " + std::string(db_name) + ";");
+    Run(engine, &session, "create database " + std::string(db_name) + ";");
+    Run(engine, &session, "use " + std::string(db_name) + ";");
+    Run(engine, &session, "create table t(id int, name char(16), primary key(id));");
+    // Build the statements up front, only their execution is timed.
+    std::vector<std::string> statements;
+    for (int i = 0; i < rows; i += batch) {
+      std::string sql = "insert into t values ";
+      for (int j = i; j < std::min(rows, i + batch); j++) {
+        if (j > i) {
+          sql += ", ";
+        }
+        sql += "(" + std::to_string(keys[j]) + ", \"name" + std::to_string(keys[j]) + "\")";
+      }
+      statements.push_back(sql + ";");
+    }
+    out.str("");
+    auto start = std::chrono::steady_clock::now();
+    for (auto &sql : statements) {
+      Run(engine, &session, sql);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%10d %12.3f %12.0f\n", batch, seconds, rows / seconds);
+  }
+  Run(engine, &session, "drop database " + std::string(db_name) + ";");
+  delete engine;
+  return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * Parallel scan benchmark.
+ *
+ * A table of --rows rows is scanned with a predicate matching one row in a hundred, so the time goes
+ * into reading pages and evaluating the predicate rather than into printing the result. The scan is
+ * repeated with the parallelism of the session doubled from 1 up to --max_parallelism, the speedup
+ * is relative to the serial scan. The table is small enough to stay in the buffer pool.
+ *
+ * Usage: scan_bench [--rows=N] [--runs=N] [--max_parallelism=N]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "executor/execute_engine.h"
+#include "parser/parsed_statement.h"
+
+static const char *db_name = "scan_bench";
+
+static void Run(ExecuteEngine *engine, Session *session, const std::string &sql) {
+  auto statement = ParsedStatement::Parse(sql);
+  if (statement->HasError()) {
+    fprintf(stderr, "%s: %s\n", sql.substr(0, 64).c_str(), statement->GetErrorMessage().c_str());
+    exit(1);
+  }
+  engine->Execute(statement->GetRoot(), session);
+}
+
+int main(int argc, char **argv) {
+  int rows = 500000;
+  int runs = 5;
+  int max_parallelism = static_cast<int>(std::min<size_t>(MAX_PARALLELISM, std::thread::hardware_concurrency()));
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--max_parallelism=", 18) == 0) {
+      max_parallelism = atoi(argv[i] + 18);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  auto engine = new ExecuteEngine();
+  std::ostringstream out;
+  Session session(out);
+  Run(engine, &session, "drop database " + std::string(db_name) + ";");
+  Run(engine, &session, "create database " + std::string(db_name) + ";");
+  Run(engine, &session, "use " + std::string(db_name) + ";");
+  Run(engine, &session, "create table t(id int, val int, name char(32));");
+  for (int i = 0; i < rows; i += 1000) {
+    std::string sql = "insert into t values ";
+    for (int j = i; j < std::min(rows, i + 1000); j++) {
+      sql += (j > i ? ", (" : "(") + std::to_string(j) + ", " + std::to_string(j % 100) + ", \"row " +
+             std::to_string(j) + "\")";
+    }
+    Run(engine, &session, sql + ";");
+  }
+
+  printf("%12s %12s %14s %10s\n", "parallelism", "avg_ms", "rows/sec", "speedup");
+  double serial_ms = 0;
+  for (int degree = 1; degree <= max_parallelism; degree *= 2) {
+    Run(engine, &session, "set parallelism = " + std::to_string(degree) + ";");
+    // One run to warm up the buffer pool.
+    Run(engine, &session, "select id from t where val = 7;");
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+      out.str("");
+      Run(engine, &session, "select id from t where val = 7;");
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+    if (degree == 1) {
+      serial_ms = ms;
+    }
+    printf("%12d %12.1f %14.0f %10.2f\n", degree, ms, rows / ms * 1000, serial_ms / ms);
+  }
+  Run(engine, &session, "drop database " + std::string(db_name) + ";");
+  delete engine;
+  return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * Benchmark of point lookups through the index types of CREATE INDEX ... USING.
+ *
+ * --keys int keys are inserted in random order into each index type, each in a database of its own whose buffer
+ * pool holds the index (the art index keeps no pages), then --lookups keys drawn at random are looked up with
+ * ScanKey(key, "="). Reported are the insert rate and the mean latency of a lookup.
+ *
+ * Usage: index_lookup_bench [--keys=N] [--lookups=N]
+ */
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "index/art_index.h"
+#include "index/b_plus_tree_index.h"
+#include "index/hash_index.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+static const char *index_types[] = {"bptree", "hash", "art"};
+
+static Row MakeKey(int32_t id) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+  return Row(fields);
+}
+
+static Index *MakeIndex(const std::string &type, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager) {
+  if (type == "art") {
+    return new ArtIndex(0, key_schema);
+  }
+  if (type == "hash") {
+    return new HashIndex(0, key_schema, 16, buffer_pool_manager);
+  }
+  return new BPlusTreeIndex(0, key_schema, 16, buffer_pool_manager);
+}
+
+int main(int argc, char **argv) {
+  int keys = 100000;
+  int lookups = 1000000;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--keys=", 7) == 0) {
+      keys = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--lookups=", 10) == 0) {
+      lookups = atoi(argv[i] + 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  Schema schema(columns);
+  std::vector<uint32_t> key_map{0};
+  auto key_schema = Schema::ShallowCopySchema(&schema, key_map);
+  std::vector<int32_t> ids(keys);
+  for (int i = 0; i < keys; i++) {
+    ids[i] = i * 7;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(1));
+  std::vector<Row> probes;
+  std::mt19937 random(2);
+  for (int i = 0; i < std::min(lookups, 4096); i++) {
+    probes.push_back(MakeKey(ids[random() % keys]));
+  }
+
+  printf("%8s %14s %14s %10s\n", "index", "inserts/sec", "ns/lookup", "found");
+  for (auto type : index_types) {
+    std::string db_name = std::string("index_lookup_bench_") + type + ".db";
+    auto engine = new DBStorageEngine(db_name, true);
+    auto index = MakeIndex(type, key_schema, engine->bpm_);
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t id : ids) {
+      index->InsertEntry(MakeKey(id), RowId(id / 100, id % 100), nullptr);
+    }
+    double insert_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t found = 0;
+    std::vector<RowId> result;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++) {
+      result.clear();
+      if (index->ScanKey(probes[i % probes.size()], result, nullptr) == DB_SUCCESS) {
+        found++;
+      }
+    }
+    double lookup_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%8s %14.0f %14.1f %10llu\n", type, keys / insert_seconds, lookup_seconds * 1e9 / lookups,
+           static_cast<unsigned long long>(found));
+    delete index;
+    delete engine;
+    DiskManager::RemoveFiles("./databases/" + db_name);
+    remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+  }
+  delete key_schema;
+  return 0;
+}
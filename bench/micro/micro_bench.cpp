@@ -0,0 +1,348 @@
+/**
+ * Microbenchmarks of the storage primitives.
+ *
+ * Each benchmark times one operation in isolation: replacer operations, buffer pool fetches which hit and
+ * which miss, tuple insertion and lookup on a table page, row serialization, index key comparison, page
+ * allocation in a bitmap page and B+ tree insertion, lookup and range scan. A benchmark runs until a sample
+ * takes --min_time_ms, then --warmup samples and --repetitions measured samples of as many iterations.
+ * Progress goes to stderr, the results in nanoseconds per operation are written as JSON to stdout or --out.
+ *
+ * Usage: micro_bench [--filter=SUBSTRING] [--min_time_ms=N] [--warmup=N] [--repetitions=N] [--out=PATH]
+ */
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/lru_replacer.h"
+#include "common/instance.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "micro_bench.h"
+#include "page/bitmap_page.h"
+#include "page/table_page.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+static const char *bpm_file_name = "micro_bench_bpm.db";
+static const char *tree_db_name = "micro_bench_tree.db";
+static const char *insert_db_name = "micro_bench_insert.db";
+static const int REPLACER_FRAMES = 1024;
+static const int HIT_PAGES = 32;       // pages fetched by fetch_hit, all cached
+static const int MISS_FRAMES = 16;     // frames of the pool of fetch_miss
+static const int MISS_PAGES = 256;     // pages cycled through by fetch_miss, never cached
+static const int TREE_KEYS = 100000;   // keys of the tree looked up and scanned
+static const int SCAN_LENGTH = 100;    // entries of a range scan
+
+/** @return a schema of an int, a float and a char(32), the shape of a narrow table row */
+static std::unique_ptr<Schema> MakeRowSchema() {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("score", TypeId::kTypeFloat, 1, false, false),
+                                   new Column("name", TypeId::kTypeChar, 32, 2, false, false)};
+  return std::make_unique<Schema>(columns);
+}
+
+static Row MakeRow(int32_t id) {
+  char name[32];
+  int length = snprintf(name, sizeof(name), "name of row %d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, id * 0.5f),
+                            Field(TypeId::kTypeChar, name, length, true)};
+  return Row(fields);
+}
+
+/** A tree of TREE_KEYS int keys, shared by the benchmarks which read it */
+class TreeFixture {
+ public:
+  TreeFixture() {
+    engine_ = std::make_unique<DBStorageEngine>(tree_db_name);
+    std::vector<Column *> columns = {new Column("key", TypeId::kTypeInt, 0, false, false)};
+    schema_ = std::make_unique<Schema>(columns);
+    manager_ = std::make_unique<KeyManager>(schema_.get(), 16);
+    tree_ = std::make_unique<BPlusTree>(0, engine_->bpm_, *manager_);
+    for (int i = 0; i < TREE_KEYS; i++) {
+      keys_.push_back(MakeKey(*manager_, schema_.get(), i));
+    }
+    std::vector<int> order(TREE_KEYS);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), std::mt19937(7));
+    for (int i : order) {
+      tree_->Insert(keys_[i], RowId(i));
+    }
+  }
+
+  ~TreeFixture() {
+    for (auto key : keys_) {
+      free(key);
+    }
+    tree_.reset();
+    engine_.reset();
+    remove(("./databases/" + std::string(tree_db_name)).c_str());
+  }
+
+  static GenericKey *MakeKey(const KeyManager &manager, Schema *schema, int32_t value) {
+    GenericKey *key = manager.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, value)};
+    manager.SerializeFromKey(key, Row(fields), schema);
+    return key;
+  }
+
+  std::unique_ptr<DBStorageEngine> engine_;
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<KeyManager> manager_;
+  std::unique_ptr<BPlusTree> tree_;
+  std::vector<GenericKey *> keys_;
+};
+
+int main(int argc, char **argv) {
+  MicroOptions options;
+  std::string filter;
+  std::string out_path;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--filter=", 9) == 0) {
+      filter = argv[i] + 9;
+    } else if (strncmp(argv[i], "--min_time_ms=", 14) == 0) {
+      options.min_time_ = std::chrono::milliseconds(atoi(argv[i] + 14));
+    } else if (strncmp(argv[i], "--warmup=", 9) == 0) {
+      options.warmup_ = atoi(argv[i] + 9);
+    } else if (strncmp(argv[i], "--repetitions=", 14) == 0) {
+      options.repetitions_ = std::max(1, atoi(argv[i] + 14));
+    } else if (strncmp(argv[i], "--out=", 6) == 0) {
+      out_path = argv[i] + 6;
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  mkdir("./databases", 0777);
+  auto row_schema = MakeRowSchema();
+  std::unique_ptr<TreeFixture> tree_fixture;
+  auto get_tree = [&]() {
+    if (tree_fixture == nullptr) {
+      tree_fixture = std::make_unique<TreeFixture>();
+    }
+    return tree_fixture.get();
+  };
+
+  std::vector<MicroBenchmark> benchmarks = {
+      {"lru_replacer/unpin_victim",
+       [](MicroState &state) {
+         LRUReplacer replacer(REPLACER_FRAMES);
+         for (frame_id_t i = 0; i < REPLACER_FRAMES; i++) {
+           replacer.Unpin(i);
+         }
+         frame_id_t frame_id;
+         while (state.KeepRunning()) {
+           replacer.Victim(&frame_id);
+           replacer.Unpin(frame_id);
+         }
+       }},
+      {"lru_replacer/pin_unpin",
+       [](MicroState &state) {
+         LRUReplacer replacer(REPLACER_FRAMES);
+         for (frame_id_t i = 0; i < REPLACER_FRAMES; i++) {
+           replacer.Unpin(i);
+         }
+         frame_id_t frame_id = 0;
+         while (state.KeepRunning()) {
+           replacer.Pin(frame_id);
+           replacer.Unpin(frame_id);
+           frame_id = (frame_id + 7) % REPLACER_FRAMES;
+         }
+       }},
+      {"buffer_pool/fetch_hit",
+       [](MicroState &state) {
+         remove(bpm_file_name);
+         DiskManager disk_manager(bpm_file_name);
+         BufferPoolManager bpm(HIT_PAGES * 2, &disk_manager);
+         std::vector<page_id_t> page_ids(HIT_PAGES);
+         for (auto &page_id : page_ids) {
+           bpm.NewPage(page_id);
+           bpm.UnpinPage(page_id, true);
+         }
+         int i = 0;
+         while (state.KeepRunning()) {
+           page_id_t page_id = page_ids[i++ % HIT_PAGES];
+           MicroState::DoNotOptimize(bpm.FetchPage(page_id));
+           bpm.UnpinPage(page_id, false);
+         }
+       }},
+      {"buffer_pool/fetch_miss",
+       [](MicroState &state) {
+         remove(bpm_file_name);
+         DiskManager disk_manager(bpm_file_name);
+         BufferPoolManager bpm(MISS_FRAMES, &disk_manager);
+         std::vector<page_id_t> page_ids(MISS_PAGES);
+         for (auto &page_id : page_ids) {
+           bpm.NewPage(page_id);
+           bpm.UnpinPage(page_id, true);
+         }
+         // One pass writes the dirty pages back, then every miss only reads.
+         for (auto page_id : page_ids) {
+           bpm.FetchPage(page_id);
+           bpm.UnpinPage(page_id, false);
+         }
+         int i = 0;
+         while (state.KeepRunning()) {
+           page_id_t page_id = page_ids[i++ % MISS_PAGES];
+           MicroState::DoNotOptimize(bpm.FetchPage(page_id));
+           bpm.UnpinPage(page_id, false);
+         }
+       }},
+      {"table_page/insert_tuple",
+       [&](MicroState &state) {
+         auto page = std::make_unique<TablePage>();
+         page->Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+         Row row = MakeRow(1);
+         while (state.KeepRunning()) {
+           if (!page->InsertTuple(row, row_schema.get(), nullptr, nullptr, nullptr)) {
+             state.PauseTiming();
+             page->Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+             state.ResumeTiming();
+             page->InsertTuple(row, row_schema.get(), nullptr, nullptr, nullptr);
+           }
+         }
+       }},
+      {"table_page/get_tuple",
+       [&](MicroState &state) {
+         auto page = std::make_unique<TablePage>();
+         page->Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+         uint32_t count = 0;
+         for (Row row = MakeRow(0); page->InsertTuple(row, row_schema.get(), nullptr, nullptr, nullptr);
+              row = MakeRow(++count)) {
+         }
+         uint32_t slot = 0;
+         while (state.KeepRunning()) {
+           Row row(RowId(0, slot));
+           page->GetTuple(&row, row_schema.get(), nullptr, nullptr);
+           MicroState::DoNotOptimize(row);
+           slot = (slot + 1) % count;
+         }
+       }},
+      {"row/serialize",
+       [&](MicroState &state) {
+         Row row = MakeRow(42);
+         char buf[PAGE_SIZE];
+         while (state.KeepRunning()) {
+           MicroState::DoNotOptimize(row.SerializeTo(buf, row_schema.get()));
+         }
+       }},
+      {"row/deserialize",
+       [&](MicroState &state) {
+         char buf[PAGE_SIZE];
+         MakeRow(42).SerializeTo(buf, row_schema.get());
+         while (state.KeepRunning()) {
+           Row row;
+           MicroState::DoNotOptimize(row.DeserializeFrom(buf, row_schema.get()));
+         }
+       }},
+      {"key_manager/compare_keys",
+       [](MicroState &state) {
+         std::vector<Column *> columns = {new Column("key", TypeId::kTypeInt, 0, false, false)};
+         Schema schema(columns);
+         KeyManager manager(&schema, 16);
+         std::vector<GenericKey *> keys;
+         for (int i = 0; i < 64; i++) {
+           keys.push_back(TreeFixture::MakeKey(manager, &schema, i * 7919 % 64));
+         }
+         int i = 0;
+         while (state.KeepRunning()) {
+           MicroState::DoNotOptimize(manager.CompareKeys(keys[i % 64], keys[(i + 1) % 64]));
+           i++;
+         }
+         for (auto key : keys) {
+           free(key);
+         }
+       }},
+      {"bitmap_page/allocate_page",
+       [](MicroState &state) {
+         auto data = std::make_unique<char[]>(PAGE_SIZE);
+         memset(data.get(), 0, PAGE_SIZE);
+         auto bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(data.get());
+         uint32_t page_offset;
+         while (state.KeepRunning()) {
+           if (!bitmap->AllocatePage(page_offset)) {
+             state.PauseTiming();
+             memset(data.get(), 0, PAGE_SIZE);
+             state.ResumeTiming();
+             bitmap->AllocatePage(page_offset);
+           }
+         }
+       }},
+      {"bplus_tree/insert",
+       [](MicroState &state) {
+         DBStorageEngine engine(insert_db_name);
+         std::vector<Column *> columns = {new Column("key", TypeId::kTypeInt, 0, false, false)};
+         Schema schema(columns);
+         KeyManager manager(&schema, 16);
+         BPlusTree tree(0, engine.bpm_, manager);
+         std::vector<GenericKey *> keys;
+         for (uint64_t i = 0; i < state.GetIterations(); i++) {
+           keys.push_back(TreeFixture::MakeKey(manager, &schema, static_cast<int32_t>(i)));
+         }
+         std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+         while (state.KeepRunning()) {
+           uint64_t i = state.GetIteration();
+           tree.Insert(keys[i], RowId(static_cast<int64_t>(i)));
+         }
+         for (auto key : keys) {
+           free(key);
+         }
+       }},
+      {"bplus_tree/lookup",
+       [&](MicroState &state) {
+         auto fixture = get_tree();
+         std::mt19937 rng(11);
+         std::vector<RowId> result;
+         while (state.KeepRunning()) {
+           result.clear();
+           fixture->tree_->GetValue(fixture->keys_[rng() % TREE_KEYS], result);
+           MicroState::DoNotOptimize(result);
+         }
+       }},
+      {"bplus_tree/range_scan_100",
+       [&](MicroState &state) {
+         auto fixture = get_tree();
+         std::mt19937 rng(13);
+         auto end = fixture->tree_->End();
+         while (state.KeepRunning()) {
+           int n = 0;
+           for (auto iter = fixture->tree_->Begin(fixture->keys_[rng() % TREE_KEYS]); n < SCAN_LENGTH && iter != end;
+                ++iter, n++) {
+             MicroState::DoNotOptimize((*iter).second);
+           }
+         }
+       }},
+  };
+
+  std::vector<MicroResult> results;
+  fprintf(stderr, "%-28s %12s %12s %12s %10s\n", "benchmark", "iterations", "median_ns", "min_ns", "stddev");
+  for (const auto &benchmark : benchmarks) {
+    if (!filter.empty() && benchmark.name_.find(filter) == std::string::npos) {
+      continue;
+    }
+    results.push_back(RunMicroBenchmark(benchmark, options));
+    const auto &result = results.back();
+    fprintf(stderr, "%-28s %12llu %12.1f %12.1f %9.1f%%\n", result.name_.c_str(),
+            static_cast<unsigned long long>(result.iterations_), result.Median(), result.Min(),
+            100 * result.Stddev() / result.Mean());
+  }
+  tree_fixture.reset();
+  remove(bpm_file_name);
+  remove(("./databases/" + std::string(insert_db_name)).c_str());
+  if (out_path.empty()) {
+    WriteMicroResults(std::cout, results, options);
+  } else {
+    std::ofstream out(out_path);
+    WriteMicroResults(out, results, options);
+  }
+  return 0;
+}
@@ -0,0 +1,158 @@
+#ifndef MINISQL_MICRO_BENCH_H
+#define MINISQL_MICRO_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * MicroState is handed to a microbenchmark, which does its setup and then runs the operation measured in a
+ * loop of `while (state.KeepRunning())`. The clock runs from the first call of KeepRunning to the last,
+ * work which is not to be measured is put between PauseTiming and ResumeTiming.
+ */
+class MicroState {
+ public:
+  explicit MicroState(uint64_t iterations) : iterations_(iterations), remaining_(iterations) {}
+
+  /** @return true while the loop is to run another iteration */
+  inline bool KeepRunning() {
+    if (!started_) {
+      started_ = true;
+      start_ = std::chrono::steady_clock::now();
+    }
+    if (remaining_ > 0) {
+      remaining_--;
+      return true;
+    }
+    elapsed_ += std::chrono::steady_clock::now() - start_;
+    return false;
+  }
+
+  inline void PauseTiming() { elapsed_ += std::chrono::steady_clock::now() - start_; }
+
+  inline void ResumeTiming() { start_ = std::chrono::steady_clock::now(); }
+
+  /** @return number of iterations the loop runs */
+  inline uint64_t GetIterations() const { return iterations_; }
+
+  /** @return number of the iteration being run, from 0 */
+  inline uint64_t GetIteration() const { return iterations_ - remaining_ - 1; }
+
+  inline std::chrono::nanoseconds GetElapsed() const { return elapsed_; }
+
+  /** Keep the compiler from dropping the computation of value as unused */
+  template <typename T>
+  static inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+ private:
+  uint64_t iterations_;
+  uint64_t remaining_;
+  bool started_{false};
+  std::chrono::steady_clock::time_point start_;
+  std::chrono::nanoseconds elapsed_{0};
+};
+
+struct MicroBenchmark {
+  std::string name_;
+  std::function<void(MicroState &)> func_;
+};
+
+struct MicroOptions {
+  std::chrono::milliseconds min_time_{20};  // a sample runs at least this long
+  int warmup_{1};                           // samples run before the measured ones
+  int repetitions_{5};                      // samples measured
+};
+
+/** Time per iteration of the samples of one benchmark */
+struct MicroResult {
+  std::string name_;
+  uint64_t iterations_{0};  // per sample
+  std::vector<double> ns_per_op_;
+
+  double Min() const { return *std::min_element(ns_per_op_.begin(), ns_per_op_.end()); }
+
+  double Max() const { return *std::max_element(ns_per_op_.begin(), ns_per_op_.end()); }
+
+  double Median() const {
+    std::vector<double> sorted(ns_per_op_);
+    std::sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    return n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+  }
+
+  double Mean() const {
+    double sum = 0;
+    for (double ns : ns_per_op_) {
+      sum += ns;
+    }
+    return sum / ns_per_op_.size();
+  }
+
+  double Stddev() const {
+    double mean = Mean();
+    double sum = 0;
+    for (double ns : ns_per_op_) {
+      sum += (ns - mean) * (ns - mean);
+    }
+    return ns_per_op_.size() > 1 ? std::sqrt(sum / (ns_per_op_.size() - 1)) : 0;
+  }
+};
+
+/**
+ * Run a benchmark. The number of iterations of a sample grows until a sample takes min_time, the samples
+ * run so far and then the warmup samples are not counted. Each measured sample runs that many iterations.
+ */
+inline MicroResult RunMicroBenchmark(const MicroBenchmark &benchmark, const MicroOptions &options) {
+  auto sample = [&](uint64_t iterations) {
+    MicroState state(iterations);
+    benchmark.func_(state);
+    return state.GetElapsed();
+  };
+  uint64_t iterations = 1;
+  for (;;) {
+    auto elapsed = sample(iterations);
+    if (elapsed >= options.min_time_ || iterations >= (uint64_t{1} << 30)) {
+      break;
+    }
+    // Aim a little past min_time, growing at most tenfold since the first samples are noisy.
+    double factor = elapsed.count() > 0 ? 1.4 * std::chrono::nanoseconds(options.min_time_).count() / elapsed.count()
+                                        : 10;
+    iterations = static_cast<uint64_t>(iterations * std::min(10.0, std::max(2.0, factor)));
+  }
+  for (int i = 0; i < options.warmup_; i++) {
+    sample(iterations);
+  }
+  MicroResult result;
+  result.name_ = benchmark.name_;
+  result.iterations_ = iterations;
+  for (int i = 0; i < options.repetitions_; i++) {
+    result.ns_per_op_.push_back(static_cast<double>(sample(iterations).count()) / iterations);
+  }
+  return result;
+}
+
+/** Write the results as one JSON document, times in nanoseconds per iteration */
+inline void WriteMicroResults(std::ostream &out, const std::vector<MicroResult> &results,
+                              const MicroOptions &options) {
+  out << "{\"context\":{\"min_time_ms\":" << options.min_time_.count() << ",\"warmup\":" << options.warmup_
+      << ",\"repetitions\":" << options.repetitions_ << "},\"benchmarks\":[";
+  for (size_t i = 0; i < results.size(); i++) {
+    const auto &result = results[i];
+    char times[256];
+    snprintf(times, sizeof(times), "\"min\":%.2f,\"median\":%.2f,\"mean\":%.2f,\"stddev\":%.2f,\"max\":%.2f",
+             result.Min(), result.Median(), result.Mean(), result.Stddev(), result.Max());
+    out << (i > 0 ? "," : "") << "\n  {\"name\":\"" << result.name_ << "\",\"iterations\":" << result.iterations_
+        << ",\"ns_per_op\":{" << times << "}}";
+  }
+  out << "\n]}\n";
+}
+
+#endif  // MINISQL_MICRO_BENCH_H
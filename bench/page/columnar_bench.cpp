@@ -0,0 +1,198 @@
+/**
+ * Benchmark of the columnar (PAX) table layout.
+ *
+ * A table of --rows rows and 30 columns, 10 int, 10 float and 10 char(12), is loaded into a row table and into a
+ * columnar table, each in a database of its own whose buffer pool holds the table. Each table is then scanned --runs times through
+ * its iterator, which makes whole rows, and --runs times through ScanColumns reading 2 of the columns into
+ * vectors. A row page deserializes every tuple in full whatever the columns asked for, a columnar page reads the
+ * minipages of the 2 columns only.
+ *
+ * The same rows are then loaded through the engine into a table of each layout and selected --runs times with a
+ * predicate no row passes, once on a column with no other column in the output and once with all the columns in
+ * the output. A sequential scan reads the columns the predicate and the output use only.
+ *
+ * Usage: columnar_bench [--rows=N] [--runs=N]
+ */
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/execute_engine.h"
+#include "parser/parsed_statement.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const char *db_names[] = {"columnar_bench_row.db", "columnar_bench_columnar.db"};
+
+static const char *engine_db_name = "columnar_bench_engine";
+
+static constexpr int GROUP_COLUMNS = 10;
+
+static Row MakeRow(int32_t id) {
+  std::vector<Field> fields;
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    fields.emplace_back(TypeId::kTypeInt, id + i);
+  }
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    fields.emplace_back(TypeId::kTypeFloat, (id % 1000) * 0.25f + i);
+  }
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    char value[16];
+    int length = snprintf(value, sizeof(value), "v%d-%d", id % 10000, i);
+    fields.emplace_back(TypeId::kTypeChar, value, length, true);
+  }
+  return Row(fields);
+}
+
+static void Run(ExecuteEngine *engine, Session *session, const std::string &sql) {
+  auto statement = ParsedStatement::Parse(sql);
+  if (statement->HasError()) {
+    fprintf(stderr, "%s: %s\n", sql.substr(0, 64).c_str(), statement->GetErrorMessage().c_str());
+    exit(1);
+  }
+  engine->Execute(statement->GetRoot(), session);
+}
+
+/** Load the rows of MakeRow through the engine and time the selects, @return rows scanned per second of each */
+static std::pair<double, double> RunEngine(int rows, int runs, const std::string &layout) {
+  auto engine = new ExecuteEngine();
+  std::ostringstream out;
+  Session session(out);
+  Run(engine, &session, "drop database " + std::string(engine_db_name) + ";");
+  Run(engine, &session, "create database " + std::string(engine_db_name) + ";");
+  Run(engine, &session, "use " + std::string(engine_db_name) + ";");
+  std::string create = "create table t(";
+  for (const char *prefix : {"i", "f", "c"}) {
+    const char *type = prefix[0] == 'i' ? "int" : prefix[0] == 'f' ? "float" : "char(12)";
+    for (int i = 0; i < GROUP_COLUMNS; i++) {
+      create += std::string(create.back() == '(' ? "" : ", ") + prefix + std::to_string(i) + " " + type;
+    }
+  }
+  Run(engine, &session, create + ") with (layout = " + layout + ");");
+  for (int i = 0; i < rows; i += 1000) {
+    std::string sql = "insert into t values ";
+    for (int id = i; id < std::min(rows, i + 1000); id++) {
+      Row row = MakeRow(id);
+      sql += id > i ? ", (" : "(";
+      for (uint32_t j = 0; j < row.GetFieldCount(); j++) {
+        std::string value = row.GetField(j)->toString();
+        sql += (j > 0 ? ", " : "") + (j < 2 * GROUP_COLUMNS ? value : "\"" + value + "\"");
+      }
+      sql += ")";
+    }
+    Run(engine, &session, sql + ";");
+  }
+  auto time = [&](const std::string &sql) {
+    // One run to warm up the buffer pool.
+    Run(engine, &session, sql);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+      out.str("");
+      Run(engine, &session, sql);
+    }
+    return rows * runs / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  double projected = time("select i0 from t where f3 < 0;");
+  double full = time("select * from t where f3 < 0;");
+  Run(engine, &session, "drop database " + std::string(engine_db_name) + ";");
+  delete engine;
+  return {full, projected};
+}
+
+int main(int argc, char **argv) {
+  int rows = 100000;
+  int runs = 5;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  std::vector<Column *> columns;
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    columns.push_back(new Column("i" + std::to_string(i), TypeId::kTypeInt, columns.size(), false, false));
+  }
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    columns.push_back(new Column("f" + std::to_string(i), TypeId::kTypeFloat, columns.size(), false, false));
+  }
+  for (int i = 0; i < GROUP_COLUMNS; i++) {
+    columns.push_back(new Column("c" + std::to_string(i), TypeId::kTypeChar, 12, columns.size(), false, false));
+  }
+  Schema schema(columns);
+  // an int and a float column
+  const std::vector<uint32_t> projection = {0, GROUP_COLUMNS + 3};
+
+  printf("%10s %10s %8s %16s %18s\n", "layout", "load_s", "pages", "full_rows/sec", "2_columns_rows/sec");
+  for (auto layout : {TableLayout::kRow, TableLayout::kColumnar}) {
+    std::string db_name = db_names[static_cast<int>(layout)];
+    auto engine = new DBStorageEngine(db_name, true);
+    auto start = std::chrono::steady_clock::now();
+    auto table = TableHeap::Create(engine->bpm_, &schema, nullptr, nullptr, nullptr, nullptr, layout);
+    std::vector<Row> batch;
+    for (int i = 0; i < rows; i += 1000) {
+      batch.clear();
+      for (int id = i; id < std::min(rows, i + 1000); id++) {
+        batch.push_back(MakeRow(id));
+      }
+      table->InsertTuples(batch, nullptr);
+    }
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<page_id_t> page_ids = table->GetPageIds();
+
+    uint64_t scanned = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+      for (auto it = table->Begin(nullptr); it != table->End(); ++it) {
+        scanned++;
+      }
+    }
+    double full_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t projected = 0;
+    int64_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+      for (auto page_id : page_ids) {
+        std::vector<std::vector<Field>> values;
+        table->ScanColumns(page_id, nullptr, projection, &values);
+        for (auto &value : values[0]) {
+          checksum += std::stoi(value.toString());
+        }
+        projected += values[0].size();
+      }
+    }
+    double projected_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%10s %10.2f %8zu %16.0f %18.0f\n", layout == TableLayout::kColumnar ? "columnar" : "row", load_seconds,
+           page_ids.size(), scanned / full_seconds, projected / projected_seconds);
+    if (projected != scanned) {
+      fprintf(stderr, "the projected scan read %llu rows, the full scan %llu (checksum %lld)\n",
+              static_cast<unsigned long long>(projected), static_cast<unsigned long long>(scanned),
+              static_cast<long long>(checksum));
+    }
+    delete table;
+    delete engine;
+    DiskManager::RemoveFiles("./databases/" + db_name);
+    remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+  }
+
+  printf("\nthrough the engine\n%10s %19s %18s\n", "layout", "30_columns_rows/sec", "2_columns_rows/sec");
+  for (const std::string layout : {"row", "columnar"}) {
+    auto result = RunEngine(rows, runs, layout);
+    printf("%10s %19.0f %18.0f\n", layout.c_str(), result.first, result.second);
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * Benchmark of page compression.
+ *
+ * A table of --rows rows, whose char columns repeat a few values as the columns of our tables do, is loaded into
+ * a database with raw pages and into one with compressed pages. For each the space the files take on disk is
+ * printed, then the database is reopened with a buffer pool of --pool_mb MB, far smaller than the table, and
+ * scanned --runs times, so every page of a scan is read from the files. The bytes read per scan and the scan
+ * time show the read bandwidth saved and what decompressing costs, the compression ratio and the time to
+ * compress and decompress a page are printed for the compressed database.
+ *
+ * Usage: compression_bench [--rows=N] [--runs=N] [--pool_mb=N]
+ */
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const char *db_names[] = {"compression_bench_raw.db", "compression_bench_compressed.db"};
+
+static const char *statuses[] = {"ACTIVE", "SUSPENDED", "CLOSED", "PENDING"};
+static const char *cities[] = {"Hangzhou", "Shanghai", "Beijing", "Shenzhen", "Guangzhou", "Chengdu", "Wuhan"};
+
+static Row MakeRow(int32_t id) {
+  char comment[96];
+  int length = snprintf(comment, sizeof(comment), "order %d shipped by standard delivery, no remarks", id);
+  const char *status = statuses[id % 4];
+  const char *city = cities[id % 7];
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, (id % 1000) * 0.25f),
+                            Field(TypeId::kTypeChar, const_cast<char *>(status), strlen(status), true),
+                            Field(TypeId::kTypeChar, const_cast<char *>(city), strlen(city), true),
+                            Field(TypeId::kTypeChar, comment, length, true)};
+  return Row(fields);
+}
+
+/** @return bytes the files of a database take on disk, the holes of sparse files are not counted */
+static uint64_t DiskUsage(const std::string &db_name) {
+  uint64_t bytes = 0;
+  std::vector<std::string> files = {db_name, "." + db_name + ".pack", "." + db_name + ".map"};
+  for (int segment = 1; segment < 1024; segment++) {
+    files.push_back("." + db_name + "." + std::to_string(segment));
+  }
+  for (const auto &file : files) {
+    struct stat stat_buf;
+    if (stat(("./databases/" + file).c_str(), &stat_buf) == 0) {
+      bytes += static_cast<uint64_t>(stat_buf.st_blocks) * 512;
+    }
+  }
+  return bytes;
+}
+
+int main(int argc, char **argv) {
+  int rows = 500000;
+  int runs = 3;
+  int pool_mb = 4;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--pool_mb=", 10) == 0) {
+      pool_mb = atoi(argv[i] + 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("price", TypeId::kTypeFloat, 1, false, false),
+                                   new Column("status", TypeId::kTypeChar, 16, 2, false, false),
+                                   new Column("city", TypeId::kTypeChar, 32, 3, false, false),
+                                   new Column("comment", TypeId::kTypeChar, 96, 4, false, false)};
+  Schema schema(columns);
+  uint32_t frames = static_cast<uint32_t>(static_cast<uint64_t>(pool_mb) * 1024 * 1024 / PAGE_SIZE);
+  auto &io = DiskManager::GetIoCounters();
+  auto &compression = CompressedPageStore::GetCounters();
+
+  printf("%12s %10s %12s %14s %14s %14s\n", "database", "load_s", "disk_mb", "read_mb/scan", "scan_ms",
+         "rows/sec");
+  for (int compressed = 0; compressed <= 1; compressed++) {
+    std::string db_name = db_names[compressed];
+    auto start = std::chrono::steady_clock::now();
+    auto engine = new DBStorageEngine(db_name, true, DEFAULT_BUFFER_POOL_SIZE, compressed == 1);
+    auto table = TableHeap::Create(engine->bpm_, &schema, nullptr, nullptr, nullptr);
+    page_id_t first_page_id = table->GetFirstPageId();
+    std::vector<Row> batch;
+    for (int i = 0; i < rows; i += 1000) {
+      batch.clear();
+      for (int id = i; id < std::min(rows, i + 1000); id++) {
+        batch.push_back(MakeRow(id));
+      }
+      table->InsertTuples(batch, nullptr);
+    }
+    delete table;
+    // the pages are written back when the engine closes
+    delete engine;
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t disk_bytes = DiskUsage(db_name);
+
+    engine = new DBStorageEngine(db_name, false, frames);
+    table = TableHeap::Create(engine->bpm_, first_page_id, &schema, nullptr, nullptr);
+    uint64_t bytes_read = io.bytes_read_;
+    start = std::chrono::steady_clock::now();
+    uint64_t scanned = 0;
+    for (int i = 0; i < runs; i++) {
+      for (auto it = table->Begin(nullptr); it != table->End(); ++it) {
+        scanned++;
+      }
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / runs;
+    bytes_read = io.bytes_read_ - bytes_read;
+    printf("%12s %10.2f %12.1f %14.1f %14.1f %14.0f\n", compressed == 1 ? "compressed" : "raw", load_seconds,
+           disk_bytes / 1048576.0, bytes_read / 1048576.0 / runs, ms, scanned / runs / ms * 1000);
+    delete table;
+    delete engine;
+    DiskManager::RemoveFiles("./databases/" + db_name);
+    remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+  }
+
+  uint64_t pages_compressed = compression.pages_compressed_;
+  uint64_t pages_decompressed = compression.pages_decompressed_;
+  printf("\ncompression ratio %.2f, compress %.0f ns/page, decompress %.0f ns/page\n",
+         compression.bytes_out_ == 0 ? 0.0 : static_cast<double>(compression.bytes_in_) / compression.bytes_out_,
+         pages_compressed == 0 ? 0.0 : static_cast<double>(compression.compress_ns_) / pages_compressed,
+         pages_decompressed == 0 ? 0.0 : static_cast<double>(compression.decompress_ns_) / pages_decompressed);
+  return 0;
+}
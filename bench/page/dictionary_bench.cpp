@@ -0,0 +1,129 @@
+/**
+ * Benchmark of dictionary encoded char columns.
+ *
+ * A table of --rows rows, whose char columns hold a few hundred values at most, is loaded into a table which
+ * stores the strings and into one whose char columns are dictionary encoded, each in a database of its own whose
+ * buffer pool holds the table. Each table is then scanned --runs times in full, and --runs times with the
+ * predicate city = "city 17": the raw table compares the strings of every row, the encoded table compares the
+ * codes of the rows as read and decodes only the rows which pass, as SeqScanExecutor does. The filtered scan is
+ * run --runs times more inside a snapshot transaction, whose reads go through the version store.
+ *
+ * Usage: dictionary_bench [--rows=N] [--runs=N]
+ */
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const char *db_names[] = {"dictionary_bench_raw.db", "dictionary_bench_dictionary.db"};
+
+static const char *statuses[] = {"ACTIVE", "SUSPENDED", "CLOSED", "PENDING"};
+
+static Row MakeRow(int32_t id) {
+  char city[32];
+  int city_length = snprintf(city, sizeof(city), "city %d", id % 300);
+  char segment[48];
+  int segment_length = snprintf(segment, sizeof(segment), "customer segment number %d", id % 40);
+  const char *status = statuses[id % 4];
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, (id % 1000) * 0.25f),
+                            Field(TypeId::kTypeChar, const_cast<char *>(status), strlen(status), true),
+                            Field(TypeId::kTypeChar, city, city_length, true),
+                            Field(TypeId::kTypeChar, segment, segment_length, true)};
+  return Row(fields);
+}
+
+int main(int argc, char **argv) {
+  int rows = 200000;
+  int runs = 5;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("price", TypeId::kTypeFloat, 1, false, false),
+                                   new Column("status", TypeId::kTypeChar, 16, 2, false, false),
+                                   new Column("city", TypeId::kTypeChar, 32, 3, false, false),
+                                   new Column("segment", TypeId::kTypeChar, 48, 4, false, false)};
+  Schema schema(columns);
+  const uint32_t city_column = 3;
+  const std::string city = "city 17";
+  Field city_value(TypeId::kTypeChar, const_cast<char *>(city.c_str()), city.size(), true);
+
+  printf("%12s %10s %8s %16s %16s %18s %10s\n", "table", "load_s", "pages", "full_rows/sec", "filter_rows/sec",
+         "snapshot_rows/sec", "matched");
+  for (int encoded = 0; encoded <= 1; encoded++) {
+    std::string db_name = db_names[encoded];
+    auto engine = new DBStorageEngine(db_name, true);
+    auto start = std::chrono::steady_clock::now();
+    auto table = TableHeap::Create(engine->bpm_, &schema, nullptr, nullptr, nullptr, engine->version_store_,
+                                   TableLayout::kRow, encoded == 1);
+    std::vector<Row> batch;
+    for (int i = 0; i < rows; i += 1000) {
+      batch.clear();
+      for (int id = i; id < std::min(rows, i + 1000); id++) {
+        batch.push_back(MakeRow(id));
+      }
+      table->InsertTuples(batch, nullptr);
+    }
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t pages = table->GetPageIds().size();
+
+    uint64_t scanned = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+      for (auto it = table->Begin(nullptr); it != table->End(); ++it) {
+        scanned++;
+      }
+    }
+    double full_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the value to look for, a code of the dictionary for the encoded table
+    Field code(TypeId::kTypeInt,
+               encoded == 1 ? table->GetDictionary()->Lookup(city_column, city.c_str(), city.size()) : -1);
+    const Field &target = encoded == 1 ? code : city_value;
+    double filter_seconds[2];
+    uint64_t filtered[2] = {0, 0}, matched = 0;
+    for (int snapshot = 0; snapshot <= 1; snapshot++) {
+      Transaction *txn = snapshot == 1 ? engine->txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation) : nullptr;
+      start = std::chrono::steady_clock::now();
+      for (int i = 0; i < runs; i++) {
+        for (auto it = table->Begin(txn, encoded == 0); it != table->End(); ++it) {
+          filtered[snapshot]++;
+          if (it->GetField(city_column)->CompareEquals(target) == CmpBool::kTrue) {
+            table->DecodeRow(it.operator->());
+            matched++;
+          }
+        }
+      }
+      filter_seconds[snapshot] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (txn != nullptr) {
+        engine->txn_mgr_->Commit(txn);
+      }
+    }
+    printf("%12s %10.2f %8zu %16.0f %16.0f %18.0f %10llu\n", encoded == 1 ? "dictionary" : "raw", load_seconds,
+           pages, scanned / full_seconds, filtered[0] / filter_seconds[0], filtered[1] / filter_seconds[1],
+           static_cast<unsigned long long>(matched / runs / 2));
+    delete table;
+    delete engine;
+    DiskManager::RemoveFiles("./databases/" + db_name);
+    remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * Benchmark of the page size, run once by a build of each page size.
+ *
+ * A table of --rows rows with a B+ tree index on its id is loaded, then the table is scanned --runs times and
+ * --lookups random ids are looked up through the index, each lookup fetching its row. The buffer pool has
+ * --pool_mb MB whatever the page size, a small part of the table, so the scans and lookups read pages; the
+ * pages read are counted along with the time. Larger pages mean fewer reads for a scan and a shallower tree.
+ * A build of another page size is configured with -DMINISQL_PAGE_SIZE=8192, 16384 or 32768.
+ *
+ * Usage: page_size_bench [--rows=N] [--runs=N] [--lookups=N] [--pool_mb=N] [--seed=N]
+ */
+#include <sys/stat.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "record/row.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+static const char *db_name = "page_size_bench.db";
+
+static Row MakeRow(int32_t id) {
+  char name[64];
+  int length = snprintf(name, sizeof(name), "name of row %d", id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeFloat, id * 0.5f),
+                            Field(TypeId::kTypeChar, name, length, true)};
+  return Row(fields);
+}
+
+static uint64_t PagesRead() { return DiskManager::GetIoCounters().reads_.load(); }
+
+int main(int argc, char **argv) {
+  int rows = 300000;
+  int runs = 3;
+  int lookups = 200000;
+  int pool_mb = 4;
+  unsigned seed = 42;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rows=", 7) == 0) {
+      rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--lookups=", 10) == 0) {
+      lookups = atoi(argv[i] + 10);
+    } else if (strncmp(argv[i], "--pool_mb=", 10) == 0) {
+      pool_mb = atoi(argv[i] + 10);
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = static_cast<unsigned>(atoi(argv[i] + 7));
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  mkdir("./databases", 0777);
+  uint32_t frames = static_cast<uint32_t>(static_cast<uint64_t>(pool_mb) * 1024 * 1024 / PAGE_SIZE);
+  auto engine = new DBStorageEngine(db_name, true, frames);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("score", TypeId::kTypeFloat, 1, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 2, false, false)};
+  Schema schema(columns);
+  std::vector<Column *> key_columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  Schema key_schema(key_columns);
+  KeyManager manager(&key_schema, 16);
+  auto table = TableHeap::Create(engine->bpm_, &schema, nullptr, nullptr, nullptr);
+  auto tree = new BPlusTree(0, engine->bpm_, manager);
+  GenericKey *key = manager.InitKey();
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Row> batch;
+  for (int i = 0; i < rows; i += 1000) {
+    batch.clear();
+    for (int id = i; id < std::min(rows, i + 1000); id++) {
+      batch.push_back(MakeRow(id));
+    }
+    table->InsertTuples(batch, nullptr);
+    for (size_t j = 0; j < batch.size(); j++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, static_cast<int32_t>(i + j))};
+      manager.SerializeFromKey(key, Row(fields), &key_schema);
+      tree->Insert(key, batch[j].GetRowId());
+    }
+  }
+  printf("page size %d bytes, buffer pool %u frames (%d MB)\n", PAGE_SIZE, frames, pool_mb);
+  printf("loaded %d rows in %.2f s\n\n", rows,
+         std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+  printf("%10s %14s %14s %14s\n", "test", "ops/sec", "pages read", "reads/op");
+  // One scan to reach a steady state of the buffer pool.
+  for (auto it = table->Begin(nullptr); it != table->End(); ++it) {
+  }
+  uint64_t reads = PagesRead();
+  start = std::chrono::steady_clock::now();
+  uint64_t scanned = 0;
+  for (int i = 0; i < runs; i++) {
+    for (auto it = table->Begin(nullptr); it != table->End(); ++it) {
+      scanned++;
+    }
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  reads = PagesRead() - reads;
+  printf("%10s %14.0f %14lu %14.4f\n", "scan", scanned / seconds, static_cast<unsigned long>(reads / runs),
+         static_cast<double>(reads) / scanned);
+
+  std::mt19937 rng(seed);
+  std::vector<RowId> result;
+  reads = PagesRead();
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < lookups; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, static_cast<int32_t>(rng() % rows))};
+    manager.SerializeFromKey(key, Row(fields), &key_schema);
+    result.clear();
+    tree->GetValue(key, result);
+    Row row(result[0]);
+    table->GetTuple(&row, nullptr);
+  }
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  reads = PagesRead() - reads;
+  printf("%10s %14.0f %14lu %14.4f\n", "lookup", lookups / seconds, static_cast<unsigned long>(reads),
+         static_cast<double>(reads) / lookups);
+
+  free(key);
+  delete tree;
+  delete table;
+  delete engine;
+  DiskManager::RemoveFiles("./databases/" + std::string(db_name));
+  remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+  return 0;
+}
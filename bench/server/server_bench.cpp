@@ -0,0 +1,190 @@
+/**
+ * Server load generator.
+ *
+ * Client threads connect to the server, each over a connection of its own, and run point selects
+ * by primary key back to back. The number of clients is doubled from 1 up to --max_clients to show
+ * how throughput and tail latency change with the number of sessions.
+ *
+ * A server is started in process on a free port unless --port names one already running. With
+ * --prepared the lookups run a prepared statement instead of being parsed and planned every time.
+ *
+ * Usage: server_bench [--port=N] [--workers=N] [--duration_ms=N] [--rows=N] [--max_clients=N] [--prepared]
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "executor/execute_engine.h"
+#include "server/server.h"
+
+static const char *db_name = "server_bench";
+
+struct BenchConfig {
+  int port = -1;
+  size_t workers = 0;
+  int duration_ms = 2000;
+  int rows = 1000;
+  int max_clients = 256;
+  bool prepared = false;
+};
+
+static void ParseArgs(int argc, char **argv, BenchConfig *config) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--port=", 7) == 0) {
+      config->port = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+      config->workers = strtoul(argv[i] + 10, nullptr, 10);
+    } else if (strncmp(argv[i], "--duration_ms=", 14) == 0) {
+      config->duration_ms = atoi(argv[i] + 14);
+    } else if (strncmp(argv[i], "--rows=", 7) == 0) {
+      config->rows = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--max_clients=", 14) == 0) {
+      config->max_clients = atoi(argv[i] + 14);
+    } else if (strcmp(argv[i], "--prepared") == 0) {
+      config->prepared = true;
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      exit(1);
+    }
+  }
+}
+
+static int Connect(int port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    perror("connect");
+    exit(1);
+  }
+  int on = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  return fd;
+}
+
+/** Send one statement and wait for its response, which ends with a '\0'. */
+static std::string Query(int fd, const std::string &sql) {
+  if (send(fd, sql.data(), sql.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(sql.size())) {
+    perror("send");
+    exit(1);
+  }
+  std::string response;
+  char buf[4096];
+  while (response.empty() || response.back() != '\0') {
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      fprintf(stderr, "server closed the connection\n");
+      exit(1);
+    }
+    response.append(buf, n);
+  }
+  response.pop_back();
+  return response;
+}
+
+static void Load(int port, int rows) {
+  int fd = Connect(port);
+  Query(fd, "drop database " + std::string(db_name) + ";");
+  Query(fd, "create database " + std::string(db_name) + ";");
+  Query(fd, "use " + std::string(db_name) + ";");
+  Query(fd, "create table account(id int, balance int, primary key(id));");
+  for (int i = 0; i < rows; i++) {
+    Query(fd, "insert into account values(" + std::to_string(i) + ", " + std::to_string(i * 10) + ");");
+  }
+  close(fd);
+}
+
+int main(int argc, char **argv) {
+  BenchConfig config;
+  ParseArgs(argc, argv, &config);
+
+  ExecuteEngine *engine = nullptr;
+  Server *server = nullptr;
+  std::thread server_thread;
+  if (config.port < 0) {
+    engine = new ExecuteEngine();
+    server = new Server(engine, config.workers);
+    if (server->ListenTcp(0) != DB_SUCCESS) {
+      return 1;
+    }
+    config.port = server->GetPort();
+    server_thread = std::thread([server] { server->Run(); });
+  }
+  Load(config.port, config.rows);
+
+  printf("%-8s %-12s %-14s %-12s\n", "clients", "qps", "avg_us", "p99_us");
+  for (int clients = 1; clients <= config.max_clients; clients *= 2) {
+    std::vector<int> fds;
+    for (int i = 0; i < clients; i++) {
+      fds.push_back(Connect(config.port));
+      Query(fds.back(), "use " + std::string(db_name) + ";");
+      if (config.prepared) {
+        Query(fds.back(), "prepare lookup from \"select * from account where id = ?\";");
+      }
+    }
+    std::atomic<bool> stop{false};
+    std::vector<std::vector<uint32_t>> latencies(clients);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++) {
+      threads.emplace_back([&, i] {
+        std::mt19937 rng(i);
+        std::uniform_int_distribution<int> dist(0, config.rows - 1);
+        while (!stop) {
+          std::string id = std::to_string(dist(rng));
+          std::string sql = config.prepared ? "execute lookup using " + id + ";"
+                                            : "select * from account where id = " + id + ";";
+          auto start = std::chrono::steady_clock::now();
+          Query(fds[i], sql);
+          auto stop_time = std::chrono::steady_clock::now();
+          latencies[i].push_back(
+              std::chrono::duration_cast<std::chrono::microseconds>(stop_time - start).count());
+        }
+      });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(config.duration_ms));
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (int fd : fds) {
+      close(fd);
+    }
+
+    std::vector<uint32_t> all;
+    for (auto &latency : latencies) {
+      all.insert(all.end(), latency.begin(), latency.end());
+    }
+    std::sort(all.begin(), all.end());
+    double total = 0;
+    for (auto latency : all) {
+      total += latency;
+    }
+    double qps = all.size() * 1000.0 / config.duration_ms;
+    double avg = all.empty() ? 0 : total / all.size();
+    uint32_t p99 = all.empty() ? 0 : all[std::min(all.size() - 1, all.size() * 99 / 100)];
+    printf("%-8d %-12.0f %-14.1f %-12u\n", clients, qps, avg, p99);
+  }
+
+  if (server != nullptr) {
+    server->Shutdown();
+    server_thread.join();
+    delete server;
+    delete engine;
+  }
+  return 0;
+}
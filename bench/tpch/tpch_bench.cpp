@@ -0,0 +1,487 @@
+/**
+ * Analytic benchmark on TPC-H like data.
+ *
+ * The eight tables of TPC-H are generated at scale factor --scale, dates are ints of the form yyyymmdd and
+ * decimals are floats. The rows are loaded by multi-row INSERT statements, with the primary key indexes
+ * created up front since an index is not built from the rows already there. The data follows the value
+ * distributions of the TPC-H generator closely enough for its predicates to be as selective, it is not the
+ * data of dbgen.
+ *
+ * Then a fixed set of queries runs through ExecuteEngine, one run to warm up and --runs timed runs each.
+ * The engine has no joins and no aggregates, so the queries are the scans, filters and key lookups of the
+ * TPC-H queries on single tables. Most return few rows, the time goes into the scan rather than into
+ * printing the result. The database is kept, --reuse runs the queries on the data of a previous run.
+ *
+ * Usage: tpch_bench [--scale=F] [--runs=N] [--queries=NAME,...] [--parallelism=N] [--reuse]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "executor/execute_engine.h"
+#include "parser/parsed_statement.h"
+
+static const char *db_name = "tpch_bench";
+static const size_t MAX_INSERT_ROWS = 1000;        // rows of one insert statement
+static const size_t MAX_INSERT_LENGTH = 1 << 18;  // length of one insert statement
+
+static const int START_DATE = 19920101;
+static const int CURRENT_DATE = 19950617;  // lines received before it are returned or accepted
+static const int ORDER_DAYS = 2405;  // days from the first to the last order date, 1998-08-02
+
+static const char *regions[] = {"AFRICA", "AMERICA", "ASIA", "EUROPE", "MIDDLE EAST"};
+static const struct {
+  const char *name_;
+  int region_;
+} nations[] = {{"ALGERIA", 0},   {"ARGENTINA", 1},      {"BRAZIL", 1},  {"CANADA", 1},         {"EGYPT", 4},
+               {"ETHIOPIA", 0},  {"FRANCE", 3},         {"GERMANY", 3}, {"INDIA", 2},          {"INDONESIA", 2},
+               {"IRAN", 4},      {"IRAQ", 4},           {"JAPAN", 2},   {"JORDAN", 4},         {"KENYA", 0},
+               {"MOROCCO", 0},   {"MOZAMBIQUE", 0},     {"PERU", 1},    {"CHINA", 2},          {"ROMANIA", 3},
+               {"SAUDI ARABIA", 4}, {"VIETNAM", 2},     {"RUSSIA", 3},  {"UNITED KINGDOM", 3}, {"UNITED STATES", 1}};
+static const char *segments[] = {"AUTOMOBILE", "BUILDING", "FURNITURE", "MACHINERY", "HOUSEHOLD"};
+static const char *priorities[] = {"1-URGENT", "2-HIGH", "3-MEDIUM", "4-NOT SPECIFIED", "5-LOW"};
+static const char *instructions[] = {"DELIVER IN PERSON", "COLLECT COD", "NONE", "TAKE BACK RETURN"};
+static const char *modes[] = {"REG AIR", "AIR", "RAIL", "SHIP", "TRUCK", "MAIL", "FOB"};
+static const char *type_syllables1[] = {"STANDARD", "SMALL", "MEDIUM", "LARGE", "ECONOMY", "PROMO"};
+static const char *type_syllables2[] = {"ANODIZED", "BURNISHED", "PLATED", "POLISHED", "BRUSHED"};
+static const char *type_syllables3[] = {"TIN", "NICKEL", "BRASS", "STEEL", "COPPER"};
+static const char *container_syllables1[] = {"SM", "LG", "MED", "JUMBO", "WRAP"};
+static const char *container_syllables2[] = {"CASE", "BOX", "BAG", "JAR", "PKG", "PACK", "CAN", "DRUM"};
+static const char *colors[] = {"almond", "antique", "aquamarine", "azure", "beige", "bisque", "black", "blanched",
+                               "blue", "blush", "brown", "burlywood", "chartreuse", "chiffon", "chocolate",
+                               "coral", "cornflower", "cream", "cyan", "dark", "deep", "dim", "dodger", "drab",
+                               "firebrick", "forest", "frosted", "gainsboro", "ghost", "goldenrod", "green",
+                               "grey", "honeydew", "hot", "indian", "ivory", "khaki", "lace", "lavender"};
+static const char *words[] = {"furiously", "quickly", "carefully", "blithely", "slyly", "fluffily", "final",
+                              "regular", "special", "pending", "express", "ironic", "bold", "even", "silent",
+                              "deposits", "requests", "accounts", "packages", "theodolites", "instructions",
+                              "foxes", "pinto", "beans", "ideas", "platelets", "dependencies", "excuses",
+                              "sleep", "wake", "are", "cajole", "haggle", "nag", "use", "boost", "affix",
+                              "detect", "integrate", "among", "above", "across", "against", "along"};
+
+template <typename T, size_t N>
+static constexpr size_t Count(T (&)[N]) {
+  return N;
+}
+
+static void Run(ExecuteEngine *engine, Session *session, const std::string &sql, bool must_succeed = true) {
+  auto statement = ParsedStatement::Parse(sql);
+  if (statement->HasError()) {
+    fprintf(stderr, "%s: %s\n", sql.substr(0, 64).c_str(), statement->GetErrorMessage().c_str());
+    exit(1);
+  }
+  if (engine->Execute(*statement, session) != DB_SUCCESS && must_succeed) {
+    fprintf(stderr, "%s: failed\n", sql.substr(0, 64).c_str());
+    exit(1);
+  }
+}
+
+/** @return the date days after START_DATE as yyyymmdd */
+static int AddDays(int days) {
+  static const int month_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int year = START_DATE / 10000;
+  int month = 0;
+  for (;;) {
+    int length = month_days[month] + (month == 1 && year % 4 == 0 ? 1 : 0);
+    if (days < length) {
+      break;
+    }
+    days -= length;
+    if (++month == 12) {
+      month = 0;
+      year++;
+    }
+  }
+  return year * 10000 + (month + 1) * 100 + days + 1;
+}
+
+/**
+ * Generator writes the rows of the tables as insert statements. Values come from a seeded generator, every
+ * run at a scale factor makes the same data.
+ */
+class Generator {
+ public:
+  Generator(ExecuteEngine *engine, Session *session, double scale) : engine_(engine), session_(session) {
+    suppliers_ = std::max<int64_t>(1, static_cast<int64_t>(10000 * scale));
+    parts_ = std::max<int64_t>(1, static_cast<int64_t>(200000 * scale));
+    customers_ = std::max<int64_t>(1, static_cast<int64_t>(150000 * scale));
+    orders_ = std::max<int64_t>(1, static_cast<int64_t>(1500000 * scale));
+  }
+
+  void CreateTables() {
+    Run(engine_, session_, "create table region(r_regionkey int, r_name char(25), r_comment char(152), "
+                           "primary key(r_regionkey));");
+    Run(engine_, session_, "create table nation(n_nationkey int, n_name char(25), n_regionkey int, "
+                           "n_comment char(152), primary key(n_nationkey));");
+    Run(engine_, session_, "create table supplier(s_suppkey int, s_name char(25), s_address char(40), "
+                           "s_nationkey int, s_phone char(15), s_acctbal float, s_comment char(101), "
+                           "primary key(s_suppkey));");
+    Run(engine_, session_, "create table customer(c_custkey int, c_name char(25), c_address char(40), "
+                           "c_nationkey int, c_phone char(15), c_acctbal float, c_mktsegment char(10), "
+                           "c_comment char(117), primary key(c_custkey));");
+    Run(engine_, session_, "create table part(p_partkey int, p_name char(55), p_mfgr char(25), p_brand char(10), "
+                           "p_type char(25), p_size int, p_container char(10), p_retailprice float, "
+                           "p_comment char(23), primary key(p_partkey));");
+    Run(engine_, session_, "create table partsupp(ps_partkey int, ps_suppkey int, ps_availqty int, "
+                           "ps_supplycost float, ps_comment char(199));");
+    Run(engine_, session_, "create table orders(o_orderkey int, o_custkey int, o_orderstatus char(1), "
+                           "o_totalprice float, o_orderdate int, o_orderpriority char(15), o_clerk char(15), "
+                           "o_shippriority int, o_comment char(79), primary key(o_orderkey));");
+    Run(engine_, session_, "create table lineitem(l_orderkey int, l_partkey int, l_suppkey int, "
+                           "l_linenumber int, l_quantity float, l_extendedprice float, l_discount float, "
+                           "l_tax float, l_returnflag char(1), l_linestatus char(1), l_shipdate int, "
+                           "l_commitdate int, l_receiptdate int, l_shipinstruct char(25), l_shipmode char(10), "
+                           "l_comment char(44));");
+    const std::pair<const char *, const char *> keys[] = {{"region", "r_regionkey"},  {"nation", "n_nationkey"},
+                                                          {"supplier", "s_suppkey"}, {"customer", "c_custkey"},
+                                                          {"part", "p_partkey"},     {"orders", "o_orderkey"}};
+    for (const auto &key : keys) {
+      Run(engine_, session_,
+          "create index " + std::string(key.first) + "_pk on " + key.first + "(" + key.second + ");");
+    }
+  }
+
+  /** Load every table, printing the time each took */
+  void Load() {
+    LoadTables({"region"}, [&] {
+      for (size_t i = 0; i < Count(regions); i++) {
+        Row("region") << i << Quote(regions[i]) << Quote(Text(31, 115));
+      }
+    });
+    LoadTables({"nation"}, [&] {
+      for (size_t i = 0; i < Count(nations); i++) {
+        Row("nation") << i << Quote(nations[i].name_) << nations[i].region_ << Quote(Text(31, 114));
+      }
+    });
+    LoadTables({"supplier"}, [&] {
+      for (int64_t key = 1; key <= suppliers_; key++) {
+        int nation = Uniform(0, 24);
+        Row("supplier") << key << Quote(Numbered("Supplier#", key)) << Quote(Address()) << nation
+                        << Quote(Phone(nation)) << Money(-99999, 999999) << Quote(Text(25, 100));
+      }
+    });
+    LoadTables({"customer"}, [&] {
+      for (int64_t key = 1; key <= customers_; key++) {
+        int nation = Uniform(0, 24);
+        Row("customer") << key << Quote(Numbered("Customer#", key)) << Quote(Address()) << nation
+                        << Quote(Phone(nation)) << Money(-99999, 999999) << Quote(Pick(segments))
+                        << Quote(Text(29, 116));
+      }
+    });
+    LoadTables({"part"}, [&] {
+      for (int64_t key = 1; key <= parts_; key++) {
+        std::string name;
+        for (int i = 0; i < 5; i++) {
+          name += (i > 0 ? " " : "") + std::string(Pick(colors));
+        }
+        int manufacturer = Uniform(1, 5);
+        std::string type =
+            std::string(Pick(type_syllables1)) + " " + Pick(type_syllables2) + " " + Pick(type_syllables3);
+        std::string container = std::string(Pick(container_syllables1)) + " " + Pick(container_syllables2);
+        Row("part") << key << Quote(name) << Quote("Manufacturer#" + std::to_string(manufacturer))
+                    << Quote("Brand#" + std::to_string(manufacturer) + std::to_string(Uniform(1, 5))) << Quote(type)
+                    << Uniform(1, 50) << Quote(container) << RetailPrice(key) << Quote(Text(5, 22));
+      }
+    });
+    LoadTables({"partsupp"}, [&] {
+      for (int64_t key = 1; key <= parts_; key++) {
+        for (int64_t i = 0; i < 4; i++) {
+          int64_t supplier = (key + i * (suppliers_ / 4 + (key - 1) / suppliers_)) % suppliers_ + 1;
+          Row("partsupp") << key << supplier << Uniform(1, 9999) << Money(100, 100000) << Quote(Text(49, 198));
+        }
+      }
+    });
+    // The lines of an order are made with it, its status and total price follow from them.
+    LoadTables({"orders", "lineitem"}, [&] {
+      for (int64_t key = 1; key <= orders_; key++) {
+        int order_date = Uniform(0, ORDER_DAYS);
+        double total = 0;
+        int shipped = 0;
+        int line_count = Uniform(1, 7);
+        for (int line = 1; line <= line_count; line++) {
+          int64_t part = Uniform(1, parts_);
+          int64_t supplier = (part + Uniform(0, 3) * (suppliers_ / 4 + (part - 1) / suppliers_)) % suppliers_ + 1;
+          int quantity = Uniform(1, 50);
+          double price = quantity * RetailPrice(part);
+          double discount = Uniform(0, 10) / 100.0;
+          double tax = Uniform(0, 8) / 100.0;
+          int ship_date = AddDays(order_date + Uniform(1, 121));
+          int receipt_date = AddDays(order_date + Uniform(1, 121) + Uniform(1, 30));
+          receipt_date = std::max(receipt_date, ship_date);
+          const char *flag = receipt_date <= CURRENT_DATE ? (Uniform(0, 1) == 0 ? "R" : "A") : "N";
+          bool open = ship_date > CURRENT_DATE;
+          shipped += open ? 0 : 1;
+          total += price * (1 + tax) * (1 - discount);
+          Row("lineitem") << key << part << supplier << line << quantity << price << discount << tax
+                          << Quote(flag) << Quote(open ? "O" : "F") << ship_date
+                          << AddDays(order_date + Uniform(30, 90)) << receipt_date << Quote(Pick(instructions))
+                          << Quote(Pick(modes)) << Quote(Text(10, 43));
+        }
+        const char *status = shipped == line_count ? "F" : shipped == 0 ? "O" : "P";
+        std::string clerk = Numbered("Clerk#", Uniform(1, std::max<int64_t>(1, orders_ / 1500)));
+        Row("orders") << key << Uniform(1, customers_) << Quote(status) << total << AddDays(order_date)
+                      << Quote(Pick(priorities)) << Quote(clerk) << 0 << Quote(Text(19, 78));
+      }
+    });
+  }
+
+  inline int64_t GetOrders() const { return orders_; }
+
+ private:
+  /** Values of one row, added to the statement being built when it goes away */
+  class RowBuilder {
+   public:
+    RowBuilder(Generator *generator, const std::string &table) : generator_(generator), table_(table) {}
+
+    ~RowBuilder() { generator_->Add(table_, "(" + values_.str() + ")"); }
+
+    template <typename T>
+    RowBuilder &operator<<(const T &value) {
+      if (!first_) {
+        values_ << ", ";
+      }
+      values_ << value;
+      first_ = false;
+      return *this;
+    }
+
+   private:
+    Generator *generator_;
+    std::string table_;
+    std::ostringstream values_;
+    bool first_{true};
+  };
+
+  /** The insert statement being built for a table */
+  struct PendingInsert {
+    std::vector<std::string> values_;
+    size_t length_{0};
+    size_t rows_{0};  // rows loaded into the table
+  };
+
+  RowBuilder Row(const std::string &table) { return RowBuilder(this, table); }
+
+  /** Load tables whose rows are made together by fill, printing the time it took */
+  template <typename Fill>
+  void LoadTables(const std::vector<std::string> &tables, const Fill &fill) {
+    auto start = std::chrono::steady_clock::now();
+    fill();
+    size_t rows = 0;
+    std::string names;
+    for (const auto &table : tables) {
+      Flush(table);
+      rows += pending_[table].rows_;
+      names += (names.empty() ? "" : "+") + table;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("%-16s %12zu rows %10.2f s %12.0f rows/sec\n", names.c_str(), rows, seconds, rows / seconds);
+    fflush(stdout);
+  }
+
+  /** Add a row to the insert statement of table, which is run once it is full */
+  void Add(const std::string &table, std::string values) {
+    auto &pending = pending_[table];
+    pending.length_ += values.size() + 2;
+    pending.values_.push_back(std::move(values));
+    if (pending.values_.size() >= MAX_INSERT_ROWS || pending.length_ >= MAX_INSERT_LENGTH) {
+      Flush(table);
+    }
+  }
+
+  void Flush(const std::string &table) {
+    auto &pending = pending_[table];
+    if (pending.values_.empty()) {
+      return;
+    }
+    std::string sql = "insert into " + table + " values ";
+    for (size_t i = 0; i < pending.values_.size(); i++) {
+      sql += (i > 0 ? ", " : "") + pending.values_[i];
+    }
+    Run(engine_, session_, sql + ";");
+    pending.rows_ += pending.values_.size();
+    pending.values_.clear();
+    pending.length_ = 0;
+  }
+
+  int64_t Uniform(int64_t low, int64_t high) { return std::uniform_int_distribution<int64_t>(low, high)(rng_); }
+
+  template <typename T, size_t N>
+  const char *Pick(T (&values)[N]) {
+    return values[Uniform(0, N - 1)];
+  }
+
+  /** @return an amount of cents between low and high, as a decimal */
+  std::string Money(int64_t low, int64_t high) {
+    int64_t cents = Uniform(low, high);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.2f", cents / 100.0);
+    return buf;
+  }
+
+  static double RetailPrice(int64_t part) {
+    return (90000 + (part / 10) % 20001 + 100 * (part % 1000)) / 100.0;
+  }
+
+  static std::string Quote(const std::string &value) { return "\"" + value + "\""; }
+
+  static std::string Numbered(const char *prefix, int64_t number) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%s%09lld", prefix, static_cast<long long>(number));
+    return buf;
+  }
+
+  std::string Phone(int nation) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%d-%03d-%03d-%04d", nation + 10, static_cast<int>(Uniform(100, 999)),
+             static_cast<int>(Uniform(100, 999)), static_cast<int>(Uniform(1000, 9999)));
+    return buf;
+  }
+
+  std::string Address() {
+    std::string address(Uniform(10, 40), ' ');
+    for (auto &ch : address) {
+      ch = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789,"[Uniform(0, 62)];
+    }
+    return address;
+  }
+
+  /** @return words making up between min_length and max_length characters */
+  std::string Text(size_t min_length, size_t max_length) {
+    size_t length = Uniform(min_length, max_length);
+    std::string text;
+    while (text.size() < length) {
+      text += (text.empty() ? "" : " ") + std::string(Pick(words));
+    }
+    text.resize(length);
+    while (!text.empty() && text.back() == ' ') {
+      text.pop_back();
+    }
+    return text;
+  }
+
+  ExecuteEngine *engine_;
+  Session *session_;
+  std::mt19937_64 rng_{19920101};
+  int64_t suppliers_;
+  int64_t parts_;
+  int64_t customers_;
+  int64_t orders_;
+  std::map<std::string, PendingInsert> pending_;
+};
+
+/** @return number of rows a select printed */
+static size_t ResultRows(const std::string &out) {
+  size_t pos = out.rfind(" row in set");
+  if (pos == std::string::npos) {
+    return 0;
+  }
+  size_t start = out.find_last_not_of("0123456789", pos - 1);
+  return std::stoul(out.substr(start == std::string::npos ? 0 : start + 1, pos));
+}
+
+int main(int argc, char **argv) {
+  double scale = 0.1;
+  int runs = 3;
+  int parallelism = 1;
+  bool reuse = false;
+  std::string query_names;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--scale=", 8) == 0) {
+      scale = atof(argv[i] + 8);
+    } else if (strncmp(argv[i], "--runs=", 7) == 0) {
+      runs = std::max(1, atoi(argv[i] + 7));
+    } else if (strncmp(argv[i], "--queries=", 10) == 0) {
+      query_names = "," + std::string(argv[i] + 10) + ",";
+    } else if (strncmp(argv[i], "--parallelism=", 14) == 0) {
+      parallelism = atoi(argv[i] + 14);
+    } else if (strcmp(argv[i], "--reuse") == 0) {
+      reuse = true;
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (scale <= 0) {
+    fprintf(stderr, "scale must be above 0\n");
+    return 1;
+  }
+
+  auto engine = new ExecuteEngine();
+  std::ostringstream out;
+  Session session(out);
+  Generator generator(engine, &session, scale);
+  if (!reuse) {
+    auto start = std::chrono::steady_clock::now();
+    Run(engine, &session, "drop database " + std::string(db_name) + ";", false);
+    Run(engine, &session, "create database " + std::string(db_name) + ";");
+    Run(engine, &session, "use " + std::string(db_name) + ";");
+    printf("scale factor %g\n", scale);
+    generator.CreateTables();
+    generator.Load();
+    printf("loaded in %.2f s\n\n",
+           std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  } else {
+    Run(engine, &session, "use " + std::string(db_name) + ";");
+  }
+  out.str("");
+  Run(engine, &session, "set parallelism = " + std::to_string(parallelism) + ";");
+
+  std::string middle_order = std::to_string(generator.GetOrders() / 2);
+  std::string range_end = std::to_string(generator.GetOrders() / 2 + 1000);
+  const std::vector<std::pair<const char *, std::string>> queries = {
+      {"q1_late_shipments",
+       "select l_returnflag, l_linestatus, l_quantity, l_extendedprice from lineitem where l_shipdate >= 19981101;"},
+      {"q6_forecast_revenue",
+       "select l_extendedprice, l_discount from lineitem where l_shipdate >= 19940101 and l_shipdate < 19950101 "
+       "and l_discount >= 0.05 and l_discount <= 0.07 and l_quantity < 24;"},
+      {"lineitem_full_scan", "select l_orderkey from lineitem where l_quantity > 50;"},
+      {"q4_urgent_orders",
+       "select o_orderkey, o_orderpriority from orders where o_orderdate >= 19930701 and o_orderdate < 19931001 "
+       "and o_orderpriority = \"1-URGENT\";"},
+      {"orders_point_lookup", "select * from orders where o_orderkey = " + middle_order + ";"},
+      {"orders_key_range",
+       "select o_orderkey, o_totalprice from orders where o_orderkey >= " + middle_order +
+           " and o_orderkey < " + range_end + ";"},
+      {"q3_building_customers",
+       "select c_custkey, c_name, c_acctbal from customer where c_mktsegment = \"BUILDING\" and c_acctbal > 9900.0;"},
+      {"q14_promo_parts",
+       "select p_partkey, p_retailprice from part where p_type = \"PROMO BRUSHED COPPER\" and p_size <= 10;"},
+      {"q11_low_stock", "select ps_partkey, ps_suppkey, ps_supplycost from partsupp where ps_availqty < 20;"},
+      {"q2_suppliers_of_nation",
+       "select s_suppkey, s_name, s_acctbal from supplier where s_nationkey = 7 and s_acctbal > 5000.0;"},
+      {"q5_nations_of_region", "select n_nationkey, n_name from nation where n_regionkey = 2;"},
+  };
+
+  printf("%-24s %10s %12s %12s %12s\n", "query", "rows", "min_ms", "avg_ms", "max_ms");
+  for (const auto &query : queries) {
+    if (!query_names.empty() && query_names.find("," + std::string(query.first) + ",") == std::string::npos) {
+      continue;
+    }
+    out.str("");
+    Run(engine, &session, query.second);
+    size_t rows = ResultRows(out.str());
+    double min_ms = 0;
+    double max_ms = 0;
+    double total_ms = 0;
+    for (int i = 0; i < runs; i++) {
+      out.str("");
+      auto start = std::chrono::steady_clock::now();
+      Run(engine, &session, query.second);
+      double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      min_ms = i == 0 ? ms : std::min(min_ms, ms);
+      max_ms = std::max(max_ms, ms);
+      total_ms += ms;
+    }
+    printf("%-24s %10zu %12.2f %12.2f %12.2f\n", query.first, rows, min_ms, total_ms / runs, max_ms);
+    fflush(stdout);
+  }
+  delete engine;
+  return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * Lock contention benchmark.
+ *
+ * Worker threads run short update transactions, each of them updates a few rows picked at random
+ * from a set of hot rows, under strict 2PL. The size of the hot set is varied to show how throughput
+ * and the abort rate (deadlock victims) change with contention.
+ *
+ * Usage: lock_manager_bench [--threads=N] [--duration_ms=N] [--rows_per_txn=N] [--rows=N]
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/disk_manager.h"
+#include "storage/table_heap.h"
+#include "transaction/lock_manager.h"
+#include "transaction/txn_manager.h"
+
+static const char *db_file_name = "lock_manager_bench.db";
+
+struct BenchConfig {
+  int threads = 8;
+  int duration_ms = 2000;
+  int rows_per_txn = 4;
+  int rows = 4096;
+};
+
+static void ParseArgs(int argc, char **argv, BenchConfig *config) {
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--threads=", 10) == 0) {
+      config->threads = atoi(argv[i] + 10);
+    } else if (strncmp(argv[i], "--duration_ms=", 14) == 0) {
+      config->duration_ms = atoi(argv[i] + 14);
+    } else if (strncmp(argv[i], "--rows_per_txn=", 15) == 0) {
+      config->rows_per_txn = atoi(argv[i] + 15);
+    } else if (strncmp(argv[i], "--rows=", 7) == 0) {
+      config->rows = atoi(argv[i] + 7);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      exit(1);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  BenchConfig config;
+  ParseArgs(argc, argv, &config);
+
+  remove(db_file_name);
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("balance", TypeId::kTypeInt, 1, false, false)};
+  Schema schema(columns);
+
+  std::vector<RowId> rids;
+  {
+    TableHeap *loader = TableHeap::Create(bpm, &schema, nullptr, nullptr, nullptr);
+    for (int i = 0; i < config.rows; i++) {
+      std::vector<Field> fields{Field(kTypeInt, i), Field(kTypeInt, 0)};
+      Row row(fields);
+      loader->InsertTuple(row, nullptr);
+      rids.push_back(row.GetRowId());
+    }
+    page_id_t first_page_id = loader->GetFirstPageId();
+    delete loader;
+
+    printf("%-10s %-8s %-14s %-12s %-10s\n", "hot_rows", "threads", "commits/sec", "aborts/sec", "abort_rate");
+    for (int hot_rows = 1; hot_rows <= config.rows; hot_rows *= 4) {
+      LockManager lock_mgr(true, std::chrono::milliseconds(10));
+      TxnManager txn_mgr(&lock_mgr);
+      TableHeap *table_heap = TableHeap::Create(bpm, first_page_id, &schema, nullptr, &lock_mgr);
+      std::atomic<bool> stop{false};
+      std::atomic<uint64_t> commits{0}, aborts{0};
+      std::vector<std::thread> workers;
+      for (int t = 0; t < config.threads; t++) {
+        workers.emplace_back([&, t] {
+          std::mt19937 rng(t);
+          std::uniform_int_distribution<int> pick(0, hot_rows - 1);
+          while (!stop) {
+            auto txn = txn_mgr.Begin();
+            bool ok = true;
+            for (int k = 0; k < config.rows_per_txn && ok; k++) {
+              int id = pick(rng);
+              std::vector<Field> fields{Field(kTypeInt, id), Field(kTypeInt, static_cast<int32_t>(rng()))};
+              Row row(fields);
+              ok = table_heap->UpdateTuple(row, rids[id], txn);
+            }
+            if (ok) {
+              txn_mgr.Commit(txn);
+              commits++;
+            } else {
+              txn_mgr.Abort(txn);
+              aborts++;
+            }
+          }
+        });
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(config.duration_ms));
+      stop = true;
+      for (auto &worker : workers) {
+        worker.join();
+      }
+      delete table_heap;
+      double seconds = config.duration_ms / 1000.0;
+      uint64_t total = commits + aborts;
+      printf("%-10d %-8d %-14.0f %-12.0f %-10.4f\n", hot_rows, config.threads, commits / seconds, aborts / seconds,
+             total == 0 ? 0.0 : static_cast<double>(aborts) / total);
+    }
+  }
+
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name);
+  return 0;
+}
@@ -0,0 +1,574 @@
+/**
+ * YCSB benchmark.
+ *
+ * The core workloads of the Yahoo! Cloud Serving Benchmark run against one of three layers:
+ *   heap    rows are read and written in the TableHeap by RowId, the keys are mapped to RowIds in memory
+ *   index   rows are found through the B+ tree index on the key and then read and written in the TableHeap
+ *   engine  every operation is a SQL statement parsed and run by ExecuteEngine, one session per thread
+ * A table of --records rows, a key and 10 char(100) fields each, is loaded in batches. Then each workload
+ * runs --operations operations split over --threads threads:
+ *   A  50% read, 50% update                  B  95% read, 5% update
+ *   C  100% read                             D  95% read of the latest keys, 5% insert
+ *   E  95% scan of up to 100 rows, 5% insert F  50% read, 50% read-modify-write
+ * Updates rewrite the whole row. Keys are picked uniformly or from a scrambled zipfian distribution, only
+ * workload D favours the keys inserted last. The workloads run one after another on the same table.
+ *
+ * One JSON object per workload is printed on a line of its own, with the throughput and the latency
+ * percentiles in microseconds of all operations together and of each kind of operation.
+ *
+ * Usage: ycsb_bench [--layer=heap|index|engine] [--workloads=ABCDEF] [--records=N] [--operations=N]
+ *                   [--threads=N] [--distribution=zipfian|uniform] [--buffer_pool_pages=N]
+ */
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sys/stat.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "common/metrics.h"
+#include "executor/execute_engine.h"
+#include "parser/parsed_statement.h"
+
+static const char *db_name = "ycsb_bench";
+static const int FIELD_COUNT = 10;
+static const int FIELD_LENGTH = 100;
+static const int MAX_SCAN_LENGTH = 100;
+static const int LOAD_BATCH_SIZE = 100;
+
+enum OperationType { kRead, kUpdate, kInsert, kScan, kReadModifyWrite, kOperationTypes };
+
+static const char *operation_names[kOperationTypes] = {"read", "update", "insert", "scan", "read_modify_write"};
+
+struct Workload {
+  char name_;
+  double proportions_[kOperationTypes];  // share of each kind of operation
+  bool latest_;                           // reads favour the keys inserted last
+};
+
+static const Workload workloads[] = {{'A', {0.5, 0.5, 0, 0, 0}, false},  {'B', {0.95, 0.05, 0, 0, 0}, false},
+                                     {'C', {1, 0, 0, 0, 0}, false},      {'D', {0.95, 0, 0.05, 0, 0}, true},
+                                     {'E', {0, 0, 0.05, 0.95, 0}, false}, {'F', {0.5, 0, 0, 0, 0.5}, false}};
+
+/**
+ * Zipfian distribution over [0, items) after Gray et al., "Quickly Generating Billion-Record Synthetic
+ * Databases", as used by YCSB.
+ */
+class ZipfianGenerator {
+ public:
+  explicit ZipfianGenerator(uint64_t items, double theta = 0.99) : items_(items), theta_(theta) {
+    zetan_ = Zeta(items, theta);
+    alpha_ = 1.0 / (1.0 - theta);
+    eta_ = (1 - std::pow(2.0 / items, 1 - theta)) / (1 - Zeta(2, theta) / zetan_);
+  }
+
+  uint64_t Next(std::mt19937_64 &rng) {
+    double u = std::uniform_real_distribution<double>(0, 1)(rng);
+    double uz = u * zetan_;
+    if (uz < 1) {
+      return 0;
+    }
+    if (uz < 1 + std::pow(0.5, theta_)) {
+      return 1;
+    }
+    return std::min<uint64_t>(items_ - 1, static_cast<uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_)));
+  }
+
+ private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 1; i <= n; i++) {
+      sum += 1 / std::pow(static_cast<double>(i), theta);
+    }
+    return sum;
+  }
+
+  uint64_t items_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+};
+
+/** @return an FNV-1a hash of value, spreads the popular zipfian items over the key space */
+static uint64_t Scramble(uint64_t value) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int i = 0; i < 8; i++) {
+    hash ^= value & 0xff;
+    hash *= 0x100000001b3ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+/** @return the value of a field, FIELD_LENGTH characters derived from seed */
+static std::string FieldValue(uint64_t seed) {
+  std::string value(FIELD_LENGTH, 'a');
+  for (int i = 0; i < FIELD_LENGTH; i++) {
+    value[i] = static_cast<char>('a' + (seed + i * 7) % 26);
+  }
+  return value;
+}
+
+/** The operations of one thread on the layer measured. */
+class Client {
+ public:
+  virtual ~Client() = default;
+
+  virtual bool Read(int32_t key) = 0;
+
+  virtual bool Update(int32_t key, uint64_t seed) = 0;
+
+  virtual bool Insert(int32_t key, uint64_t seed) = 0;
+
+  virtual bool Scan(int32_t key, int length) = 0;
+};
+
+/** A layer the workloads run against. */
+class Store {
+ public:
+  virtual ~Store() = default;
+
+  /** Create the table and load the keys [0, records) */
+  virtual void Load(int32_t records) = 0;
+
+  virtual std::unique_ptr<Client> NewClient() = 0;
+};
+
+/**
+ * The heap and index layers. The RowId of every key is kept in memory, the index layer looks the keys up in
+ * the B+ tree instead. A scan finds its first row and reads on in the heap, which holds the loaded rows in
+ * key order.
+ */
+class StorageStore : public Store {
+ public:
+  StorageStore(BufferPool *buffer_pool, bool use_index, size_t max_keys)
+      : use_index_(use_index), rids_(max_keys) {
+    db_ = std::make_unique<DBStorageEngine>(db_name, true, buffer_pool);
+    for (auto &rid : rids_) {
+      rid.store(INVALID_ROWID.Get(), std::memory_order_relaxed);
+    }
+  }
+
+  ~StorageStore() override {
+    db_.reset();
+    remove(("./databases/" + std::string(db_name)).c_str());
+  }
+
+  void Load(int32_t records) override {
+    std::vector<Column *> columns = {new Column("ycsb_key", TypeId::kTypeInt, 0, false, true)};
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      columns.push_back(
+          new Column("field" + std::to_string(i), TypeId::kTypeChar, FIELD_LENGTH, i + 1, false, false));
+    }
+    schema_ = std::make_shared<Schema>(columns);
+    TableInfo *table_info = nullptr;
+    db_->catalog_mgr_->CreateTable("usertable", schema_.get(), nullptr, table_info);
+    heap_ = table_info->GetTableHeap();
+    if (use_index_) {
+      IndexInfo *index_info = nullptr;
+      db_->catalog_mgr_->CreateIndex("usertable", "usertable_key", {"ycsb_key"}, nullptr, index_info, "bptree");
+      index_ = index_info->GetIndex();
+    }
+    for (int32_t start = 0; start < records; start += LOAD_BATCH_SIZE) {
+      std::vector<Row> rows;
+      std::vector<Row> keys;
+      for (int32_t key = start; key < std::min(records, start + LOAD_BATCH_SIZE); key++) {
+        rows.push_back(MakeRow(key, key));
+        keys.push_back(MakeKey(key));
+      }
+      heap_->InsertTuples(rows, nullptr);
+      std::vector<RowId> row_ids;
+      for (size_t i = 0; i < rows.size(); i++) {
+        row_ids.push_back(rows[i].GetRowId());
+        rids_[start + i].store(rows[i].GetRowId().Get(), std::memory_order_relaxed);
+      }
+      if (use_index_) {
+        std::vector<bool> inserted;
+        index_->InsertEntries(keys, row_ids, nullptr, inserted);
+      }
+    }
+  }
+
+  std::unique_ptr<Client> NewClient() override;
+
+  bool Read(int32_t key) {
+    RowId rid;
+    if (!Find(key, &rid)) {
+      return false;
+    }
+    Row row(rid);
+    return heap_->GetTuple(&row, nullptr);
+  }
+
+  bool Update(int32_t key, uint64_t seed) {
+    RowId rid;
+    if (!Find(key, &rid)) {
+      return false;
+    }
+    Row row = MakeRow(key, seed);
+    return heap_->UpdateTuple(row, rid, nullptr);
+  }
+
+  bool Insert(int32_t key, uint64_t seed) {
+    Row row = MakeRow(key, seed);
+    if (!heap_->InsertTuple(row, nullptr)) {
+      return false;
+    }
+    if (use_index_ && index_->InsertEntry(MakeKey(key), row.GetRowId(), nullptr) != DB_SUCCESS) {
+      return false;
+    }
+    rids_[key].store(row.GetRowId().Get(), std::memory_order_release);
+    return true;
+  }
+
+  bool Scan(int32_t key, int length) {
+    RowId rid;
+    if (!Find(key, &rid)) {
+      return false;
+    }
+    auto iter = TableIterator(heap_, rid, nullptr);
+    for (int i = 0; i < length && iter != heap_->End(); i++, ++iter) {
+    }
+    return true;
+  }
+
+ private:
+  Row MakeRow(int32_t key, uint64_t seed) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      std::string value = FieldValue(seed + i);
+      fields.emplace_back(TypeId::kTypeChar, const_cast<char *>(value.data()), FIELD_LENGTH, true);
+    }
+    return Row(fields);
+  }
+
+  static Row MakeKey(int32_t key) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+    return Row(fields);
+  }
+
+  bool Find(int32_t key, RowId *rid) {
+    if (!use_index_) {
+      *rid = RowId(rids_[key].load(std::memory_order_acquire));
+      return !(*rid == INVALID_ROWID);
+    }
+    std::vector<RowId> result;
+    if (index_->ScanKey(MakeKey(key), result, nullptr) != DB_SUCCESS) {
+      return false;
+    }
+    *rid = result[0];
+    return true;
+  }
+
+  bool use_index_;
+  std::unique_ptr<DBStorageEngine> db_;
+  std::shared_ptr<Schema> schema_;
+  TableHeap *heap_{nullptr};
+  Index *index_{nullptr};
+  std::vector<std::atomic<int64_t>> rids_;  // RowId of each key, INVALID_ROWID until it is inserted
+};
+
+class StorageClient : public Client {
+ public:
+  explicit StorageClient(StorageStore *store) : store_(store) {}
+
+  bool Read(int32_t key) override { return store_->Read(key); }
+
+  bool Update(int32_t key, uint64_t seed) override { return store_->Update(key, seed); }
+
+  bool Insert(int32_t key, uint64_t seed) override { return store_->Insert(key, seed); }
+
+  bool Scan(int32_t key, int length) override { return store_->Scan(key, length); }
+
+ private:
+  StorageStore *store_;
+};
+
+std::unique_ptr<Client> StorageStore::NewClient() { return std::make_unique<StorageClient>(this); }
+
+/** Run a statement in session, the output is dropped. @return false if the statement failed */
+static bool Run(ExecuteEngine *engine, Session *session, std::ostringstream *out, const std::string &sql) {
+  auto statement = ParsedStatement::Parse(sql);
+  if (statement->HasError()) {
+    fprintf(stderr, "%s: %s\n", sql.substr(0, 64).c_str(), statement->GetErrorMessage().c_str());
+    exit(1);
+  }
+  bool success = engine->Execute(*statement, session) == DB_SUCCESS;
+  out->str("");
+  return success;
+}
+
+/** @return the values of a row as SQL literals */
+static std::string RowValues(int32_t key, uint64_t seed) {
+  std::string values = "(" + std::to_string(key);
+  for (int i = 0; i < FIELD_COUNT; i++) {
+    values += ", \"" + FieldValue(seed + i) + "\"";
+  }
+  return values + ")";
+}
+
+class EngineClient : public Client {
+ public:
+  explicit EngineClient(ExecuteEngine *engine) : engine_(engine), session_(out_) {
+    Run(engine_, &session_, &out_, "use " + std::string(db_name) + ";");
+  }
+
+  ~EngineClient() override { engine_->CloseSession(&session_); }
+
+  bool Read(int32_t key) override {
+    return Run(engine_, &session_, &out_, "select * from usertable where ycsb_key = " + std::to_string(key) + ";");
+  }
+
+  bool Update(int32_t key, uint64_t seed) override {
+    std::string sql = "update usertable set ";
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      sql += (i > 0 ? ", field" : "field") + std::to_string(i) + " = \"" + FieldValue(seed + i) + "\"";
+    }
+    return Run(engine_, &session_, &out_, sql + " where ycsb_key = " + std::to_string(key) + ";");
+  }
+
+  bool Insert(int32_t key, uint64_t seed) override {
+    return Run(engine_, &session_, &out_, "insert into usertable values " + RowValues(key, seed) + ";");
+  }
+
+  bool Scan(int32_t key, int length) override {
+    return Run(engine_, &session_, &out_,
+               "select * from usertable where ycsb_key >= " + std::to_string(key) +
+                   " and ycsb_key < " + std::to_string(key + length) + ";");
+  }
+
+ private:
+  ExecuteEngine *engine_;
+  std::ostringstream out_;
+  Session session_;
+};
+
+/** The engine layer, the table has a unique key with a B+ tree index on it. */
+class EngineStore : public Store {
+ public:
+  explicit EngineStore(size_t buffer_pool_pages) : engine_(buffer_pool_pages), session_(out_) {
+    Run(&engine_, &session_, &out_, "drop database " + std::string(db_name) + ";");
+    Run(&engine_, &session_, &out_, "create database " + std::string(db_name) + ";");
+    Run(&engine_, &session_, &out_, "use " + std::string(db_name) + ";");
+  }
+
+  ~EngineStore() override {
+    engine_.CloseSession(&session_);
+    Run(&engine_, &session_, &out_, "drop database " + std::string(db_name) + ";");
+  }
+
+  void Load(int32_t records) override {
+    std::string sql = "create table usertable(ycsb_key int";
+    for (int i = 0; i < FIELD_COUNT; i++) {
+      sql += ", field" + std::to_string(i) + " char(" + std::to_string(FIELD_LENGTH) + ")";
+    }
+    Run(&engine_, &session_, &out_, sql + ", primary key(ycsb_key));");
+    Run(&engine_, &session_, &out_, "create index usertable_key on usertable(ycsb_key);");
+    for (int32_t start = 0; start < records; start += LOAD_BATCH_SIZE) {
+      sql = "insert into usertable values ";
+      for (int32_t key = start; key < std::min(records, start + LOAD_BATCH_SIZE); key++) {
+        sql += (key > start ? ", " : "") + RowValues(key, key);
+      }
+      Run(&engine_, &session_, &out_, sql + ";");
+    }
+  }
+
+  std::unique_ptr<Client> NewClient() override { return std::make_unique<EngineClient>(&engine_); }
+
+ private:
+  ExecuteEngine engine_;
+  std::ostringstream out_;
+  Session session_;
+};
+
+/**
+ * KeyCounter tells how many keys there are to read, inserts may finish out of order and a key counts only
+ * once all keys before it are inserted too.
+ */
+class KeyCounter {
+ public:
+  KeyCounter(int64_t count, size_t max_keys) : count_(count), done_(max_keys) {}
+
+  inline int64_t Get() const { return count_.load(std::memory_order_acquire); }
+
+  void Done(int64_t key) {
+    done_[key].store(true, std::memory_order_release);
+    int64_t count = count_.load(std::memory_order_acquire);
+    while (count < static_cast<int64_t>(done_.size()) && done_[count].load(std::memory_order_acquire)) {
+      if (count_.compare_exchange_weak(count, count + 1)) {
+        count++;
+      }
+    }
+  }
+
+ private:
+  std::atomic<int64_t> count_;
+  std::vector<std::atomic<bool>> done_;
+};
+
+/** Latency of the operations of one workload, shared by its threads. */
+struct WorkloadResult {
+  LatencyHistogram all_;
+  LatencyHistogram operations_[kOperationTypes];
+  std::atomic<uint64_t> errors_{0};
+};
+
+static void WriteLatency(std::ostringstream &out, const LatencyHistogram &histogram) {
+  out << "{\"count\":" << histogram.GetCount() << ",\"p50\":" << histogram.GetQuantile(0.5)
+      << ",\"p95\":" << histogram.GetQuantile(0.95) << ",\"p99\":" << histogram.GetQuantile(0.99)
+      << ",\"max\":" << (histogram.GetMaxNanos() + 999) / 1000 << "}";
+}
+
+int main(int argc, char **argv) {
+  std::string layer = "engine";
+  std::string workload_names = "ABCDEF";
+  int32_t records = 10000;
+  int64_t operations = 10000;
+  int threads = 1;
+  std::string distribution = "zipfian";
+  size_t buffer_pool_pages = DEFAULT_BUFFER_POOL_SIZE;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--layer=", 8) == 0) {
+      layer = argv[i] + 8;
+    } else if (strncmp(argv[i], "--workloads=", 12) == 0) {
+      workload_names = argv[i] + 12;
+    } else if (strncmp(argv[i], "--records=", 10) == 0) {
+      records = atoi(argv[i] + 10);
+    } else if (strncmp(argv[i], "--operations=", 13) == 0) {
+      operations = atoll(argv[i] + 13);
+    } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+      threads = std::max(1, atoi(argv[i] + 10));
+    } else if (strncmp(argv[i], "--distribution=", 15) == 0) {
+      distribution = argv[i] + 15;
+    } else if (strncmp(argv[i], "--buffer_pool_pages=", 20) == 0) {
+      buffer_pool_pages = strtoul(argv[i] + 20, nullptr, 10);
+    } else {
+      fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if ((layer != "heap" && layer != "index" && layer != "engine") ||
+      (distribution != "zipfian" && distribution != "uniform") || records < 2) {
+    fprintf(stderr, "usage: %s [--layer=heap|index|engine] [--workloads=ABCDEF] [--records=N] [--operations=N] "
+                    "[--threads=N] [--distribution=zipfian|uniform] [--buffer_pool_pages=N]\n", argv[0]);
+    return 1;
+  }
+
+  mkdir("./databases", 0777);
+  BufferPool buffer_pool(buffer_pool_pages);
+  std::unique_ptr<Store> store;
+  // Every operation of every workload may be an insert, the keys it takes are reserved up front.
+  size_t max_keys = records + operations * workload_names.size();
+  if (layer == "engine") {
+    store = std::make_unique<EngineStore>(buffer_pool_pages);
+  } else {
+    store = std::make_unique<StorageStore>(&buffer_pool, layer == "index", max_keys);
+  }
+  auto start = std::chrono::steady_clock::now();
+  store->Load(records);
+  double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  fprintf(stderr, "loaded %d records in %.2f s\n", records, load_seconds);
+
+  ZipfianGenerator zipfian(records);
+  std::atomic<int64_t> next_key{records};
+  KeyCounter inserted(records, max_keys);
+  for (char name : workload_names) {
+    const Workload *workload = nullptr;
+    for (const auto &w : workloads) {
+      if (w.name_ == name) {
+        workload = &w;
+      }
+    }
+    if (workload == nullptr) {
+      fprintf(stderr, "unknown workload %c\n", name);
+      return 1;
+    }
+    WorkloadResult result;
+    auto run_thread = [&](int thread_id, int64_t count) {
+      auto client = store->NewClient();
+      std::mt19937_64 rng(thread_id * 131 + name);
+      std::uniform_real_distribution<double> pick(0, 1);
+      for (int64_t i = 0; i < count; i++) {
+        int64_t key_count = inserted.Get();
+        int64_t key;
+        if (workload->latest_) {
+          key = std::max<int64_t>(0, key_count - 1 - static_cast<int64_t>(zipfian.Next(rng)));
+        } else if (distribution == "zipfian") {
+          key = Scramble(zipfian.Next(rng)) % records;
+        } else {
+          key = std::uniform_int_distribution<int64_t>(0, key_count - 1)(rng);
+        }
+        double p = pick(rng);
+        int type = 0;
+        while (type + 1 < kOperationTypes && p >= workload->proportions_[type]) {
+          p -= workload->proportions_[type];
+          type++;
+        }
+        uint64_t seed = rng();
+        auto op_start = std::chrono::steady_clock::now();
+        bool success = true;
+        switch (type) {
+          case kRead:
+            success = client->Read(key);
+            break;
+          case kUpdate:
+            success = client->Update(key, seed);
+            break;
+          case kInsert:
+            key = next_key.fetch_add(1);
+            success = client->Insert(key, seed);
+            inserted.Done(key);
+            break;
+          case kScan:
+            success = client->Scan(key, std::uniform_int_distribution<int>(1, MAX_SCAN_LENGTH)(rng));
+            break;
+          default:
+            success = client->Read(key) && client->Update(key, seed);
+            break;
+        }
+        auto latency = std::chrono::steady_clock::now() - op_start;
+        result.all_.Record(latency);
+        result.operations_[type].Record(latency);
+        if (!success) {
+          result.errors_++;
+        }
+      }
+    };
+    start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back(run_thread, t, operations / threads + (t < operations % threads ? 1 : 0));
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream json;
+    json << "{\"workload\":\"" << name << "\",\"layer\":\"" << layer << "\",\"distribution\":\""
+         << (workload->latest_ ? "latest" : distribution) << "\",\"records\":" << records
+         << ",\"operations\":" << operations << ",\"threads\":" << threads
+         << ",\"buffer_pool_pages\":" << buffer_pool_pages << ",\"seconds\":" << seconds
+         << ",\"ops_per_sec\":" << operations / seconds << ",\"errors\":" << result.errors_ << ",\"latency_us\":";
+    WriteLatency(json, result.all_);
+    for (int type = 0; type < kOperationTypes; type++) {
+      if (result.operations_[type].GetCount() > 0) {
+        json << ",\"" << operation_names[type] << "\":";
+        WriteLatency(json, result.operations_[type]);
+      }
+    }
+    json << "}";
+    printf("%s\n", json.str().c_str());
+    fflush(stdout);
+  }
+  return 0;
+}
@@ -0,0 +1,354 @@
+#include "buffer/buffer_pool.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+
+thread_local BufferAccessStrategy *BufferAccessStrategy::current_ = nullptr;
+
+BufferPool::BufferPool(size_t pool_size)
+    : pool_size_(pool_size), frame_files_(pool_size, 0), frame_ticks_(pool_size, 0), frame_in_io_(pool_size, false) {
+    pages_ = new Page[pool_size_];
+    replacer_ = new LRUReplacer(pool_size_);
+    for (size_t i = 0; i < pool_size_; i++) {
+        free_list_.emplace_back(i);
+    }
+}
+
+BufferPool::~BufferPool() {
+    // The files still registered get their pages written back, a page still pinned may not be marked dirty yet.
+    for (auto &page : page_table_) {
+        auto frame = &pages_[page.second];
+        if (frame->is_dirty_ || frame->pin_count_ > 0) {
+            files_[frame_files_[page.second]]->WritePage(frame->page_id_, frame->data_);
+        }
+    }
+    delete[] pages_;
+    delete replacer_;
+}
+
+size_t BufferPool::GetFileCount() {
+    lock_guard<recursive_mutex> guard(latch_);
+    return files_.size();
+}
+
+size_t BufferPool::GetPageCount() {
+    lock_guard<recursive_mutex> guard(latch_);
+    return page_table_.size() - evicting_;
+}
+
+BufferPoolStats &BufferPool::GetThreadStats() {
+    thread_local BufferPoolStats stats;
+    return stats;
+}
+
+uint32_t BufferPool::RegisterFile(DiskManager *disk_manager) {
+    lock_guard<recursive_mutex> guard(latch_);
+    uint32_t file_id = next_file_id_++;
+    files_.emplace(file_id, disk_manager);
+    return file_id;
+}
+
+void BufferPool::UnregisterFile(uint32_t file_id) {
+    unique_lock<recursive_mutex> guard(latch_);
+    // Fetches of other files may be writing back a page of the file, they use its disk manager.
+    io_done_.wait(guard, [&]() {
+        return none_of(page_table_.begin(), page_table_.end(), [&](const pair<const PageKey, frame_id_t> &entry) {
+            return static_cast<uint32_t>(entry.first >> 32) == file_id && frame_in_io_[entry.second];
+        });
+    });
+    auto disk_manager = files_[file_id];
+    for (auto iter = page_table_.begin(); iter != page_table_.end();) {
+        frame_id_t frame_id = iter->second;
+        if (frame_files_[frame_id] != file_id) {
+            ++iter;
+            continue;
+        }
+        // Pages left pinned by the owner of the file are dropped as well, nobody else can refer to them.
+        auto page = &pages_[frame_id];
+        if (page->is_dirty_ || page->pin_count_ > 0) {
+            disk_manager->WritePage(page->page_id_, page->data_);
+        }
+        replacer_->Pin(frame_id);
+        page->page_id_ = INVALID_PAGE_ID;
+        page->pin_count_ = 0;
+        page->is_dirty_ = false;
+        free_list_.push_back(frame_id);
+        iter = page_table_.erase(iter);
+    }
+    files_.erase(file_id);
+}
+
+Page *BufferPool::FetchPage(uint32_t file_id, page_id_t page_id) {
+    // 1.     Search the page table for the requested page (P).
+    // 1.1    If P exists, pin it and return it immediately.
+    // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
+    //        Note that pages are always found from the free list first.
+    // 2.     If R is dirty, write it back to the disk of its file.
+    // 3.     Delete R from the page table and insert P.
+    // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
+    if (page_id == INVALID_PAGE_ID) {
+        return nullptr;
+    }
+    unique_lock<recursive_mutex> guard(latch_);
+    counters_.fetches_.fetch_add(1, memory_order_relaxed);
+    auto iter = FindPage(guard, MakeKey(file_id, page_id));
+    if (iter != page_table_.end()) {
+        frame_id_t frame_id = iter->second;
+        if (pages_[frame_id].pin_count_++ == 0) {
+            replacer_->Pin(frame_id);
+        }
+        frame_ticks_[frame_id] = ++tick_;
+        counters_.hits_.fetch_add(1, memory_order_relaxed);
+        GetThreadStats().hits_++;
+        return &pages_[frame_id];
+    }
+    counters_.misses_.fetch_add(1, memory_order_relaxed);
+    GetThreadStats().misses_++;
+    auto strategy = BufferAccessStrategy::GetCurrent();
+    frame_id_t frame_id = strategy != nullptr ? TryToFindRingPage(strategy, MakeKey(file_id, page_id))
+                                              : TryToFindFreePage();
+    if (frame_id == INVALID_FRAME_ID || !LoadFrame(guard, frame_id, file_id, page_id, true)) {
+        return nullptr;
+    }
+    GetThreadStats().pages_read_++;
+    frame_ticks_[frame_id] = ++tick_;
+    replacer_->Pin(frame_id);
+    return &pages_[frame_id];
+}
+
+Page *BufferPool::NewPage(uint32_t file_id, page_id_t &page_id, bool in_run, page_id_t last_page_id) {
+    // 1.   If all the pages in the buffer pool are pinned, return nullptr.
+    // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
+    // 3.   Allocate a page of the file, update P's metadata, zero out memory and add P to the page table.
+    // 4.   Set the page ID output parameter. Return a pointer to P.
+    page_id = INVALID_PAGE_ID;
+    unique_lock<recursive_mutex> guard(latch_);
+    frame_id_t frame_id = TryToFindFreePage();
+    if (frame_id == INVALID_FRAME_ID) {
+        return nullptr;
+    }
+    page_id = in_run ? files_[file_id]->AllocatePageNear(last_page_id) : files_[file_id]->AllocatePage();
+    if (page_id == INVALID_PAGE_ID) {
+        // A victim stays cached.
+        if (pages_[frame_id].page_id_ != INVALID_PAGE_ID) {
+            replacer_->Unpin(frame_id);
+        } else {
+            free_list_.push_back(frame_id);
+        }
+        return nullptr;
+    }
+    ASSERT(page_id < MAX_VALID_PAGE_ID, "INVALID PAGE ID.");
+    LoadFrame(guard, frame_id, file_id, page_id, false);
+    frame_ticks_[frame_id] = ++tick_;
+    replacer_->Pin(frame_id);
+    return &pages_[frame_id];
+}
+
+bool BufferPool::DeletePage(uint32_t file_id, page_id_t page_id) {
+    // 1.   Search the page table for the requested page (P).
+    // 1.   If P does not exist, return true.
+    // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
+    // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
+    // 4.   Deallocate the page in the file.
+    unique_lock<recursive_mutex> guard(latch_);
+    auto iter = FindPage(guard, MakeKey(file_id, page_id));
+    if (iter != page_table_.end()) {
+        frame_id_t frame_id = iter->second;
+        auto page = &pages_[frame_id];
+        if (page->pin_count_ > 0) {
+            return false;
+        }
+        // Take the frame out of the replacer, it goes back to the free list.
+        replacer_->Pin(frame_id);
+        page_table_.erase(iter);
+        page->page_id_ = INVALID_PAGE_ID;
+        page->is_dirty_ = false;
+        free_list_.push_back(frame_id);
+    }
+    files_[file_id]->DeAllocatePage(page_id);
+    return true;
+}
+
+bool BufferPool::UnpinPage(uint32_t file_id, page_id_t page_id, bool is_dirty) {
+    lock_guard<recursive_mutex> guard(latch_);
+    auto iter = page_table_.find(MakeKey(file_id, page_id));
+    if (iter == page_table_.end()) {
+        return false;
+    }
+    frame_id_t frame_id = iter->second;
+    auto page = &pages_[frame_id];
+    if (page->pin_count_ <= 0) {
+        return false;
+    }
+    page->is_dirty_ |= is_dirty;
+    if (--page->pin_count_ == 0) {
+        replacer_->Unpin(frame_id);
+    }
+    return true;
+}
+
+bool BufferPool::FlushPage(uint32_t file_id, page_id_t page_id) {
+    unique_lock<recursive_mutex> guard(latch_);
+    auto iter = FindPage(guard, MakeKey(file_id, page_id));
+    if (iter == page_table_.end()) {
+        return false;
+    }
+    auto page = &pages_[iter->second];
+    files_[file_id]->WritePage(page_id, page->data_);
+    counters_.flushes_.fetch_add(1, memory_order_relaxed);
+    GetThreadStats().pages_written_++;
+    page->is_dirty_ = false;
+    return true;
+}
+
+vector<page_id_t> BufferPool::GetHotPages(uint32_t file_id) {
+    vector<pair<uint64_t, page_id_t>> pages;
+    {
+        lock_guard<recursive_mutex> guard(latch_);
+        for (auto &entry : page_table_) {
+            if (frame_files_[entry.second] == file_id && !frame_in_io_[entry.second]) {
+                pages.emplace_back(frame_ticks_[entry.second], pages_[entry.second].page_id_);
+            }
+        }
+    }
+    sort(pages.begin(), pages.end(), greater<pair<uint64_t, page_id_t>>());
+    vector<page_id_t> page_ids;
+    page_ids.reserve(pages.size());
+    for (auto &page : pages) {
+        page_ids.push_back(page.second);
+    }
+    return page_ids;
+}
+
+bool BufferPool::PrefetchPage(uint32_t file_id, page_id_t page_id) {
+    unique_lock<recursive_mutex> guard(latch_);
+    if (free_list_.empty()) {
+        return false;
+    }
+    // A page freed since it was listed is skipped, it is checked under the latch NewPage allocates under.
+    if (page_table_.count(MakeKey(file_id, page_id)) > 0 || files_[file_id]->IsPageFree(page_id)) {
+        return true;
+    }
+    frame_id_t frame_id = free_list_.front();
+    free_list_.pop_front();
+    // A page which cannot be read is left to the FetchPage which reports it.
+    if (!LoadFrame(guard, frame_id, file_id, page_id, true)) {
+        return true;
+    }
+    counters_.prefetches_.fetch_add(1, memory_order_relaxed);
+    GetThreadStats().pages_read_++;
+    // Prefetched pages rank below every page requested so far.
+    pages_[frame_id].pin_count_ = 0;
+    frame_ticks_[frame_id] = 0;
+    replacer_->Unpin(frame_id);
+    return true;
+}
+
+unordered_map<BufferPool::PageKey, frame_id_t>::iterator BufferPool::FindPage(unique_lock<recursive_mutex> &guard,
+                                                                              PageKey key) {
+    auto iter = page_table_.find(key);
+    while (iter != page_table_.end() && frame_in_io_[iter->second]) {
+        io_done_.wait(guard);
+        iter = page_table_.find(key);
+    }
+    return iter;
+}
+
+bool BufferPool::LoadFrame(unique_lock<recursive_mutex> &guard, frame_id_t frame_id, uint32_t file_id,
+                           page_id_t page_id, bool read) {
+    auto page = &pages_[frame_id];
+    bool evicted = page->page_id_ != INVALID_PAGE_ID;
+    PageKey victim_key = MakeKey(frame_files_[frame_id], page->page_id_);
+    page_id_t victim_page_id = page->page_id_;
+    DiskManager *victim_file = evicted && page->is_dirty_ ? files_[frame_files_[frame_id]] : nullptr;
+    DiskManager *file = files_[file_id];
+    page_table_.emplace(MakeKey(file_id, page_id), frame_id);
+    page->pin_count_ = 1;
+    bool loaded = true;
+    if (read || victim_file != nullptr) {
+        frame_in_io_[frame_id] = true;
+        evicting_ += evicted;
+        guard.unlock();
+        if (victim_file != nullptr) {
+            victim_file->WritePage(victim_page_id, page->data_);
+            counters_.dirty_writebacks_.fetch_add(1, memory_order_relaxed);
+            GetThreadStats().pages_written_++;
+        }
+        if (read) {
+            loaded = file->ReadPage(page_id, page->data_);
+        }
+        guard.lock();
+        frame_in_io_[frame_id] = false;
+        evicting_ -= evicted;
+        io_done_.notify_all();
+    }
+    if (evicted) {
+        page_table_.erase(victim_key);
+    }
+    page->is_dirty_ = false;
+    if (!loaded) {
+        page_table_.erase(MakeKey(file_id, page_id));
+        page->page_id_ = INVALID_PAGE_ID;
+        page->pin_count_ = 0;
+        free_list_.push_back(frame_id);
+        return false;
+    }
+    if (!read) {
+        page->ResetMemory();
+    }
+    frame_files_[frame_id] = file_id;
+    page->page_id_ = page_id;
+    return true;
+}
+
+frame_id_t BufferPool::TryToFindFreePage() {
+    if (!free_list_.empty()) {
+        frame_id_t frame_id = free_list_.front();
+        free_list_.pop_front();
+        return frame_id;
+    }
+    frame_id_t frame_id;
+    if (!replacer_->Victim(&frame_id)) {
+        return INVALID_FRAME_ID;
+    }
+    counters_.evictions_.fetch_add(1, memory_order_relaxed);
+    return frame_id;
+}
+
+frame_id_t BufferPool::TryToFindRingPage(BufferAccessStrategy *strategy, PageKey key) {
+    if (strategy->buffer_pool_ == nullptr) {
+        strategy->buffer_pool_ = this;
+    }
+    // From the first miss on, so the pages of a scan never push out more of the pool than the ring.
+    if (strategy->buffer_pool_ != this) {
+        return TryToFindFreePage();
+    }
+    size_t ring_size = std::min(strategy->ring_frames_.size(), std::max<size_t>(pool_size_ / 8, 1));
+    size_t slot = strategy->next_++ % ring_size;
+    frame_id_t frame_id = strategy->ring_frames_[slot];
+    auto iter = frame_id == INVALID_FRAME_ID ? page_table_.end() : page_table_.find(strategy->ring_keys_[slot]);
+    if (iter != page_table_.end() && iter->second == frame_id && pages_[frame_id].pin_count_ == 0) {
+        replacer_->Pin(frame_id);
+        counters_.ring_reuses_.fetch_add(1, memory_order_relaxed);
+    } else {
+        frame_id = TryToFindFreePage();
+    }
+    strategy->ring_frames_[slot] = frame_id;
+    strategy->ring_keys_[slot] = key;
+    return frame_id;
+}
+
+// Only used for debug
+bool BufferPool::CheckAllUnpinned(uint32_t file_id) {
+    lock_guard<recursive_mutex> guard(latch_);
+    bool res = true;
+    for (auto &page : page_table_) {
+        auto frame = &pages_[page.second];
+        if (frame_files_[page.second] == file_id && frame->pin_count_ != 0) {
+            res = false;
+            LOG(ERROR) << "page " << frame->page_id_ << " pin count:" << frame->pin_count_ << endl;
+        }
+    }
+    return res;
+}
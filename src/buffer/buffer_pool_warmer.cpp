@@ -0,0 +1,108 @@
+#include "buffer/buffer_pool_warmer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "glog/logging.h"
+
+static const char *MANIFEST_HEADER = "minisql-hot-pages 1";
+
+BufferPoolWarmer::BufferPoolWarmer(BufferPoolManager *bpm, std::string manifest_path, bool warm_up,
+                                   std::chrono::milliseconds save_interval)
+    : bpm_(bpm), manifest_path_(std::move(manifest_path)), save_interval_(save_interval), warming_(warm_up) {
+  thread_ = std::thread(&BufferPoolWarmer::Run, this, warm_up);
+}
+
+BufferPoolWarmer::~BufferPoolWarmer() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  if (!SaveManifest()) {
+    LOG(WARNING) << "failed to write hot pages to " << manifest_path_;
+  }
+}
+
+bool BufferPoolWarmer::SaveManifest() {
+  std::vector<page_id_t> page_ids = bpm_->GetHotPages();
+  std::string tmp_path = manifest_path_ + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    out << MANIFEST_HEADER << "\n";
+    for (page_id_t page_id : page_ids) {
+      out << page_id << "\n";
+    }
+    if (!out) {
+      return false;
+    }
+  }
+  return rename(tmp_path.c_str(), manifest_path_.c_str()) == 0;
+}
+
+bool BufferPoolWarmer::ReadManifest(const std::string &path, std::vector<page_id_t> *page_ids) {
+  std::ifstream in(path);
+  std::string header;
+  if (!in || !std::getline(in, header) || header != MANIFEST_HEADER) {
+    return false;
+  }
+  page_ids->clear();
+  page_id_t page_id;
+  while (in >> page_id) {
+    page_ids->push_back(page_id);
+  }
+  return in.eof();
+}
+
+void BufferPoolWarmer::WaitForWarmUp() {
+  std::unique_lock<std::mutex> lock(latch_);
+  cv_.wait(lock, [this] { return !warming_; });
+}
+
+void BufferPoolWarmer::WarmUp() {
+  std::vector<page_id_t> page_ids;
+  if (!ReadManifest(manifest_path_, &page_ids)) {
+    return;
+  }
+  // The hottest pages which fit are read, in the order of the file so the reads are sequential.
+  page_ids.resize(std::min(page_ids.size(), bpm_->GetFreeFrameCount()));
+  std::sort(page_ids.begin(), page_ids.end());
+  for (page_id_t page_id : page_ids) {
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      if (stop_) {
+        return;
+      }
+    }
+    if (page_id < 0) {
+      continue;
+    }
+    if (!bpm_->PrefetchPage(page_id)) {
+      return;
+    }
+    pages_warmed_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void BufferPoolWarmer::Run(bool warm_up) {
+  if (warm_up) {
+    WarmUp();
+    std::lock_guard<std::mutex> guard(latch_);
+    warming_ = false;
+    cv_.notify_all();
+  }
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!cv_.wait_for(lock, save_interval_, [this] { return stop_; })) {
+    lock.unlock();
+    if (!SaveManifest()) {
+      LOG(WARNING) << "failed to write hot pages to " << manifest_path_;
+    }
+    lock.lock();
+  }
+}
@@ -1,8 +1,9 @@
 #include "../include/catalog/catalog.h"
 
+#include <unordered_set>
+
 
 void CatalogMeta::SerializeTo(char *buf) const {
-    ASSERT(GetSerializedSize() <= PAGE_SIZE, "Failed to serialize catalog metadata to disk.");
     MACH_WRITE_UINT32(buf, CATALOG_METADATA_MAGIC_NUM);
     buf += 4;
     MACH_WRITE_UINT32(buf, table_meta_pages_.size());
@@ -14,12 +15,27 @@ void CatalogMeta::SerializeTo(char *buf) const {
         buf += 4;
         MACH_WRITE_TO(page_id_t, buf, iter.second);
         buf += 4;
+        auto name = table_names_.find(iter.first);
+        std::string table_name = name == table_names_.end() ? "" : name->second;
+        MACH_WRITE_UINT32(buf, table_name.length());
+        buf += 4;
+        MACH_WRITE_STRING(buf, table_name);
+        buf += table_name.length();
     }
     for (auto iter : index_meta_pages_) {
         MACH_WRITE_TO(index_id_t, buf, iter.first);
         buf += 4;
         MACH_WRITE_TO(page_id_t, buf, iter.second);
         buf += 4;
+        auto name = index_names_.find(iter.first);
+        table_id_t table_id = name == index_names_.end() ? 0 : name->second.first;
+        std::string index_name = name == index_names_.end() ? "" : name->second.second;
+        MACH_WRITE_TO(table_id_t, buf, table_id);
+        buf += 4;
+        MACH_WRITE_UINT32(buf, index_name.length());
+        buf += 4;
+        MACH_WRITE_STRING(buf, index_name);
+        buf += index_name.length();
     }
 }
 
@@ -27,7 +43,9 @@ CatalogMeta *CatalogMeta::DeserializeFrom(char *buf) {
     // check valid
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == CATALOG_METADATA_MAGIC_NUM, "Failed to deserialize catalog metadata from disk.");
+    ASSERT(magic_num == CATALOG_METADATA_MAGIC_NUM || magic_num == CATALOG_METADATA_SINGLE_PAGE_MAGIC_NUM,
+           "Failed to deserialize catalog metadata from disk.");
+    bool has_names = magic_num == CATALOG_METADATA_MAGIC_NUM;
     // get table and index nums
     uint32_t table_nums = MACH_READ_UINT32(buf);
     buf += 4;
@@ -41,6 +59,12 @@ CatalogMeta *CatalogMeta::DeserializeFrom(char *buf) {
         auto table_heap_page_id = MACH_READ_FROM(page_id_t, buf);
         buf += 4;
         meta->table_meta_pages_.emplace(table_id, table_heap_page_id);
+        if (has_names) {
+            uint32_t len = MACH_READ_UINT32(buf);
+            buf += 4;
+            meta->table_names_.emplace(table_id, std::string(buf, len));
+            buf += len;
+        }
     }
     for (uint32_t i = 0; i < index_nums; i++) {
         auto index_id = MACH_READ_FROM(index_id_t, buf);
@@ -48,6 +72,14 @@ CatalogMeta *CatalogMeta::DeserializeFrom(char *buf) {
         auto index_page_id = MACH_READ_FROM(page_id_t, buf);
         buf += 4;
         meta->index_meta_pages_.emplace(index_id, index_page_id);
+        if (has_names) {
+            auto table_id = MACH_READ_FROM(table_id_t, buf);
+            buf += 4;
+            uint32_t len = MACH_READ_UINT32(buf);
+            buf += 4;
+            meta->index_names_.emplace(index_id, std::make_pair(table_id, std::string(buf, len)));
+            buf += len;
+        }
     }
     return meta;
 }
@@ -64,6 +96,8 @@ uint32_t CatalogMeta::GetSerializedSize() const {
     for (const auto& entry : table_meta_pages_) {
         size += sizeof(table_id_t);
         size += sizeof(page_id_t);
+        auto name = table_names_.find(entry.first);
+        size += sizeof(uint32_t) + (name == table_names_.end() ? 0 : name->second.length());
     }
 
     // Add the size of index meta pages
@@ -71,6 +105,9 @@ uint32_t CatalogMeta::GetSerializedSize() const {
     for (const auto& entry : index_meta_pages_) {
         size += sizeof(index_id_t);
         size += sizeof(page_id_t);
+        size += sizeof(table_id_t);
+        auto name = index_names_.find(entry.first);
+        size += sizeof(uint32_t) + (name == index_names_.end() ? 0 : name->second.second.length());
     }
 
     return size;
@@ -83,71 +120,36 @@ CatalogMeta::CatalogMeta() {}
  * TODO: Student Implement
  */
 CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
-                               LogManager *log_manager, bool init)
+                               LogManager *log_manager, bool init, VersionStore *version_store)
         : buffer_pool_manager_(buffer_pool_manager),
           lock_manager_(lock_manager),
           log_manager_(log_manager),
+          version_store_(version_store),
           catalog_meta_(nullptr),
           next_table_id_(0),
           next_index_id_(0) {
     if (init) {
-
         catalog_meta_ = CatalogMeta::NewInstance();
-    } else {
-
-        Page *meta_page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-        catalog_meta_ = CatalogMeta::DeserializeFrom(meta_page->GetData());
-
-        for (auto it : *catalog_meta_->GetTableMetaPages()) {
-            page_id_t table_meta_page_id = it.second;
-            Page *table_meta_page = buffer_pool_manager_->FetchPage(table_meta_page_id);
-            char *table_meta_page_data = table_meta_page->GetData();
-
-            TableMetadata *table_meta;
-            TableMetadata::DeserializeFrom(table_meta_page_data, table_meta);
-            TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_meta->GetFirstPageId(), table_meta->GetSchema(),
-                                                      log_manager_, lock_manager_);
-
-            table_names_[table_meta->GetTableName()] = table_meta->GetTableId();
-
-            TableInfo *table_info = TableInfo::Create();
-            table_info->Init(table_meta, table_heap);
-
-            // Store table info
-            tables_[table_meta->GetTableId()] = table_info;
-
-            // Unpin table meta page
-            buffer_pool_manager_->UnpinPage(table_meta_page_id, false);
+        FlushCatalogMetaPage();
+        return;
+    }
+    if (ReadCatalogMetaPages() != DB_SUCCESS) {
+        // The destructor does not run, nothing is written over the meta data which could not be read.
+        delete catalog_meta_;
+        throw std::logic_error("Failed to read the catalog meta data.");
+    }
+    // Only the names are read, tables and indexes are loaded on first use.
+    for (auto &it : catalog_meta_->table_names_) {
+        table_names_[it.second] = it.first;
+    }
+    for (auto &it : catalog_meta_->index_names_) {
+        auto table_name = catalog_meta_->table_names_.find(it.second.first);
+        if (table_name != catalog_meta_->table_names_.end()) {
+            index_names_[table_name->second][it.second.second] = it.first;
         }
-
-        for (auto it : *catalog_meta_->GetIndexMetaPages()) {
-            page_id_t index_meta_page_id = it.second;
-
-            Page *index_meta_page = buffer_pool_manager_->FetchPage(index_meta_page_id);
-            char *index_meta_page_data = index_meta_page->GetData();
-            IndexMetadata *index_meta;
-
-            IndexMetadata::DeserializeFrom(index_meta_page_data, index_meta);
-
-            std::string table_name = tables_[index_meta->GetTableId()]->GetTableName();
-            std::string index_name = index_meta->GetIndexName();
-
-            index_names_[table_name][index_name] = index_meta->GetIndexId();
-
-            IndexInfo *index_info = IndexInfo::Create();
-            index_info->Init(index_meta, tables_[index_meta->GetTableId()], buffer_pool_manager_);
-
-            indexes_[index_meta->GetIndexId()] = index_info;
-
-            buffer_pool_manager_->UnpinPage(index_meta_page_id, false);
-        }
-
-//        next_table_id_.store(catalog_meta_->GetNextTableId() + 1);
-//        next_index_id_.store(catalog_meta_->GetNextIndexId() + 1);
-
-
-        buffer_pool_manager_->UnpinPage(CATALOG_META_PAGE_ID, false);
     }
+    next_table_id_.store(catalog_meta_->GetNextTableId());
+    next_index_id_.store(catalog_meta_->GetNextIndexId());
 }
 
 
@@ -171,17 +173,26 @@ CatalogManager::~CatalogManager() {
 * TODO: Student Implement
 */
 dberr_t CatalogManager::CreateTable(const std::string& table_name, TableSchema* schema, Transaction* txn,
-                                    TableInfo*& table_info) {
+                                    TableInfo*& table_info, TableLayout layout, bool dictionary_encoded) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
     // Check if the table already exists
     if (table_names_.find(table_name) != table_names_.end()) {
         return DB_TABLE_ALREADY_EXIST;
     }
+    if (layout == TableLayout::kColumnar && TablePage::GetColumnarCapacity(schema) == 0) {
+        return DB_FAILED;
+    }
 
-    // Create a new table metadata
+    // Create a new table metadata, which owns a copy of the schema
     page_id_t table_meta_page_id;
     Page* meta_page = buffer_pool_manager_->NewPage(table_meta_page_id);
-    TableHeap* table_heap = TableHeap::Create(buffer_pool_manager_, schema, nullptr, log_manager_, lock_manager_);
-    TableMetadata* table_meta = TableMetadata::Create(next_table_id_, table_name, table_heap->GetFirstPageId(), schema);
+    Schema* table_schema = Schema::DeepCopySchema(schema);
+    TableHeap* table_heap = TableHeap::Create(buffer_pool_manager_, table_schema, nullptr, log_manager_,
+                                              lock_manager_, version_store_, layout, dictionary_encoded);
+    page_id_t dictionary_page_id =
+        table_heap->GetDictionary() == nullptr ? INVALID_PAGE_ID : table_heap->GetDictionary()->GetFirstPageId();
+    TableMetadata* table_meta = TableMetadata::Create(next_table_id_, table_name, table_heap->GetFirstPageId(),
+                                                      table_schema, layout, dictionary_page_id);
 
     table_meta->SerializeTo(meta_page->GetData());
     buffer_pool_manager_->UnpinPage(meta_page->GetPageId(), true);
@@ -194,9 +205,11 @@ dberr_t CatalogManager::CreateTable(const std::string& table_name, TableSchema*
     table_names_[table_name] = next_table_id_;
     tables_[next_table_id_] = table_info;
     catalog_meta_->table_meta_pages_[next_table_id_] = table_meta_page_id;
+    catalog_meta_->table_names_[next_table_id_] = table_name;
 
     // Increment the next table id
     next_table_id_++;
+    version_++;
 
     return DB_SUCCESS;
 }
@@ -209,20 +222,13 @@ dberr_t CatalogManager::CreateTable(const std::string& table_name, TableSchema*
  * TODO: Student Implement
  */
 dberr_t CatalogManager::GetTable(const std::string& table_name, TableInfo*& table_info) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
     // Check if the table name exists in the map
-    if (table_names_.find(table_name) == table_names_.end()) {
+    auto it = table_names_.find(table_name);
+    if (it == table_names_.end()) {
         return DB_TABLE_NOT_EXIST;
     }
-
-    table_id_t table_id = table_names_[table_name];
-
-    if (tables_.find(table_id) == tables_.end()) {
-        return DB_TABLE_NOT_EXIST;
-    }
-
-    table_info = tables_[table_id];
-
-    return DB_SUCCESS;
+    return GetTable(it->second, table_info);
 }
 
 
@@ -231,14 +237,18 @@ dberr_t CatalogManager::GetTable(const std::string& table_name, TableInfo*& tabl
 /**
  * TODO: Student Implement
  */
-dberr_t CatalogManager::GetTables(vector<TableInfo*>& tables) const {
+dberr_t CatalogManager::GetTables(vector<TableInfo*>& tables) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
     tables.clear();
-    if(tables_.empty()) {
+    if(catalog_meta_->table_meta_pages_.empty()) {
         return DB_FAILED;
     }
 
-    for (const auto& entry : tables_) {
-        tables.push_back(entry.second);
+    for (const auto& entry : catalog_meta_->table_meta_pages_) {
+        TableInfo *table_info = nullptr;
+        if (GetTable(entry.first, table_info) == DB_SUCCESS) {
+            tables.push_back(table_info);
+        }
     }
 
     return DB_SUCCESS;
@@ -251,19 +261,20 @@ dberr_t CatalogManager::GetTables(vector<TableInfo*>& tables) const {
 dberr_t CatalogManager::CreateIndex(const string &table_name, const string &index_name, const vector<std::string> &index_keys,
                                     Transaction *txn,
                                     IndexInfo *&index_info, const string &index_type) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
 
     TableInfo *table_info;
     dberr_t result = GetTable(table_name, table_info);
     if (result != DB_SUCCESS) {
         return result;
     }
-    if(table_names_.count(table_name) <= 0 ) {
-        return DB_TABLE_NOT_EXIST;
-    }
 
     if (index_names_.count(table_name) > 0 && index_names_[table_name].count(index_name) > 0) {
         return DB_INDEX_ALREADY_EXIST;
     }
+    if (!IndexInfo::IsIndexType(index_type)) {
+        return DB_FAILED;
+    }
 
     std::vector<uint32_t> key_map;
     for (const auto &key : index_keys) {
@@ -275,44 +286,31 @@ dberr_t CatalogManager::CreateIndex(const string &table_name, const string &inde
         key_map.push_back(column_index);
     }
 
-    page_id_t page_id;
-
-    Page* index_meta_page = buffer_pool_manager_->NewPage(page_id);
-    catalog_meta_->index_meta_pages_[catalog_meta_->GetNextIndexId()] = page_id;
-    buffer_pool_manager_->UnpinPage(page_id, true);
-
-    IndexMetadata *index_meta = IndexMetadata::Create(next_index_id_, index_name, table_info->GetTableId(), key_map);
+    IndexMetadata *index_meta =
+        IndexMetadata::Create(next_index_id_, index_name, table_info->GetTableId(), key_map, index_type);
     if (index_meta == nullptr) {
         return DB_FAILED;
     }
 
-    index_meta->SerializeTo(index_meta_page->GetData());
-
-    IndexSchema *index_schema = Schema::ShallowCopySchema(table_info->GetSchema(), key_map);
-    if (index_schema == nullptr) {
+    page_id_t page_id;
+    Page* index_meta_page = buffer_pool_manager_->NewPage(page_id);
+    if (index_meta_page == nullptr) {
         delete index_meta;
         return DB_FAILED;
     }
+    index_meta->SerializeTo(index_meta_page->GetData());
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    catalog_meta_->index_meta_pages_[next_index_id_] = page_id;
+    catalog_meta_->index_names_[next_index_id_] = std::make_pair(table_info->GetTableId(), index_name);
 
     index_info = IndexInfo::Create();
-    if (index_info == nullptr) {
-        delete index_meta;
-        delete index_schema;
-        return DB_FAILED;
-    }
-
     index_info->Init(index_meta, table_info, buffer_pool_manager_);
-//    string index_type = "type";
-//    Index *index = index_info->CreateIndex(buffer_pool_manager_, index_type);
-//    if (index == nullptr) {
-//        delete index_info;
-//        return DB_FAILED;
-//    }
-
+    table_info->GetTableHeap()->AttachIndex(index_info->GetIndex());
 
     next_index_id_++;
     index_names_[table_name][index_name] = index_meta->GetIndexId();
     indexes_[index_meta->GetIndexId()] = index_info;
+    version_++;
 
     return DB_SUCCESS;
 }
@@ -323,7 +321,8 @@ dberr_t CatalogManager::CreateIndex(const string &table_name, const string &inde
  * TODO: Student Implement
  */
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
-                                 IndexInfo *&index_info) const {
+                                 IndexInfo *&index_info) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
     auto table_it = table_names_.find(table_name);
     if (table_it == table_names_.end()) {
         return DB_TABLE_NOT_EXIST;
@@ -339,29 +338,20 @@ dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::strin
         return DB_INDEX_NOT_FOUND;
     }
 
-    index_id_t index_id = index_id_it->second;
-    auto index_info_it = indexes_.find(index_id);
-    if (index_info_it == indexes_.end()) {
-        return DB_INDEX_NOT_FOUND;
-    }
-
-    index_info = index_info_it->second;
-    return DB_SUCCESS;
+    return GetIndex(index_id_it->second, index_info);
 }
 
 
 /**
  * TODO: Student Implement
  */
-dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const {
+dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
     // Check if the table exists
     if (table_names_.find(table_name) == table_names_.end()) {
         return DB_TABLE_NOT_EXIST;
     }
 
-    table_id_t table_id = table_names_.at(table_name);
-    TableInfo* table_info = tables_.at(table_id);
-
     auto index_entries = index_names_.find(table_name);
     if (index_entries == index_names_.end()) {
         // No indexes found for the table
@@ -369,18 +359,11 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
     }
 
     for (const auto &index_entry : index_entries->second) {
-        const std::string &index_name = index_entry.first;
-        index_id_t index_id = index_entry.second;
-
-        auto index_meta_entry = indexes_.find(index_id);
-        if (index_meta_entry == indexes_.end()) {
+        IndexInfo *index_info = nullptr;
+        if (GetIndex(index_entry.second, index_info) != DB_SUCCESS) {
             return DB_INDEX_NOT_FOUND;
         }
-        IndexMetadata *index_meta = index_meta_entry->second->meta_data_;
-
-        IndexInfo *index_info = IndexInfo::Create();
-        index_info->Init(index_meta, table_info, buffer_pool_manager_);
-
+        // Hand out the catalog's own index info, write sets of running transactions keep pointers to its index.
         indexes.push_back(index_info);
     }
 
@@ -391,6 +374,7 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
  * TODO: Student Implement
  */
 dberr_t CatalogManager::DropTable(const std::string &table_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
 
     if (table_names_.find(table_name) == table_names_.end()) {
         return DB_TABLE_NOT_EXIST;
@@ -398,14 +382,19 @@ dberr_t CatalogManager::DropTable(const std::string &table_name) {
 
     table_id_t table_id = table_names_[table_name];
 
-    std::vector<IndexInfo *> indexes;
-    GetTableIndexes(table_name, indexes);
-    for (auto index_info : indexes) {
-        DropIndex(table_name, index_info->GetIndexName());
+    if (index_names_.count(table_name) > 0) {
+        std::vector<std::string> index_names;
+        for (auto &index : index_names_[table_name]) {
+            index_names.push_back(index.first);
+        }
+        for (auto &index_name : index_names) {
+            DropIndex(table_name, index_name);
+        }
+        index_names_.erase(table_name);
     }
 
     // Delete the table metadata page
-    if (tables_.find(table_id) == tables_.end()) {
+    if (!catalog_meta_->DeleteTableMetaPage(buffer_pool_manager_, table_id)) {
         return DB_TABLE_NOT_EXIST;
     }
 
@@ -413,10 +402,8 @@ dberr_t CatalogManager::DropTable(const std::string &table_name) {
 
     table_names_.erase(table_name);
 
-    page_id_t page_id = catalog_meta_->table_meta_pages_[table_id];
-    buffer_pool_manager_->DeletePage((page_id));
-
     FlushCatalogMetaPage();
+    version_++;
 
     return DB_SUCCESS;
 }
@@ -426,6 +413,7 @@ dberr_t CatalogManager::DropTable(const std::string &table_name) {
  * TODO: Student Implement
  */
 dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_name) {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
 
     if (table_names_.find(table_name) == table_names_.end()) {
         return DB_TABLE_NOT_EXIST;
@@ -438,7 +426,12 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
 
 
     index_id_t index_id = index_names_[table_name][index_name];
-
+    // the pages of the index go with it, an index not used since the database was opened is loaded to find them
+    IndexInfo *index_info = nullptr;
+    if (GetIndex(index_id, index_info) == DB_SUCCESS && index_info->GetIndex() != nullptr) {
+        index_info->GetTableInfo()->GetTableHeap()->DetachIndex(index_info->GetIndex());
+        index_info->GetIndex()->Destroy();
+    }
 
     if (!catalog_meta_->DeleteIndexMetaPage(buffer_pool_manager_, index_id)) {
         return DB_FAILED;
@@ -446,46 +439,135 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
 
     index_names_[table_name].erase(index_name);
 
-    page_id_t  page_id = catalog_meta_->index_meta_pages_[index_id];
-    buffer_pool_manager_->DeletePage(page_id);
-
     indexes_.erase(index_id);
+    version_++;
 
     return DB_SUCCESS;
 }
 
+size_t CatalogManager::GetLoadedTableCount() {
+    std::lock_guard<std::recursive_mutex> guard(latch_);
+    return tables_.size();
+}
+
 /**
- * TODO: Student Implement
+ * The catalog meta data starts on the catalog meta page and overflows to a chain of pages, each page begins
+ * with the id of the next one.
  */
-dberr_t CatalogManager::FlushCatalogMetaPage() const {
+dberr_t CatalogManager::FlushCatalogMetaPage() {
 
     uint32_t serialized_size = catalog_meta_->GetSerializedSize();
+    size_t page_count = (serialized_size + CATALOG_META_PAGE_PAYLOAD - 1) / CATALOG_META_PAGE_PAYLOAD;
 
-    char *buffer = new char[serialized_size];
+    char *buffer = new char[page_count * CATALOG_META_PAGE_PAYLOAD];
 
     catalog_meta_->SerializeTo(buffer);
 
-    Page *page = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
-    if (page == nullptr) {
-        delete[] buffer;
-        return DB_FAILED;
+    // Grow or shrink the chain to fit.
+    while (catalog_meta_pages_.size() + 1 < page_count) {
+        page_id_t page_id;
+        if (buffer_pool_manager_->NewPage(page_id) == nullptr) {
+            delete[] buffer;
+            return DB_FAILED;
+        }
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        catalog_meta_pages_.push_back(page_id);
+    }
+    while (catalog_meta_pages_.size() + 1 > page_count) {
+        buffer_pool_manager_->DeletePage(catalog_meta_pages_.back());
+        catalog_meta_pages_.pop_back();
     }
 
-    memcpy(page->GetData(), buffer, serialized_size);
-
+    for (size_t i = 0; i < page_count; i++) {
+        page_id_t page_id = i == 0 ? CATALOG_META_PAGE_ID : catalog_meta_pages_[i - 1];
+        Page *page = buffer_pool_manager_->FetchPage(page_id);
+        if (page == nullptr) {
+            delete[] buffer;
+            return DB_FAILED;
+        }
+        MACH_WRITE_TO(page_id_t, page->GetData(), i + 1 < page_count ? catalog_meta_pages_[i] : INVALID_PAGE_ID);
+        memcpy(page->GetData() + sizeof(page_id_t), buffer + i * CATALOG_META_PAGE_PAYLOAD, CATALOG_META_PAGE_PAYLOAD);
+        buffer_pool_manager_->UnpinPage(page_id, true);
+        if (!buffer_pool_manager_->FlushPage(page_id)) {
+            delete[] buffer;
+            return DB_FAILED;
+        }
+    }
 
     delete[] buffer;
+    return DB_SUCCESS;
+}
 
-    if(!buffer_pool_manager_->FlushPage(CATALOG_META_PAGE_ID)) {
+/**
+ * A database written before the meta data was chained keeps it on the catalog meta page alone, starting with its
+ * magic number where the chain keeps the next page id. It is read as it is and written in the chain on the next
+ * flush.
+ */
+dberr_t CatalogManager::ReadCatalogMetaPages() {
+    std::vector<char> buffer;
+    std::unordered_set<page_id_t> visited;
+    page_id_t page_id = CATALOG_META_PAGE_ID;
+    while (page_id != INVALID_PAGE_ID) {
+        // A broken chain is not followed around in circles.
+        if (!visited.insert(page_id).second) {
+            return DB_FAILED;
+        }
+        Page *page = buffer_pool_manager_->FetchPage(page_id);
+        if (page == nullptr) {
+            return DB_FAILED;
+        }
+        // A chained first page whose next page happens to be 89849 has the chained magic number after it.
+        if (page_id == CATALOG_META_PAGE_ID &&
+            MACH_READ_UINT32(page->GetData()) == CatalogMeta::CATALOG_METADATA_SINGLE_PAGE_MAGIC_NUM &&
+            MACH_READ_UINT32(page->GetData() + sizeof(page_id_t)) != CatalogMeta::CATALOG_METADATA_MAGIC_NUM) {
+            catalog_meta_ = CatalogMeta::DeserializeFrom(page->GetData());
+            buffer_pool_manager_->UnpinPage(page_id, false);
+            return ReadCatalogNames();
+        }
+        buffer.insert(buffer.end(), page->GetData() + sizeof(page_id_t), page->GetData() + PAGE_SIZE);
+        page_id_t next_page_id = MACH_READ_FROM(page_id_t, page->GetData());
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        if (page_id != CATALOG_META_PAGE_ID) {
+            catalog_meta_pages_.push_back(page_id);
+        }
+        page_id = next_page_id;
+    }
+    if (MACH_READ_UINT32(buffer.data()) != CatalogMeta::CATALOG_METADATA_MAGIC_NUM) {
         return DB_FAILED;
     }
+    catalog_meta_ = CatalogMeta::DeserializeFrom(buffer.data());
+    return DB_SUCCESS;
+}
 
+dberr_t CatalogManager::ReadCatalogNames() {
+    for (auto &it : catalog_meta_->table_meta_pages_) {
+        Page *page = buffer_pool_manager_->FetchPage(it.second);
+        if (page == nullptr) {
+            return DB_FAILED;
+        }
+        TableMetadata *meta_data = nullptr;
+        TableMetadata::DeserializeFrom(page->GetData(), meta_data);
+        buffer_pool_manager_->UnpinPage(it.second, false);
+        catalog_meta_->table_names_[it.first] = meta_data->GetTableName();
+        delete meta_data;
+    }
+    for (auto &it : catalog_meta_->index_meta_pages_) {
+        Page *page = buffer_pool_manager_->FetchPage(it.second);
+        if (page == nullptr) {
+            return DB_FAILED;
+        }
+        IndexMetadata *index_meta = nullptr;
+        IndexMetadata::DeserializeFrom(page->GetData(), index_meta);
+        buffer_pool_manager_->UnpinPage(it.second, false);
+        catalog_meta_->index_names_[it.first] = std::make_pair(index_meta->GetTableId(), index_meta->GetIndexName());
+        delete index_meta;
+    }
     return DB_SUCCESS;
 }
 
 
 /**
- * TODO: Student Implement
+ * Build the TableInfo of a table from its meta page.
  */
 dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t page_id) {
 
@@ -493,32 +575,30 @@ dberr_t CatalogManager::LoadTable(const table_id_t table_id, const page_id_t pag
         return DB_TABLE_ALREADY_EXIST;
     }
 
-    catalog_meta_->table_meta_pages_[table_id] = page_id;
-
     Page *page = buffer_pool_manager_->FetchPage(page_id);
     if (page == nullptr) {
         return DB_NOT_EXIST;
     }
 
-    TableMetadata *meta_data;
-    meta_data->DeserializeFrom(page->GetData(), meta_data);
-    table_names_[meta_data->GetTableName()] = table_id;
+    TableMetadata *meta_data = nullptr;
+    TableMetadata::DeserializeFrom(page->GetData(), meta_data);
+    buffer_pool_manager_->UnpinPage(page_id, false);
 
     TableInfo *table_info = TableInfo::Create();
-    TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, page_id, meta_data->GetSchema(), log_manager_, lock_manager_);
+    TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, meta_data->GetFirstPageId(),
+                                              meta_data->GetSchema(), log_manager_, lock_manager_, version_store_,
+                                              meta_data->GetLayout(), meta_data->GetDictionaryPageId());
 
     table_info->Init(meta_data, table_heap);
 
     tables_.emplace(table_id, table_info);
-
-    catalog_meta_->table_meta_pages_[table_id] = page_id;
     return DB_SUCCESS;
 }
 
 
 
 /**
- * TODO: Student Implement
+ * Build the IndexInfo of an index from its meta page, the table of the index is loaded as well.
  */
 dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t page_id) {
 
@@ -526,31 +606,27 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
         return DB_INDEX_ALREADY_EXIST;
     }
 
-    catalog_meta_->index_meta_pages_[index_id] = page_id;
     Page* meta_page = buffer_pool_manager_->FetchPage(page_id);
-
-
-    IndexMetadata* index_meta;
-    uint32_t result = IndexMetadata::DeserializeFrom(meta_page->GetData(), index_meta);
-    if (result != 0) {
-        buffer_pool_manager_->UnpinPage(page_id, false);
-        return DB_FAILED;
+    if (meta_page == nullptr) {
+        return DB_NOT_EXIST;
     }
 
+    IndexMetadata* index_meta = nullptr;
+    IndexMetadata::DeserializeFrom(meta_page->GetData(), index_meta);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+
     TableInfo* table_info;
-    result = GetTable(index_meta->GetTableId(), table_info);
-    if (result != DB_SUCCESS) {
-        buffer_pool_manager_->UnpinPage(page_id, false);
+    if (GetTable(index_meta->GetTableId(), table_info) != DB_SUCCESS) {
+        delete index_meta;
         return DB_FAILED;
     }
 
     IndexInfo* index_info = IndexInfo::Create();
 
     index_info->Init(index_meta, table_info, buffer_pool_manager_);
-
+    table_info->GetTableHeap()->AttachIndex(index_info->GetIndex());
 
     indexes_[index_id] = index_info;
-    catalog_meta_->index_meta_pages_[index_id] = page_id;
 
     return DB_SUCCESS;
 }
@@ -562,9 +638,35 @@ dberr_t CatalogManager::LoadIndex(const index_id_t index_id, const page_id_t pag
 dberr_t CatalogManager::GetTable(const table_id_t table_id, TableInfo *&table_info) {
     auto it = tables_.find(table_id);
     if (it == tables_.end()) {
-        return DB_TABLE_NOT_EXIST;
+        auto page = catalog_meta_->table_meta_pages_.find(table_id);
+        if (page == catalog_meta_->table_meta_pages_.end()) {
+            return DB_TABLE_NOT_EXIST;
+        }
+        dberr_t result = LoadTable(table_id, page->second);
+        if (result != DB_SUCCESS) {
+            return result;
+        }
+        it = tables_.find(table_id);
     }
 
     table_info = it->second;
     return DB_SUCCESS;
 }
+
+dberr_t CatalogManager::GetIndex(const index_id_t index_id, IndexInfo *&index_info) {
+    auto it = indexes_.find(index_id);
+    if (it == indexes_.end()) {
+        auto page = catalog_meta_->index_meta_pages_.find(index_id);
+        if (page == catalog_meta_->index_meta_pages_.end()) {
+            return DB_INDEX_NOT_FOUND;
+        }
+        dberr_t result = LoadIndex(index_id, page->second);
+        if (result != DB_SUCCESS) {
+            return result;
+        }
+        it = indexes_.find(index_id);
+    }
+
+    index_info = it->second;
+    return DB_SUCCESS;
+}
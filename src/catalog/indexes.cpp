@@ -1,12 +1,12 @@
 #include "../include/catalog/indexes.h"
 
 IndexMetadata::IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                             const std::vector<uint32_t> &key_map)
-    : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map) {}
+                             const std::vector<uint32_t> &key_map, const std::string &index_type)
+    : index_id_(index_id), index_name_(index_name), table_id_(table_id), key_map_(key_map), index_type_(index_type) {}
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name, const table_id_t table_id,
-                                     const vector<uint32_t> &key_map) {
-  return new IndexMetadata(index_id, index_name, table_id, key_map);
+                                     const vector<uint32_t> &key_map, const std::string &index_type) {
+  return new IndexMetadata(index_id, index_name, table_id, key_map, index_type);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -14,7 +14,7 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
   uint32_t ofs = GetSerializedSize();
   ASSERT(ofs <= PAGE_SIZE, "Failed to serialize index info.");
   // magic num
-  MACH_WRITE_UINT32(buf, INDEX_METADATA_MAGIC_NUM);
+  MACH_WRITE_UINT32(buf, INDEX_METADATA_TYPE_MAGIC_NUM);
   buf += 4;
   // index id
   MACH_WRITE_TO(index_id_t, buf, index_id_);
@@ -35,6 +35,11 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     MACH_WRITE_UINT32(buf, col_index);
     buf += 4;
   }
+  // index type
+  MACH_WRITE_UINT32(buf, index_type_.length());
+  buf += 4;
+  MACH_WRITE_STRING(buf, index_type_);
+  buf += index_type_.length();
   ASSERT(buf - p == ofs, "Unexpected serialize size.");
   return ofs;
 }
@@ -51,6 +56,8 @@ uint32_t IndexMetadata::GetSerializedSize() const {
 
   size += sizeof(uint32_t) + key_map_.size() * sizeof(uint32_t);
 
+  size += sizeof(uint32_t) + index_type_.size() * sizeof(char);
+
   return size;
 }
 
@@ -63,7 +70,8 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
   // magic num
   uint32_t magic_num = MACH_READ_UINT32(buf);
   buf += 4;
-  ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM, "Failed to deserialize index info.");
+  ASSERT(magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == INDEX_METADATA_TYPE_MAGIC_NUM,
+         "Failed to deserialize index info.");
   // index id
   index_id_t index_id = MACH_READ_FROM(index_id_t, buf);
   buf += 4;
@@ -85,8 +93,16 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta) {
     buf += 4;
     key_map.push_back(key_index);
   }
+  // index type
+  std::string index_type = "bptree";
+  if (magic_num == INDEX_METADATA_TYPE_MAGIC_NUM) {
+    uint32_t type_len = MACH_READ_UINT32(buf);
+    buf += 4;
+    index_type.assign(buf, type_len);
+    buf += type_len;
+  }
   // allocate space for index meta data
-  index_meta = new IndexMetadata(index_id, index_name, table_id, key_map);
+  index_meta = new IndexMetadata(index_id, index_name, table_id, key_map, index_type);
   return buf - p;
 }
 
@@ -96,23 +112,32 @@ Index *IndexInfo::CreateIndex(BufferPoolManager *buffer_pool_manager, const stri
     max_size += col->GetLength();
   }
 
+  if (max_size <= 8)
+    max_size = 16;
+  else if (max_size <= 24)
+    max_size = 32;
+  else if (max_size <= 56)
+    max_size = 64;
+  else if (max_size <= 120)
+    max_size = 128;
+  else if (max_size <= 248)
+    max_size = 256;
+  else {
+    LOG(ERROR) << "GenericKey size is too large";
+    return nullptr;
+  }
   if (index_type == "bptree") {
-    if (max_size <= 8)
-      max_size = 16;
-    else if (max_size <= 24)
-      max_size = 32;
-    else if (max_size <= 56)
-      max_size = 64;
-    else if (max_size <= 120)
-      max_size = 128;
-    else if (max_size <= 248)
-      max_size = 256;
-    else {
-      LOG(ERROR) << "GenericKey size is too large";
-      return nullptr;
+    return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  } else if (index_type == "hash") {
+    return new HashIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  } else if (index_type == "art") {
+    // the tree lives in memory only, it is filled from the table each time the index is opened
+    auto index = new ArtIndex(meta_data_->index_id_, key_schema_);
+    if (index->Rebuild(table_info_->GetTableHeap(), table_info_->GetSchema()) != DB_SUCCESS) {
+      LOG(WARNING) << "Duplicate keys in table " << table_info_->GetTableName() << " for index "
+                   << meta_data_->GetIndexName();
     }
-  } else {
-    return nullptr;
+    return index;
   }
-  return new BPlusTreeIndex(meta_data_->index_id_, key_schema_, max_size, buffer_pool_manager);
+  return nullptr;
 }
\ No newline at end of file
@@ -5,7 +5,13 @@ uint32_t TableMetadata::SerializeTo(char *buf) const {
     uint32_t ofs = GetSerializedSize();
     ASSERT(ofs <= PAGE_SIZE, "Failed to serialize table info.");
     // magic num
-    MACH_WRITE_UINT32(buf, TABLE_METADATA_MAGIC_NUM);
+    MACH_WRITE_UINT32(buf, TABLE_METADATA_DICTIONARY_MAGIC_NUM);
+    buf += 4;
+    // layout
+    MACH_WRITE_UINT32(buf, static_cast<uint32_t>(layout_));
+    buf += 4;
+    // dictionary page id
+    MACH_WRITE_TO(page_id_t, buf, dictionary_page_id_);
     buf += 4;
     // table id
     MACH_WRITE_TO(table_id_t, buf, table_id_);
@@ -36,8 +42,9 @@ uint32_t TableMetadata::GetSerializedSize() const {
     uint32_t schema_size = schema_->GetSerializedSize();
 
     // Sum up the sizes of all member variables
-    uint32_t total_size = sizeof(TABLE_METADATA_MAGIC_NUM) + table_id_size + table_name_size +
-                          root_page_id_size + schema_size;
+    uint32_t total_size = sizeof(TABLE_METADATA_DICTIONARY_MAGIC_NUM) + sizeof(uint32_t) +
+                          sizeof(dictionary_page_id_) + table_id_size + table_name_size + root_page_id_size +
+                          schema_size;
 
     return total_size;
 }
@@ -51,7 +58,18 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     // magic num
     uint32_t magic_num = MACH_READ_UINT32(buf);
     buf += 4;
-    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM, "Failed to deserialize table info.");
+    ASSERT(magic_num == TABLE_METADATA_MAGIC_NUM || magic_num == TABLE_METADATA_LAYOUT_MAGIC_NUM ||
+           magic_num == TABLE_METADATA_DICTIONARY_MAGIC_NUM, "Failed to deserialize table info.");
+    TableLayout layout = TableLayout::kRow;
+    if (magic_num != TABLE_METADATA_MAGIC_NUM) {
+        layout = static_cast<TableLayout>(MACH_READ_UINT32(buf));
+        buf += 4;
+    }
+    page_id_t dictionary_page_id = INVALID_PAGE_ID;
+    if (magic_num == TABLE_METADATA_DICTIONARY_MAGIC_NUM) {
+        dictionary_page_id = MACH_READ_FROM(page_id_t, buf);
+        buf += 4;
+    }
     // table id
     table_id_t table_id = MACH_READ_FROM(table_id_t, buf);
     buf += 4;
@@ -67,7 +85,7 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
     TableSchema *schema = nullptr;
     buf += TableSchema::DeserializeFrom(buf, schema);
     // allocate space for table metadata
-    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema);
+    table_meta = new TableMetadata(table_id, table_name, root_page_id, schema, layout, dictionary_page_id);
     return buf - p;
 }
 
@@ -77,10 +95,16 @@ uint32_t TableMetadata::DeserializeFrom(char *buf, TableMetadata *&table_meta) {
  * @param heap Memory heap passed by TableInfo
  */
 TableMetadata *TableMetadata::Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                                     TableSchema *schema) {
+                                     TableSchema *schema, TableLayout layout, page_id_t dictionary_page_id) {
   // allocate space for table metadata
-  return new TableMetadata(table_id, table_name, root_page_id, schema);
+  return new TableMetadata(table_id, table_name, root_page_id, schema, layout, dictionary_page_id);
 }
 
-TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema)
-    : table_id_(table_id), table_name_(table_name), root_page_id_(root_page_id), schema_(schema) {}
+TableMetadata::TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                             TableLayout layout, page_id_t dictionary_page_id)
+    : table_id_(table_id),
+      table_name_(table_name),
+      root_page_id_(root_page_id),
+      schema_(schema),
+      layout_(layout),
+      dictionary_page_id_(dictionary_page_id) {}
@@ -3,19 +3,35 @@
 //
 #include "common/instance.h"
 
-DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size)
-    : db_file_name_(std::move(db_name)), init_(init) {
+#include "executor/plan_cache.h"
+
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer_pool_size, bool compressed)
+    : db_file_name_("./databases/" + db_name), hot_pages_file_name_(GetHotPagesFileName(db_name)), init_(init) {
   // Init database file if needed
-  db_file_name_ = "./databases/"+db_file_name_;
   if (init_) {
-    remove(db_file_name_.c_str());
+    DiskManager::RemoveFiles(db_file_name_);
+    remove(hot_pages_file_name_.c_str());
   }
   // Initialize components
-  disk_mgr_ = new DiskManager(db_file_name_);
+  disk_mgr_ = new DiskManager(db_file_name_, init_ && compressed);
   bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
+  Open();
+}
 
+DBStorageEngine::DBStorageEngine(std::string db_name, bool init, BufferPool *buffer_pool, bool compressed)
+    : db_file_name_("./databases/" + db_name), hot_pages_file_name_(GetHotPagesFileName(db_name)), init_(init) {
+  if (init_) {
+    DiskManager::RemoveFiles(db_file_name_);
+    remove(hot_pages_file_name_.c_str());
+  }
+  disk_mgr_ = new DiskManager(db_file_name_, init_ && compressed);
+  bpm_ = new BufferPoolManager(buffer_pool, disk_mgr_);
+  Open();
+}
+
+void DBStorageEngine::Open() {
   // Allocate static page for db storage engine
-  if (init) {
+  if (init_) {
     page_id_t id;
     if (!bpm_->IsPageFree(CATALOG_META_PAGE_ID)) {
       throw logic_error("Catalog meta page not free.");
@@ -38,15 +54,30 @@ DBStorageEngine::DBStorageEngine(std::string db_name, bool init, uint32_t buffer
     ASSERT(!bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Invalid catalog meta page.");
     ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
   }
-  catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
+  lock_mgr_ = new LockManager();
+  version_store_ = new VersionStore();
+  txn_mgr_ = new TxnManager(lock_mgr_, version_store_);
+  catalog_mgr_ = new CatalogManager(bpm_, lock_mgr_, nullptr, init_, version_store_);
+  plan_cache_ = new PlanCache();
+  // Reopened, the pool is warmed up with the pages hot when the database was last open.
+  warmer_ = new BufferPoolWarmer(bpm_, hot_pages_file_name_, !init_);
 }
 
 DBStorageEngine::~DBStorageEngine() {
+  delete warmer_;
+  delete plan_cache_;
+  delete txn_mgr_;
   delete catalog_mgr_;
+  delete version_store_;
+  delete lock_mgr_;
   delete bpm_;
   delete disk_mgr_;
 }
 
+std::string DBStorageEngine::GetHotPagesFileName(const std::string &db_name) {
+  return "./databases/." + db_name + ".hot";
+}
+
 std::unique_ptr<ExecuteContext> DBStorageEngine::MakeExecuteContext(Transaction *txn) {
   return std::make_unique<ExecuteContext>(txn, catalog_mgr_, bpm_);
 }
@@ -0,0 +1,130 @@
+#include "common/metrics.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <utility>
+
+#include "glog/logging.h"
+
+void LatencyHistogram::Record(std::chrono::nanoseconds latency) {
+  uint64_t ns = latency.count() > 0 ? static_cast<uint64_t>(latency.count()) : 0;
+  buckets_[GetBucketIndex((ns + 999) / 1000)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (ns > max_ns && !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+  }
+}
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t us) {
+  if (us <= SUB_BUCKETS) {
+    return us;
+  }
+  // us - 1 lies in [2^e, 2^(e+1)), the sub bucket is given by the bits below the leading one.
+  size_t exponent = 63 - __builtin_clzll(us - 1);
+  if (exponent > MAX_EXPONENT) {
+    return BUCKET_COUNT - 1;
+  }
+  size_t sub_bucket = ((us - 1) >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+  return SUB_BUCKETS + 1 + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t LatencyHistogram::GetBucketBound(size_t i) {
+  if (i <= SUB_BUCKETS) {
+    return i;
+  }
+  if (i >= BUCKET_COUNT - 1) {
+    return 0;
+  }
+  size_t exponent = (i - SUB_BUCKETS - 1) / SUB_BUCKETS + SUB_BUCKET_BITS;
+  size_t sub_bucket = (i - SUB_BUCKETS - 1) % SUB_BUCKETS;
+  return (uint64_t{1} << exponent) + ((sub_bucket + 1) << (exponent - SUB_BUCKET_BITS));
+}
+
+uint64_t LatencyHistogram::GetQuantile(double q) const {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+  // No duration is longer than the longest one recorded, whatever the bound of its bucket.
+  uint64_t max_us = (GetMaxNanos() + 999) / 1000;
+  auto rank = std::max<uint64_t>(static_cast<uint64_t>(q * static_cast<double>(count) + 0.5), 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i + 1 < BUCKET_COUNT; i++) {
+    seen += GetBucketCount(i);
+    if (seen >= rank) {
+      return std::min(GetBucketBound(i), max_us);
+    }
+  }
+  return max_us;
+}
+
+void LatencyHistogram::WritePrometheus(std::ostream &out, const std::string &name, const std::string &help) const {
+  out << "# HELP " << name << " " << help << "\n";
+  out << "# TYPE " << name << " histogram\n";
+  auto precision = out.precision(12);
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i + 1 < BUCKET_COUNT; i++) {
+    cumulative += GetBucketCount(i);
+    // The sub buckets are summed up, a scraper gets the bounds which are powers of two.
+    uint64_t bound = GetBucketBound(i);
+    if (bound != 0 && (bound & (bound - 1)) == 0) {
+      out << name << "_bucket{le=\"" << static_cast<double>(bound) / 1e6 << "\"} " << cumulative << "\n";
+    }
+  }
+  cumulative += GetBucketCount(BUCKET_COUNT - 1);
+  out << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+  out << name << "_sum " << static_cast<double>(GetSumNanos()) / 1e9 << "\n";
+  out << name << "_count " << cumulative << "\n";
+  out.precision(precision);
+}
+
+void WritePrometheusMetric(std::ostream &out, const std::string &name, const std::string &type,
+                           const std::string &help, uint64_t value) {
+  out << "# HELP " << name << " " << help << "\n";
+  out << "# TYPE " << name << " " << type << "\n";
+  out << name << " " << value << "\n";
+}
+
+MetricsFileWriter::MetricsFileWriter(std::string path, std::chrono::milliseconds interval,
+                                     std::function<void(std::ostream &)> write_metrics)
+    : path_(std::move(path)), interval_(interval), write_metrics_(std::move(write_metrics)) {
+  thread_ = std::thread(&MetricsFileWriter::Run, this);
+}
+
+MetricsFileWriter::~MetricsFileWriter() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  thread_.join();
+  WriteFile();
+}
+
+bool MetricsFileWriter::WriteFile() {
+  std::string tmp_path = path_ + ".tmp";
+  {
+    std::ofstream out(tmp_path, std::ios::trunc);
+    if (!out) {
+      return false;
+    }
+    write_metrics_(out);
+    if (!out) {
+      return false;
+    }
+  }
+  return rename(tmp_path.c_str(), path_.c_str()) == 0;
+}
+
+void MetricsFileWriter::Run() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+    lock.unlock();
+    if (!WriteFile()) {
+      LOG(WARNING) << "failed to write metrics to " << path_;
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,46 @@
+#include "common/thread_pool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t num_workers) {
+  num_workers = std::max<size_t>(num_workers, 1);
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    tasks_.push(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> guard(latch_);
+      cv_.wait(guard, [this] { return stop_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop();
+    }
+    task();
+  }
+}
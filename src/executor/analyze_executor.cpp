@@ -0,0 +1,21 @@
+#include "executor/executors/analyze_executor.h"
+
+void AnalyzeExecutor::Init() {
+  auto start_stats = BufferPool::GetThreadStats();
+  auto start_time = std::chrono::steady_clock::now();
+  child_->Init();
+  stats_.time_ += std::chrono::steady_clock::now() - start_time;
+  stats_.buffer_ += BufferPool::GetThreadStats() - start_stats;
+}
+
+bool AnalyzeExecutor::Next(Row *row, RowId *rid) {
+  auto start_stats = BufferPool::GetThreadStats();
+  auto start_time = std::chrono::steady_clock::now();
+  bool more = child_->Next(row, rid);
+  stats_.time_ += std::chrono::steady_clock::now() - start_time;
+  stats_.buffer_ += BufferPool::GetThreadStats() - start_stats;
+  if (more) {
+    stats_.rows_++;
+  }
+  return more;
+}
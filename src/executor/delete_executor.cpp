@@ -25,15 +25,24 @@ bool DeleteExecutor::Next([[maybe_unused]] Row *row, RowId *rid) {
     RowId to_delete_rid;
     int32_t cnt = 0;
 
+    auto txn = exec_ctx_->GetTransaction();
     while(child_executor_->Next(&to_delete_row,&to_delete_rid)){
-        bool deleted = table_info_->GetTableHeap()->MarkDelete(to_delete_rid, exec_ctx_->GetTransaction()); //Mark or actual?
+        // The tuple is only marked, it is physically removed when the transaction commits.
+        bool deleted = table_info_->GetTableHeap()->MarkDelete(to_delete_rid, txn);
         if(!deleted){
+            if(txn != nullptr) txn->ThrowIfAborted();
             return false;
         }
+        // Snapshots may still find the row through its index entries, the garbage collection removes them.
+        if(table_info_->GetTableHeap()->IsVersioned(txn)){
+            cnt++;
+            continue;
+        }
         for(auto index : table_indexes_){
             Row key;
             to_delete_row.GetKeyFromRow(table_info_->GetSchema(),index->GetIndexKeySchema(),key);
-            index->GetIndex()->RemoveEntry(key,to_delete_rid,exec_ctx_->GetTransaction());
+            if(index->GetIndex()->RemoveEntry(key,to_delete_rid,txn) == DB_SUCCESS && txn != nullptr)
+                txn->GetIndexWriteSet()->emplace_back(to_delete_rid, WType::kDelete, key, index->GetIndex());
         }
         cnt++;
     }
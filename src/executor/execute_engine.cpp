@@ -4,31 +4,29 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
+#include <thread>
 
+#include "common/metrics.h"
 #include "common/result_writer.h"
+#include "executor/executors/analyze_executor.h"
 #include "executor/executors/delete_executor.h"
+#include "executor/executors/gather_executor.h"
 #include "executor/executors/index_scan_executor.h"
 #include "executor/executors/insert_executor.h"
 #include "executor/executors/seq_scan_executor.h"
 #include "executor/executors/update_executor.h"
 #include "executor/executors/values_executor.h"
+#include "executor/plan_cache.h"
+#include "executor/plan_printer.h"
 #include "glog/logging.h"
+#include "parser/parsed_statement.h"
 #include "planner/planner.h"
 #include "utils/utils.h"
 
-#include <cstdio>
-#include "parser/syntax_tree_printer.h"
-#include "utils/tree_file_mgr.h"
-
-extern "C" {
-int yyparse(void);
-// FILE *yyin;
-#include "parser/minisql_lex.h"
-#include "parser/parser.h"
-}
-
-ExecuteEngine::ExecuteEngine() {
+ExecuteEngine::ExecuteEngine(size_t buffer_pool_size)
+        : buffer_pool_(buffer_pool_size), scan_pool_(std::max(1u, std::thread::hardware_concurrency())) {
     char path[] = "./databases";
     DIR *dir;
     if((dir = opendir(path)) == nullptr) {
@@ -42,50 +40,77 @@ ExecuteEngine::ExecuteEngine() {
             strcmp( stdir->d_name , "..") == 0 ||
             stdir->d_name[0] == '.')
             continue;
-        dbs_[stdir->d_name] = new DBStorageEngine(stdir->d_name, false);
+        // Databases are opened on first use.
+        db_names_.insert(stdir->d_name);
     }
 
     closedir(dir);
 }
 
+/**
+ * Only the scan of a plan which reads rows is split among workers, the workers take no locks for an update or a
+ * delete above it.
+ */
+static bool IsReadOnly(const AbstractPlanNodeRef &plan) {
+    return plan->GetType() == PlanType::SeqScan || plan->GetType() == PlanType::IndexScan;
+}
+
 std::unique_ptr<AbstractExecutor> ExecuteEngine::CreateExecutor(ExecuteContext *exec_ctx,
                                                                 const AbstractPlanNodeRef &plan) {
+    std::unique_ptr<AbstractExecutor> executor;
     switch (plan->GetType()) {
         // Create a new sequential scan executor
         case PlanType::SeqScan: {
-            return std::make_unique<SeqScanExecutor>(exec_ctx, dynamic_cast<const SeqScanPlanNode *>(plan.get()));
+            auto seq_scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan.get());
+            if (GatherExecutor::IsParallel(exec_ctx)) {
+                executor = std::make_unique<GatherExecutor>(exec_ctx, seq_scan_plan);
+            } else {
+                executor = std::make_unique<SeqScanExecutor>(exec_ctx, seq_scan_plan);
+            }
+            break;
         }
             // Create a new index scan executor
         case PlanType::IndexScan: {
-            return std::make_unique<IndexScanExecutor>(exec_ctx, dynamic_cast<const IndexScanPlanNode *>(plan.get()));
+            executor = std::make_unique<IndexScanExecutor>(exec_ctx,
+                                                           dynamic_cast<const IndexScanPlanNode *>(plan.get()));
+            break;
         }
             // Create a new update executor
         case PlanType::Update: {
             auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan.get());
             auto child_executor = CreateExecutor(exec_ctx, update_plan->GetChildPlan());
-            return std::make_unique<UpdateExecutor>(exec_ctx, update_plan, std::move(child_executor));
+            executor = std::make_unique<UpdateExecutor>(exec_ctx, update_plan, std::move(child_executor));
+            break;
         }
             // Create a new delete executor
         case PlanType::Delete: {
             auto delete_plan = dynamic_cast<const DeletePlanNode *>(plan.get());
             auto child_executor = CreateExecutor(exec_ctx, delete_plan->GetChildPlan());
-            return std::make_unique<DeleteExecutor>(exec_ctx, delete_plan, std::move(child_executor));
+            executor = std::make_unique<DeleteExecutor>(exec_ctx, delete_plan, std::move(child_executor));
+            break;
         }
         case PlanType::Insert: {
             auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan.get());
             auto child_executor = CreateExecutor(exec_ctx, insert_plan->GetChildPlan());
-            return std::make_unique<InsertExecutor>(exec_ctx, insert_plan, std::move(child_executor));
+            executor = std::make_unique<InsertExecutor>(exec_ctx, insert_plan, std::move(child_executor));
+            break;
         }
         case PlanType::Values: {
-            return std::make_unique<ValuesExecutor>(exec_ctx, dynamic_cast<const ValuesPlanNode *>(plan.get()));
+            executor = std::make_unique<ValuesExecutor>(exec_ctx, dynamic_cast<const ValuesPlanNode *>(plan.get()));
+            break;
         }
         default:
             throw std::logic_error("Unsupported plan type.");
     }
+    // EXPLAIN ANALYZE measures every executor of the plan.
+    if (exec_ctx->IsAnalyzing()) {
+        executor = std::make_unique<AnalyzeExecutor>(exec_ctx, plan.get(), std::move(executor));
+    }
+    return executor;
 }
 
 dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<Row> *result_set, Transaction *txn,
-                                   ExecuteContext *exec_ctx) {
+                                   ExecuteContext *exec_ctx, std::ostream &out) {
     // Construct the executor for the abstract plan node
     auto executor = CreateExecutor(exec_ctx, plan);
 
@@ -99,7 +124,7 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
             }
         }
     } catch (const exception &ex) {
-        std::cout << "Error Encountered in Executor Execution: " << ex.what() << std::endl;
+        out << "Error Encountered in Executor Execution: " << ex.what() << std::endl;
         if (result_set != nullptr) {
             result_set->clear();
         }
@@ -109,67 +134,285 @@ dberr_t ExecuteEngine::ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<
 }
 
 dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
+    return Execute(ast, &default_session_);
+}
+
+dberr_t ExecuteEngine::Execute(pSyntaxNode ast, Session *session) {
     if (ast == nullptr) {
         return DB_FAILED;
     }
-    auto start_time = std::chrono::system_clock::now();
+    // Statements of a script take the latch one by one.
+    if (ast->type_ == kNodeExecFile) {
+        return ExecuteExecfile(ast, nullptr, session);
+    }
+    // Statements which change the set of databases or a catalog run alone, the others run concurrently.
+    switch (ast->type_) {
+        case kNodeCreateDB:
+        case kNodeDropDB:
+        case kNodeUseDB:
+        case kNodeCreateTable:
+        case kNodeDropTable:
+        case kNodeCreateIndex:
+        case kNodeDropIndex: {
+            std::unique_lock<std::shared_mutex> guard(latch_);
+            return ExecuteStatement(ast, session);
+        }
+        default: {
+            std::shared_lock<std::shared_mutex> guard(latch_);
+            return ExecuteStatement(ast, session);
+        }
+    }
+}
+
+dberr_t ExecuteEngine::Execute(const ParsedStatement &statement) {
+    return Execute(statement, &default_session_);
+}
+
+dberr_t ExecuteEngine::Execute(const ParsedStatement &statement, Session *session) {
+    StatementProfile profile;
+    profile.parse_ = statement.GetParseTime();
+    auto start_stats = BufferPool::GetThreadStats();
+    // The statements of a script run by execfile are profiled one by one.
+    auto outer_profile = session->profile_;
+    session->profile_ = &profile;
+    auto result = Execute(statement.GetRoot(), session);
+    session->profile_ = outer_profile;
+    if (statement.HasError()) {
+        return result;
+    }
+    profile.buffer_ = BufferPool::GetThreadStats() - start_stats;
+    profile.execute_ = std::chrono::steady_clock::now() - profile.start_ - profile.plan_ - profile.format_;
+    statement_stats_.Record(StatementStats::Fingerprint(statement.GetSql()), profile);
+    if (slow_query_log_.IsSlow(profile.GetTotal())) {
+        slow_query_log_.Write(statement.GetSql(), session->current_db_, profile, result == DB_SUCCESS);
+    }
+    return result;
+}
+
+dberr_t ExecuteEngine::OpenSlowQueryLog(const std::string &path, std::chrono::milliseconds threshold) {
+    return slow_query_log_.Open(path, threshold) ? DB_SUCCESS : DB_FAILED;
+}
+
+void ExecuteEngine::CloseSession(Session *session) {
+    std::unique_lock<std::shared_mutex> guard(latch_);
+    auto db = GetDatabase(session->current_db_);
+    if (session->current_txn_ != nullptr && db != nullptr) {
+        db->txn_mgr_->Abort(session->current_txn_);
+    }
+    session->current_txn_ = nullptr;
+    LeaveDatabase(session);
+}
+
+size_t ExecuteEngine::GetOpenDatabaseCount() {
+    std::shared_lock<std::shared_mutex> guard(latch_);
+    return dbs_.size();
+}
+
+void ExecuteEngine::WriteMetrics(std::ostream &out) {
+    const auto &pool = buffer_pool_.GetCounters();
+    auto &io = DiskManager::GetIoCounters();
+    WritePrometheusMetric(out, "minisql_buffer_pool_size_pages", "gauge", "Frames of the buffer pool.",
+                          buffer_pool_.GetPoolSize());
+    WritePrometheusMetric(out, "minisql_buffer_pool_cached_pages", "gauge", "Frames holding a page.",
+                          buffer_pool_.GetPageCount());
+    WritePrometheusMetric(out, "minisql_buffer_pool_fetches_total", "counter", "Pages fetched.", pool.fetches_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_hits_total", "counter", "Pages fetched which were cached.",
+                          pool.hits_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_misses_total", "counter", "Pages fetched which were not cached.",
+                          pool.misses_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_evictions_total", "counter", "Pages evicted to free a frame.",
+                          pool.evictions_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_dirty_writebacks_total", "counter",
+                          "Evicted pages written back.", pool.dirty_writebacks_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_flushes_total", "counter", "Pages flushed.", pool.flushes_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_ring_reuses_total", "counter",
+                          "Frames recycled by large scans.", pool.ring_reuses_);
+    WritePrometheusMetric(out, "minisql_buffer_pool_prefetches_total", "counter",
+                          "Pages read ahead by the warm-up.", pool.prefetches_);
+    WritePrometheusMetric(out, "minisql_disk_reads_total", "counter", "Pages read from disk.", io.reads_);
+    WritePrometheusMetric(out, "minisql_disk_writes_total", "counter", "Pages written to disk.", io.writes_);
+    WritePrometheusMetric(out, "minisql_disk_read_bytes_total", "counter", "Bytes read from disk.", io.bytes_read_);
+    WritePrometheusMetric(out, "minisql_disk_written_bytes_total", "counter", "Bytes written to disk.",
+                          io.bytes_written_);
+    io.read_latency_.WritePrometheus(out, "minisql_disk_read_latency_seconds", "Time of a page read.");
+    io.write_latency_.WritePrometheus(out, "minisql_disk_write_latency_seconds", "Time of a page write.");
+    auto &compression = CompressedPageStore::GetCounters();
+    WritePrometheusMetric(out, "minisql_page_compression_input_bytes_total", "counter",
+                          "Bytes of the pages written to compressed databases.", compression.bytes_in_);
+    WritePrometheusMetric(out, "minisql_page_compression_output_bytes_total", "counter",
+                          "Bytes stored for the pages written to compressed databases.", compression.bytes_out_);
+    WritePrometheusMetric(out, "minisql_page_compress_nanoseconds_total", "counter",
+                          "Time spent compressing pages.", compression.compress_ns_);
+    WritePrometheusMetric(out, "minisql_page_decompress_nanoseconds_total", "counter",
+                          "Time spent decompressing pages.", compression.decompress_ns_);
+    statement_stats_.GetTotalLatency().WritePrometheus(out, "minisql_statement_latency_seconds",
+                                                       "Time of a statement, parsing included.");
+    WritePrometheusMetric(out, "minisql_slow_queries_total", "counter", "Statements logged as slow.",
+                          slow_query_log_.GetCount());
+    WritePrometheusMetric(out, "minisql_open_databases", "gauge", "Databases open.", GetOpenDatabaseCount());
+}
+
+DBStorageEngine *ExecuteEngine::GetDatabase(const std::string &db_name) const {
+    auto it = dbs_.find(db_name);
+    return it == dbs_.end() ? nullptr : it->second;
+}
+
+DBStorageEngine *ExecuteEngine::EnterDatabase(const std::string &db_name, Session *session) {
+    if (session->current_db_ == db_name) {
+        return GetDatabase(db_name);
+    }
+    auto db = GetDatabase(db_name);
+    if (db == nullptr) {
+        // opened before the session leaves its database, which it keeps if the open fails
+        db = new DBStorageEngine(db_name, false, &buffer_pool_);
+        dbs_[db_name] = db;
+    }
+    LeaveDatabase(session);
+    db_sessions_[db_name]++;
+    session->current_db_ = db_name;
+    return db;
+}
+
+void ExecuteEngine::LeaveDatabase(Session *session) {
+    if (session->current_db_.empty()) {
+        return;
+    }
+    auto it = db_sessions_.find(session->current_db_);
+    // The session's transaction is over, nobody else refers to a database without sessions.
+    if (it != db_sessions_.end() && --it->second == 0) {
+        delete dbs_[it->first];
+        dbs_.erase(it->first);
+        db_sessions_.erase(it);
+    }
+    session->current_db_.clear();
+}
+
+dberr_t ExecuteEngine::ExecuteStatement(pSyntaxNode ast, Session *session) {
+    auto start_time = std::chrono::steady_clock::now();
     unique_ptr<ExecuteContext> context(nullptr);
-    if(!current_db_.empty())
-        context = dbs_[current_db_]->MakeExecuteContext(nullptr);
+    DBStorageEngine *current_db = GetDatabase(session->current_db_);
+    if (current_db != nullptr)
+        context = current_db->MakeExecuteContext(session->current_txn_);
     switch (ast->type_) {
         case kNodeCreateDB:
-            return ExecuteCreateDatabase(ast, context.get());
+            return ExecuteCreateDatabase(ast, context.get(), session);
         case kNodeDropDB:
-            return ExecuteDropDatabase(ast, context.get());
+            return ExecuteDropDatabase(ast, context.get(), session);
         case kNodeShowDB:
-            return ExecuteShowDatabases(ast, context.get());
+            return ExecuteShowDatabases(ast, context.get(), session);
         case kNodeUseDB:
-            return ExecuteUseDatabase(ast, context.get());
+            return ExecuteUseDatabase(ast, context.get(), session);
         case kNodeShowTables:
-            return ExecuteShowTables(ast, context.get());
+            return ExecuteShowTables(ast, context.get(), session);
         case kNodeCreateTable:
-            return ExecuteCreateTable(ast, context.get());
+            return ExecuteCreateTable(ast, context.get(), session);
         case kNodeDropTable:
-            return ExecuteDropTable(ast, context.get());
+            return ExecuteDropTable(ast, context.get(), session);
         case kNodeShowIndexes:
-            return ExecuteShowIndexes(ast, context.get());
+            return ExecuteShowIndexes(ast, context.get(), session);
         case kNodeCreateIndex:
-            return ExecuteCreateIndex(ast, context.get());
+            return ExecuteCreateIndex(ast, context.get(), session);
         case kNodeDropIndex:
-            return ExecuteDropIndex(ast, context.get());
+            return ExecuteDropIndex(ast, context.get(), session);
         case kNodeTrxBegin:
-            return ExecuteTrxBegin(ast, context.get());
+            return ExecuteTrxBegin(ast, context.get(), session);
         case kNodeTrxCommit:
-            return ExecuteTrxCommit(ast, context.get());
+            return ExecuteTrxCommit(ast, context.get(), session);
         case kNodeTrxRollback:
-            return ExecuteTrxRollback(ast, context.get());
+            return ExecuteTrxRollback(ast, context.get(), session);
         case kNodeExecFile:
-            return ExecuteExecfile(ast, context.get());
+            return ExecuteExecfile(ast, context.get(), session);
         case kNodeQuit:
-            return ExecuteQuit(ast, context.get());
+            return ExecuteQuit(ast, context.get(), session);
+        case kNodePrepare:
+            return ExecutePrepare(ast, context.get(), session);
+        case kNodeExecute:
+            return ExecutePrepared(ast, context.get(), session);
+        case kNodeDeallocate:
+            return ExecuteDeallocate(ast, context.get(), session);
+        case kNodeSet:
+            return ExecuteSet(ast, context.get(), session);
+        case kNodeExplain:
+            return ExecuteExplain(ast, context.get(), session);
+        case kNodeShowStatus:
+            return ExecuteShowStatus(ast, context.get(), session);
         default:
             break;
     }
+    if (context == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
     // Plan the query.
     Planner planner(context.get());
-    std::vector<Row> result_set{};
     try {
+        PhaseTimer timer(session->profile_, &StatementProfile::plan_);
         planner.PlanQuery(ast);
-        // Execute the query.
-        ExecutePlan(planner.plan_, &result_set, nullptr, context.get());
     } catch (const exception &ex) {
-        std::cout << "Error Encountered in Planner: " << ex.what() << std::endl;
+        session->Out() << "Error Encountered in Planner: " << ex.what() << std::endl;
         return DB_FAILED;
     }
-    auto stop_time = std::chrono::system_clock::now();
-    double duration_time =
-            double((std::chrono::duration_cast<std::chrono::milliseconds>(stop_time - start_time)).count());
+    if (!planner.params_.empty()) {
+        session->Out() << "Parameters are only allowed in prepared statements." << std::endl;
+        return DB_FAILED;
+    }
+    return ExecuteQueryPlan(planner.plan_, current_db, session, start_time);
+}
+
+dberr_t ExecuteEngine::ExecuteQueryPlan(const AbstractPlanNodeRef &plan, DBStorageEngine *db, Session *session,
+                                        std::chrono::steady_clock::time_point start_time, bool analyze) {
+    // Statements outside of BEGIN ... COMMIT run in a transaction of their own.
+    auto txn_mgr = db->txn_mgr_;
+    bool autocommit = session->current_txn_ == nullptr;
+    auto txn = autocommit ? txn_mgr->Begin(IsolationLevel::kSnapshotIsolation) : session->current_txn_;
+    auto context = db->MakeExecuteContext(txn);
+    if (IsReadOnly(plan)) {
+        context->SetParallelism(session->parallelism_, &scan_pool_);
+    }
+    if (analyze) {
+        context->EnableAnalyze();
+    }
+    std::vector<Row> result_set{};
+    // Execute the query.
+    dberr_t result = ExecutePlan(plan, &result_set, txn, context.get(), session->Out());
+    // The plan is printed while the transaction, which decided how it ran, is still there.
+    std::stringstream explain;
+    if (analyze && result == DB_SUCCESS) {
+        PlanPrinter(context.get()).Print(plan.get(), explain);
+    }
+    auto profile = session->profile_;
+    if (profile != nullptr && slow_query_log_.IsSlow(profile->GetElapsed())) {
+        std::stringstream plan_text;
+        PlanPrinter(context.get()).Print(plan.get(), plan_text);
+        profile->plan_text_ = plan_text.str();
+    }
+    if (autocommit) {
+        result == DB_SUCCESS ? txn_mgr->Commit(txn) : txn_mgr->Abort(txn);
+    } else if (result != DB_SUCCESS) {
+        // Without savepoints a failed statement can not be undone alone, the whole transaction is rolled back.
+        txn_mgr->Abort(txn);
+        session->current_txn_ = nullptr;
+        session->Out() << "Transaction rolled back." << std::endl;
+    }
+    if (result != DB_SUCCESS) {
+        return result;
+    }
+    auto stop_time = std::chrono::steady_clock::now();
+    double duration_time = std::chrono::duration<double, std::milli>(stop_time - start_time).count();
+    if (analyze) {
+        session->Out() << explain.rdbuf();
+        session->Out() << "Execution time: "
+                       << std::chrono::duration<double, std::milli>(stop_time - start_time).count() << " ms"
+                       << std::endl;
+        return DB_SUCCESS;
+    }
+    PhaseTimer timer(profile, &StatementProfile::format_);
     // Return the result set as string.
     std::stringstream ss;
     ResultWriter writer(ss);
 
-    if (planner.plan_->GetType() == PlanType::SeqScan || planner.plan_->GetType() == PlanType::IndexScan) {
-        auto schema = planner.plan_->OutputSchema();
+    if (plan->GetType() == PlanType::SeqScan || plan->GetType() == PlanType::IndexScan) {
+        auto schema = plan->OutputSchema();
         auto num_of_columns = schema->GetColumnCount();
         if (!result_set.empty()) {
             // find the max width for each column
@@ -208,38 +451,42 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast) {
     } else {
         writer.EndInformation(result_set.size(), duration_time, false);
     }
-    std::cout << writer.stream_.rdbuf();
+    session->Out() << writer.stream_.rdbuf();
     return DB_SUCCESS;
 }
 
 void ExecuteEngine::ExecuteInformation(dberr_t result) {
+    ExecuteInformation(result, &default_session_);
+}
+
+void ExecuteEngine::ExecuteInformation(dberr_t result, Session *session) {
     switch (result) {
         case DB_ALREADY_EXIST:
-            cout << "Database already exists." << endl;
+            session->Out() << "Database already exists." << endl;
             break;
         case DB_NOT_EXIST:
-            cout << "Database not exists." << endl;
+            session->Out() << "Database not exists." << endl;
             break;
         case DB_TABLE_ALREADY_EXIST:
-            cout << "Table already exists." << endl;
+            session->Out() << "Table already exists." << endl;
             break;
         case DB_TABLE_NOT_EXIST:
-            cout << "Table not exists." << endl;
+            session->Out() << "Table not exists." << endl;
             break;
         case DB_INDEX_ALREADY_EXIST:
-            cout << "Index already exists." << endl;
+            session->Out() << "Index already exists." << endl;
             break;
         case DB_INDEX_NOT_FOUND:
-            cout << "Index not exists." << endl;
+            session->Out() << "Index not exists." << endl;
             break;
         case DB_COLUMN_NAME_NOT_EXIST:
-            cout << "Column not exists." << endl;
+            session->Out() << "Column not exists." << endl;
             break;
         case DB_KEY_NOT_FOUND:
-            cout << "Key not exists." << endl;
+            session->Out() << "Key not exists." << endl;
             break;
         case DB_QUIT:
-            cout << "Bye." << endl;
+            session->Out() << "Bye." << endl;
             break;
         default:
             break;
@@ -248,7 +495,7 @@ void ExecuteEngine::ExecuteInformation(dberr_t result) {
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteCreateDatabase" << std::endl;
 #endif
@@ -256,13 +503,14 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
 
     string db_name(ast->child_->val_); // 获得数据库名字
 
-    if (dbs_[db_name] != nullptr) {
-        std::cout << "database " << db_name << " exists." << endl;
+    if (db_names_.count(db_name) != 0) {
+        session->Out() << "database " << db_name << " exists." << endl;
         return DB_FAILED;
     }
 
-    DBStorageEngine* new_database = new DBStorageEngine(db_name, true);
-    dbs_[db_name]=new_database;
+    // Only the file is set up here, the database is opened by the first session using it.
+    delete new DBStorageEngine(db_name, true, &buffer_pool_, session->page_compression_);
+    db_names_.insert(db_name);
     //->dbs_.insert(pair<std::string, DBStorageEngine*>(db_name, new_database));
 /*
   auto size = this->dbs_.size();
@@ -274,14 +522,14 @@ dberr_t ExecuteEngine::ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *co
   }
   out_file.close();
 */
-    std::cout << "Create database success" << std::endl;
+    session->Out() << "Create database success" << std::endl;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteDropDatabase" << std::endl;
 #endif
@@ -289,15 +537,31 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
 
     std::string db_name(ast->child_->val_);
 
-    if (dbs_[db_name] == nullptr) {
-        std::cout << "database " << db_name << " not exists." << endl;
+    if (db_names_.count(db_name) == 0) {
+        session->Out() << "database " << db_name << " not exists." << endl;
         return DB_FAILED;
     }
 
-    if (current_db_ == db_name) current_db_ = "";
-    auto target_db = dbs_[db_name];
-    target_db->~DBStorageEngine();
-    dbs_.erase(db_name);
+    // The database can not go while other sessions use it, this one only leaves it once the drop is sure.
+    auto sessions = db_sessions_.find(db_name);
+    size_t other_sessions = sessions == db_sessions_.end() ? 0 : sessions->second;
+    if (session->current_db_ == db_name) {
+        other_sessions--;
+    }
+    if (other_sessions > 0) {
+        session->Out() << "database " << db_name << " is in use." << endl;
+        return DB_FAILED;
+    }
+    if (session->current_db_ == db_name) {
+        if (session->current_txn_ != nullptr) {
+            GetDatabase(db_name)->txn_mgr_->Abort(session->current_txn_);
+            session->current_txn_ = nullptr;
+        }
+        LeaveDatabase(session);
+    }
+    DiskManager::RemoveFiles("./databases/" + db_name);
+    remove(DBStorageEngine::GetHotPagesFileName(db_name).c_str());
+    db_names_.erase(db_name);
 /*
   auto size = this->dbs_.size();
   ofstream out_file;
@@ -308,72 +572,81 @@ dberr_t ExecuteEngine::ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *cont
   }
   out_file.close();
  */
-    std::cout << "Drop database success" << std::endl;
+    session->Out() << "Drop database success" << std::endl;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteShowDatabases(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteShowDatabases(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteShowDatabases" << std::endl;
 #endif
-    std::cout << "Database(s) of number: " << dbs_.size() << endl;
+    session->Out() << "Database(s) of number: " << db_names_.size() << endl;
 
-    std::cout << "+-------------+" << std::endl;
-    std::cout << "| Database    |" << std::endl;
-    std::cout << "+-------------+" << std::endl;
-    for(auto it : dbs_)
-        std::cout << "| " << setw(12) << left << it.first << "|" << std::endl;
-    std::cout << "+-------------+" << std::endl;
+    session->Out() << "+-------------+" << std::endl;
+    session->Out() << "| Database    |" << std::endl;
+    session->Out() << "+-------------+" << std::endl;
+    for(auto &it : db_names_)
+        session->Out() << "| " << setw(12) << left << it << "|" << std::endl;
+    session->Out() << "+-------------+" << std::endl;
 
 /*
   for (const auto &db : dbs_) {
-    std::cout << db.first << std::endl;
+    session->Out() << db.first << std::endl;
   }
   */
 
-    std::cout << "Show database success" << std::endl;
+    session->Out() << "Show database success" << std::endl;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteUseDatabase" << std::endl;
 #endif
     if (ast->child_ == nullptr) return DB_FAILED;
     std::string db_name(ast->child_->val_);
-    if (dbs_[db_name] == nullptr) {
-        std::cout << "database " << db_name << " not exists." << endl;
+    if (db_names_.count(db_name) == 0) {
+        session->Out() << "database " << db_name << " not exists." << endl;
+        return DB_FAILED;
+    }
+    if (session->current_txn_ != nullptr && session->current_db_ != db_name) {
+        session->Out() << "Commit or rollback the running transaction first." << std::endl;
+        return DB_FAILED;
+    }
+    try {
+        EnterDatabase(db_name, session);
+    } catch (const exception &ex) {
+        session->Out() << "database " << db_name << " cannot be opened: " << ex.what() << std::endl;
         return DB_FAILED;
     }
-    current_db_ = db_name;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteShowTables(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteShowTables(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteShowTables" << std::endl;
 #endif
-    DBStorageEngine *current_db_engine = dbs_[current_db_];
+    DBStorageEngine *current_db_engine = GetDatabase(session->current_db_);
     if (current_db_engine == nullptr) {
-        std::cout << "No database selected." << endl;
+        session->Out() << "No database selected." << endl;
         return DB_FAILED;
     }
     std::vector<TableInfo *> table_info;
     current_db_engine->catalog_mgr_->GetTables(table_info);
-    std::cout << "table(s) of number: " << table_info.size() << endl;
+    session->Out() << "table(s) of number: " << table_info.size() << endl;
     for (auto table_info1 : table_info) {
-        std::cout << table_info1->GetTableName() << std::endl;
+        session->Out() << table_info1->GetTableName() << std::endl;
     }
-    std::cout << "Show table success" << std::endl;
+    session->Out() << "Show table success" << std::endl;
 
     return DB_SUCCESS;
 }
@@ -381,19 +654,59 @@ dberr_t ExecuteEngine::ExecuteShowTables(pSyntaxNode ast, ExecuteContext *contex
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteCreateTable" << std::endl;
 #endif
-    if (dbs_[current_db_] == nullptr) {
-        std::cout << "no database selected" << std::endl;
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "no database selected" << std::endl;
         return DB_FAILED;
     }
     pSyntaxNode ptr = ast->child_;
     string table_name(ptr->val_);
+    // WITH (layout = row | columnar, encoding = none | dictionary) follows the column definitions
+    TableLayout layout = TableLayout::kRow;
+    bool dictionary_encoded = false;
+    pSyntaxNode option = ptr->next_->next_;
+    if (option != nullptr && option->type_ == kNodeTableOption) {
+        if (string(option->val_) != "with") {
+            session->Out() << "unknown table option " << option->val_ << std::endl;
+            return DB_FAILED;
+        }
+        // the names and values of the options alternate
+        for (auto name = option->child_; name != nullptr; name = name->next_->next_) {
+            string option_name(name->val_), option_value(name->next_->val_);
+            if (option_name == "layout") {
+                if (option_value == "columnar") {
+                    layout = TableLayout::kColumnar;
+                } else if (option_value != "row") {
+                    session->Out() << "layout must be row or columnar." << std::endl;
+                    return DB_FAILED;
+                }
+            } else if (option_name == "encoding") {
+                if (option_value == "dictionary") {
+                    dictionary_encoded = true;
+                } else if (option_value != "none") {
+                    session->Out() << "encoding must be none or dictionary." << std::endl;
+                    return DB_FAILED;
+                }
+            } else {
+                session->Out() << "unknown table option " << option_name << std::endl;
+                return DB_FAILED;
+            }
+        }
+    }
     ptr = ptr->next_->child_;
     std::vector<Column *> columns;
     std::vector<std::string> uni, pri;
+    // The primary key follows the columns, its columns are known to be unique before they are made.
+    for (auto node = ptr; node != nullptr; node = node->next_) {
+        if (node->type_ == kNodeColumnList) {
+            for (auto pri_key_node = node->child_; pri_key_node != nullptr; pri_key_node = pri_key_node->next_) {
+                pri.emplace_back(pri_key_node->val_);
+            }
+        }
+    }
     string column_name, column_type;
     TypeId type;
     uint32_t column_length = 4;
@@ -409,15 +722,15 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
                 type = kTypeChar;
                 column_length = atoi(ptr->child_->next_->child_->val_);
                 if (column_length <= 0 || strchr(ptr->child_->next_->child_->val_, '.') != nullptr) {
-                    std::cout << "char invalid" << std::endl;
+                    session->Out() << "char invalid" << std::endl;
                     return DB_FAILED;
                 }
             } else {
                 type = kTypeInvalid;
-                cout << "type invalid" << std::endl;
+                session->Out() << "type invalid" << std::endl;
                 return DB_FAILED;
             }
-            bool unique = ptr->val_ != nullptr;
+            bool unique = ptr->val_ != nullptr || std::find(pri.begin(), pri.end(), column_name) != pri.end();
             if (unique) uni.push_back(column_name);
             Column *column_ptr;
             if (type == kTypeInt || type == kTypeFloat)
@@ -425,49 +738,55 @@ dberr_t ExecuteEngine::ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *conte
             else
                 column_ptr = new Column(column_name, type, column_length, i, false, unique);
             columns.push_back(column_ptr);
-        } else if (ptr->type_ == kNodeColumnList) {
-            pSyntaxNode pri_key_node = ptr->child_;
-            while (pri_key_node) {
-                string pri_name(pri_key_node->val_);
-                pri.push_back(pri_name);
-                uni.push_back(pri_name);
-                pri_key_node = pri_key_node->next_;
-            }
         }
     }
     auto *schema = new Schema(columns);
+    if (layout == TableLayout::kColumnar && TablePage::GetColumnarCapacity(schema) == 0) {
+        session->Out() << "a row of " << table_name << " does not fit a columnar page" << std::endl;
+        delete schema;
+        return DB_FAILED;
+    }
     TableInfo *table_info = nullptr;
-    auto mgr = dbs_[current_db_]->catalog_mgr_;
-    bool create = mgr->CreateTable(table_name, schema, nullptr, table_info);
-    if (!create) return DB_FAILED;
+    auto mgr = GetDatabase(session->current_db_)->catalog_mgr_;
+    dberr_t created = mgr->CreateTable(table_name, schema, nullptr, table_info, layout, dictionary_encoded);
+    delete schema;
+    if (created != DB_SUCCESS) return DB_FAILED;
     //table_info->SetPrimaryKey(pri);
     //table_info->SetUniqueKey(uni);
     table_info->table_meta_->primary_key_name = pri;
     table_info->table_meta_->unique_key_name = uni;
-    cout << "Create table success" << endl;
+    session->Out() << "Create table success" << endl;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteDropTable" << std::endl;
 #endif
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
     if (ast->child_ == nullptr) return DB_FAILED;
     string drop_table_name(ast->child_->val_);
-    return dbs_[current_db_]->catalog_mgr_->DropTable(drop_table_name);
+    return GetDatabase(session->current_db_)->catalog_mgr_->DropTable(drop_table_name);
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteShowIndexes" << std::endl;
 #endif
-    auto cata_manager = dbs_[current_db_]->catalog_mgr_;
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
+    auto cata_manager = GetDatabase(session->current_db_)->catalog_mgr_;
     std::vector<TableInfo *> table_infos;
     auto res = cata_manager->GetTables(table_infos);
     if (res != DB_SUCCESS) {
@@ -481,7 +800,7 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
             return res;
         }
         for (auto idx : idx_list) {
-            std::cout << idx->GetIndexName() << std::endl;
+            session->Out() << idx->GetIndexName() << std::endl;
         }
     }
     return DB_SUCCESS;
@@ -490,16 +809,29 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteCreateIndex" << std::endl;
 #endif
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
     auto idx_node = ast->child_;
-    auto cata_manager = dbs_[current_db_]->catalog_mgr_;
+    auto cata_manager = GetDatabase(session->current_db_)->catalog_mgr_;
     string idx_name = idx_node->val_;
     auto table_node = idx_node->next_;
     string table_name = table_node->val_;
     auto keys_node = table_node->next_;
+    // USING bptree | hash follows the key columns, a B+ tree if none
+    string index_type = "bptree";
+    if (keys_node != nullptr && keys_node->next_ != nullptr && keys_node->next_->type_ == kNodeIndexType) {
+        index_type = keys_node->next_->child_->val_;
+        if (!IndexInfo::IsIndexType(index_type)) {
+            session->Out() << "unknown index type " << index_type << std::endl;
+            return DB_FAILED;
+        }
+    }
 
     TableInfo *table_info;
     auto res = cata_manager->GetTable(table_name, table_info);
@@ -512,22 +844,24 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
         for (keys_node = keys_node->child_; keys_node != nullptr; keys_node = keys_node->next_) {
             col_names.emplace_back(keys_node->val_);
         }
+        // The unique key names are not stored, after a restart the columns tell.
         bool flag = false;
-        for (const auto &iter1 : uni) {
-            for (const auto &iter2 : col_names) {
-                if (iter1 == iter2) {
-                    flag = true;
-                    break;
-                }
+        for (const auto &iter2 : col_names) {
+            uint32_t column_index;
+            if (std::find(uni.begin(), uni.end(), iter2) != uni.end() ||
+                (table_info->GetSchema()->GetColumnIndex(iter2, column_index) == DB_SUCCESS &&
+                 table_info->GetSchema()->GetColumn(column_index)->IsUnique())) {
+                flag = true;
+                break;
             }
         }
         if (!flag) {
-            cout << "not unique" << endl;
+            session->Out() << "not unique" << endl;
             return DB_FAILED;
         }
     }
     IndexInfo *index_info;
-    res = cata_manager->CreateIndex(table_name, idx_name, col_names, nullptr, index_info, "bptree");
+    res = cata_manager->CreateIndex(table_name, idx_name, col_names, nullptr, index_info, index_type);
     if (res != DB_SUCCESS) return DB_FAILED;
     return DB_SUCCESS;
 }
@@ -535,13 +869,17 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteDropIndex" << std::endl;
 #endif
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
     auto idx_node = ast->child_;
     string idx_name = idx_node->val_;
-    auto cata_manager = dbs_[current_db_]->catalog_mgr_;
+    auto cata_manager = GetDatabase(session->current_db_)->catalog_mgr_;
     std::vector<TableInfo *> table_infos;
     auto res = cata_manager->GetTables(table_infos);
     if (res != DB_SUCCESS) {
@@ -556,94 +894,404 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
         }
         for (auto index_info : index_infos) {
             if (index_info->GetIndexName() == idx_name) {
-                res = cata_manager->DropIndex(table_info->GetTableName(), idx_name);
-                if (res != DB_SUCCESS) {
-                    return res;
-                }
+                return cata_manager->DropIndex(table_name, idx_name);
             }
-            return DB_SUCCESS;
         }
     }
+    return DB_INDEX_NOT_FOUND;
 }
 
 
-dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteTrxBegin" << std::endl;
 #endif
-    return DB_FAILED;
+    if (GetDatabase(session->current_db_) == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
+    if (session->current_txn_ != nullptr) {
+        session->Out() << "Transaction already started." << std::endl;
+        return DB_FAILED;
+    }
+    session->current_txn_ = GetDatabase(session->current_db_)->txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+    return DB_SUCCESS;
 }
 
-dberr_t ExecuteEngine::ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteTrxCommit" << std::endl;
 #endif
-    return DB_FAILED;
+    if (session->current_txn_ == nullptr) {
+        session->Out() << "No transaction started." << std::endl;
+        return DB_FAILED;
+    }
+    GetDatabase(session->current_db_)->txn_mgr_->Commit(session->current_txn_);
+    session->current_txn_ = nullptr;
+    return DB_SUCCESS;
 }
 
-dberr_t ExecuteEngine::ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteTrxRollback" << std::endl;
 #endif
-    return DB_FAILED;
+    if (session->current_txn_ == nullptr) {
+        session->Out() << "No transaction started." << std::endl;
+        return DB_FAILED;
+    }
+    GetDatabase(session->current_db_)->txn_mgr_->Abort(session->current_txn_);
+    session->current_txn_ = nullptr;
+    return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context, Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteExecfile" << std::endl;
 #endif
     std::ifstream ist;
     std::string file_name=ast->child_->val_;
     ist.open(file_name);
-    const int maxsize=1024;
-    char cmd[maxsize];
-    // for print syntax tree
-    // TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
-    uint32_t syntax_tree_id = 0;
+    std::string cmd;
     clock_t Ts=clock();
-    for(int i=1;ist.getline(cmd,maxsize);i++)
+    for(int i=1;std::getline(ist,cmd);i++)
     {
-        cout<<file_name<<" line "<<i<<": "<<cmd<<'\n';
-        YY_BUFFER_STATE bp = yy_scan_string(cmd);
-        if (bp == nullptr) {
-            LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
-            exit(1);
-        }
-        yy_switch_to_buffer(bp);
-        // init parser module
-        MinisqlParserInit();
-        // parse
-        yyparse();
+        session->Out()<<file_name<<" line "<<i<<": "<<cmd<<'\n';
+        auto statement = ParsedStatement::Parse(cmd);
         // parse result handle
-        if (MinisqlParserGetError()) {
+        if (statement->HasError()) {
             // error
-            printf("%s\n", MinisqlParserGetErrorMessage());
+            session->Out() << statement->GetErrorMessage() << std::endl;
         } else {
-            // Comment them out if you don't need to debug the syntax tree
-            printf("[INFO] Sql syntax parse ok!\n");
-            // SyntaxTreePrinter printer(MinisqlGetParserRootNode());
-            // printer.PrintTree(syntax_tree_file_mgr[syntax_tree_id++]);
+            session->Out() << "[INFO] Sql syntax parse ok!" << std::endl;
         }
-        auto result = this->Execute(MinisqlGetParserRootNode());
-        // clean memory after parse
-        MinisqlParserFinish();
-        yy_delete_buffer(bp);
-        yylex_destroy();
+        auto result = this->Execute(*statement, session);
+        ExecuteInformation(result, session);
     }
     clock_t Tt=clock();
-    cout<<"Query OK, "<< "(" <<(double)(Tt-Ts)/CLOCKS_PER_SEC<<"sec)"<<endl;
+    session->Out()<<"Query OK, "<< "(" <<(double)(Tt-Ts)/CLOCKS_PER_SEC<<"sec)"<<endl;
     return DB_SUCCESS;
 }
 
 /**
  * TODO: Student Implement
  */
-dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
+dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context, [[maybe_unused]] Session *session) {
 #ifdef ENABLE_EXECUTE_DEBUG
     LOG(INFO) << "ExecuteQuit" << std::endl;
 #endif
     return DB_QUIT;
 }
+
+std::unique_ptr<CachedPlan> ExecuteEngine::MakeCachedPlan(const std::string &sql, ExecuteContext *context,
+                                                          Session *session) {
+    auto statement = ParsedStatement::Parse(sql);
+    if (statement->HasError()) {
+        session->Out() << statement->GetErrorMessage() << std::endl;
+        return nullptr;
+    }
+    switch (statement->GetRoot()->type_) {
+        case kNodeSelect:
+        case kNodeInsert:
+        case kNodeDelete:
+        case kNodeUpdate:
+            break;
+        default:
+            session->Out() << "Only select, insert, delete and update can be prepared." << std::endl;
+            return nullptr;
+    }
+    auto cached = std::make_unique<CachedPlan>();
+    cached->version_ = context->GetCatalog()->GetVersion();
+    Planner planner(context);
+    try {
+        planner.PlanQuery(statement->GetRoot());
+    } catch (const exception &ex) {
+        session->Out() << "Error Encountered in Planner: " << ex.what() << std::endl;
+        return nullptr;
+    }
+    cached->plan_ = planner.plan_;
+    cached->params_ = planner.params_;
+    return cached;
+}
+
+dberr_t ExecuteEngine::ExecutePrepare(pSyntaxNode ast, ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecutePrepare" << std::endl;
+#endif
+    if (context == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
+    std::string name = ast->child_->val_;
+    // The statement is quoted, characters escaped by a backslash are taken as they are.
+    std::string sql;
+    for (const char *p = ast->child_->next_->val_; *p != '\0'; p++) {
+        if (*p == '\\' && *(p + 1) != '\0') p++;
+        sql.push_back(*p);
+    }
+    sql = PlanCache::Normalize(sql);
+    if (sql.empty() || sql.back() != ';') {
+        sql.push_back(';');
+    }
+    // The statement is planned once to check it, the plan is kept for its first execution.
+    auto cached = MakeCachedPlan(sql, context, session);
+    if (cached == nullptr) {
+        return DB_FAILED;
+    }
+    GetDatabase(session->current_db_)->plan_cache_->Release(sql, std::move(cached));
+    session->prepared_[name] = sql;
+    session->Out() << "Statement prepared." << std::endl;
+    return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecutePrepared(pSyntaxNode ast, ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecutePrepared" << std::endl;
+#endif
+    auto start_time = std::chrono::steady_clock::now();
+    if (context == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
+    std::string name = ast->child_->val_;
+    auto it = session->prepared_.find(name);
+    if (it == session->prepared_.end()) {
+        session->Out() << "Prepared statement " << name << " not exists." << std::endl;
+        return DB_FAILED;
+    }
+    const std::string &sql = it->second;
+    auto db = GetDatabase(session->current_db_);
+    auto plan_cache = db->plan_cache_;
+    std::unique_ptr<CachedPlan> cached;
+    {
+        PhaseTimer timer(session->profile_, &StatementProfile::plan_);
+        // Another session may be running the cached plan, or the catalog changed since it was made.
+        cached = plan_cache->Acquire(sql, context->GetCatalog()->GetVersion());
+        if (cached == nullptr) {
+            cached = MakeCachedPlan(sql, context, session);
+        }
+    }
+    if (cached == nullptr) {
+        return DB_FAILED;
+    }
+    std::vector<pSyntaxNode> values;
+    if (ast->child_->next_ != nullptr) {
+        for (auto value = ast->child_->next_->child_; value != nullptr; value = value->next_) {
+            values.push_back(value);
+        }
+    }
+    if (values.size() != cached->params_.size()) {
+        session->Out() << "Statement " << name << " takes " << cached->params_.size() << " parameters, "
+                       << values.size() << " given." << std::endl;
+        plan_cache->Release(sql, std::move(cached));
+        return DB_FAILED;
+    }
+    try {
+        for (size_t i = 0; i < values.size(); i++) {
+            auto &param = cached->params_[i];
+            param->Bind(*AbstractStatement::MakeConstantField(param->GetReturnType(), values[i]));
+        }
+    } catch (const exception &ex) {
+        session->Out() << "Error Encountered in Planner: " << ex.what() << std::endl;
+        plan_cache->Release(sql, std::move(cached));
+        return DB_FAILED;
+    }
+    auto result = ExecuteQueryPlan(cached->plan_, db, session, start_time);
+    plan_cache->Release(sql, std::move(cached));
+    return result;
+}
+
+dberr_t ExecuteEngine::ExecuteDeallocate(pSyntaxNode ast, [[maybe_unused]] ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecuteDeallocate" << std::endl;
+#endif
+    std::string name = ast->child_->val_;
+    if (session->prepared_.erase(name) == 0) {
+        session->Out() << "Prepared statement " << name << " not exists." << std::endl;
+        return DB_FAILED;
+    }
+    return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteSet(pSyntaxNode ast, [[maybe_unused]] ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecuteSet" << std::endl;
+#endif
+    std::string name = ast->child_->val_;
+    pSyntaxNode value = ast->child_->next_;
+    if (name == "parallelism") {
+        long degree = value->type_ == kNodeNumber ? strtol(value->val_, nullptr, 10) : 0;
+        if (degree < 1 || degree > static_cast<long>(MAX_PARALLELISM)) {
+            session->Out() << "parallelism must be between 1 and " << MAX_PARALLELISM << "." << std::endl;
+            return DB_FAILED;
+        }
+        session->parallelism_ = degree;
+        return DB_SUCCESS;
+    }
+    if (name == "page_compression") {
+        if (value->type_ != kNodeNumber || (strcmp(value->val_, "0") != 0 && strcmp(value->val_, "1") != 0)) {
+            session->Out() << "page_compression must be 0 or 1." << std::endl;
+            return DB_FAILED;
+        }
+        session->page_compression_ = strcmp(value->val_, "1") == 0;
+        return DB_SUCCESS;
+    }
+    session->Out() << "Unknown setting " << name << "." << std::endl;
+    return DB_FAILED;
+}
+
+dberr_t ExecuteEngine::ExecuteExplain(pSyntaxNode ast, ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecuteExplain" << std::endl;
+#endif
+    auto start_time = std::chrono::steady_clock::now();
+    if (context == nullptr) {
+        session->Out() << "No database selected." << std::endl;
+        return DB_FAILED;
+    }
+    Planner planner(context);
+    try {
+        PhaseTimer timer(session->profile_, &StatementProfile::plan_);
+        planner.PlanQuery(ast->child_);
+    } catch (const exception &ex) {
+        session->Out() << "Error Encountered in Planner: " << ex.what() << std::endl;
+        return DB_FAILED;
+    }
+    if (!planner.params_.empty()) {
+        session->Out() << "Parameters are only allowed in prepared statements." << std::endl;
+        return DB_FAILED;
+    }
+    auto db = GetDatabase(session->current_db_);
+    // With ANALYZE the statement runs, its changes are kept like those of the statement itself.
+    if (ast->val_ != nullptr && strcmp(ast->val_, "analyze") == 0) {
+        return ExecuteQueryPlan(planner.plan_, db, session, start_time, true);
+    }
+    auto explain_context = db->MakeExecuteContext(session->current_txn_);
+    if (IsReadOnly(planner.plan_)) {
+        explain_context->SetParallelism(session->parallelism_, &scan_pool_);
+    }
+    PlanPrinter(explain_context.get()).Print(planner.plan_.get(), session->Out());
+    return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteShowStatus(pSyntaxNode ast, ExecuteContext *context, Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecuteShowStatus" << std::endl;
+#endif
+    std::string name = ast->child_->val_;
+    if (name == "statements") {
+        return ExecuteShowStatements(ast, context, session);
+    }
+    if (name != "status") {
+        session->Out() << "Unknown statement show " << name << "." << std::endl;
+        return DB_FAILED;
+    }
+    const auto &pool = buffer_pool_.GetCounters();
+    auto &io = DiskManager::GetIoCounters();
+    auto &compression = CompressedPageStore::GetCounters();
+    uint64_t fetches = pool.fetches_;
+    uint64_t hits = pool.hits_;
+    auto average_us = [](const LatencyHistogram &histogram) {
+        uint64_t count = histogram.GetCount();
+        return std::to_string(count == 0 ? 0 : histogram.GetSumNanos() / count / 1000);
+    };
+    auto average_ns = [](uint64_t total_ns, uint64_t count) { return std::to_string(count == 0 ? 0 : total_ns / count); };
+    uint64_t compressed_bytes = compression.bytes_out_;
+    std::vector<std::pair<std::string, std::string>> variables = {
+            {"Buffer_pool_size", std::to_string(buffer_pool_.GetPoolSize())},
+            {"Buffer_pool_cached_pages", std::to_string(buffer_pool_.GetPageCount())},
+            {"Buffer_pool_fetches", std::to_string(fetches)},
+            {"Buffer_pool_hits", std::to_string(hits)},
+            {"Buffer_pool_misses", std::to_string(pool.misses_)},
+            {"Buffer_pool_hit_ratio", std::to_string(fetches == 0 ? 0.0 : static_cast<double>(hits) / fetches)},
+            {"Buffer_pool_evictions", std::to_string(pool.evictions_)},
+            {"Buffer_pool_dirty_writebacks", std::to_string(pool.dirty_writebacks_)},
+            {"Buffer_pool_flushes", std::to_string(pool.flushes_)},
+            {"Buffer_pool_ring_reuses", std::to_string(pool.ring_reuses_)},
+            {"Buffer_pool_prefetches", std::to_string(pool.prefetches_)},
+            {"Disk_reads", std::to_string(io.reads_)},
+            {"Disk_writes", std::to_string(io.writes_)},
+            {"Disk_read_bytes", std::to_string(io.bytes_read_)},
+            {"Disk_written_bytes", std::to_string(io.bytes_written_)},
+            {"Disk_read_latency_avg_us", average_us(io.read_latency_)},
+            {"Disk_read_latency_p99_us", std::to_string(io.read_latency_.GetQuantile(0.99))},
+            {"Disk_write_latency_avg_us", average_us(io.write_latency_)},
+            {"Disk_write_latency_p99_us", std::to_string(io.write_latency_.GetQuantile(0.99))},
+            {"Page_compression_writes", std::to_string(compression.pages_compressed_)},
+            {"Page_compression_ratio",
+             std::to_string(compressed_bytes == 0 ? 0.0 : static_cast<double>(compression.bytes_in_) / compressed_bytes)},
+            {"Page_compress_avg_ns", average_ns(compression.compress_ns_, compression.pages_compressed_)},
+            {"Page_decompress_avg_ns", average_ns(compression.decompress_ns_, compression.pages_decompressed_)},
+            {"Open_databases", std::to_string(dbs_.size())}};
+    std::vector<int> data_width = {static_cast<int>(strlen("Variable_name")), static_cast<int>(strlen("Value"))};
+    for (const auto &variable : variables) {
+        data_width[0] = max(data_width[0], static_cast<int>(variable.first.size()));
+        data_width[1] = max(data_width[1], static_cast<int>(variable.second.size()));
+    }
+    ResultWriter writer(session->Out());
+    writer.Divider(data_width);
+    writer.BeginRow();
+    writer.WriteHeaderCell("Variable_name", data_width[0]);
+    writer.WriteHeaderCell("Value", data_width[1]);
+    writer.EndRow();
+    writer.Divider(data_width);
+    for (const auto &variable : variables) {
+        writer.BeginRow();
+        writer.WriteCell(variable.first, data_width[0]);
+        writer.WriteCell(variable.second, data_width[1]);
+        writer.EndRow();
+    }
+    writer.Divider(data_width);
+    return DB_SUCCESS;
+}
+
+dberr_t ExecuteEngine::ExecuteShowStatements([[maybe_unused]] pSyntaxNode ast, [[maybe_unused]] ExecuteContext *context,
+                                             Session *session) {
+#ifdef ENABLE_EXECUTE_DEBUG
+    LOG(INFO) << "ExecuteShowStatements" << std::endl;
+#endif
+    auto ms = [](double ns) {
+        std::stringstream ss;
+        ss << std::fixed << std::setprecision(3) << ns / 1e6;
+        return ss.str();
+    };
+    std::vector<std::string> header = {"Statement", "Count",    "Avg_ms",     "P50_ms",   "P99_ms",   "Max_ms",
+                                       "Parse_ms",  "Plan_ms",  "Execute_ms", "Format_ms"};
+    std::vector<std::vector<std::string>> rows;
+    statement_stats_.ForEach([&](const std::string &fingerprint, const StatementLatency &latency) {
+        auto count = static_cast<double>(latency.total_.GetCount());
+        rows.push_back({fingerprint, std::to_string(latency.total_.GetCount()),
+                        ms(latency.total_.GetSumNanos() / count), ms(latency.total_.GetQuantile(0.5) * 1e3),
+                        ms(latency.total_.GetQuantile(0.99) * 1e3), ms(latency.total_.GetMaxNanos()),
+                        ms(latency.parse_ns_ / count), ms(latency.plan_ns_ / count), ms(latency.execute_ns_ / count),
+                        ms(latency.format_ns_ / count)});
+    });
+    std::vector<int> data_width;
+    for (const auto &cell : header) {
+        data_width.push_back(static_cast<int>(cell.size()));
+    }
+    for (const auto &row : rows) {
+        for (size_t i = 0; i < row.size(); i++) {
+            data_width[i] = max(data_width[i], static_cast<int>(row[i].size()));
+        }
+    }
+    ResultWriter writer(session->Out());
+    writer.Divider(data_width);
+    writer.BeginRow();
+    for (size_t i = 0; i < header.size(); i++) {
+        writer.WriteHeaderCell(header[i], data_width[i]);
+    }
+    writer.EndRow();
+    writer.Divider(data_width);
+    for (const auto &row : rows) {
+        writer.BeginRow();
+        for (size_t i = 0; i < row.size(); i++) {
+            writer.WriteCell(row[i], data_width[i]);
+        }
+        writer.EndRow();
+    }
+    writer.Divider(data_width);
+    return DB_SUCCESS;
+}
@@ -0,0 +1,111 @@
+#include "executor/executors/gather_executor.h"
+
+GatherExecutor::GatherExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+GatherExecutor::~GatherExecutor() {
+  std::unique_lock<std::mutex> lock(latch_);
+  cancelled_ = true;
+  cv_.notify_all();
+  // The workers refer to this executor until they finish.
+  cv_.wait(lock, [this] { return running_ == 0; });
+  lock.unlock();
+  ChargeWorkerStats();
+}
+
+bool GatherExecutor::IsParallel(ExecuteContext *exec_ctx) {
+  // Parallel workers take no locks, only snapshot reads can share the scan.
+  auto txn = exec_ctx->GetTransaction();
+  return exec_ctx->GetParallelism() > 1 && (txn == nullptr || txn->IsSnapshotRead());
+}
+
+void GatherExecutor::Init() {
+  TableInfo *table_info = nullptr;
+  exec_ctx_->GetCatalog()->GetTable(plan_->GetTableName(), table_info);
+  {
+    BufferAccessScope scope(&strategy_);
+    morsels_ = std::make_unique<MorselQueue>(table_info->GetTableHeap()->GetPageIds());
+  }
+  worker_count_ = std::min(exec_ctx_->GetParallelism(), morsels_->GetMorselCount());
+  running_ = worker_count_;
+  for (size_t i = 0; i < worker_count_; i++) {
+    exec_ctx_->GetThreadPool()->Submit([this] { RunWorker(); });
+  }
+}
+
+bool GatherExecutor::Next(Row *row, RowId *rid) {
+  while (cursor_ == batch_.size()) {
+    std::unique_lock<std::mutex> lock(latch_);
+    cv_.wait(lock, [this] { return !batches_.empty() || running_ == 0 || error_ != nullptr; });
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+    if (batches_.empty()) {
+      lock.unlock();
+      ChargeWorkerStats();
+      return false;
+    }
+    batch_ = std::move(batches_.front());
+    batches_.pop_front();
+    cursor_ = 0;
+    cv_.notify_all();
+  }
+  *row = batch_[cursor_].first;
+  *rid = batch_[cursor_].second;
+  cursor_++;
+  return true;
+}
+
+void GatherExecutor::RunWorker() {
+  BufferPoolStats start_stats = BufferPool::GetThreadStats();
+  try {
+    SeqScanExecutor scan(exec_ctx_, plan_, morsels_.get(), &strategy_);
+    scan.Init();
+    Batch batch;
+    batch.reserve(GATHER_BATCH_SIZE);
+    Row row;
+    RowId rid;
+    bool more = true;
+    while (more) {
+      more = scan.Next(&row, &rid);
+      if (more) {
+        batch.emplace_back(row, rid);
+      }
+      if (batch.size() == GATHER_BATCH_SIZE || (!more && !batch.empty())) {
+        if (!Push(std::move(batch))) {
+          break;
+        }
+        batch = Batch();
+        batch.reserve(GATHER_BATCH_SIZE);
+      }
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+    cancelled_ = true;
+  }
+  std::lock_guard<std::mutex> guard(latch_);
+  worker_stats_ += BufferPool::GetThreadStats() - start_stats;
+  running_--;
+  cv_.notify_all();
+}
+
+void GatherExecutor::ChargeWorkerStats() {
+  std::lock_guard<std::mutex> guard(latch_);
+  BufferPool::GetThreadStats() += worker_stats_;
+  worker_stats_ = BufferPoolStats();
+}
+
+bool GatherExecutor::Push(Batch &&batch) {
+  std::unique_lock<std::mutex> lock(latch_);
+  // A few batches per worker keep the workers busy while the consumer catches up.
+  cv_.wait(lock, [this] { return cancelled_ || batches_.size() < 2 * worker_count_; });
+  if (cancelled_) {
+    return false;
+  }
+  batches_.emplace_back(std::move(batch));
+  cv_.notify_all();
+  return true;
+}
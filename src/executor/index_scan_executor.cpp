@@ -59,17 +59,22 @@ void IndexScanExecutor::Init() {
 bool IndexScanExecutor::Next(Row *row, RowId *rid) {
     // cerr<<"IndexScanExecutor Next\n";
     // cerr<<(itr-RowSet.begin())<<'\n';
-    if(itr==RowSet.end()) return false;
+    auto txn=exec_ctx_->GetTransaction();
     if(!plan_->need_filter_)
     {
         // cerr<<"IndexScanExecutor Next not need filter\n";
-        *rid=*itr;
-        // cerr<<"IndexScanExecutor Next after1\n";
-        Row new_row(*rid),res_row;
-        // cerr<<"IndexScanExecutor Next after2\n";
-        assert(table_info!=nullptr);
-        // cerr<<"IndexScanExecutor Next row "<<row->GetRowId().GetPageId()<<' '<<row->GetRowId().GetSlotNum()<<'\n';
-        table_info->GetTableHeap()->GetTuple(&new_row,exec_ctx_->GetTransaction());
+        Row new_row,res_row;
+        do
+        {
+            if(itr==RowSet.end()) return false;
+            *rid=*itr;
+            new_row=Row(*rid);
+            assert(table_info!=nullptr);
+            // the row is skipped if it was deleted after the index was scanned, or if the entry is one of an old key
+            if(table_info->GetTableHeap()->GetTuple(&new_row,txn) && MatchPredicate(&new_row)) break;
+            if(txn!=nullptr) txn->ThrowIfAborted();
+            itr++;
+        }while(true);
         new_row.GetKeyFromRow(table_info->GetSchema(),plan_->OutputSchema(),res_row);
         // cerr<<"IndexScanExecutor Next after3\n";
         itr++;
@@ -86,7 +91,12 @@ bool IndexScanExecutor::Next(Row *row, RowId *rid) {
             *rid=*itr;
             // row->SetRowId(*rid);
             Row new_row(*rid),res_row;
-            table_info->GetTableHeap()->GetTuple(&new_row,exec_ctx_->GetTransaction());
+            if(!table_info->GetTableHeap()->GetTuple(&new_row,txn) || !MatchPredicate(&new_row))
+            {
+                if(txn!=nullptr) txn->ThrowIfAborted();
+                itr++;
+                continue;
+            }
             new_row.GetKeyFromRow(table_info->GetSchema(),plan_->OutputSchema(),res_row);
             for(auto it:need_seq)//check every predicate which has no index
             {
@@ -107,6 +117,10 @@ bool IndexScanExecutor::Next(Row *row, RowId *rid) {
     }
 }
 
+bool IndexScanExecutor::MatchPredicate(Row *row) {
+    return plan_->filter_predicate_==nullptr || plan_->filter_predicate_->Evaluate(row).CompareEquals(Field(kTypeInt, 1))==kTrue;
+}
+
 void IndexScanExecutor::getPredicate(std::vector<single_predicate>& pred,AbstractExpression* exp)
 {
     LogicExpression* loc=dynamic_cast<LogicExpression*>(exp);
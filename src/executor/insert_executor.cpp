@@ -17,14 +17,73 @@ void InsertExecutor::Init() {
 }
 
 bool InsertExecutor::Next(Row *row, RowId *rid) {
-    if(child_executor_->Next(row, rid)){
-        if(!table_info_->GetTableHeap()->InsertTuple(*row, exec_ctx_->GetTransaction())) return false;
-        for(auto& index_info: table_indexes_){
-            Row key;
-            row->GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), key);
-            index_info->GetIndex()->InsertEntry(key, *rid, exec_ctx_->GetTransaction());
+    if(cursor_ == batch_.size() && !InsertBatch()){
+        return false;
+    }
+    *row = batch_[cursor_++];
+    *rid = row->GetRowId();
+    return true;
+}
+
+bool InsertExecutor::InsertBatch() {
+    batch_.clear();
+    cursor_ = 0;
+    Row next_row;
+    RowId next_rid;
+    while(batch_.size() < INSERT_BATCH_SIZE && child_executor_->Next(&next_row, &next_rid)){
+        batch_.emplace_back(next_row);
+    }
+    if(batch_.empty()){
+        return false;
+    }
+    auto txn = exec_ctx_->GetTransaction();
+    if(!table_info_->GetTableHeap()->InsertTuples(batch_, txn)) {
+        if(txn != nullptr) txn->ThrowIfAborted();
+        batch_.clear();
+        return false;
+    }
+    std::vector<RowId> rids;
+    rids.reserve(batch_.size());
+    for(auto &inserted_row: batch_){
+        rids.push_back(inserted_row.GetRowId());
+    }
+    // Each index takes the keys of the whole batch at once, it may sort them to insert them in one pass.
+    // Without a transaction the entries inserted are remembered here, a violation undoes them.
+    std::deque<IndexWriteRecord> undo_entries;
+    for(auto& index_info: table_indexes_){
+        std::vector<Row> keys(batch_.size());
+        for(size_t i = 0; i < batch_.size(); i++){
+            batch_[i].GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), keys[i]);
+        }
+        auto index = index_info->GetIndex();
+        std::vector<bool> inserted;
+        index->InsertEntries(keys, rids, txn, inserted);
+        bool violated = false;
+        for(size_t i = 0; i < keys.size(); i++){
+            bool replaced = !inserted[i] && txn != nullptr &&
+                            table_info_->GetTableHeap()->ReplaceStaleEntry(index, keys[i], rids[i], txn);
+            if(inserted[i] || replaced){
+                auto write_set = txn != nullptr ? txn->GetIndexWriteSet() : &undo_entries;
+                write_set->emplace_back(rids[i], WType::kInsert, keys[i], index);
+            } else {
+                violated = true;
+            }
+        }
+        if(violated){
+            // The transaction undoes the rows and entries of the statement when it is aborted.
+            if(txn == nullptr) UndoBatch(undo_entries, rids);
+            batch_.clear();
+            throw std::logic_error("Duplicate key in unique index " + index_info->GetIndexName() + ".");
         }
-        return true;
     }
-    return false;
-}
\ No newline at end of file
+    return true;
+}
+
+void InsertExecutor::UndoBatch(const std::deque<IndexWriteRecord> &entries, const std::vector<RowId> &rids) {
+    for(auto &entry: entries){
+        entry.index_->RemoveEntry(entry.key_, entry.rid_, nullptr);
+    }
+    for(auto &rid: rids){
+        table_info_->GetTableHeap()->ApplyDelete(rid, nullptr);
+    }
+}
@@ -0,0 +1,72 @@
+#include "executor/plan_cache.h"
+
+#include <algorithm>
+#include <cctype>
+
+std::unique_ptr<CachedPlan> PlanCache::Acquire(const std::string &sql, uint64_t version) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = entries_.find(sql);
+  if (it == entries_.end()) {
+    misses_++;
+    return nullptr;
+  }
+  auto &idle = it->second.idle_;
+  idle.erase(std::remove_if(idle.begin(), idle.end(), [version](const auto &plan) { return plan->version_ != version; }),
+             idle.end());
+  lru_.splice(lru_.begin(), lru_, it->second.lru_pos_);
+  if (idle.empty()) {
+    misses_++;
+    return nullptr;
+  }
+  hits_++;
+  auto plan = std::move(idle.back());
+  idle.pop_back();
+  return plan;
+}
+
+void PlanCache::Release(const std::string &sql, std::unique_ptr<CachedPlan> plan) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = entries_.find(sql);
+  if (it == entries_.end()) {
+    lru_.push_front(sql);
+    it = entries_.emplace(sql, Entry()).first;
+    it->second.lru_pos_ = lru_.begin();
+    while (entries_.size() > capacity_) {
+      entries_.erase(lru_.back());
+      lru_.pop_back();
+    }
+  }
+  it->second.idle_.push_back(std::move(plan));
+}
+
+size_t PlanCache::GetPlanCount() {
+  std::lock_guard<std::mutex> guard(latch_);
+  size_t count = 0;
+  for (auto &entry : entries_) {
+    count += entry.second.idle_.size();
+  }
+  return count;
+}
+
+std::string PlanCache::Normalize(const std::string &sql) {
+  std::string result;
+  char quote = 0;
+  bool space = false;
+  for (char ch : sql) {
+    if (quote == 0 && std::isspace(static_cast<unsigned char>(ch))) {
+      space = !result.empty();
+      continue;
+    }
+    if (space) {
+      result.push_back(' ');
+      space = false;
+    }
+    if (quote != 0 && ch == quote) {
+      quote = 0;
+    } else if (quote == 0 && (ch == '"' || ch == '\'')) {
+      quote = ch;
+    }
+    result.push_back(ch);
+  }
+  return result;
+}
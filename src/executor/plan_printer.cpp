@@ -0,0 +1,148 @@
+#include "executor/plan_printer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "executor/executors/gather_executor.h"
+#include "executor/plans/delete_plan.h"
+#include "executor/plans/index_scan_plan.h"
+#include "executor/plans/insert_plan.h"
+#include "executor/plans/seq_scan_plan.h"
+#include "executor/plans/update_plan.h"
+#include "executor/plans/values_plan.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+#include "planner/expressions/parameter_value_expression.h"
+
+void PlanPrinter::Print(const AbstractPlanNode *plan, std::ostream &out) { PrintNode(plan, 0, out); }
+
+void PlanPrinter::PrintNode(const AbstractPlanNode *plan, int depth, std::ostream &out) {
+  auto indent = [&out](int depth) { out << (depth == 0 ? "" : std::string(depth * 4 - 4, ' ') + "  -> "); };
+  if (plan->GetType() == PlanType::SeqScan && GatherExecutor::IsParallel(exec_ctx_)) {
+    // The workers run the scan, their work is counted by the Gather executor.
+    indent(depth);
+    out << "Gather (workers: " << exec_ctx_->GetParallelism() << ")" << DescribeStats(plan) << std::endl;
+    indent(depth + 1);
+    out << Describe(plan) << std::endl;
+    return;
+  }
+  indent(depth);
+  out << Describe(plan) << DescribeStats(plan) << std::endl;
+  for (const auto &child : plan->GetChildren()) {
+    PrintNode(child.get(), depth + 1, out);
+  }
+}
+
+std::string PlanPrinter::Describe(const AbstractPlanNode *plan) {
+  switch (plan->GetType()) {
+    case PlanType::SeqScan: {
+      auto scan_plan = dynamic_cast<const SeqScanPlanNode *>(plan);
+      std::string line = "SeqScan on " + scan_plan->GetTableName();
+      if (scan_plan->GetPredicate() != nullptr) {
+        line += " (filter: " +
+                DescribeExpression(scan_plan->GetPredicate(), GetTableSchema(scan_plan->GetTableName())) + ")";
+      }
+      return line;
+    }
+    case PlanType::IndexScan: {
+      auto scan_plan = dynamic_cast<const IndexScanPlanNode *>(plan);
+      std::string line = "IndexScan on " + scan_plan->GetTableName() + " using ";
+      for (size_t i = 0; i < scan_plan->indexes_.size(); i++) {
+        line += (i == 0 ? "" : ", ") + scan_plan->indexes_[i]->GetIndexName();
+      }
+      if (scan_plan->GetPredicate() != nullptr) {
+        // Without a filter the rows found by the indexes are returned as they are.
+        line += scan_plan->need_filter_ ? " (filter: " : " (index cond: ";
+        line += DescribeExpression(scan_plan->GetPredicate(), GetTableSchema(scan_plan->GetTableName())) + ")";
+      }
+      return line;
+    }
+    case PlanType::Insert:
+      return "Insert on " + dynamic_cast<const InsertPlanNode *>(plan)->GetTableName();
+    case PlanType::Delete:
+      return "Delete on " + dynamic_cast<const DeletePlanNode *>(plan)->GetTableName();
+    case PlanType::Update: {
+      auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan);
+      auto schema = GetTableSchema(update_plan->GetTableName());
+      std::vector<std::pair<uint32_t, AbstractExpressionRef>> attrs(update_plan->GetUpdateAttr().begin(),
+                                                                    update_plan->GetUpdateAttr().end());
+      std::sort(attrs.begin(), attrs.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+      std::string line = "Update on " + update_plan->GetTableName() + " (set: ";
+      for (size_t i = 0; i < attrs.size(); i++) {
+        line += (i == 0 ? "" : ", ") + (schema == nullptr ? "#" + std::to_string(attrs[i].first)
+                                                          : schema->GetColumn(attrs[i].first)->GetName());
+        line += " = " + DescribeExpression(attrs[i].second, schema);
+      }
+      return line + ")";
+    }
+    case PlanType::Values: {
+      auto rows = dynamic_cast<const ValuesPlanNode *>(plan)->GetValues().size();
+      return "Values (" + std::to_string(rows) + (rows == 1 ? " row)" : " rows)");
+    }
+    default:
+      return "Unknown";
+  }
+}
+
+std::string PlanPrinter::DescribeStats(const AbstractPlanNode *plan) {
+  if (!exec_ctx_->HasExecutorStats(plan)) {
+    return "";
+  }
+  auto &stats = exec_ctx_->GetExecutorStats(plan);
+  char time[32];
+  snprintf(time, sizeof(time), "%.3f", std::chrono::duration<double, std::milli>(stats.time_).count());
+  return std::string(" (actual rows=") + std::to_string(stats.rows_) + " time=" + time +
+         " ms, buffers: hit=" + std::to_string(stats.buffer_.hits_) + " miss=" + std::to_string(stats.buffer_.misses_) +
+         " read=" + std::to_string(stats.buffer_.pages_read_) +
+         " written=" + std::to_string(stats.buffer_.pages_written_) + ")";
+}
+
+std::string PlanPrinter::DescribeExpression(const AbstractExpressionRef &expr, const Schema *schema) {
+  switch (expr->GetType()) {
+    case ExpressionType::ColumnExpression: {
+      auto col_idx = std::dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx();
+      if (schema == nullptr || col_idx >= schema->GetColumnCount()) {
+        return "#" + std::to_string(col_idx);
+      }
+      return schema->GetColumn(col_idx)->GetName();
+    }
+    case ExpressionType::ConstantExpression: {
+      Field val(std::dynamic_pointer_cast<ConstantValueExpression>(expr)->val_);
+      if (val.IsNull()) {
+        return "null";
+      }
+      return val.GetTypeId() == TypeId::kTypeChar ? "\"" + val.toString() + "\"" : val.toString();
+    }
+    case ExpressionType::ParameterExpression:
+      return "?" + std::to_string(std::dynamic_pointer_cast<ParameterValueExpression>(expr)->GetParamIdx() + 1);
+    case ExpressionType::ComparisonExpression: {
+      auto comp_type = std::dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType();
+      auto lhs = DescribeExpression(expr->GetChildAt(0), schema);
+      if (comp_type == "is") {
+        return lhs + " is null";
+      }
+      if (comp_type == "not") {
+        return lhs + " is not null";
+      }
+      return lhs + " " + comp_type + " " + DescribeExpression(expr->GetChildAt(1), schema);
+    }
+    case ExpressionType::LogicExpression: {
+      auto logic_type = std::dynamic_pointer_cast<LogicExpression>(expr)->logic_type_;
+      return "(" + DescribeExpression(expr->GetChildAt(0), schema) + (logic_type == LogicType::And ? " and " : " or ") +
+             DescribeExpression(expr->GetChildAt(1), schema) + ")";
+    }
+    default:
+      return "?";
+  }
+}
+
+const Schema *PlanPrinter::GetTableSchema(const std::string &table_name) {
+  TableInfo *table_info = nullptr;
+  if (exec_ctx_->GetCatalog()->GetTable(table_name, table_info) != DB_SUCCESS) {
+    return nullptr;
+  }
+  return table_info->GetSchema();
+}
@@ -3,6 +3,40 @@
 //
 #include "executor/executors/seq_scan_executor.h"
 
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+#include "planner/expressions/logic_expression.h"
+
+/** Append the indexes of the columns expr reads to column_ids */
+static void CollectColumns(const AbstractExpressionRef &expr, std::vector<uint32_t> *column_ids) {
+    if(expr->GetType() == ExpressionType::ColumnExpression) {
+        column_ids->push_back(std::dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx());
+    }
+    for(auto &child : expr->GetChildren()) CollectColumns(child, column_ids);
+}
+
+/** Rewrite expr to read each column at its position in a row made of some of the columns */
+static AbstractExpressionRef ProjectExpression(const AbstractExpressionRef &expr,
+                                               const std::unordered_map<uint32_t, uint32_t> &positions) {
+    switch(expr->GetType()) {
+        case ExpressionType::ColumnExpression: {
+            uint32_t column_id = std::dynamic_pointer_cast<ColumnValueExpression>(expr)->GetColIdx();
+            return std::make_shared<ColumnValueExpression>(0, positions.at(column_id), expr->GetReturnType());
+        }
+        case ExpressionType::ComparisonExpression:
+            return std::make_shared<ComparisonExpression>(
+                ProjectExpression(expr->GetChildAt(0), positions), ProjectExpression(expr->GetChildAt(1), positions),
+                std::dynamic_pointer_cast<ComparisonExpression>(expr)->GetComparisonType());
+        case ExpressionType::LogicExpression:
+            return std::make_shared<LogicExpression>(
+                ProjectExpression(expr->GetChildAt(0), positions), ProjectExpression(expr->GetChildAt(1), positions),
+                std::dynamic_pointer_cast<LogicExpression>(expr)->logic_type_);
+        default:
+            return expr;
+    }
+}
+
 /**
 * TODO: Student Implement
 */
@@ -13,22 +47,141 @@ SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode
     table_info_ = temp;
 }
 
-void SeqScanExecutor::Init() { table_iter_ = table_info_->GetTableHeap()->Begin(exec_ctx_->GetTransaction()); }
+SeqScanExecutor::SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan, MorselQueue *morsels,
+                                 BufferAccessStrategy *strategy)
+        : SeqScanExecutor(exec_ctx, plan) {
+    morsels_ = morsels;
+    strategy_ = strategy;
+}
+
+void SeqScanExecutor::Init() {
+    BufferAccessScope scope(strategy_);
+    auto table_heap = table_info_->GetTableHeap();
+    if(table_heap->GetDictionary() != nullptr && plan_->GetPredicate() != nullptr) {
+        code_predicate_ = EncodePredicate(plan_->GetPredicate());
+    }
+    // a scan which takes no locks reads a page at a time as the workers of a parallel scan do
+    if(morsels_ == nullptr || own_morsels_ != nullptr) {
+        auto txn = exec_ctx_->GetTransaction();
+        if(txn != nullptr && !txn->IsSnapshotRead()) {
+            table_iter_ = table_heap->Begin(txn, code_predicate_ == nullptr);
+            return;
+        }
+        own_morsels_ = std::make_unique<MorselQueue>(table_heap->GetPageIds());
+        morsels_ = own_morsels_.get();
+        page_cursor_ = page_end_ = 0;
+    }
+    page_columns_.clear();
+    page_rids_.clear();
+    row_cursor_ = 0;
+    InitProjection();
+}
+
+void SeqScanExecutor::InitProjection() {
+    std::vector<uint32_t> output_columns;
+    for(auto &col : plan_->OutputSchema()->GetColumns()) {
+        uint32_t idx;
+        table_info_->GetSchema()->GetColumnIndex(col->GetName(), idx);
+        output_columns.push_back(idx);
+    }
+    auto predicate = code_predicate_ != nullptr ? code_predicate_ : plan_->GetPredicate();
+    scan_columns_ = output_columns;
+    if(predicate != nullptr) CollectColumns(predicate, &scan_columns_);
+    std::sort(scan_columns_.begin(), scan_columns_.end());
+    scan_columns_.erase(std::unique(scan_columns_.begin(), scan_columns_.end()), scan_columns_.end());
+    std::unordered_map<uint32_t, uint32_t> positions;
+    for(uint32_t i = 0; i < scan_columns_.size(); i++) positions[scan_columns_[i]] = i;
+    scan_predicate_ = predicate != nullptr ? ProjectExpression(predicate, positions) : nullptr;
+    output_positions_.clear();
+    for(auto idx : output_columns) output_positions_.push_back(positions[idx]);
+}
+
+AbstractExpressionRef SeqScanExecutor::EncodePredicate(const AbstractExpressionRef &expr) const {
+    auto table_heap = table_info_->GetTableHeap();
+    if(expr->GetType() == ExpressionType::LogicExpression) {
+        auto logic = std::dynamic_pointer_cast<LogicExpression>(expr);
+        auto left = EncodePredicate(expr->GetChildAt(0)), right = EncodePredicate(expr->GetChildAt(1));
+        if(left == nullptr || right == nullptr) return nullptr;
+        return std::make_shared<LogicExpression>(left, right, logic->logic_type_);
+    }
+    if(expr->GetType() != ExpressionType::ComparisonExpression) return nullptr;
+    auto comparison = std::dynamic_pointer_cast<ComparisonExpression>(expr);
+    // only the comparisons of an encoded column change, it may be on either side
+    AbstractExpressionRef column, other;
+    for(uint32_t i = 0; i < 2; i++) {
+        auto child = expr->GetChildAt(i);
+        if(child->GetType() == ExpressionType::ColumnExpression &&
+           table_heap->IsEncoded(std::dynamic_pointer_cast<ColumnValueExpression>(child)->GetColIdx())) {
+            if(column != nullptr) return nullptr;
+            column = child;
+            other = expr->GetChildAt(1 - i);
+        }
+    }
+    if(column == nullptr) return expr;
+    uint32_t column_id = std::dynamic_pointer_cast<ColumnValueExpression>(column)->GetColIdx();
+    // a null test reads the same on the codes
+    std::string comp_type = comparison->GetComparisonType();
+    if(comp_type == "is" || comp_type == "not") return expr;
+    if((comp_type != "=" && comp_type != "<>") || other->GetType() != ExpressionType::ConstantExpression) {
+        return nullptr;
+    }
+    const Field &value = std::dynamic_pointer_cast<ConstantValueExpression>(other)->val_;
+    if(value.GetTypeId() != TypeId::kTypeChar) return nullptr;
+    // a value the dictionary does not hold is equal to no code
+    Field code = value.IsNull() ? Field(kTypeInt)
+                                : Field(kTypeInt, table_heap->GetDictionary()->Lookup(column_id, value.GetData(),
+                                                                                       value.GetLength()));
+    return std::make_shared<ComparisonExpression>(std::make_shared<ColumnValueExpression>(0, column_id, kTypeInt),
+                                                  std::make_shared<ConstantValueExpression>(code), comp_type);
+}
+
+bool SeqScanExecutor::NextInMorsel(Row *row) {
+    while(row_cursor_ == page_rids_.size()) {
+        if(page_cursor_ == page_end_ && !morsels_->Next(&page_cursor_, &page_end_)) return false;
+        for(auto &values : page_columns_) values.clear();
+        page_rids_.clear();
+        row_cursor_ = 0;
+        table_info_->GetTableHeap()->ScanColumns(morsels_->PageAt(page_cursor_++), exec_ctx_->GetTransaction(),
+                                                 scan_columns_, &page_columns_, &page_rids_, code_predicate_ == nullptr);
+    }
+    row->destroy();
+    row->SetRowId(page_rids_[row_cursor_]);
+    for(auto &values : page_columns_) row->GetFields().push_back(new Field(values[row_cursor_]));
+    row_cursor_++;
+    return true;
+}
 
 bool SeqScanExecutor::Next(Row *row, RowId *rid) {
+    BufferAccessScope scope(strategy_);
+    if(morsels_ != nullptr) {
+        do{
+            if(!NextInMorsel(row)) return false;
+        }while(scan_predicate_ != nullptr && !scan_predicate_->Evaluate(row).CompareEquals(Field(kTypeInt, 1)));
+        *rid = row->GetRowId();
+        if(code_predicate_ != nullptr) table_info_->GetTableHeap()->DecodeRow(row, scan_columns_);
+        std::vector<Field> values;
+        for(auto pos : output_positions_) values.emplace_back(*row->GetField(pos));
+        *row = Row{values};
+        return true;
+    }
+    auto predicate = code_predicate_ != nullptr ? code_predicate_ : plan_->GetPredicate();
     do{
-        if(table_iter_ == table_info_->GetTableHeap()->End())
+        if(table_iter_ == table_info_->GetTableHeap()->End()) {
+            // the iterator stops early when the transaction is aborted while waiting for a lock
+            if(exec_ctx_->GetTransaction() != nullptr) exec_ctx_->GetTransaction()->ThrowIfAborted();
             return false;
+        }
         *row = *table_iter_;
         *rid = row->GetRowId();
         table_iter_++;
-    }while(plan_->GetPredicate() != nullptr && !plan_->GetPredicate()->Evaluate(row).CompareEquals(Field(kTypeInt, 1)));
+    }while(predicate != nullptr && !predicate->Evaluate(row).CompareEquals(Field(kTypeInt, 1)));
+    if(code_predicate_ != nullptr) table_info_->GetTableHeap()->DecodeRow(row);
 
     auto schema = plan_->OutputSchema();
     std::vector<Field> values;
     for(auto &col : schema->GetColumns()){
         uint32_t idx;
-        schema->GetColumnIndex(col->GetName(),idx);
+        table_info_->GetSchema()->GetColumnIndex(col->GetName(),idx);
         values.emplace_back(*row->GetField(idx));
     }
     *row = Row{values};
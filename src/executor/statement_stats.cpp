@@ -0,0 +1,138 @@
+#include "executor/statement_stats.h"
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "executor/plan_cache.h"
+
+std::string StatementStats::Fingerprint(const std::string &sql) {
+  std::string normalized = PlanCache::Normalize(sql);
+  std::string result;
+  result.reserve(normalized.size());
+  for (size_t i = 0; i < normalized.size(); i++) {
+    char ch = normalized[i];
+    if (ch == '"' || ch == '\'') {
+      size_t end = normalized.find(ch, i + 1);
+      i = end == std::string::npos ? normalized.size() : end;
+      result.push_back('?');
+      continue;
+    }
+    // A digit which does not continue an identifier starts a number.
+    bool in_word = !result.empty() && (std::isalnum(static_cast<unsigned char>(result.back())) || result.back() == '_');
+    if (std::isdigit(static_cast<unsigned char>(ch)) && !in_word) {
+      while (i + 1 < normalized.size() &&
+             (std::isdigit(static_cast<unsigned char>(normalized[i + 1])) || normalized[i + 1] == '.')) {
+        i++;
+      }
+      result.push_back('?');
+      continue;
+    }
+    result.push_back(ch);
+  }
+  // A row which repeats the one before it is dropped, inserts of any number of rows share a fingerprint.
+  std::string folded;
+  folded.reserve(result.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    if (result[i] == '(') {
+      size_t end = result.find(')', i);
+      if (end != std::string::npos) {
+        size_t length = end - i + 1;
+        size_t n = folded.size();
+        if (n > 0 && folded[n - 1] == ' ') {
+          n--;
+        }
+        if (n > length && folded[n - 1] == ',' &&
+            folded.compare(n - 1 - length, length, result, i, length) == 0) {
+          folded.resize(n - 1);
+          i = end;
+          continue;
+        }
+      }
+    }
+    folded.push_back(result[i]);
+  }
+  return folded;
+}
+
+void StatementStats::Record(const std::string &fingerprint, const StatementProfile &profile) {
+  StatementLatency *latency;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    auto iter = latencies_.find(fingerprint);
+    if (iter == latencies_.end()) {
+      const std::string &key = latencies_.size() < max_fingerprints_ ? fingerprint : OTHER_FINGERPRINT;
+      iter = latencies_.find(key);
+      if (iter == latencies_.end()) {
+        iter = latencies_.emplace(key, std::make_unique<StatementLatency>()).first;
+      }
+    }
+    latency = iter->second.get();
+  }
+  latency->total_.Record(profile.GetTotal());
+  latency->parse_ns_.fetch_add(profile.parse_.count(), std::memory_order_relaxed);
+  latency->plan_ns_.fetch_add(profile.plan_.count(), std::memory_order_relaxed);
+  latency->execute_ns_.fetch_add(profile.execute_.count(), std::memory_order_relaxed);
+  latency->format_ns_.fetch_add(profile.format_.count(), std::memory_order_relaxed);
+  all_.Record(profile.GetTotal());
+}
+
+void StatementStats::ForEach(const std::function<void(const std::string &, const StatementLatency &)> &func) {
+  std::vector<std::pair<const std::string *, const StatementLatency *>> latencies;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (const auto &latency : latencies_) {
+      latencies.emplace_back(&latency.first, latency.second.get());
+    }
+  }
+  // Entries are never removed, the pointers stay valid without the latch.
+  std::sort(latencies.begin(), latencies.end(), [](const auto &a, const auto &b) {
+    return a.second->total_.GetSumNanos() > b.second->total_.GetSumNanos();
+  });
+  for (const auto &latency : latencies) {
+    func(*latency.first, *latency.second);
+  }
+}
+
+bool SlowQueryLog::Open(const std::string &path, std::chrono::nanoseconds threshold) {
+  std::lock_guard<std::mutex> guard(latch_);
+  file_.open(path, std::ios::app);
+  enabled_ = file_.is_open();
+  threshold_ = threshold;
+  return enabled_;
+}
+
+void SlowQueryLog::Write(const std::string &sql, const std::string &db_name, const StatementProfile &profile,
+                         bool success) {
+  auto ms = [](std::chrono::nanoseconds time) { return std::chrono::duration<double, std::milli>(time).count(); };
+  std::time_t now = std::time(nullptr);
+  std::tm local_time{};
+  localtime_r(&now, &local_time);
+  // The entry is put together first, entries of concurrent sessions do not interleave.
+  std::ostringstream entry;
+  entry << std::fixed << std::setprecision(3);
+  entry << "# Time: " << std::put_time(&local_time, "%Y-%m-%d %H:%M:%S") << "\n";
+  entry << "# Database: " << (db_name.empty() ? "-" : db_name) << "  Result: " << (success ? "ok" : "failed")
+        << "\n";
+  entry << "# Query_time: " << ms(profile.GetTotal()) << " ms  Parse: " << ms(profile.parse_)
+        << " ms  Plan: " << ms(profile.plan_) << " ms  Execute: " << ms(profile.execute_)
+        << " ms  Format: " << ms(profile.format_) << " ms\n";
+  entry << "# Buffers: hit=" << profile.buffer_.hits_ << " miss=" << profile.buffer_.misses_
+        << " read=" << profile.buffer_.pages_read_ << " written=" << profile.buffer_.pages_written_ << "\n";
+  if (!profile.plan_text_.empty()) {
+    entry << "# Plan:\n";
+    std::istringstream plan(profile.plan_text_);
+    std::string line;
+    while (std::getline(plan, line)) {
+      entry << "#   " << line << "\n";
+    }
+  }
+  entry << PlanCache::Normalize(sql) << "\n";
+  std::lock_guard<std::mutex> guard(latch_);
+  file_ << entry.str();
+  file_.flush();
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
@@ -24,14 +24,28 @@ bool UpdateExecutor::Next(Row *row, RowId *rid) {
     if(child_executor_->Next(&src_row,&src_rid)){
         // ASSERT(src_row.GetRowId().Get()!=INVALID_ROWID.Get(),"Update Invalid Row");
         Row dest_row =GenerateUpdatedTuple(src_row);  //generate new row
-        if(!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, exec_ctx_->GetTransaction())) return false;
+        auto txn = exec_ctx_->GetTransaction();
+        if(!table_info_->GetTableHeap()->UpdateTuple(dest_row, src_rid, txn)) {
+            if(txn != nullptr) txn->ThrowIfAborted();
+            return false;
+        }
+        // the row may have been moved to another page, the new rid is wrapped in dest_row
+        RowId dest_rid = dest_row.GetRowId();
+        auto table_heap = table_info_->GetTableHeap();
+        // Snapshots may still read the old version through the old key, the garbage collection removes it.
+        bool keep_old_keys = table_heap->IsVersioned(txn);
         for(auto& index_info: table_indexes_){ //update all the indexes
-            Row key;
-            row->GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), key);
-            index_info->GetIndex()->RemoveEntry(key, *rid, exec_ctx_->GetTransaction());
-            dest_row.GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), key);
-            index_info->GetIndex()->InsertEntry(key, *rid, exec_ctx_->GetTransaction());
+            Row old_key, new_key;
+            src_row.GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), old_key);
+            dest_row.GetKeyFromRow(table_info_->GetSchema(), index_info->GetIndexKeySchema(), new_key);
+            auto index = index_info->GetIndex();
+            if(!keep_old_keys && index->RemoveEntry(old_key, src_rid, txn) == DB_SUCCESS && txn != nullptr)
+                txn->GetIndexWriteSet()->emplace_back(src_rid, WType::kDelete, old_key, index);
+            if((index->InsertEntry(new_key, dest_rid, txn) == DB_SUCCESS ||
+                table_heap->ReplaceStaleEntry(index, new_key, dest_rid, txn)) && txn != nullptr)
+                txn->GetIndexWriteSet()->emplace_back(dest_rid, WType::kInsert, new_key, index);
         }
+        *rid = dest_rid;
         return true;
     }
     return false;
@@ -0,0 +1,219 @@
+#ifndef MINISQL_BUFFER_POOL_H
+#define MINISQL_BUFFER_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/lru_replacer.h"
+#include "page/page.h"
+#include "storage/disk_manager.h"
+
+using namespace std;
+
+/**
+ * Buffer pool counters of one thread. The difference of two readings taken on the same thread is what the
+ * work in between cost the buffer pool.
+ */
+struct BufferPoolStats {
+  uint64_t hits_{0};           // pages fetched which were cached
+  uint64_t misses_{0};         // pages fetched which were not cached
+  uint64_t pages_read_{0};     // pages read from disk
+  uint64_t pages_written_{0};  // pages written to disk
+
+  BufferPoolStats &operator+=(const BufferPoolStats &other) {
+    hits_ += other.hits_;
+    misses_ += other.misses_;
+    pages_read_ += other.pages_read_;
+    pages_written_ += other.pages_written_;
+    return *this;
+  }
+
+  BufferPoolStats operator-(const BufferPoolStats &other) const {
+    BufferPoolStats diff;
+    diff.hits_ = hits_ - other.hits_;
+    diff.misses_ = misses_ - other.misses_;
+    diff.pages_read_ = pages_read_ - other.pages_read_;
+    diff.pages_written_ = pages_written_ - other.pages_written_;
+    return diff;
+  }
+};
+
+/**
+ * Buffer pool counters since the pool was created, summed over all threads and files.
+ */
+struct BufferPoolCounters {
+  std::atomic<uint64_t> fetches_{0};           // pages asked for by FetchPage
+  std::atomic<uint64_t> hits_{0};              // pages fetched which were cached
+  std::atomic<uint64_t> misses_{0};            // pages fetched which were read from disk
+  std::atomic<uint64_t> evictions_{0};         // pages dropped to free a frame
+  std::atomic<uint64_t> dirty_writebacks_{0};  // evicted pages written back
+  std::atomic<uint64_t> flushes_{0};           // pages written back by FlushPage
+  std::atomic<uint64_t> ring_reuses_{0};       // frames taken back from the ring of a bulk read
+  std::atomic<uint64_t> prefetches_{0};        // pages read ahead of any request by PrefetchPage
+};
+
+class BufferPool;
+
+/**
+ * BufferAccessStrategy keeps a large scan from flushing the pool. Every page read under the strategy goes
+ * to a ring of at most BULK_READ_RING_SIZE frames, or an eighth of the pool if smaller, and once the ring
+ * is full replaces the page read a ring length before it instead of the least recently used page of the pool.
+ * A table which fits in the ring stays cached between scans.
+ *
+ * A frame is only taken back if it still holds the page the ring put there and nobody pins it, else the
+ * slot is filled with a frame found as usual. The strategy is used by the pool under its latch, so the
+ * workers of a parallel scan may share one.
+ */
+class BufferAccessStrategy {
+  friend class BufferPool;
+
+ public:
+  explicit BufferAccessStrategy(size_t ring_size = BULK_READ_RING_SIZE)
+      : ring_frames_(ring_size, INVALID_FRAME_ID), ring_keys_(ring_size, 0) {}
+
+  /** @return the strategy of the pages the calling thread fetches, nullptr if none */
+  static BufferAccessStrategy *GetCurrent() { return current_; }
+
+ private:
+  friend class BufferAccessScope;
+
+  static thread_local BufferAccessStrategy *current_;
+
+  BufferPool *buffer_pool_{nullptr};  // pool the frames of the ring belong to
+  std::vector<frame_id_t> ring_frames_;
+  std::vector<uint64_t> ring_keys_;   // page each frame of the ring was given to
+  size_t next_{0};                    // slot of the ring to fill next
+};
+
+/**
+ * BufferAccessScope makes the pages the calling thread fetches from any pool go through strategy until
+ * the scope ends.
+ */
+class BufferAccessScope {
+ public:
+  explicit BufferAccessScope(BufferAccessStrategy *strategy) : previous_(BufferAccessStrategy::current_) {
+    BufferAccessStrategy::current_ = strategy;
+  }
+
+  ~BufferAccessScope() { BufferAccessStrategy::current_ = previous_; }
+
+  BufferAccessScope(const BufferAccessScope &) = delete;
+  BufferAccessScope &operator=(const BufferAccessScope &) = delete;
+
+ private:
+  BufferAccessStrategy *previous_;
+};
+
+/**
+ * BufferPool holds the frames shared by the buffer pool managers of all open database files, so the
+ * memory budget of the process is set once no matter how many databases are open.
+ *
+ * Every file registered gets a file id, a cached page is keyed by (file id, page id). A frame may be
+ * given to a page of any file, a dirty victim is written back through the disk manager of its file.
+ * BufferPoolManager is the view of one file on the pool.
+ */
+class BufferPool {
+  friend class BufferPoolManager;
+
+ public:
+  explicit BufferPool(size_t pool_size);
+
+  ~BufferPool();
+
+  /** @return number of frames */
+  inline size_t GetPoolSize() const { return pool_size_; }
+
+  /** @return number of files registered */
+  size_t GetFileCount();
+
+  /** @return number of frames holding a page */
+  size_t GetPageCount();
+
+  /** @return the counters of the pool */
+  inline const BufferPoolCounters &GetCounters() const { return counters_; }
+
+  /** @return the counters of the calling thread, summed over all pools */
+  static BufferPoolStats &GetThreadStats();
+
+ private:
+  using PageKey = uint64_t;
+
+  static inline PageKey MakeKey(uint32_t file_id, page_id_t page_id) {
+    return (static_cast<uint64_t>(file_id) << 32) | static_cast<uint32_t>(page_id);
+  }
+
+  /** @return the file id pages of disk_manager are cached under */
+  uint32_t RegisterFile(DiskManager *disk_manager);
+
+  /** Write back the pages of the file and free their frames */
+  void UnregisterFile(uint32_t file_id);
+
+  Page *FetchPage(uint32_t file_id, page_id_t page_id);
+
+  bool UnpinPage(uint32_t file_id, page_id_t page_id, bool is_dirty);
+
+  bool FlushPage(uint32_t file_id, page_id_t page_id);
+
+  /**
+   * @param in_run whether the page is allocated in the runs of an object, see DiskManager::AllocatePageNear
+   * @param last_page_id the page the object got last
+   */
+  Page *NewPage(uint32_t file_id, page_id_t &page_id, bool in_run = false, page_id_t last_page_id = INVALID_PAGE_ID);
+
+  bool DeletePage(uint32_t file_id, page_id_t page_id);
+
+  bool CheckAllUnpinned(uint32_t file_id);
+
+  /** @return the cached pages of the file, the most recently used first */
+  vector<page_id_t> GetHotPages(uint32_t file_id);
+
+  /**
+   * Read a page into a free frame without pinning it, no page is evicted for it. A page which is cached
+   * already or not allocated is skipped.
+   * @return false if there is no free frame left
+   */
+  bool PrefetchPage(uint32_t file_id, page_id_t page_id);
+
+  /**
+   * Wait until the frame of the page is out of I/O.
+   * @return the entry of the page, end if it is not cached
+   */
+  unordered_map<PageKey, frame_id_t>::iterator FindPage(unique_lock<recursive_mutex> &guard, PageKey key);
+
+  /**
+   * Give a frame found by TryToFindFreePage or TryToFindRingPage to a page and pin it. The latch is released
+   * while the page the frame held is written back and the page is read, or zeroed if read is false. Both
+   * pages keep their entries meanwhile, fetchers of either wait for the frame instead of reading the disk.
+   * @return false if the page could not be read, the frame is freed then
+   */
+  bool LoadFrame(unique_lock<recursive_mutex> &guard, frame_id_t frame_id, uint32_t file_id, page_id_t page_id,
+                 bool read);
+
+  /** Find a frame for a page, a victim keeps its page until LoadFrame wrote it back */
+  frame_id_t TryToFindFreePage();
+
+  /** Find a frame for the page key is read into under strategy */
+  frame_id_t TryToFindRingPage(BufferAccessStrategy *strategy, PageKey key);
+
+  size_t pool_size_;                                    // number of pages in buffer pool
+  Page *pages_;                                         // array of pages
+  vector<uint32_t> frame_files_;                        // file id of the page held by each frame
+  vector<uint64_t> frame_ticks_;                        // tick of the last request of the page held by each frame
+  vector<bool> frame_in_io_;                            // whether each frame is read or written back unlatched
+  size_t evicting_{0};                                  // frames in I/O which still hold the page they were taken from
+  uint64_t tick_{0};                                    // ticks once per page requested
+  unordered_map<uint32_t, DiskManager *> files_;        // disk managers of the registered files
+  uint32_t next_file_id_{0};                            // file id of the next file registered
+  unordered_map<PageKey, frame_id_t> page_table_;       // to keep track of pages
+  Replacer *replacer_;                                  // to find an unpinned page for replacement
+  list<frame_id_t> free_list_;                          // to find a free page for replacement
+  recursive_mutex latch_;                               // to protect shared data structure
+  condition_variable_any io_done_;                      // notified whenever a frame comes out of I/O
+  BufferPoolCounters counters_;                         // read without the latch
+};
+
+#endif  // MINISQL_BUFFER_POOL_H
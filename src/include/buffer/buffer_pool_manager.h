@@ -1,23 +1,35 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
-#include <list>
-#include <mutex>
-#include <unordered_map>
-
-#include "buffer/lru_replacer.h"
+#include "buffer/buffer_pool.h"
 #include "page/disk_file_meta_page.h"
 #include "page/page.h"
 #include "storage/disk_manager.h"
 
 using namespace std;
 
+/**
+ * BufferPoolManager caches the pages of one database file in a BufferPool, either a pool of its own or
+ * one shared with the files of other databases.
+ */
 class BufferPoolManager {
  public:
+  /**
+   * Cache the pages of the file in a pool of its own.
+   */
   explicit BufferPoolManager(size_t pool_size, DiskManager *disk_manager);
 
+  /**
+   * Cache the pages of the file in a shared pool, which must outlive the manager.
+   */
+  explicit BufferPoolManager(BufferPool *buffer_pool, DiskManager *disk_manager);
+
+  /**
+   * Write back the pages of the file and give their frames back to the pool.
+   */
   ~BufferPoolManager();
 
+  /** @return nullptr if every frame is pinned or the page cannot be read, see DiskManager::ReadPage */
   Page *FetchPage(page_id_t page_id);
 
   bool UnpinPage(page_id_t page_id, bool is_dirty);
@@ -26,33 +38,35 @@ class BufferPoolManager {
 
   Page *NewPage(page_id_t &page_id);
 
+  /**
+   * Allocate a page of a table or index, which grows by runs of contiguous pages.
+   * @param last_page_id the page the object got last, INVALID_PAGE_ID for its first page
+   */
+  Page *NewPageNear(page_id_t &page_id, page_id_t last_page_id);
+
   bool DeletePage(page_id_t page_id);
 
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
 
- private:
-  /**
-   * Allocate new page (operations like create index/table) For now just keep an increasing counter
-   */
-  page_id_t AllocatePage();
+  /** @return the cached pages of the file, the most recently used first */
+  vector<page_id_t> GetHotPages();
 
   /**
-   * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
+   * Read a page into a free frame of the pool without pinning it, no cached page is evicted for it.
+   * @return false if the pool has no free frame left
    */
-  void DeallocatePage(page_id_t page_id);
+  bool PrefetchPage(page_id_t page_id);
 
-  frame_id_t TryToFindFreePage();
+  /** @return number of frames of the pool holding no page */
+  size_t GetFreeFrameCount();
 
  private:
-  size_t pool_size_;                                 // number of pages in buffer pool
-  Page *pages_;                                      // array of pages
+  BufferPool *buffer_pool_;                          // pool holding the cached pages
+  BufferPool *own_buffer_pool_{nullptr};             // the pool if it is not shared
   DiskManager *disk_manager_;                        // pointer to the disk manager.
-  unordered_map<page_id_t, frame_id_t> page_table_;  // to keep track of pages
-  Replacer *replacer_;                               // to find an unpinned page for replacement
-  list<frame_id_t> free_list_;                       // to find a free page for replacement
-  recursive_mutex latch_;                            // to protect shared data structure
+  uint32_t file_id_;                                 // id of the file in the pool
 };
 
 #endif  // MINISQL_BUFFER_POOL_MANAGER_H
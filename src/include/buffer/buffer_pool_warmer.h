@@ -0,0 +1,72 @@
+#ifndef MINISQL_BUFFER_POOL_WARMER_H
+#define MINISQL_BUFFER_POOL_WARMER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+#include "common/macros.h"
+
+/**
+ * BufferPoolWarmer keeps the pool of a database warm across restarts. The pages cached for the file are
+ * listed in a manifest, the most recently used first, every save interval and once more when the warmer is
+ * destroyed.
+ *
+ * Started on an existing database, a thread of its own reads the pages of the manifest back into the free
+ * frames of the pool, as many of the hottest as fit and in the order they lie in the file. Requests are
+ * served meanwhile, a page they ask for first is read by them and skipped by the warm-up, and the warm-up
+ * never evicts a page.
+ */
+class BufferPoolWarmer {
+ public:
+  /**
+   * @param bpm the buffer pool manager of the database file
+   * @param manifest_path file the hot pages are listed in
+   * @param warm_up whether to read the pages of an existing manifest back
+   * @param save_interval time between two writes of the manifest
+   */
+  BufferPoolWarmer(BufferPoolManager *bpm, std::string manifest_path, bool warm_up,
+                   std::chrono::milliseconds save_interval = DEFAULT_HOT_PAGE_SAVE_INTERVAL);
+
+  ~BufferPoolWarmer();
+
+  DISALLOW_COPY_AND_MOVE(BufferPoolWarmer);
+
+  /** @return false if the manifest could not be written */
+  bool SaveManifest();
+
+  /** Wait until the warm-up is done */
+  void WaitForWarmUp();
+
+  /** @return number of pages of the manifest the warm-up has gone through so far */
+  inline size_t GetPagesWarmed() const { return pages_warmed_.load(std::memory_order_relaxed); }
+
+  /**
+   * Read the pages of a manifest.
+   * @return false if there is no manifest or it is not valid
+   */
+  static bool ReadManifest(const std::string &path, std::vector<page_id_t> *page_ids);
+
+ private:
+  void Run(bool warm_up);
+
+  void WarmUp();
+
+  BufferPoolManager *bpm_;
+  std::string manifest_path_;
+  std::chrono::milliseconds save_interval_;
+  std::atomic<size_t> pages_warmed_{0};
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool warming_{false};
+  bool stop_{false};
+  std::thread thread_;
+};
+
+#endif  // MINISQL_BUFFER_POOL_WARMER_H
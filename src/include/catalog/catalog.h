@@ -2,8 +2,11 @@
 #define MINISQL_CATALOG_H
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/indexes.h"
@@ -13,6 +16,7 @@
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
+#include "transaction/version_store.h"
 
 class CatalogMeta {
   friend class CatalogManager;
@@ -25,11 +29,11 @@ class CatalogMeta {
   uint32_t GetSerializedSize() const;
 
   inline table_id_t GetNextTableId() const {
-    return table_meta_pages_.size() == 0 ? 0 : table_meta_pages_.rbegin()->first;
+    return table_meta_pages_.size() == 0 ? 0 : table_meta_pages_.rbegin()->first + 1;
   }
 
   inline index_id_t GetNextIndexId() const {
-    return index_meta_pages_.size() == 0 ? 0 : index_meta_pages_.rbegin()->first;
+    return index_meta_pages_.size() == 0 ? 0 : index_meta_pages_.rbegin()->first + 1;
   }
 
   static CatalogMeta *NewInstance() { return new CatalogMeta(); }
@@ -53,6 +57,20 @@ class CatalogMeta {
     }
     bpm->DeletePage(index_meta_pages_[index_id]);
     index_meta_pages_.erase(index_id);
+    index_names_.erase(index_id);
+    return true;
+  }
+
+  /**
+   * Delete table meta data and its meta page.
+   */
+  bool DeleteTableMetaPage(BufferPoolManager *bpm, table_id_t table_id) {
+    if (table_meta_pages_.find(table_id) == table_meta_pages_.end()) {
+      return false;
+    }
+    bpm->DeletePage(table_meta_pages_[table_id]);
+    table_meta_pages_.erase(table_id);
+    table_names_.erase(table_id);
     return true;
   }
 
@@ -60,44 +78,70 @@ class CatalogMeta {
   CatalogMeta();
 
  private:
-  static constexpr uint32_t CATALOG_METADATA_MAGIC_NUM = 89849;
+  static constexpr uint32_t CATALOG_METADATA_MAGIC_NUM = 89850;
+  // meta data written before the names were kept, it fills the catalog meta page from its first byte
+  static constexpr uint32_t CATALOG_METADATA_SINGLE_PAGE_MAGIC_NUM = 89849;
   std::map<table_id_t, page_id_t> table_meta_pages_;
   std::map<index_id_t, page_id_t> index_meta_pages_;
+  // names are kept here as well, so a table or an index is found without reading its meta page
+  std::map<table_id_t, std::string> table_names_;
+  std::map<index_id_t, std::pair<table_id_t, std::string>> index_names_;
 };
 
 /**
  * Catalog manager
  *
+ * Opening a database only reads the catalog meta data, which maps the names of tables and indexes to their
+ * meta pages. The TableInfo of a table and the IndexInfo of an index are built when they are first asked for,
+ * so the time to open a database does not grow with the number of tables in it.
  */
 class CatalogManager {
  public:
   explicit CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
-                          bool init);
+                          bool init, VersionStore *version_store = nullptr);
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * @param schema The columns of the table, the catalog keeps a copy of its own
+   * @param layout How the pages of the table store its tuples, DB_FAILED if a tuple does not fit a columnar page
+   * @param dictionary_encoded Whether the char columns are stored as codes of a dictionary of the table
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      TableLayout layout = TableLayout::kRow, bool dictionary_encoded = false);
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
-  dberr_t GetTables(std::vector<TableInfo *> &tables) const;
+  /** Every table is loaded, prefer GetTable when one is needed */
+  dberr_t GetTables(std::vector<TableInfo *> &tables);
 
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn, IndexInfo *&index_info,
                       const string &index_type);
 
-  dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
+  dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info);
 
-  dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const;
+  dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes);
 
   dberr_t DropTable(const std::string &table_name);
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /** @return a number changed by every table or index created or dropped, plans made before a change are stale */
+  inline uint64_t GetVersion() const { return version_; }
+
+  /** @return number of tables whose TableInfo has been built */
+  size_t GetLoadedTableCount();
+
  private:
   dberr_t DropTable(table_id_t table_id);
 
-  dberr_t FlushCatalogMetaPage() const;
+  dberr_t FlushCatalogMetaPage();
+
+  dberr_t ReadCatalogMetaPages();
+
+  /** Fill in the names missing from meta data of the single page layout from the meta pages */
+  dberr_t ReadCatalogNames();
 
   dberr_t LoadTable(const table_id_t table_id, const page_id_t page_id);
 
@@ -105,19 +149,29 @@ class CatalogManager {
 
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
+  dberr_t GetIndex(const index_id_t index_id, IndexInfo *&index_info);
+
+  /** Bytes of catalog meta data held by a page, the rest is the id of the next page */
+  static constexpr uint32_t CATALOG_META_PAGE_PAYLOAD = PAGE_SIZE - sizeof(page_id_t);
+
  private:
   [[maybe_unused]] BufferPoolManager *buffer_pool_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
+  VersionStore *version_store_;
   CatalogMeta *catalog_meta_;
+  std::vector<page_id_t> catalog_meta_pages_;  // pages the catalog meta data overflows to
   std::atomic<table_id_t> next_table_id_;
   std::atomic<index_id_t> next_index_id_;
+  std::atomic<uint64_t> version_{0};
   // map for tables
   std::unordered_map<std::string, table_id_t> table_names_;
   std::unordered_map<table_id_t, TableInfo *> tables_;
   // map for indexes: table_name->index_name->indexes
   std::unordered_map<std::string, std::unordered_map<std::string, index_id_t>> index_names_;
   std::unordered_map<index_id_t, IndexInfo *> indexes_;
+  // tables and indexes are loaded under concurrent reads of the catalog
+  std::recursive_mutex latch_;
 };
 
 #endif  // MINISQL_CATALOG_H
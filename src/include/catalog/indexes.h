@@ -6,8 +6,10 @@
 #include "catalog/table.h"
 #include "common/macros.h"
 #include "common/rowid.h"
+#include "index/art_index.h"
 #include "index/b_plus_tree_index.h"
 #include "index/generic_key.h"
+#include "index/hash_index.h"
 #include "record/schema.h"
 
 class IndexMetadata {
@@ -15,7 +17,7 @@ class IndexMetadata {
 
  public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                               const std::vector<uint32_t> &key_map);
+                               const std::vector<uint32_t> &key_map, const std::string &index_type = "bptree");
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -33,18 +35,24 @@ class IndexMetadata {
 
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  /** @return the structure of the index, "bptree", "hash" or "art" */
+  inline const std::string &GetIndexType() const { return index_type_; }
+
  private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name, const table_id_t table_id,
-                         const std::vector<uint32_t> &key_map);
+                         const std::vector<uint32_t> &key_map, const std::string &index_type);
 
  private:
   static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  // metadata with the index type after the key mapping, the indexes of older databases are B+ trees
+  static constexpr uint32_t INDEX_METADATA_TYPE_MAGIC_NUM = 344529;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_; /** The mapping of index key to tuple key */
+  std::string index_type_;
 };
 
 /**
@@ -72,7 +80,12 @@ class IndexInfo {
     auto schema = table_info->GetSchema();
     this->key_schema_ = Schema::ShallowCopySchema(schema,meta_data->key_map_);
     // Step3: call CreateIndex to create the index
-    this->index_ = CreateIndex(buffer_pool_manager, "bptree");
+    this->index_ = CreateIndex(buffer_pool_manager, meta_data->GetIndexType());
+  }
+
+  /** @return whether an index of the type can be made */
+  static bool IsIndexType(const std::string &index_type) {
+    return index_type == "bptree" || index_type == "hash" || index_type == "art";
   }
 
   inline Index *GetIndex() { return index_; }
@@ -26,7 +26,8 @@ class TableMetadata {
    * will create new table schema and owned by mem heap
    */
   static TableMetadata *Create(table_id_t table_id, std::string table_name, page_id_t root_page_id,
-                               TableSchema *schema);
+                               TableSchema *schema, TableLayout layout = TableLayout::kRow,
+                               page_id_t dictionary_page_id = INVALID_PAGE_ID);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -36,17 +37,29 @@ class TableMetadata {
 
   inline Schema *GetSchema() const { return schema_; }
 
+  inline TableLayout GetLayout() const { return layout_; }
+
+  /** @return first page of the dictionary of the encoded columns, INVALID_PAGE_ID if the table is not encoded */
+  inline page_id_t GetDictionaryPageId() const { return dictionary_page_id_; }
+
  private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                TableLayout layout, page_id_t dictionary_page_id);
 
  private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
+  // metadata with the layout of the table after the magic num, the tables of older databases are row tables
+  static constexpr uint32_t TABLE_METADATA_LAYOUT_MAGIC_NUM = 344529;
+  // metadata with the layout and the dictionary page id of the table after the magic num
+  static constexpr uint32_t TABLE_METADATA_DICTIONARY_MAGIC_NUM = 344530;
   table_id_t table_id_;
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  TableLayout layout_;
+  page_id_t dictionary_page_id_;
 };
 
 /**
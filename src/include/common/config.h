@@ -1,6 +1,7 @@
 #ifndef MINISQL_CONFIG_H
 #define MINISQL_CONFIG_H
 
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 
@@ -13,8 +14,20 @@ static constexpr int META_PAGE_ID = 0;          // physical page id of the disk
 static constexpr int CATALOG_META_PAGE_ID = 0;  // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;   // logical page id of the index roots
 
-static constexpr int PAGE_SIZE = 4096;                  // size of a data page in byte
+// size of a data page in byte, set with -DMINISQL_PAGE_SIZE=N at configure time, a database keeps the size it
+// was created with
+#ifndef MINISQL_PAGE_SIZE
+#define MINISQL_PAGE_SIZE 4096
+#endif
+static constexpr int PAGE_SIZE = MINISQL_PAGE_SIZE;
+static_assert(PAGE_SIZE == 4096 || PAGE_SIZE == 8192 || PAGE_SIZE == 16384 || PAGE_SIZE == 32768,
+              "the page size is one of 4, 8, 16 or 32 KB");
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 20480;  // default size of buffer pool
+static constexpr int BULK_READ_RING_SIZE = 64;          // frames a large scan recycles for the pages it reads
+
+static constexpr std::chrono::milliseconds DEFAULT_CYCLE_DETECTION_INTERVAL{50};  // period of deadlock detection
+static constexpr std::chrono::milliseconds DEFAULT_GC_INTERVAL{100};  // period of old version garbage collection
+static constexpr std::chrono::milliseconds DEFAULT_HOT_PAGE_SAVE_INTERVAL{60000};  // period of hot page manifest writes
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;  // max length of varchar
@@ -25,6 +38,7 @@ using page_id_t = int32_t;
 using frame_id_t = int32_t;
 using txn_id_t = int32_t;
 using lsn_t = int32_t;
+using timestamp_t = uint64_t;
 using column_id_t = uint32_t;
 using index_id_t = uint32_t;
 using table_id_t = uint32_t;
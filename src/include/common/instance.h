@@ -5,26 +5,56 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_warmer.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
 #include "common/macros.h"
 #include "executor/execute_context.h"
 #include "storage/disk_manager.h"
+#include "transaction/lock_manager.h"
+#include "transaction/txn_manager.h"
+#include "transaction/version_store.h"
+
+class PlanCache;
 
 class DBStorageEngine {
  public:
-  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+  /**
+   * Open the database with a buffer pool of its own.
+   * @param compressed whether the data pages of a database created are compressed
+   */
+  explicit DBStorageEngine(std::string db_name, bool init = true, uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE,
+                           bool compressed = false);
+
+  /**
+   * Open the database with its pages cached in a buffer pool shared with other databases.
+   * @param compressed whether the data pages of a database created are compressed
+   */
+  DBStorageEngine(std::string db_name, bool init, BufferPool *buffer_pool, bool compressed = false);
 
   ~DBStorageEngine();
 
   std::unique_ptr<ExecuteContext> MakeExecuteContext(Transaction *txn);
 
+  /** @return the file the hot pages of database db_name are listed in, hidden so it is not taken for a database */
+  static std::string GetHotPagesFileName(const std::string &db_name);
+
+ private:
+  /** Set up the database file and the components on top of the buffer pool manager */
+  void Open();
+
  public:
   DiskManager *disk_mgr_;
   BufferPoolManager *bpm_;
   CatalogManager *catalog_mgr_;
+  LockManager *lock_mgr_;
+  VersionStore *version_store_;
+  TxnManager *txn_mgr_;
+  PlanCache *plan_cache_;
+  BufferPoolWarmer *warmer_;
   std::string db_file_name_;
+  std::string hot_pages_file_name_;
   bool init_;
 };
 
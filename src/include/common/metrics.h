@@ -0,0 +1,102 @@
+#ifndef MINISQL_METRICS_H
+#define MINISQL_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "common/macros.h"
+
+/**
+ * LatencyHistogram counts durations in microseconds the way an HDR histogram does: up to 8 us every value has
+ * a bucket of its own, above that every range from 2^e to 2^(e+1) is split into 8 buckets of equal width. A
+ * quantile is thus off by at most 12.5%. The last bucket takes everything above 2^27 us, about 134 s.
+ *
+ * Recording is a few relaxed atomic operations, so a histogram can be shared by threads and read while it is
+ * updated.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t SUB_BUCKET_BITS = 3;
+  static constexpr size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr size_t MAX_EXPONENT = 26;
+  static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + 1 + (MAX_EXPONENT + 1 - SUB_BUCKET_BITS) * SUB_BUCKETS + 1;
+
+  void Record(std::chrono::nanoseconds latency);
+
+  inline uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+
+  inline uint64_t GetSumNanos() const { return sum_ns_.load(std::memory_order_relaxed); }
+
+  inline uint64_t GetMaxNanos() const { return max_ns_.load(std::memory_order_relaxed); }
+
+  /** @return number of durations recorded in bucket i */
+  inline uint64_t GetBucketCount(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+  /** @return the bucket a duration of us microseconds is counted in */
+  static size_t GetBucketIndex(uint64_t us);
+
+  /** @return the upper bound of bucket i in microseconds, 0 for the last bucket which has none */
+  static uint64_t GetBucketBound(size_t i);
+
+  /**
+   * @return the bound in microseconds below which the fraction q of the durations lies, at most the longest
+   * duration, 0 if none were recorded
+   */
+  uint64_t GetQuantile(double q) const;
+
+  /** Write the histogram in the Prometheus text format, with bounds doubling from 1 us given in seconds */
+  void WritePrometheus(std::ostream &out, const std::string &name, const std::string &help) const;
+
+ private:
+  std::atomic<uint64_t> buckets_[BUCKET_COUNT]{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_ns_{0};
+  std::atomic<uint64_t> max_ns_{0};
+};
+
+/** Write one counter or gauge in the Prometheus text format */
+void WritePrometheusMetric(std::ostream &out, const std::string &name, const std::string &type,
+                           const std::string &help, uint64_t value);
+
+/**
+ * MetricsFileWriter writes the metrics into a file every interval from a thread of its own, and once more
+ * when it is destroyed. The file is written next to its path and then renamed, so a scraper never reads a
+ * file half written.
+ */
+class MetricsFileWriter {
+ public:
+  /**
+   * @param path file the metrics are written to
+   * @param interval time between two writes
+   * @param write_metrics writes the metrics into a stream
+   */
+  MetricsFileWriter(std::string path, std::chrono::milliseconds interval,
+                    std::function<void(std::ostream &)> write_metrics);
+
+  ~MetricsFileWriter();
+
+  DISALLOW_COPY_AND_MOVE(MetricsFileWriter);
+
+  /** @return false if the file could not be written */
+  bool WriteFile();
+
+ private:
+  void Run();
+
+  std::string path_;
+  std::chrono::milliseconds interval_;
+  std::function<void(std::ostream &)> write_metrics_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+  std::thread thread_;
+};
+
+#endif  // MINISQL_METRICS_H
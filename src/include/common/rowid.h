@@ -2,6 +2,7 @@
 #define MINISQL_RID_H
 
 #include <cstdint>
+#include <functional>
 
 #include "common/config.h"
 
@@ -36,4 +37,11 @@ class RowId {
 
 static const RowId INVALID_ROWID = RowId(INVALID_PAGE_ID, 0);
 
+namespace std {
+template <>
+struct hash<RowId> {
+  size_t operator()(const RowId &rid) const noexcept { return hash<int64_t>()(rid.Get()); }
+};
+}  // namespace std
+
 #endif  // MINISQL_RID_H
@@ -0,0 +1,47 @@
+#ifndef MINISQL_THREAD_POOL_H
+#define MINISQL_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "common/macros.h"
+
+/**
+ * ThreadPool runs submitted tasks on a fixed number of worker threads in FIFO order.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param num_workers number of worker threads, at least one
+   */
+  explicit ThreadPool(size_t num_workers);
+
+  /**
+   * Run the tasks already submitted and stop the workers.
+   */
+  ~ThreadPool();
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /**
+   * Queue a task, it is run by the first idle worker.
+   */
+  void Submit(std::function<void()> task);
+
+  inline size_t GetWorkerCount() const { return workers_.size(); }
+
+ private:
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> tasks_;
+  std::mutex latch_;
+  std::condition_variable cv_;
+  bool stop_{false};
+};
+
+#endif  // MINISQL_THREAD_POOL_H
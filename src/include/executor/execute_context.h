@@ -5,11 +5,27 @@
 #ifndef MINISQL_EXECUTE_CONTEXT_H
 #define MINISQL_EXECUTE_CONTEXT_H
 
+#include <chrono>
+#include <unordered_map>
+
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/macros.h"
+#include "common/thread_pool.h"
 #include "transaction/transaction.h"
 
+class AbstractPlanNode;
+
+/**
+ * Counters of one executor collected by EXPLAIN ANALYZE, the time and the buffer pool work include the
+ * work of its children.
+ */
+struct ExecutorStats {
+  uint64_t rows_{0};
+  std::chrono::nanoseconds time_{0};
+  BufferPoolStats buffer_;
+};
+
 class ExecuteContext {
  public:
   /**
@@ -34,6 +50,32 @@ class ExecuteContext {
   /** @return the buffer pool manager */
   BufferPoolManager *GetBufferPoolManager() { return bpm_; }
 
+  /**
+   * Let scans run on up to degree workers of pool.
+   */
+  void SetParallelism(size_t degree, ThreadPool *pool) {
+    parallelism_ = degree;
+    thread_pool_ = pool;
+  }
+
+  /** @return the number of workers a scan may use, 1 for none but the calling thread */
+  size_t GetParallelism() const { return thread_pool_ == nullptr ? 1 : parallelism_; }
+
+  /** @return the pool running the workers of parallel scans */
+  ThreadPool *GetThreadPool() { return thread_pool_; }
+
+  /** Let every executor built for the context collect counters, see AnalyzeExecutor. */
+  void EnableAnalyze() { analyze_ = true; }
+
+  /** @return whether the executors collect counters */
+  bool IsAnalyzing() const { return analyze_; }
+
+  /** @return the counters of the executor running plan */
+  ExecutorStats &GetExecutorStats(const AbstractPlanNode *plan) { return executor_stats_[plan]; }
+
+  /** @return whether an executor ran plan */
+  bool HasExecutorStats(const AbstractPlanNode *plan) const { return executor_stats_.count(plan) != 0; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -41,6 +83,14 @@ class ExecuteContext {
   CatalogManager *catalog_;
   /** The buffer pool manager associated with this executor context */
   BufferPoolManager *bpm_;
+  /** The degree of parallelism of scans */
+  size_t parallelism_{1};
+  /** The pool running the workers of parallel scans, not owned */
+  ThreadPool *thread_pool_{nullptr};
+  /** Whether the executors collect counters */
+  bool analyze_{false};
+  /** The counters of each executor, by the plan node it runs */
+  std::unordered_map<const AbstractPlanNode *, ExecutorStats> executor_stats_;
 };
 
 #endif  // MINISQL_EXECUTE_CONTEXT_H
@@ -1,15 +1,25 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <chrono>
+#include <iostream>
 #include <memory>
+#include <set>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 
+#include "buffer/buffer_pool.h"
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "common/thread_pool.h"
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
+#include "executor/plan_cache.h"
 #include "executor/plans/abstract_plan.h"
+#include "executor/session.h"
+#include "executor/statement_stats.h"
+#include "parser/parsed_statement.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
 
@@ -19,10 +29,19 @@ extern "C" {
 
 /**
  * ExecuteEngine
+ *
+ * The engine is shared by all sessions. Statements of different sessions run concurrently, except
+ * for the ones changing the databases or a catalog which run alone.
+ *
+ * A database is opened by the first session using it and closed when the last one leaves it, the
+ * pages of all open databases are cached in one buffer pool.
  */
 class ExecuteEngine {
  public:
-  ExecuteEngine();
+  /**
+   * @param buffer_pool_size number of pages cached for all databases together
+   */
+  explicit ExecuteEngine(size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
 
   ~ExecuteEngine() {
     for (auto it : dbs_) {
@@ -31,51 +50,137 @@ class ExecuteEngine {
   }
 
   /**
-   * executor interface
+   * executor interface, runs the statement in the default session writing to stdout
    */
   dberr_t Execute(pSyntaxNode ast);
 
+  /**
+   * Run the statement on behalf of session, results are written to the session's stream.
+   */
+  dberr_t Execute(pSyntaxNode ast, Session *session);
+
+  /**
+   * Run a parsed statement in the default session, its latency is recorded, see Execute(statement, session).
+   */
+  dberr_t Execute(const ParsedStatement &statement);
+
+  /**
+   * Run a parsed statement on behalf of session. The time of each phase is added to the statistics of the
+   * statement's fingerprint, and the statement goes to the slow query log if it took long enough.
+   */
+  dberr_t Execute(const ParsedStatement &statement, Session *session);
+
+  /**
+   * Log the statements which take at least threshold to the file at path.
+   * @return DB_FAILED if the file can not be opened
+   */
+  dberr_t OpenSlowQueryLog(const std::string &path, std::chrono::milliseconds threshold);
+
+  /** @return the latency of the statements run, by fingerprint */
+  inline StatementStats *GetStatementStats() { return &statement_stats_; }
+
   dberr_t ExecutePlan(const AbstractPlanNodeRef &plan, std::vector<Row> *result_set, Transaction *txn,
-                      ExecuteContext *exec_ctx);
+                      ExecuteContext *exec_ctx, std::ostream &out = std::cout);
 
   void ExecuteInformation(dberr_t result);
 
+  void ExecuteInformation(dberr_t result, Session *session);
+
+  /**
+   * Roll back the transaction left open by session, called when its client goes away.
+   */
+  void CloseSession(Session *session);
+
+  /** @return number of databases open at the moment */
+  size_t GetOpenDatabaseCount();
+
+  /** @return the buffer pool shared by the databases */
+  inline BufferPool *GetBufferPool() { return &buffer_pool_; }
+
+  /**
+   * Write the buffer pool and disk I/O counters in the Prometheus text format, may be called from any thread.
+   */
+  void WriteMetrics(std::ostream &out);
+
  private:
   static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecuteContext *exec_ctx, const AbstractPlanNodeRef &plan);
 
-  dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
+  /** @return the opened database named db_name, nullptr if there is none */
+  DBStorageEngine *GetDatabase(const std::string &db_name) const;
+
+  /** Make session use the database db_name, it is opened if no other session uses it. */
+  DBStorageEngine *EnterDatabase(const std::string &db_name, Session *session);
+
+  /** Make session leave its database, which is closed if no other session uses it. */
+  void LeaveDatabase(Session *session);
+
+  /** Run a statement, called with latch_ held */
+  dberr_t ExecuteStatement(pSyntaxNode ast, Session *session);
+
+  /**
+   * Run the plan of a query in the session's transaction and write its result, or with analyze the plan
+   * and the counters of its executors.
+   */
+  dberr_t ExecuteQueryPlan(const AbstractPlanNodeRef &plan, DBStorageEngine *db, Session *session,
+                           std::chrono::steady_clock::time_point start_time, bool analyze = false);
+
+  /** Parse and plan a statement to be prepared, nullptr if it can not be */
+  std::unique_ptr<CachedPlan> MakeCachedPlan(const std::string &sql, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteShowDatabases(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteShowTables(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context, Session *session);
+
+  dberr_t ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteShowDatabases(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteUseDatabase(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteShowTables(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteCreateTable(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecutePrepare(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecutePrepared(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteTrxBegin(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteDeallocate(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteTrxCommit(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteSet(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteTrxRollback(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteExplain(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteExecfile(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteShowStatus(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
-  dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
+  dberr_t ExecuteShowStatements(pSyntaxNode ast, ExecuteContext *context, Session *session);
 
  private:
-  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** all opened databases */
-  std::string current_db_;                                 /** current database */
+  BufferPool buffer_pool_;                                 /** caches the pages of all opened databases */
+  std::set<std::string> db_names_;                         /** all databases, opened or not */
+  std::unordered_map<std::string, DBStorageEngine *> dbs_; /** opened databases */
+  std::unordered_map<std::string, size_t> db_sessions_;    /** number of sessions using each opened database */
+  std::shared_mutex latch_;                                /** guards the databases and the catalogs */
+  Session default_session_;                                /** session of the interactive shell */
+  ThreadPool scan_pool_;                                   /** runs the workers of parallel scans of all sessions */
+  StatementStats statement_stats_;                         /** latency of the statements by fingerprint */
+  SlowQueryLog slow_query_log_;                            /** statements which took too long */
 };
 
 #endif  // MINISQL_EXECUTE_ENGINE_H
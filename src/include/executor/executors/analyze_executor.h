@@ -0,0 +1,38 @@
+#ifndef MINISQL_ANALYZE_EXECUTOR_H
+#define MINISQL_ANALYZE_EXECUTOR_H
+
+#include <memory>
+#include <utility>
+
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/plans/abstract_plan.h"
+
+/**
+ * AnalyzeExecutor wraps every executor of a plan run by EXPLAIN ANALYZE. It passes the rows of the wrapped
+ * executor through and adds the rows, the time and the buffer pool work of its Init and Next calls to the
+ * counters the executor context keeps for the plan node.
+ */
+class AnalyzeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new AnalyzeExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The plan node run by child
+   * @param child The executor measured
+   */
+  AnalyzeExecutor(ExecuteContext *exec_ctx, const AbstractPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child)
+      : AbstractExecutor(exec_ctx), stats_(exec_ctx->GetExecutorStats(plan)), child_(std::move(child)) {}
+
+  void Init() override;
+
+  bool Next(Row *row, RowId *rid) override;
+
+  const Schema *GetOutputSchema() const override { return child_->GetOutputSchema(); }
+
+ private:
+  ExecutorStats &stats_;
+  std::unique_ptr<AbstractExecutor> child_;
+};
+
+#endif  // MINISQL_ANALYZE_EXECUTOR_H
@@ -0,0 +1,97 @@
+#ifndef MINISQL_GATHER_EXECUTOR_H
+#define MINISQL_GATHER_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "executor/execute_context.h"
+#include "executor/executors/abstract_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "executor/plans/seq_scan_plan.h"
+
+static constexpr size_t GATHER_BATCH_SIZE = 256;  // number of rows a scan worker hands over at a time
+
+/**
+ * GatherExecutor runs a sequential scan in parallel and merges the output of the workers.
+ *
+ * The pages of the table are split into morsels which the workers, SeqScanExecutors running on the thread pool
+ * of the executor context, take one after another, so a worker finishing early takes over more of the table.
+ * Each worker filters and projects its rows and hands them over in batches, the rows come out in no particular
+ * order. At most a few batches per worker are buffered, a worker waits for the consumer when they are full.
+ * The buffer pool work of the workers is charged to the thread consuming the rows once they are done.
+ */
+class GatherExecutor : public AbstractExecutor {
+  using Batch = std::vector<std::pair<Row, RowId>>;
+
+ public:
+  /**
+   * Construct a new GatherExecutor instance.
+   * @param exec_ctx The executor context, its transaction must read a snapshot
+   * @param plan The sequential scan plan run by every worker
+   */
+  GatherExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
+
+  /** Stop the workers, the ones still running are waited for. */
+  ~GatherExecutor() override;
+
+  /** Start the workers */
+  void Init() override;
+
+  /**
+   * Yield the next row produced by any of the workers.
+   * @param[out] row The next row produced by the scan
+   * @param[out] rid The next row RID produced by the scan
+   * @return `true` if a row was produced, `false` if all workers are done
+   */
+  bool Next(Row *row, RowId *rid) override;
+
+  /** @return The output schema of the scan */
+  const Schema *GetOutputSchema() const override { return plan_->OutputSchema(); }
+
+  /** @return the number of workers started by Init */
+  inline size_t GetWorkerCount() const { return worker_count_; }
+
+  /** @return whether a sequential scan run in exec_ctx is split among workers */
+  static bool IsParallel(ExecuteContext *exec_ctx);
+
+ private:
+  /** Scan morsels until there are none left, run on the thread pool */
+  void RunWorker();
+
+  /** Hand a batch of rows over to the consumer, false if the scan was cancelled */
+  bool Push(Batch &&batch);
+
+  /** Add the buffer pool work of the finished workers to the counters of the calling thread */
+  void ChargeWorkerStats();
+
+  /** The sequential scan plan node run by the workers */
+  const SeqScanPlanNode *plan_;
+  std::unique_ptr<MorselQueue> morsels_;
+  /** Ring the pages are read through, shared by the workers */
+  BufferAccessStrategy strategy_;
+  size_t worker_count_{0};
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  /** Batches handed over but not consumed yet */
+  std::deque<Batch> batches_;
+  /** Number of workers not finished yet */
+  size_t running_{0};
+  /** Set when the consumer goes away or a worker fails, the workers stop at their next batch */
+  bool cancelled_{false};
+  /** The first exception raised by a worker, it is rethrown by Next */
+  std::exception_ptr error_;
+  /** Buffer pool work of the finished workers not charged to the consumer yet */
+  BufferPoolStats worker_stats_;
+
+  /** The batch being consumed */
+  Batch batch_;
+  size_t cursor_{0};
+};
+
+#endif  // MINISQL_GATHER_EXECUTOR_H
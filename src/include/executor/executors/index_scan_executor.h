@@ -52,6 +52,12 @@ class IndexScanExecutor : public AbstractExecutor {
     void getPredicate(std::vector<single_predicate>& pred,AbstractExpression* exp);
 
  private:
+  /**
+   * A snapshot may read an older version of the row than the one the index entry was made for, and
+   * the entries of old keys stay until the garbage collection, so the whole predicate is checked again
+   * on the version read.
+   */
+  bool MatchPredicate(Row *row);
 
   /** The sequential scan plan node to be executed */
   const IndexScanPlanNode *plan_;
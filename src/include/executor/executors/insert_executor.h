@@ -9,10 +9,13 @@
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/insert_plan.h"
 
+static constexpr size_t INSERT_BATCH_SIZE = 1024;  // max number of rows inserted in one pass
+
 /**
  * InsertExecutor executes an insert on a table.
  *
- * Inserted values are always pulled from a child executor.
+ * Inserted values are always pulled from a child executor. They are inserted in batches of up to
+ * INSERT_BATCH_SIZE rows, the heap pages and every index are walked once per batch.
  */
 class InsertExecutor : public AbstractExecutor {
  public:
@@ -48,6 +51,18 @@ class InsertExecutor : public AbstractExecutor {
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Rows of the current batch, they are yielded one by one after the batch is inserted */
+  std::vector<Row> batch_;
+  size_t cursor_{0};
+
+  /**
+   * Pull the next batch from the child and insert it.
+   * @throw std::logic_error if a key of the batch is already in a unique index, the statement fails
+   */
+  bool InsertBatch();
+
+  /** Remove the index entries and the heap rows of a batch inserted without a transaction */
+  void UndoBatch(const std::deque<IndexWriteRecord> &entries, const std::vector<RowId> &rids);
 };
 
 #endif  // MINISQL_INSERT_EXECUTOR_H
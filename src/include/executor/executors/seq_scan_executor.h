@@ -5,14 +5,60 @@
 #ifndef MINISQL_SEQ_SCAN_EXECUTOR_H
 #define MINISQL_SEQ_SCAN_EXECUTOR_H
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "executor/execute_context.h"
 #include "executor/executors/abstract_executor.h"
 #include "executor/plans/seq_scan_plan.h"
+#include "planner/expressions/abstract_expression.h"
+
+static constexpr size_t MORSEL_SIZE = 16;  // number of pages a parallel scan worker takes at a time
+
+/**
+ * MorselQueue hands the pages of a table out to the workers of a parallel scan, MORSEL_SIZE pages at a time.
+ */
+class MorselQueue {
+ public:
+  explicit MorselQueue(std::vector<page_id_t> page_ids) : page_ids_(std::move(page_ids)) {}
+
+  /**
+   * Take the next morsel, the pages of page_ids_[*begin, *end).
+   * @return false if all pages are taken
+   */
+  bool Next(size_t *begin, size_t *end) {
+    *begin = next_.fetch_add(MORSEL_SIZE);
+    if (*begin >= page_ids_.size()) {
+      return false;
+    }
+    *end = std::min(*begin + MORSEL_SIZE, page_ids_.size());
+    return true;
+  }
+
+  inline page_id_t PageAt(size_t i) const { return page_ids_[i]; }
+
+  inline size_t GetMorselCount() const { return (page_ids_.size() + MORSEL_SIZE - 1) / MORSEL_SIZE; }
+
+ private:
+  const std::vector<page_id_t> page_ids_;
+  std::atomic<size_t> next_{0};
+};
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * Given a MorselQueue it is one worker of a parallel scan, it only reads the pages it takes from the queue.
+ * The pages are read through a BufferAccessStrategy, so scanning a large table leaves the pool to the pages
+ * other statements use.
+ *
+ * A scan which takes no locks, a worker or a serial scan of a snapshot, reads a page at a time and only the
+ * columns the predicate and the output use, the predicate is evaluated on rows made of these columns.
+ *
+ * On a table with dictionary encoded columns an equality predicate on those columns is evaluated on the codes,
+ * the rows are read without decoding and only the rows which pass are decoded.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -23,6 +69,14 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /**
+   * Construct a worker of a parallel scan, it takes no locks so the transaction must read a snapshot.
+   * @param morsels The queue the worker takes pages from, shared with the other workers
+   * @param strategy The strategy the pages are read through, shared with the other workers
+   */
+  SeqScanExecutor(ExecuteContext *exec_ctx, const SeqScanPlanNode *plan, MorselQueue *morsels,
+                  BufferAccessStrategy *strategy);
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -41,8 +95,43 @@ class SeqScanExecutor : public AbstractExecutor {
   TableIterator table_iter_;
 
  private:
+  /** Move to the next tuple of the pages taken from morsels_, row is made of the columns in scan_columns_ */
+  bool NextInMorsel(Row *row);
+
+  /** Find the columns the predicate and the output use and rewrite the predicate on rows made of them */
+  void InitProjection();
+
+  /**
+   * Rewrite a predicate to be evaluated on the codes of the dictionary encoded columns, an encoded column may
+   * only be compared with a constant by = and <> or tested for null.
+   * @return nullptr if the predicate can not be evaluated on the codes
+   */
+  AbstractExpressionRef EncodePredicate(const AbstractExpressionRef &expr) const;
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** Source of pages of a parallel scan worker or of a serial scan which takes no locks, else nullptr */
+  MorselQueue *morsels_{nullptr};
+  /** Pages of a serial scan which takes no locks */
+  std::unique_ptr<MorselQueue> own_morsels_;
+  /** Strategy the pages are read through, own_strategy_ unless shared by the workers of a parallel scan */
+  BufferAccessStrategy own_strategy_;
+  BufferAccessStrategy *strategy_{&own_strategy_};
+  /** Pages of the current morsel still to be read */
+  size_t page_cursor_{0};
+  size_t page_end_{0};
+  /** Columns read from the pages taken from morsels_, indexes in the schema of the table */
+  std::vector<uint32_t> scan_columns_;
+  /** The predicate on rows made of scan_columns_, nullptr if none */
+  AbstractExpressionRef scan_predicate_;
+  /** Position in scan_columns_ of each output column */
+  std::vector<uint32_t> output_positions_;
+  /** Values of scan_columns_ of the tuples read from the current page */
+  std::vector<std::vector<Field>> page_columns_;
+  std::vector<RowId> page_rids_;
+  size_t row_cursor_{0};
+  /** The predicate on the codes, nullptr if the rows are decoded before the predicate */
+  AbstractExpressionRef code_predicate_;
 };
 
 #endif  // MINISQL_SEQ_SCAN_EXECUTOR_H
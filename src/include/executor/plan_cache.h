@@ -0,0 +1,81 @@
+#ifndef MINISQL_PLAN_CACHE_H
+#define MINISQL_PLAN_CACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/macros.h"
+#include "executor/plans/abstract_plan.h"
+#include "planner/expressions/parameter_value_expression.h"
+
+static constexpr size_t DEFAULT_PLAN_CACHE_SIZE = 128;  // number of statements whose plans are kept
+
+/**
+ * A plan ready to be run, its parameters are bound before each run.
+ */
+struct CachedPlan {
+  AbstractPlanNodeRef plan_;
+  /** '?' parameters ordered by their position */
+  std::vector<ParameterValueExpressionRef> params_;
+  /** catalog version the plan was made at */
+  uint64_t version_;
+};
+
+/**
+ * PlanCache keeps the plans of prepared statements, keyed by the normalized statement text.
+ *
+ * Bound parameters live in the plan, so a plan is run by one session at a time: Acquire hands an
+ * idle plan out and Release puts it back once the statement finished. Sessions running the same
+ * statement at the same time get plans of their own. Plans made at an older catalog version are
+ * dropped when met, the least recently used statements are evicted beyond the capacity.
+ */
+class PlanCache {
+ public:
+  explicit PlanCache(size_t capacity = DEFAULT_PLAN_CACHE_SIZE) : capacity_(capacity) {}
+
+  DISALLOW_COPY_AND_MOVE(PlanCache);
+
+  /**
+   * Take an idle plan of sql made at catalog version.
+   * @return nullptr if there is none, the statement has to be planned
+   */
+  std::unique_ptr<CachedPlan> Acquire(const std::string &sql, uint64_t version);
+
+  /**
+   * Give a plan taken by Acquire or newly made back to the cache.
+   */
+  void Release(const std::string &sql, std::unique_ptr<CachedPlan> plan);
+
+  /** @return number of idle plans kept */
+  size_t GetPlanCount();
+
+  inline size_t GetHitCount() const { return hits_; }
+
+  inline size_t GetMissCount() const { return misses_; }
+
+  /**
+   * Collapse the white space outside of string literals, so statements differing in layout only share
+   * their plans.
+   */
+  static std::string Normalize(const std::string &sql);
+
+ private:
+  struct Entry {
+    std::vector<std::unique_ptr<CachedPlan>> idle_;
+    std::list<std::string>::iterator lru_pos_;
+  };
+
+  std::mutex latch_;
+  size_t capacity_;
+  std::unordered_map<std::string, Entry> entries_;
+  /** statements, most recently used first */
+  std::list<std::string> lru_;
+  size_t hits_{0};
+  size_t misses_{0};
+};
+
+#endif  // MINISQL_PLAN_CACHE_H
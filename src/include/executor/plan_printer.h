@@ -0,0 +1,43 @@
+#ifndef MINISQL_PLAN_PRINTER_H
+#define MINISQL_PLAN_PRINTER_H
+
+#include <ostream>
+#include <string>
+
+#include "executor/execute_context.h"
+#include "executor/plans/abstract_plan.h"
+#include "planner/expressions/abstract_expression.h"
+
+/**
+ * PlanPrinter writes a plan tree for EXPLAIN, one operator per line with its children indented below it.
+ * Tables, indexes and predicates are printed by name. Once the plan ran with EXPLAIN ANALYZE, the counters
+ * the executors collected in the context are printed after each operator.
+ *
+ * The context decides how a plan would run, a sequential scan run by parallel workers is printed below a
+ * Gather operator.
+ */
+class PlanPrinter {
+ public:
+  explicit PlanPrinter(ExecuteContext *exec_ctx) : exec_ctx_(exec_ctx) {}
+
+  void Print(const AbstractPlanNode *plan, std::ostream &out);
+
+ private:
+  void PrintNode(const AbstractPlanNode *plan, int depth, std::ostream &out);
+
+  /** @return the line of an operator without its counters */
+  std::string Describe(const AbstractPlanNode *plan);
+
+  /** @return the counters of the executor which ran plan, empty if it did not run */
+  std::string DescribeStats(const AbstractPlanNode *plan);
+
+  /** @return expr with the columns named after the table schema */
+  std::string DescribeExpression(const AbstractExpressionRef &expr, const Schema *schema);
+
+  /** @return the schema of the table, nullptr if it does not exist */
+  const Schema *GetTableSchema(const std::string &table_name);
+
+  ExecuteContext *exec_ctx_;
+};
+
+#endif  // MINISQL_PLAN_PRINTER_H
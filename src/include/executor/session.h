@@ -0,0 +1,43 @@
+#ifndef MINISQL_SESSION_H
+#define MINISQL_SESSION_H
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "transaction/transaction.h"
+
+struct StatementProfile;
+
+static constexpr size_t MAX_PARALLELISM = 64;  // max number of workers of a parallel scan
+
+/**
+ * Session keeps the state of one client: the database in use, the transaction started by BEGIN, its
+ * prepared statements, its settings and the stream results and messages are written to.
+ */
+class Session {
+ public:
+  explicit Session(std::ostream &out = std::cout) : out_(&out) {}
+
+  inline std::ostream &Out() { return *out_; }
+
+  inline void SetOut(std::ostream &out) { out_ = &out; }
+
+  /** database in use, empty if none */
+  std::string current_db_;
+  /** explicit transaction started by BEGIN */
+  Transaction *current_txn_{nullptr};
+  /** normalized text of the statements prepared by PREPARE, by name */
+  std::unordered_map<std::string, std::string> prepared_;
+  /** number of workers a sequential scan may use, changed by SET parallelism = n */
+  size_t parallelism_{1};
+  /** whether the databases created compress their pages, changed by SET page_compression = 0 or 1 */
+  bool page_compression_{false};
+  /** cost of the statement running, nullptr if it is not profiled */
+  StatementProfile *profile_{nullptr};
+
+ private:
+  std::ostream *out_;
+};
+
+#endif  // MINISQL_SESSION_H
@@ -0,0 +1,127 @@
+#ifndef MINISQL_STATEMENT_STATS_H
+#define MINISQL_STATEMENT_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "buffer/buffer_pool.h"
+#include "common/metrics.h"
+
+static constexpr size_t MAX_STATEMENT_FINGERPRINTS = 1000;  // fingerprints beyond are counted together
+
+/**
+ * What one statement cost, filled in by the engine while it runs the statement. The time not spent parsing,
+ * planning or formatting the result is counted as execution.
+ */
+struct StatementProfile {
+  std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};  // when parsing was done
+  std::chrono::nanoseconds parse_{0};
+  std::chrono::nanoseconds plan_{0};
+  std::chrono::nanoseconds execute_{0};
+  std::chrono::nanoseconds format_{0};
+  BufferPoolStats buffer_;  // buffer pool work of the statement
+  std::string plan_text_;   // printed plan, kept for a statement already slow when its plan was done
+
+  /** @return time since the statement was handed to the parser */
+  inline std::chrono::nanoseconds GetElapsed() const { return parse_ + (std::chrono::steady_clock::now() - start_); }
+
+  inline std::chrono::nanoseconds GetTotal() const { return parse_ + plan_ + execute_ + format_; }
+};
+
+/**
+ * PhaseTimer adds the time from its construction to its destruction to one phase of a profile. Without a
+ * profile it does nothing.
+ */
+class PhaseTimer {
+ public:
+  PhaseTimer(StatementProfile *profile, std::chrono::nanoseconds StatementProfile::*phase)
+      : profile_(profile), phase_(phase), start_(std::chrono::steady_clock::now()) {}
+
+  ~PhaseTimer() {
+    if (profile_ != nullptr) {
+      profile_->*phase_ += std::chrono::steady_clock::now() - start_;
+    }
+  }
+
+ private:
+  StatementProfile *profile_;
+  std::chrono::nanoseconds StatementProfile::*phase_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Latency of the statements with one fingerprint.
+ */
+struct StatementLatency {
+  LatencyHistogram total_;
+  std::atomic<uint64_t> parse_ns_{0};
+  std::atomic<uint64_t> plan_ns_{0};
+  std::atomic<uint64_t> execute_ns_{0};
+  std::atomic<uint64_t> format_ns_{0};
+};
+
+/**
+ * StatementStats aggregates the latency of statements by fingerprint, the text of a statement with its
+ * literals replaced by '?'. Statements differing only in their constants share a histogram, so the p99 of
+ * one kind of statement can be told from the others.
+ */
+class StatementStats {
+ public:
+  explicit StatementStats(size_t max_fingerprints = MAX_STATEMENT_FINGERPRINTS) : max_fingerprints_(max_fingerprints) {}
+
+  /**
+   * @return sql normalized like PlanCache::Normalize, with numbers and strings replaced by '?' and the rows of
+   * a multi-row insert folded into one
+   */
+  static std::string Fingerprint(const std::string &sql);
+
+  void Record(const std::string &fingerprint, const StatementProfile &profile);
+
+  /** Call func for every fingerprint, the one which took the longest in total first */
+  void ForEach(const std::function<void(const std::string &, const StatementLatency &)> &func);
+
+  /** @return the latency of all statements together */
+  inline const LatencyHistogram &GetTotalLatency() const { return all_; }
+
+  /** Fingerprint the statements are counted under once there are max_fingerprints others */
+  static constexpr const char *OTHER_FINGERPRINT = "<other>";
+
+ private:
+  size_t max_fingerprints_;
+  std::mutex latch_;  // guards the map, the latencies are updated without it
+  std::unordered_map<std::string, std::unique_ptr<StatementLatency>> latencies_;
+  LatencyHistogram all_;
+};
+
+/**
+ * SlowQueryLog appends every statement which took at least the threshold to a file, with the time of each
+ * phase, its buffer pool work and its plan.
+ */
+class SlowQueryLog {
+ public:
+  /** @return false if the file could not be opened */
+  bool Open(const std::string &path, std::chrono::nanoseconds threshold);
+
+  /** @return whether a statement which took elapsed goes to the log */
+  inline bool IsSlow(std::chrono::nanoseconds elapsed) const { return enabled_ && elapsed >= threshold_; }
+
+  void Write(const std::string &sql, const std::string &db_name, const StatementProfile &profile, bool success);
+
+  /** @return number of statements logged */
+  inline uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+
+ private:
+  bool enabled_{false};
+  std::chrono::nanoseconds threshold_{0};
+  std::mutex latch_;
+  std::ofstream file_;
+  std::atomic<uint64_t> count_{0};
+};
+
+#endif  // MINISQL_STATEMENT_STATS_H
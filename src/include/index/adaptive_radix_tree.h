@@ -0,0 +1,100 @@
+#ifndef MINISQL_ADAPTIVE_RADIX_TREE_H
+#define MINISQL_ADAPTIVE_RADIX_TREE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "common/rowid.h"
+
+/**
+ * In memory adaptive radix tree (Leis et al., ICDE 2013) from byte string keys to row ids.
+ *
+ * (1) Inner nodes hold 4, 16, 48 or 256 children and grow or shrink between these sizes
+ * (2) A chain of nodes with one child is collapsed into a prefix of the node below it, at most
+ *     MAX_PREFIX_LENGTH bytes of the prefix are kept, a longer one is read from a leaf below it
+ * (3) A leaf holds the whole key, no key may be a prefix of another key
+ *
+ * Keys are ordered by their unsigned bytes, a scan visits them in this order.
+ */
+class AdaptiveRadixTree {
+ public:
+  static constexpr uint32_t MAX_PREFIX_LENGTH = 10;
+
+  AdaptiveRadixTree() = default;
+
+  ~AdaptiveRadixTree();
+
+  AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+
+  AdaptiveRadixTree &operator=(const AdaptiveRadixTree &) = delete;
+
+  /**
+   * @return false if the key is already in the tree
+   */
+  bool Insert(const std::string &key, const RowId &value);
+
+  /**
+   * @return false if the key is not in the tree
+   */
+  bool Remove(const std::string &key);
+
+  bool GetValue(const std::string &key, RowId &value) const;
+
+  /**
+   * Visit the keys of the tree in order, from the first key above low, or from the first key if low is null.
+   * The scan stops when visit returns false.
+   */
+  void Scan(const std::string *low, bool low_inclusive,
+            const std::function<bool(const std::string &, const RowId &)> &visit) const;
+
+  /** Remove every key */
+  void Clear();
+
+  inline size_t Size() const { return size_; }
+
+  /**
+   * Check the size of every node and that the keys are in order.
+   */
+  bool Verify() const;
+
+ private:
+  struct Node;
+  struct Leaf;
+  struct InnerNode;
+  struct Node4;
+  struct Node16;
+  struct Node48;
+  struct Node256;
+
+  static Node **FindChild(InnerNode *node, uint8_t byte);
+
+  static void AddChild(Node *&ref, uint8_t byte, Node *child);
+
+  static void RemoveChild(Node *&ref, uint8_t byte);
+
+  static const Leaf *Minimum(const Node *node);
+
+  /** @return number of bytes of the prefix of the node which match the key from depth on */
+  static uint32_t PrefixMismatch(const InnerNode *node, const std::string &key, uint32_t depth);
+
+  static bool InsertAt(Node *&ref, const std::string &key, const RowId &value, uint32_t depth);
+
+  static bool RemoveAt(Node *&ref, const std::string &key, uint32_t depth);
+
+  static bool ScanAt(const Node *node, uint32_t depth, const std::string *low, bool low_inclusive,
+                     const std::function<bool(const std::string &, const RowId &)> &visit);
+
+  static bool VerifyAt(const Node *node, uint32_t depth, const std::string **last);
+
+  /** Call f(byte, child) for the children of the node in the order of their bytes until it returns false */
+  template <typename F>
+  static bool ForEachChild(const InnerNode *node, F &&f);
+
+  static void Free(Node *node);
+
+  Node *root_{nullptr};
+  size_t size_{0};
+};
+
+#endif  // MINISQL_ADAPTIVE_RADIX_TREE_H
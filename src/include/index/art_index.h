@@ -0,0 +1,52 @@
+#ifndef MINISQL_ART_INDEX_H
+#define MINISQL_ART_INDEX_H
+
+#include <shared_mutex>
+#include <string>
+
+#include "index/adaptive_radix_tree.h"
+#include "index/index.h"
+#include "storage/table_heap.h"
+
+/**
+ * Index on an in memory adaptive radix tree, selected by CREATE INDEX ... USING art. It is meant for small hot
+ * tables: a lookup reads no page of the buffer pool. The tree is not written to disk, it is filled from the table
+ * each time the index is opened.
+ *
+ * The key columns are encoded into bytes which sort as the fields do, so the tree answers every operator of
+ * ScanKey, a range returns its row ids in key order.
+ */
+class ArtIndex : public Index {
+ public:
+  ArtIndex(index_id_t index_id, IndexSchema *key_schema);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                  std::string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+  /**
+   * Fill the tree with the keys of the rows of a table.
+   */
+  dberr_t Rebuild(TableHeap *table_heap, Schema *table_schema);
+
+  /**
+   * Encode the key row so that encoded keys compare by their unsigned bytes as the rows compare by their fields.
+   * Each field is a tag byte, 0 for null and 1 otherwise, then an int or float as 4 big endian bytes whose order
+   * is the order of the numbers, or the bytes of a char with each 0 escaped as 0 1 and ended by 0 0. No encoded
+   * key is a prefix of another.
+   */
+  std::string EncodeKey(const Row &key) const;
+
+  inline AdaptiveRadixTree &GetContainer() { return container_; }
+
+ protected:
+  std::shared_mutex latch_;
+  AdaptiveRadixTree container_;
+};
+
+#endif  // MINISQL_ART_INDEX_H
@@ -35,6 +35,10 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
+  // Insert key-value pairs sorted by key in one pass, inserted tells which ones were not duplicates.
+  size_t InsertBatch(const std::vector<std::pair<GenericKey *, RowId>> &entries, std::vector<bool> &inserted,
+                     Transaction *transaction = nullptr);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const GenericKey *key, Transaction *transaction = nullptr);
 
@@ -72,6 +76,10 @@ class BPlusTree {
 
   bool InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
 
+  void SplitLeaf(LeafPage *node, Transaction *transaction);
+
+  Page *FindLeafPage(const GenericKey *key, GenericKey *upper_bound, bool *has_upper_bound);
+
   void InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
@@ -96,6 +104,9 @@ class BPlusTree {
 
   void UpdateRootPageId(int insert_record = 0);
 
+  /** Allocate a page of the tree, in the run of pages of the page the tree got last */
+  Page *NewTreePage(page_id_t &page_id);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
@@ -104,6 +115,7 @@ class BPlusTree {
   // member variable
   index_id_t index_id_;
   page_id_t root_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};  // page the tree got last
   BufferPoolManager *buffer_pool_manager_;
   KeyManager processor_;
   int leaf_max_size_;
@@ -1,6 +1,8 @@
 #ifndef MINISQL_B_PLUS_TREE_INDEX_H
 #define MINISQL_B_PLUS_TREE_INDEX_H
 
+#include <shared_mutex>
+
 #include "index/b_plus_tree.h"
 #include "index/generic_key.h"
 #include "index/index.h"
@@ -11,6 +13,9 @@ class BPlusTreeIndex : public Index {
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
+  dberr_t InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids, Transaction *txn,
+                        std::vector<bool> &inserted) override;
+
   dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
   dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn, string compare_operator = "=") override;
@@ -24,6 +29,8 @@ class BPlusTreeIndex : public Index {
   IndexIterator GetEndIterator();
 
  protected:
+  // the tree itself is not thread safe, sessions running concurrently share it through this latch
+  std::shared_mutex latch_;
   // comparator for key
   KeyManager processor_;
   // container
@@ -0,0 +1,86 @@
+#ifndef MINISQL_EXTENDIBLE_HASH_TABLE_H
+#define MINISQL_EXTENDIBLE_HASH_TABLE_H
+
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/generic_key.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+#include "transaction/transaction.h"
+
+/**
+ * Disk based extendible hash table, a directory page whose slots point to bucket pages.
+ *
+ * (1) Only unique keys are supported, keys are compared by their serialized bytes
+ * (2) A full bucket splits in two by one more bit of the hash, the directory doubles when the bucket uses
+ *     every bit it has. A bucket which can not split any more, the directory filling its page, links overflow
+ *     pages
+ * (3) Buckets are not merged, a removal only frees an emptied overflow page
+ *
+ * The directory page id is kept in the index roots page, like the root of a B+ tree.
+ */
+class ExtendibleHashTable {
+ public:
+  /**
+   * Open the hash table of an index, a new table with one empty bucket is made if the index has none.
+   */
+  ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyManager &key_manager);
+
+  /**
+   * @return false if the key is already in the table or a page could not be had
+   */
+  bool Insert(GenericKey *key, const RowId &value, Transaction *transaction = nullptr);
+
+  /**
+   * @return false if the key is not in the table
+   */
+  bool Remove(const GenericKey *key, Transaction *transaction = nullptr);
+
+  bool GetValue(const GenericKey *key, std::vector<RowId> &result, Transaction *transaction = nullptr);
+
+  /**
+   * Visit every pair of the table, in no order.
+   */
+  void ForEach(const std::function<void(GenericKey *, const RowId &)> &visit);
+
+  /**
+   * Delete the pages of the table and its entry in the index roots page.
+   */
+  void Destroy();
+
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Check the directory and that every key is in the bucket its hash points to, and that no page is left pinned.
+   */
+  bool Verify();
+
+ private:
+  /** @return hash of the serialized key */
+  uint32_t Hash(const GenericKey *key) const;
+
+  inline HashTableDirectoryPage *FetchDirectory() {
+    return reinterpret_cast<HashTableDirectoryPage *>(buffer_pool_manager_->FetchPage(directory_page_id_)->GetData());
+  }
+
+  inline HashTableBucketPage *FetchBucket(page_id_t bucket_page_id) {
+    Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    return page == nullptr ? nullptr : reinterpret_cast<HashTableBucketPage *>(page->GetData());
+  }
+
+  /**
+   * Split the bucket of a slot by the next bit of the hash, the directory doubles if the bucket uses all of its
+   * bits. The caller checked that the local depth is below the largest.
+   * @return false if no page could be had for the new bucket
+   */
+  bool SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx);
+
+  index_id_t index_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  uint32_t key_size_;
+  page_id_t directory_page_id_{INVALID_PAGE_ID};
+};
+
+#endif  // MINISQL_EXTENDIBLE_HASH_TABLE_H
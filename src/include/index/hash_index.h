@@ -0,0 +1,37 @@
+#ifndef MINISQL_HASH_INDEX_H
+#define MINISQL_HASH_INDEX_H
+
+#include <shared_mutex>
+
+#include "index/extendible_hash_table.h"
+#include "index/generic_key.h"
+#include "index/index.h"
+
+/**
+ * Index on an extendible hash table, selected by CREATE INDEX ... USING hash. An equality lookup reads the
+ * directory and one bucket. The other operators of ScanKey are answered by walking every bucket, the planner
+ * is better off with a B+ tree for them.
+ */
+class HashIndex : public Index {
+ public:
+  HashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size, BufferPoolManager *buffer_pool_manager);
+
+  dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) override;
+
+  dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                  std::string compare_operator = "=") override;
+
+  dberr_t Destroy() override;
+
+  inline ExtendibleHashTable &GetContainer() { return container_; }
+
+ protected:
+  // the table itself is not thread safe, sessions running concurrently share it through this latch
+  std::shared_mutex latch_;
+  KeyManager processor_;
+  ExtendibleHashTable container_;
+};
+
+#endif  // MINISQL_HASH_INDEX_H
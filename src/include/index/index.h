@@ -2,6 +2,8 @@
 #define MINISQL_INDEX_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common/dberr.h"
 #include "record/row.h"
@@ -15,13 +17,32 @@ class Index {
 
   virtual dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
+  /**
+   * Insert many entries, an index may reorder them to apply them in one pass.
+   * @param[out] inserted whether each entry was inserted
+   */
+  virtual dberr_t InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids, Transaction *txn,
+                                std::vector<bool> &inserted) {
+    inserted.assign(keys.size(), false);
+    for (size_t i = 0; i < keys.size(); i++) {
+      inserted[i] = InsertEntry(keys[i], row_ids[i], txn) == DB_SUCCESS;
+    }
+    return DB_SUCCESS;
+  }
+
+  /**
+   * Remove the entry of key if it points at row_id.
+   * @return DB_KEY_NOT_FOUND if there is no such entry
+   */
   virtual dberr_t RemoveEntry(const Row &key, RowId row_id, Transaction *txn) = 0;
 
   virtual dberr_t ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
-                          string compare_operator = "=") = 0;
+                          std::string compare_operator = "=") = 0;
 
   virtual dberr_t Destroy() = 0;
 
+  inline IndexSchema *GetKeySchema() const { return key_schema_; }
+
  protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
@@ -14,12 +14,21 @@ class BitmapPage {
    */
   static constexpr size_t GetMaxSupportedSize() { return 8 * MAX_CHARS; }
 
+  /** Pages of a run, the pages of one word of the bitmap. A run starts at a multiple of RUN_SIZE. */
+  static constexpr uint32_t RUN_SIZE = 64;
+
   /**
    * @param page_offset Index in extent of the page allocated.
    * @return true if successfully allocate a page.
    */
   bool AllocatePage(uint32_t &page_offset);
 
+  /**
+   * @param page_offset Index in extent of the page to allocate.
+   * @return true if the page was free and is allocated now.
+   */
+  bool AllocatePageAt(uint32_t page_offset);
+
   /**
    * @return true if successfully de-allocate a page.
    */
@@ -30,6 +39,12 @@ class BitmapPage {
    */
   bool IsPageFree(uint32_t page_offset) const;
 
+  /** @return the first free page at or after from, GetMaxSupportedSize() if there is none */
+  uint32_t NextFreePage(uint32_t from) const;
+
+  /** @return first page of the first run at or after from with all pages free, GetMaxSupportedSize() if none */
+  uint32_t NextFreeRun(uint32_t from) const;
+
  private:
   /**
    * check a bit(byte_index, bit_index) in bytes is free(value 0).
@@ -40,6 +55,9 @@ class BitmapPage {
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /** @return word of the bitmap holding the bits of a run */
+  uint64_t GetRunBits(uint32_t run) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
@@ -5,8 +5,30 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-
+/** Extents of a database kept in a single file, as many as the meta page has room for */
+static constexpr uint32_t SINGLE_FILE_MAX_EXTENTS = (PAGE_SIZE - 8) / 4;
+/** Extents of a database split into segments, as many as there are positive page ids for */
+static constexpr uint32_t MAX_EXTENTS = INT32_MAX / BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+static constexpr page_id_t MAX_VALID_PAGE_ID = MAX_EXTENTS * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+
+/** Extents of a segmented database whose used page counts are in the meta page, its last slots hold the format
+ * flags, the page size and the magic */
+static constexpr uint32_t META_PAGE_EXTENTS = SINGLE_FILE_MAX_EXTENTS - 3;
+/** Pages following the meta page with the used page counts of the other extents of a segmented database */
+static constexpr uint32_t META_DIRECTORY_PAGES = ((MAX_EXTENTS - META_PAGE_EXTENTS) * 4 + PAGE_SIZE - 1) / PAGE_SIZE;
+/** Last word of the meta page of a segmented database, above any used page count of an extent */
+static constexpr uint32_t SEGMENTED_FILE_MAGIC = 0x4D534732;
+/** Format flag of a database whose data pages are compressed */
+static constexpr uint32_t META_FLAG_COMPRESSED = 1;
+
+/**
+ * The meta page is the first page of a database file.
+ *
+ * A single file database has the used page counts of all its extents in the meta page, its pages are of 4 KB. A
+ * segmented database has those of the first META_PAGE_EXTENTS extents there, its format flags, its page size and
+ * SEGMENTED_FILE_MAGIC in the last three slots, so the page size and the magic are in the last 8 bytes of the page
+ * whatever its size, and the counts of the other extents in META_DIRECTORY_PAGES pages following the meta page.
+ */
 class DiskFileMetaPage {
  public:
   uint32_t GetExtentNums() { return num_extents_; }
@@ -20,6 +42,14 @@ class DiskFileMetaPage {
     return extent_used_page_[extent_id];
   }
 
+  inline bool IsSegmented() const { return extent_used_page_[META_PAGE_EXTENTS + 2] == SEGMENTED_FILE_MAGIC; }
+
+  /** @return size of the pages of the database */
+  inline uint32_t GetPageSize() const { return IsSegmented() ? extent_used_page_[META_PAGE_EXTENTS + 1] : 4096; }
+
+  /** @return the META_FLAG_ bits of the format of the database */
+  inline uint32_t GetFlags() const { return IsSegmented() ? extent_used_page_[META_PAGE_EXTENTS] : 0; }
+
  public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};  // each extent consists with a bit map and BIT_MAP_SIZE pages
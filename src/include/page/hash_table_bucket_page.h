@@ -0,0 +1,72 @@
+#ifndef MINISQL_HASH_TABLE_BUCKET_PAGE_H
+#define MINISQL_HASH_TABLE_BUCKET_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "index/generic_key.h"
+
+/**
+ * Bucket page of an extendible hash table, it holds the key and row id pairs in no order. A bucket which can
+ * not split any more, its local depth is the largest the directory allows, links overflow pages of its own.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------------------
+ * | PageId (4) | NextPageId (4) | Size (4) | KEY(1) + RID(1) | KEY(2) + RID(2) | ... |
+ *  ----------------------------------------------------------------------------------
+ */
+class HashTableBucketPage {
+ public:
+  void Init(page_id_t page_id);
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  /** @return the overflow page of the bucket, INVALID_PAGE_ID if none */
+  inline page_id_t GetNextPageId() const { return next_page_id_; }
+
+  inline void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  inline uint32_t GetSize() const { return size_; }
+
+  /** @return number of pairs a page holds */
+  static inline uint32_t GetCapacity(uint32_t key_size) {
+    return (PAGE_SIZE - HEADER_SIZE) / (key_size + sizeof(RowId));
+  }
+
+  inline bool IsFull(uint32_t key_size) const { return size_ >= GetCapacity(key_size); }
+
+  inline GenericKey *KeyAt(uint32_t index, uint32_t key_size) {
+    return reinterpret_cast<GenericKey *>(data_ + index * (key_size + sizeof(RowId)));
+  }
+
+  inline RowId ValueAt(uint32_t index, uint32_t key_size) const {
+    return *reinterpret_cast<const RowId *>(data_ + index * (key_size + sizeof(RowId)) + key_size);
+  }
+
+  /**
+   * The keys of an index are serialized into zeroed buffers of key_size bytes, equal keys have equal bytes.
+   * @return index of the key, -1 if the page does not hold it
+   */
+  int KeyIndex(const GenericKey *key, uint32_t key_size);
+
+  /**
+   * Append a pair, the caller checked that the page is not full.
+   */
+  void Insert(const GenericKey *key, const RowId &value, uint32_t key_size);
+
+  /**
+   * Remove a pair, the last pair takes its place.
+   */
+  void RemoveAt(uint32_t index, uint32_t key_size);
+
+  static constexpr uint32_t HEADER_SIZE = 12;
+
+ private:
+  page_id_t page_id_;
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[0];
+};
+
+#endif  // MINISQL_HASH_TABLE_BUCKET_PAGE_H
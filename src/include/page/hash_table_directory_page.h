@@ -0,0 +1,86 @@
+#ifndef MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+#define MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/** @return the largest global depth whose directory fits a page */
+static constexpr uint32_t ComputeHashDirectoryMaxDepth() {
+  uint32_t depth = 0;
+  while (8 + (2U << depth) * (sizeof(uint8_t) + sizeof(page_id_t)) <= PAGE_SIZE) {
+    depth++;
+  }
+  return depth;
+}
+
+/**
+ * Directory page of an extendible hash table. Slot i of the directory points to the bucket of the keys whose
+ * hash ends in the global depth low bits of i, a bucket of local depth d is shared by the 2^(global depth - d)
+ * slots which agree on the d low bits.
+ *
+ * Format (size in byte):
+ *  -------------------------------------------------------------------------------------------
+ * | PageId (4) | GlobalDepth (4) | LocalDepth_0 (1) | ... | BucketPageId_0 (4) | ... |
+ *  -------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  static constexpr uint32_t MAX_DEPTH = ComputeHashDirectoryMaxDepth();
+  static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 1U << MAX_DEPTH;
+
+  /**
+   * A directory of global depth 0, its one slot points to bucket_page_id.
+   */
+  void Init(page_id_t page_id, page_id_t bucket_page_id);
+
+  inline page_id_t GetPageId() const { return page_id_; }
+
+  inline uint32_t GetGlobalDepth() const { return global_depth_; }
+
+  inline uint32_t GetGlobalDepthMask() const { return (1U << global_depth_) - 1; }
+
+  /** @return number of slots of the directory */
+  inline uint32_t Size() const { return 1U << global_depth_; }
+
+  inline bool CanGrow() const { return global_depth_ < MAX_DEPTH; }
+
+  /**
+   * Double the directory, the slots of the new half point to the buckets of the slots they mirror.
+   */
+  void IncrGlobalDepth();
+
+  inline page_id_t GetBucketPageId(uint32_t bucket_idx) const { return bucket_page_ids_[bucket_idx]; }
+
+  inline void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id) {
+    bucket_page_ids_[bucket_idx] = bucket_page_id;
+  }
+
+  inline uint32_t GetLocalDepth(uint32_t bucket_idx) const { return local_depths_[bucket_idx]; }
+
+  inline void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth) {
+    local_depths_[bucket_idx] = static_cast<uint8_t>(local_depth);
+  }
+
+  /**
+   * @return whether slot bucket_idx is the first of the slots which share its bucket, each bucket is visited once
+   * when only these slots are
+   */
+  inline bool IsFirstSlot(uint32_t bucket_idx) const { return bucket_idx < (1U << local_depths_[bucket_idx]); }
+
+  /**
+   * Check the invariants of the directory: no local depth above the global depth and the slots of a bucket are
+   * the ones agreeing on its local depth low bits.
+   */
+  bool Verify() const;
+
+ private:
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+static_assert(sizeof(HashTableDirectoryPage) <= PAGE_SIZE, "hash directory does not fit a page");
+
+#endif  // MINISQL_HASH_TABLE_DIRECTORY_PAGE_H
@@ -16,6 +16,7 @@
 class Page {
   // There is bookkeeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManager;
+  friend class BufferPool;
 
  public:
   DISALLOW_COPY(Page)
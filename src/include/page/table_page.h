@@ -15,6 +15,17 @@
  *  ----------------------------------------------------------------
  *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
  *  ----------------------------------------------------------------
+ *
+ * Columnar (PAX) page format, the page holds a fixed number of tuples, the capacity, and groups their values per
+ * column in minipages:
+ *  ----------------------------------------------------------------------------
+ *  | HEADER | SLOTS (8 * capacity) | MINIPAGE_1 | MINIPAGE_2 | ... | FREE SPACE |
+ *  ----------------------------------------------------------------------------
+ *  The header is the one above, its free space pointer holds COLUMNAR_FLAG | capacity. The slots are those of
+ *  the slotted page, so deletes and the walk over the tuples work alike, only the tuple size of a slot tells
+ *  whether it is used and its offset is unused. A minipage has a null bitmap of capacity bits followed by the
+ *  values of the column in slot order, a value of a char column is its length (2) followed by as many bytes as
+ *  the column is long.
  **/
 
 #include <cstring>
@@ -27,10 +38,32 @@
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
 
+/**
+ * How the pages of a table store their tuples, whole rows in slots or values grouped per column.
+ */
+enum class TableLayout : uint32_t { kRow = 0, kColumnar };
+
 class TablePage : public Page {
  public:
   void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn);
 
+  /**
+   * Init a columnar page for tuples of schema, the capacity must not be 0.
+   */
+  void InitColumnar(page_id_t page_id, page_id_t prev_id, Schema *schema, LogManager *log_mgr, Transaction *txn);
+
+  bool IsColumnar() { return (GetFreeSpacePointer() & COLUMNAR_FLAG) != 0; }
+
+  /**
+   * @return how many tuples of schema a columnar page holds, 0 if not even one fits
+   */
+  static uint32_t GetColumnarCapacity(Schema *schema);
+
+  /**
+   * @return whether the values of row fit the minipages of a columnar page, i.e. no char is longer than its column
+   */
+  static bool FitsColumnar(const Row &row, Schema *schema);
+
   page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
 
   page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
@@ -49,8 +82,22 @@ class TablePage : public Page {
 
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
-  bool UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn, LockManager *lock_manager,
-                   LogManager *log_manager);
+  /**
+   * Result of an in-place update.
+   */
+  enum UpdateStatus { kUpdateSuccess = 0, kUpdateInvalidSlot, kUpdateDeleted, kUpdateNoSpace, kUpdateLockFailed };
+
+  /**
+   * Update a tuple in place. Under a transaction the tuple keeps at least the space of the old one, so that the
+   * undo of the update always fits, TrimTuple gives the rest back when the transaction ends.
+   */
+  UpdateStatus UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn, LockManager *lock_manager,
+                           LogManager *log_manager);
+
+  /**
+   * Give back the space a tuple keeps beyond its size.
+   */
+  void TrimTuple(const RowId &rid, Schema *schema);
 
   void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
 
@@ -58,11 +105,66 @@ class TablePage : public Page {
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
-  bool GetFirstTupleRid(RowId *first_rid);
+  /**
+   * Read a tuple marked deleted, without locks. Its index entries are removed with it.
+   * @return false if the slot holds no tuple marked deleted
+   */
+  bool GetDeletedTuple(Row *row, Schema *schema);
+
+  /**
+   * @param include_deleted also return tuples marked deleted, snapshot readers may still see them
+   */
+  bool GetFirstTupleRid(RowId *first_rid, bool include_deleted = false);
 
-  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, bool include_deleted = false);
+
+  /**
+   * Read the given columns of the tuples not deleted, without locks. A columnar page reads only the minipages of
+   * these columns, a row page deserializes the whole tuples.
+   * @param[out] columns One vector per column id, the values are appended in slot order
+   * @param[out] rids The rids of the tuples read are appended here unless it is null
+   */
+  void GetColumns(Schema *schema, const std::vector<uint32_t> &column_ids, std::vector<std::vector<Field>> *columns,
+                  std::vector<RowId> *rids = nullptr);
 
  private:
+  /**
+   * Find the slot of a new tuple, a free slot or else a new one below slot_limit, and lock it. The page is latched
+   * so the lock is only tried, a free slot locked by another transaction is passed over.
+   * @return false if no slot could be had
+   */
+  bool ClaimSlot(Transaction *txn, LockManager *lock_manager, uint32_t slot_limit, uint32_t *slot_num);
+
+  /**
+   * Change the space of a tuple, the tuples stored in front of it are moved. The bytes of the tuple are left
+   * where they were, the caller rewrites them. The caller checked that the page has the space.
+   */
+  void ResizeTuple(uint32_t slot_num, uint32_t new_size);
+
+  bool InsertColumnarTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager);
+
+  UpdateStatus UpdateColumnarTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn,
+                                   LockManager *lock_manager);
+
+  /** @return offset of the minipage of a column */
+  uint32_t GetMinipageOffset(Schema *schema, uint32_t column_id);
+
+  /** @return bytes a value of a column takes in its minipage */
+  static uint32_t GetColumnarWidth(const Column *column);
+
+  void WriteColumnarTuple(uint32_t slot_num, const Row &row, Schema *schema);
+
+  void ReadColumnarTuple(uint32_t slot_num, Row *row, Schema *schema);
+
+  /**
+   * Read the value of a column at a slot, minipage_offset is where the minipage of the column starts.
+   * @param append Called with the arguments of the Field constructor which makes the value
+   */
+  template <typename Append>
+  void ReadColumnarField(uint32_t slot_num, const Column *column, uint32_t minipage_offset, Append append);
+
+  uint32_t GetColumnarCapacity() { return GetFreeSpacePointer() & ~COLUMNAR_FLAG; }
+
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
   void SetFreeSpacePointer(uint32_t free_space_pointer) {
@@ -110,6 +212,10 @@ class TablePage : public Page {
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
   static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
   static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  // the free space pointer of a row page never has this bit set
+  static constexpr uint32_t COLUMNAR_FLAG = 1U << 31;
+  // tuple size of a used slot of a columnar page
+  static constexpr uint32_t COLUMNAR_TUPLE_SIZE = 1;
 
  public:
   static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
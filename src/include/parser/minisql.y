@@ -17,17 +17,21 @@
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
+%token <syntax_node> PREPARE EXECUTE DEALLOCATE PARAM
+%token <syntax_node> EXPLAIN ANALYZE
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
 %type <syntax_node> sql_show_tables sql_create_table sql_drop_table
-%type <syntax_node> column_definition_list column_definition column_type column_list
+%type <syntax_node> column_definition_list column_definition column_type column_list table_option_list
 %type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
-%type <syntax_node> sql_insert sql_delete sql_update update_values update_value
+%type <syntax_node> sql_insert value_rows sql_delete sql_update update_values update_value
 %type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_prepare sql_execute sql_deallocate sql_set
+%type <syntax_node> sql_explain sql_explainable sql_show_status
 
 %%
 
@@ -58,6 +62,12 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_prepare { $$ = $1; }
+  | sql_execute { $$ = $1; }
+  | sql_deallocate { $$ = $1; }
+  | sql_set { $$ = $1; }
+  | sql_explain { $$ = $1; }
+  | sql_show_status { $$ = $1; }
   ;
 
 sql_create_database:
@@ -101,6 +111,28 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' IDENTIFIER '(' table_option_list ')' {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode option_node = CreateSyntaxNode(kNodeTableOption, $7->val_);
+    SyntaxNodeAddChildren(option_node, $9);
+    SyntaxNodeAddChildren($$, option_node);
+  }
+  ;
+
+table_option_list:
+  IDENTIFIER EQ IDENTIFIER ',' table_option_list {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+    SyntaxNodeAddSibling($$, $5);
+  }
+  | IDENTIFIER EQ IDENTIFIER {
+    $$ = $1;
+    SyntaxNodeAddSibling($$, $3);
+  }
   ;
 
 column_list:
@@ -259,6 +291,9 @@ column_value:
   | FLAGNULL {
     $$ = CreateSyntaxNode(kNodeNull, NULL);
   }
+  | PARAM {
+    $$ = $1;
+  }
   ;
 
 operator:
@@ -289,12 +324,22 @@ operator:
   ;
 
 sql_insert:
-  INSERT INTO IDENTIFIER VALUES '(' column_values ')' {
+  INSERT INTO IDENTIFIER VALUES value_rows {
     $$ = CreateSyntaxNode(kNodeInsert, NULL);
     SyntaxNodeAddChildren($$, $3);
-    pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
-    SyntaxNodeAddChildren(col_val_node, $6);
-    SyntaxNodeAddChildren($$, col_val_node);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  ;
+
+value_rows:
+  '(' column_values ')' ',' value_rows {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddSibling($$, $5);
+  }
+  | '(' column_values ')' {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -393,6 +438,68 @@ sql_exec_file:
   }
   ;
 
+sql_prepare:
+  PREPARE IDENTIFIER FROM STRING {
+    $$ = CreateSyntaxNode(kNodePrepare, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_execute:
+  EXECUTE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeExecute, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | EXECUTE IDENTIFIER USING column_values {
+    $$ = CreateSyntaxNode(kNodeExecute, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren(col_val_node, $4);
+    SyntaxNodeAddChildren($$, col_val_node);
+  }
+  ;
+
+sql_deallocate:
+  DEALLOCATE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeDeallocate, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_set:
+  SET IDENTIFIER EQ column_value {
+    $$ = CreateSyntaxNode(kNodeSet, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
+sql_explain:
+  EXPLAIN sql_explainable {
+    $$ = CreateSyntaxNode(kNodeExplain, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  | EXPLAIN ANALYZE sql_explainable {
+    $$ = CreateSyntaxNode(kNodeExplain, "analyze");
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
+sql_show_status:
+  SHOW IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeShowStatus, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
+sql_explainable:
+  sql_select { $$ = $1; }
+  | sql_insert { $$ = $1; }
+  | sql_delete { $$ = $1; }
+  | sql_update { $$ = $1; }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
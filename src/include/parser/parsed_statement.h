@@ -0,0 +1,56 @@
+#ifndef MINISQL_PARSED_STATEMENT_H
+#define MINISQL_PARSED_STATEMENT_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+extern "C" {
+#include "parser/syntax_tree.h"
+};
+
+/**
+ * ParsedStatement owns the syntax tree of one SQL statement.
+ *
+ * The generated parser keeps its state in globals, so parsing is serialized by a process wide latch.
+ * The nodes are detached from the parser once the statement is parsed, the tree stays valid until the
+ * statement is destroyed while other sessions go on parsing.
+ */
+class ParsedStatement {
+ public:
+  /**
+   * Parse a single statement terminated by ';'.
+   */
+  static std::unique_ptr<ParsedStatement> Parse(const std::string &sql);
+
+  ~ParsedStatement() { DestroySyntaxNodeList(nodes_); }
+
+  ParsedStatement(const ParsedStatement &) = delete;
+
+  ParsedStatement &operator=(const ParsedStatement &) = delete;
+
+  /** @return root of the syntax tree, nullptr on a syntax error */
+  inline pSyntaxNode GetRoot() const { return root_; }
+
+  inline bool HasError() const { return has_error_; }
+
+  inline const std::string &GetErrorMessage() const { return error_message_; }
+
+  /** @return the text the statement was parsed from */
+  inline const std::string &GetSql() const { return sql_; }
+
+  /** @return time spent parsing, waiting for other sessions to finish parsing included */
+  inline std::chrono::nanoseconds GetParseTime() const { return parse_time_; }
+
+ private:
+  ParsedStatement() = default;
+
+  pSyntaxNodeList nodes_{nullptr};
+  pSyntaxNode root_{nullptr};
+  bool has_error_{false};
+  std::string error_message_;
+  std::string sql_;
+  std::chrono::nanoseconds parse_time_{0};
+};
+
+#endif  // MINISQL_PARSED_STATEMENT_H
@@ -22,4 +22,9 @@ int MinisqlParserGetError();
 
 char *MinisqlParserGetErrorMessage();
 
+/**
+ * Create the node of the next '?' placeholder, placeholders are numbered from 0 in their order in the sql.
+ */
+pSyntaxNode MinisqlParserCreateParameter();
+
 #endif  // MINISQL_PARSER_H
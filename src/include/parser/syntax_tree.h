@@ -43,7 +43,15 @@ typedef enum {
   kNodeIndexType,            /** type of index */
   kNodeTrxBegin,             /** begin transaction command */
   kNodeTrxCommit,            /** commit transaction command */
-  kNodeTrxRollback           /** rollback transaction command */
+  kNodeTrxRollback,          /** rollback transaction command */
+  kNodeParameter,            /** '?' placeholder of a prepared statement, the value is its position */
+  kNodePrepare,              /** prepare command */
+  kNodeExecute,              /** execute command */
+  kNodeDeallocate,           /** deallocate command */
+  kNodeSet,                  /** set command, changes a setting of the session */
+  kNodeExplain,              /** explain command, the value is "analyze" if the statement is run */
+  kNodeShowStatus,           /** show status command, the child names what is shown */
+  kNodeTableOption           /** option of create table, the value is "with", the children the name and the value */
 } SyntaxNodeType;
 
 /**
@@ -87,4 +95,15 @@ struct SyntaxNodeList {
 };
 typedef struct SyntaxNodeList *pSyntaxNodeList;
 
+/**
+ * Take over the syntax nodes allocated by the last parse, they are no longer freed by DestroySyntaxTree
+ * and the parser may be reused while the tree is still in use
+ */
+pSyntaxNodeList DetachSyntaxTree();
+
+/**
+ * Free the syntax nodes returned by DetachSyntaxTree
+ */
+void DestroySyntaxNodeList(pSyntaxNodeList list);
+
 #endif  // MINISQL_SYNTAX_TREE_H
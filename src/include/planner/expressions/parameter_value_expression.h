@@ -0,0 +1,42 @@
+#ifndef MINISQL_PARAMETER_VALUE_EXPRESSION_H
+#define MINISQL_PARAMETER_VALUE_EXPRESSION_H
+
+#include "abstract_expression.h"
+
+class ParameterValueExpression;
+using ParameterValueExpressionRef = std::shared_ptr<ParameterValueExpression>;
+
+/**
+ * ParameterValueExpression represents a '?' placeholder of a prepared statement. It evaluates to the
+ * value bound last, so a cached plan is run with new parameters without being rebuilt.
+ */
+class ParameterValueExpression : public AbstractExpression {
+ public:
+  /**
+   * @param param_idx position of the placeholder in the statement
+   * @param ret_type type of the column the parameter is compared with or assigned to
+   */
+  ParameterValueExpression(uint32_t param_idx, TypeId ret_type)
+      : AbstractExpression({}, ret_type, ExpressionType::ParameterExpression), param_idx_(param_idx), val_(ret_type) {}
+
+  Field Evaluate([[maybe_unused]] const Row *row) const override { return Field(val_); }
+
+  Field EvaluateJoin([[maybe_unused]] const Row *left_row, [[maybe_unused]] const Row *right_row) const override {
+    return Field(val_);
+  }
+
+  /** @return the position of the placeholder in the statement */
+  uint32_t GetParamIdx() const { return param_idx_; }
+
+  /** Set the value of the parameter, called before the plan is executed. */
+  void Bind(const Field &val) {
+    Field copy(val);
+    val_ = copy;
+  }
+
+ private:
+  uint32_t param_idx_;
+  Field val_;
+};
+
+#endif  // MINISQL_PARAMETER_VALUE_EXPRESSION_H
@@ -43,6 +43,12 @@ class Planner {
   /** the root plan node of the plan tree */
   AbstractPlanNodeRef plan_;
 
+  /** the '?' parameters of the plan, ordered by their position in the statement */
+  std::vector<ParameterValueExpressionRef> params_;
+
+  /** Take the parameters met while binding statement. */
+  void CollectParameters(AbstractStatement *statement);
+
   Schema *MakeOutputSchema(const std::vector<std::pair<std::string, AbstractExpressionRef>> &exprs);
 
   /** Catalog will be used during the planning process. SHOULD ONLY BE USED IN
@@ -13,6 +13,7 @@
 #include "planner/expressions/comparison_expression.h"
 #include "planner/expressions/constant_value_expression.h"
 #include "planner/expressions/logic_expression.h"
+#include "planner/expressions/parameter_value_expression.h"
 
 extern "C" {
 #include "parser/parser.h"
@@ -30,6 +31,9 @@ class AbstractStatement {
 
   ExecuteContext *context_;
 
+  /** '?' placeholders met while binding the statement */
+  std::vector<ParameterValueExpressionRef> params_;
+
  public:
   /** Render this statement as a string. */
   virtual std::string ToString() const {
@@ -54,42 +58,51 @@ class AbstractStatement {
   }
 
   /**
-   * Allocate a constant value expression and return it to the caller.
+   * Convert a literal to a field of the column type.
+   * @param col_type The type of the column
+   * @param value The ptr to the SyntaxNode of the literal
+   * @return An owning pointer to the field
+   */
+  static std::unique_ptr<Field> MakeConstantField(TypeId col_type, pSyntaxNode value) {
+    if (value->type_ == kNodeNull) {
+      return std::make_unique<Field>(col_type);
+    }
+    switch (col_type) {
+      case kTypeInt: {
+        if (value->type_ != kNodeNumber)
+          throw std::logic_error("The value of the predicate does not match the type of column");
+        return std::make_unique<Field>(kTypeInt, stoi(value->val_));
+      }
+      case kTypeFloat: {
+        if (value->type_ != kNodeNumber)
+          throw std::logic_error("The value of the predicate does not match the type of column");
+        return std::make_unique<Field>(kTypeFloat, stof(value->val_));
+      }
+      case kTypeChar: {
+        if (value->type_ != kNodeString)
+          throw std::logic_error("The value of the predicate does not match the type of column");
+        return std::make_unique<Field>(kTypeChar, value->val_, strlen(value->val_), true);
+      }
+      default:
+        throw std::logic_error("The type of the column is kTypeInvalid");
+    }
+  }
+
+  /**
+   * Allocate a constant value expression and return it to the caller. A '?' placeholder gives a parameter
+   * expression, which is collected in params_.
    * @param col_type The type of the constant value
    * @param value The ptr to the SyntaxNode of the constant value
    * @return An owning pointer to the ConstantValueExpression
    */
   AbstractExpressionRef MakeConstantValueExpression(TypeId col_type, pSyntaxNode value) {
-    Field *f = nullptr;
-    if (value->type_ == kNodeNull) {
-      f = new Field(col_type);
-    } else {
-      switch (col_type) {
-        case kTypeInt: {
-          if (value->type_ != kNodeNumber)
-            throw std::logic_error("The value of the predicate does not match the type of column");
-          f = new Field(kTypeInt, stoi(value->val_));
-          break;
-        }
-        case kTypeFloat: {
-          if (value->type_ != kNodeNumber)
-            throw std::logic_error("The value of the predicate does not match the type of column");
-          f = new Field(kTypeFloat, stof(value->val_));
-          break;
-        }
-        case kTypeChar: {
-          if (value->type_ != kNodeString)
-            throw std::logic_error("The value of the predicate does not match the type of column");
-          f = new Field(kTypeChar, value->val_, strlen(value->val_), true);
-          break;
-        }
-        default:
-          throw std::logic_error("The type of the column is kTypeInvalid");
-      }
+    if (value->type_ == kNodeParameter) {
+      auto param_expr = std::make_shared<ParameterValueExpression>(std::stoul(value->val_), col_type);
+      params_.push_back(param_expr);
+      return param_expr;
     }
-    auto const_expr = std::make_shared<ConstantValueExpression>(*f);
-    delete f;
-    return const_expr;
+    auto f = MakeConstantField(col_type, value);
+    return std::make_shared<ConstantValueExpression>(*f);
   }
 
   /**
@@ -0,0 +1,92 @@
+#ifndef MINISQL_SERVER_H
+#define MINISQL_SERVER_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/dberr.h"
+#include "common/macros.h"
+#include "common/thread_pool.h"
+#include "executor/execute_engine.h"
+#include "executor/session.h"
+
+/**
+ * Server accepts clients on TCP and Unix domain sockets and runs their statements on a pool of
+ * worker threads, every client having a session of its own.
+ *
+ * A client sends statements terminated by ';' and gets one response per statement: the text the shell
+ * would print for it followed by a '\0'. A connection is served by one worker at a time, a worker
+ * runs the complete statements received so far and hands the connection back to the poller.
+ */
+class Server {
+ public:
+  /**
+   * @param num_workers number of worker threads, 0 to pick it from the number of cores
+   */
+  Server(ExecuteEngine *engine, size_t num_workers = 0);
+
+  ~Server();
+
+  DISALLOW_COPY_AND_MOVE(Server);
+
+  /**
+   * Listen on a TCP port of every interface, port 0 picks a free one.
+   */
+  dberr_t ListenTcp(uint16_t port);
+
+  /**
+   * Listen on a Unix domain socket created at path.
+   */
+  dberr_t ListenUnix(const std::string &path);
+
+  /**
+   * Serve the clients until Shutdown is called, the open connections are closed on return.
+   */
+  void Run();
+
+  /**
+   * Make Run return, can be called from any thread or a signal handler.
+   */
+  inline void Shutdown() { stop_ = true; }
+
+  /** @return the TCP port listened on, 0 if none */
+  inline uint16_t GetPort() const { return port_; }
+
+  inline size_t GetWorkerCount() const { return num_workers_; }
+
+ private:
+  struct Connection {
+    explicit Connection(int fd) : fd_(fd) {}
+
+    int fd_;
+    Session session_;
+    /** received text not yet run */
+    std::string buffer_;
+  };
+
+  void Accept(int listen_fd);
+
+  /** Run the statements received on conn, called by a worker */
+  void Serve(Connection *conn);
+
+  void Close(Connection *conn);
+
+  /** @return false if the client went away */
+  static bool SendAll(int fd, const std::string &data);
+
+  ExecuteEngine *engine_;
+  size_t num_workers_;
+  int epoll_fd_{-1};
+  std::vector<int> listen_fds_;
+  std::string unix_path_;
+  uint16_t port_{0};
+  std::atomic<bool> stop_{false};
+  std::mutex latch_;                                    /** guards connections_ */
+  std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+};
+
+#endif  // MINISQL_SERVER_H
@@ -0,0 +1,107 @@
+#ifndef MINISQL_COMPRESSED_PAGE_STORE_H
+#define MINISQL_COMPRESSED_PAGE_STORE_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+
+/**
+ * Page compression counters summed over all compressed databases since the process started.
+ */
+struct CompressionCounters {
+  std::atomic<uint64_t> pages_compressed_{0};    // pages written
+  std::atomic<uint64_t> bytes_in_{0};            // bytes of the pages written
+  std::atomic<uint64_t> bytes_out_{0};           // bytes stored for them, compressed or not
+  std::atomic<uint64_t> compress_ns_{0};         // time spent compressing
+  std::atomic<uint64_t> pages_decompressed_{0};  // compressed pages read
+  std::atomic<uint64_t> decompress_ns_{0};       // time spent decompressing
+};
+
+/**
+ * CompressedPageStore keeps the data pages of a compressed database, see DiskManager.
+ *
+ * A page is compressed with PageCodec and stored in a slot of the pack file, a slot is a multiple of SLOT_UNIT
+ * bytes. A compressed page starts its slot with the length of its data, a page which does not compress is stored
+ * as is in a slot of PAGE_SIZE bytes. The page map file has an entry per logical page id with the offset and size
+ * of its slot and whether the page is compressed.
+ *
+ * A page rewritten keeps its slot as long as the data fits and the page stays compressed or uncompressed, its map
+ * entry is then left as is. Else the page moves to a free slot of the size it needs or to the end of the pack
+ * file, and the entry is written after the data, so a page keeps its former content until the entry is written.
+ * The free slots are rebuilt from the gaps between the slots of the map when the store is opened, adjacent free
+ * slots are merged.
+ */
+class CompressedPageStore {
+ public:
+  /**
+   * Open the pack file and the page map file, they are created if need be.
+   * @throws std::runtime_error if a file cannot be opened
+   */
+  CompressedPageStore(const std::string &pack_file, const std::string &map_file);
+
+  ~CompressedPageStore();
+
+  /**
+   * Read a page, a page never written reads as zeros.
+   * @param bytes_read bytes read from the pack file
+   * @return false if the page is cut short in the pack file or does not decompress
+   */
+  bool ReadPage(page_id_t page_id, char *page_data, size_t &bytes_read);
+
+  /**
+   * Write a page.
+   * @return bytes written to the pack file
+   */
+  size_t WritePage(page_id_t page_id, const char *page_data);
+
+  /** Free the slot of a page */
+  void FreePage(page_id_t page_id);
+
+  /** @return bytes of the slots of the pages stored */
+  inline uint64_t GetStoredBytes() const { return stored_bytes_; }
+
+  /** @return size of the pack file, free slots included */
+  inline uint64_t GetPackFileSize() const { return pack_end_; }
+
+  /** @return the compression counters of all stores */
+  static CompressionCounters &GetCounters();
+
+  /** granularity of the slots */
+  static constexpr uint32_t SLOT_UNIT = 256;
+
+ private:
+  struct PageMapEntry {
+    uint64_t offset_;     // offset of the slot in the pack file
+    uint32_t slot_size_;  // 0 if the page has no slot
+    uint32_t data_size_;  // PAGE_SIZE if the page is stored uncompressed, else the size it moved in with
+  };
+
+  /** length of the data of a compressed page, at the start of its slot */
+  using DataLength = uint32_t;
+
+  /** @return offset of a free slot of size bytes, at the end of the pack file if there is none */
+  uint64_t AllocateSlot(uint32_t size);
+
+  /** Free a slot, it is merged with the free slots right before and after it */
+  void FreeSlot(uint64_t offset, uint64_t size);
+
+  /** Write the map entry of a page */
+  void WriteEntry(page_id_t page_id);
+
+  int pack_fd_{-1};
+  int map_fd_{-1};
+  std::vector<PageMapEntry> entries_;
+  // size of the free slots by offset, and the same slots by size
+  std::map<uint64_t, uint64_t> free_slots_;
+  std::set<std::pair<uint64_t, uint64_t>> free_slots_by_size_;
+  uint64_t pack_end_{0};
+  uint64_t stored_bytes_{0};
+};
+
+#endif  // MINISQL_COMPRESSED_PAGE_STORE_H
@@ -1,16 +1,33 @@
 #ifndef DISK_MGR_H
 #define DISK_MGR_H
 
+#include <algorithm>
 #include <atomic>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
+#include "common/metrics.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/compressed_page_store.h"
+
+/**
+ * Disk I/O counters summed over all database files since the process started.
+ */
+struct DiskIoCounters {
+  std::atomic<uint64_t> reads_{0};          // pages read
+  std::atomic<uint64_t> writes_{0};         // pages written
+  std::atomic<uint64_t> bytes_read_{0};     // bytes read, reads beyond the end of a file are not counted
+  std::atomic<uint64_t> bytes_written_{0};  // bytes written
+  LatencyHistogram read_latency_;           // time of each page read
+  LatencyHistogram write_latency_;          // time of each page write, flush included
+};
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -19,10 +36,37 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * A database created now is split into segments of EXTENTS_PER_SEGMENT extents, about a GB each. The first
+ * segment is the database file, it starts with the meta page and the META_DIRECTORY_PAGES pages of the meta
+ * directory. Segment s is the hidden file .<database file name>.s next to it, it starts right with an extent. A
+ * database made of a single file, the format of databases created before, is still opened and grows up to
+ * SINGLE_FILE_MAX_EXTENTS extents.
+ *
+ * Finding a free page does not depend on the size of the database. The bitmaps are read once and kept in memory,
+ * and a bit per extent tells whether the extent has a free page, so the first such extent is found by counting
+ * trailing zeros. Within the extent the bitmap keeps the first free page.
+ *
+ * A database created compressed keeps its data pages in a CompressedPageStore, the files .<database file name>.pack
+ * and .<database file name>.map next to it. Its segments then hold the meta page, the meta directory and the
+ * bitmaps only, the places of the data pages in them are never written so the files stay sparse. The pages are
+ * compressed when they are written and decompressed when they are read, so the buffer pool has them as they are.
+ *
+ * The page size is PAGE_SIZE, chosen when the build is configured. A segmented database records the page size it
+ * was created with in its meta page, a build with another page size refuses to open it.
+ *
+ * A table or index grows by runs of RUN_SIZE contiguous pages, see AllocatePageNear, so its pages are not
+ * interleaved with those of other objects and a scan reads them in file order. The space of a run is
+ * preallocated in the file system when the run is started.
  */
 class DiskManager {
  public:
-  explicit DiskManager(const std::string &db_file);
+  /**
+   * Open a database file, it is created if need be.
+   * @param compressed whether the data pages are compressed, for a database created now, else the format of the
+   * database decides
+   */
+  explicit DiskManager(const std::string &db_file, bool compressed = false);
 
   ~DiskManager() {
     if (!closed) {
@@ -33,8 +77,9 @@ class DiskManager {
   /**
    * Read page from specific page_id
    * Note: page_id = 0 is reserved for free page bit map
+   * @return false if the page of a compressed database cannot be read back, see CompressedPageStore::ReadPage
    */
-  void ReadPage(page_id_t logical_page_id, char *page_data);
+  bool ReadPage(page_id_t logical_page_id, char *page_data);
 
   /**
    * Write data to specific page
@@ -48,6 +93,14 @@ class DiskManager {
    */
   page_id_t AllocatePage();
 
+  /**
+   * Get a free page for an object growing by runs: the next free page of the run of last_page_id, the page
+   * the object got last, or else the first page of a run with all pages free, which is preallocated.
+   * @param last_page_id INVALID_PAGE_ID if the object has no page yet
+   * @return logical page id of allocated page
+   */
+  page_id_t AllocatePageNear(page_id_t last_page_id);
+
   /**
    * Free this page and reset bit map
    */
@@ -64,42 +117,106 @@ class DiskManager {
   void Close();
 
   /**
-   * Get Meta Page
+   * Get Meta Page, the used page counts of the extents past the meta page are not in it
    * Note: Used only for debug
    */
-  char *GetMetaData() { return meta_data_; }
+  char *GetMetaData();
+
+  /** @return whether the database is split into segments */
+  inline bool IsSegmented() const { return segmented_; }
+
+  /** @return whether the data pages of the database are compressed */
+  inline bool IsCompressed() const { return page_store_ != nullptr; }
+
+  /** @return the store of the data pages of a compressed database, nullptr if it is not compressed */
+  inline CompressedPageStore *GetPageStore() const { return page_store_.get(); }
+
+  /** @return number of segment files of the database */
+  uint32_t GetSegmentCount();
+
+  /** @return the I/O counters of all disk managers */
+  static DiskIoCounters &GetIoCounters();
+
+  /** Remove the files of a database, its segments included */
+  static void RemoveFiles(const std::string &db_file);
 
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
+  /** pages an object is given at a time */
+  static constexpr size_t RUN_SIZE = BitmapPage<PAGE_SIZE>::RUN_SIZE;
+
+  /** extents of a segment, about a GB, or a single extent when pages are so large an extent is larger */
+  static constexpr uint32_t EXTENTS_PER_SEGMENT =
+      std::max<uint32_t>(1, (1u << 30) / (BITMAP_SIZE * PAGE_SIZE));
+
  private:
-  /**
-   * Helper function to get disk file size
-   */
-  int GetFileSize(const std::string &file_name);
+  /** @return the bitmap of an extent, read from disk on first use */
+  BitmapPage<PAGE_SIZE> *GetExtentBitmap(uint32_t extent_id);
+
+  /** Allocate a page known to be free in an initialized extent */
+  page_id_t AllocatePageAt(uint32_t extent_id, uint32_t offset);
+
+  /** @return id of a new extent, max_extents_ if the database is full */
+  uint32_t AddExtent();
+
+  /** Have the file system reserve the space of the run starting at a page */
+  void PreallocateRun(page_id_t logical_page_id);
+
+  /** Set the bit of the extent in the free extent summary from its count of used pages */
+  void UpdateFreeExtents(uint32_t extent_id);
+
+  /** @return physical page id of the bitmap of an extent in its segment */
+  page_id_t GetBitmapPageId(uint32_t extent_id, uint32_t *segment);
+
+  /** @return path of the file of a segment */
+  static std::string GetSegmentFileName(const std::string &db_file, uint32_t segment);
+
+  /** @return page size of the database file open as fd, databases of the single file format have 4 KB pages */
+  static uint32_t ReadFilePageSize(int fd);
+
+  /** @return path of the hidden file .<database file name>.<suffix> next to the database file */
+  static std::string GetHiddenFileName(const std::string &db_file, const std::string &suffix);
+
+  /** @return file descriptor of a segment, the file is opened and created if need be */
+  int GetSegmentFd(uint32_t segment);
 
   /**
    * Read physical page from disk
    */
-  void ReadPhysicalPage(page_id_t physical_page_id, char *page_data);
+  void ReadPhysicalPage(uint32_t segment, page_id_t physical_page_id, char *page_data);
 
   /**
    * Write data to physical page in disk
    */
-  void WritePhysicalPage(page_id_t physical_page_id, const char *page_data);
+  void WritePhysicalPage(uint32_t segment, page_id_t physical_page_id, const char *page_data);
 
   /**
-   * Map logical page id to physical page id
+   * Map logical page id to physical page id in its segment
    */
-  page_id_t MapPageId(page_id_t logical_page_id);
+  page_id_t MapPageId(page_id_t logical_page_id, uint32_t *segment);
 
  private:
-  // stream to write db file
-  std::fstream db_io_;
   std::string file_name_;
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
+  // descriptors of the segment files opened so far, -1 for the others
+  std::vector<int> segment_fds_;
   bool closed{false};
   char meta_data_[PAGE_SIZE];
+  // whether the database is split into segments, else it is the single file of the former format
+  bool segmented_{false};
+  uint32_t max_extents_{SINGLE_FILE_MAX_EXTENTS};
+  uint32_t num_allocated_pages_{0};
+  // used page count of each extent initialized
+  std::vector<uint32_t> extent_used_pages_;
+  // bitmaps of the extents read so far
+  std::vector<std::unique_ptr<char[]>> extent_bitmaps_;
+  // bit e % 64 of word e / 64 is set if extent e has a free page
+  std::vector<uint64_t> free_extents_;
+  // bit w % 64 of word w / 64 is set if word w of free_extents_ is not 0
+  std::vector<uint64_t> free_extent_words_;
+  // data pages of a compressed database
+  std::unique_ptr<CompressedPageStore> page_store_;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef MINISQL_PAGE_CODEC_H
+#define MINISQL_PAGE_CODEC_H
+
+#include <cstddef>
+
+/**
+ * PageCodec compresses pages with a byte oriented LZ77 codec in the manner of LZ4, fast enough to run on every
+ * page read and write.
+ *
+ * The compressed data is a list of sequences. A sequence starts with a token byte, its high nibble is the number
+ * of literals and its low nibble the length of the match minus 4, a nibble of 15 is followed by bytes adding to
+ * the length up to a byte below 255. Then come the literals, then the offset of the match back from the current
+ * position in 2 bytes, little endian. The last sequence has literals only.
+ */
+class PageCodec {
+ public:
+  /**
+   * Compress size bytes of src into dst.
+   * @return size of the compressed data, 0 if it does not fit in capacity bytes
+   */
+  static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+  /**
+   * Decompress compressed_size bytes of src into dst.
+   * @return true iff src is well formed and decompresses to exactly size bytes
+   */
+  static bool Decompress(const char *src, size_t compressed_size, char *dst, size_t size);
+
+  /** shortest match, the matches are found through a hash of their first MIN_MATCH bytes */
+  static constexpr size_t MIN_MATCH = 4;
+
+  /** the last bytes of the input are always literals, so the search reads 4 bytes without a bound check */
+  static constexpr size_t LAST_LITERALS = 5;
+
+  /** farthest a match can be behind the position it is copied to */
+  static constexpr size_t MAX_OFFSET = 65535;
+};
+
+#endif  // MINISQL_PAGE_CODEC_H
@@ -0,0 +1,79 @@
+#ifndef MINISQL_TABLE_DICTIONARY_H
+#define MINISQL_TABLE_DICTIONARY_H
+
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+
+/**
+ * TableDictionary maps the values of the dictionary encoded columns of a table to integer codes, each column has
+ * a dictionary of its own and the codes of a column count up from 0 in the order the values came. The
+ * dictionaries only grow, a code once given keeps its value for the life of the table.
+ *
+ * The entries are kept in a chain of pages, each new value is appended to the last page:
+ *  ---------------------------------------------------------------------------------------------------
+ *  | NextPageId (4) | UsedBytes (4) | Column_1 (2) | Length_1 (2) | Value_1 | Column_2 (2) | ... |
+ *  ---------------------------------------------------------------------------------------------------
+ * and the whole chain is read into memory when the table is opened.
+ */
+class TableDictionary {
+ public:
+  /**
+   * Create an empty dictionary in a new page.
+   */
+  TableDictionary(BufferPoolManager *buffer_pool_manager, uint32_t column_count);
+
+  /**
+   * Read a dictionary from its chain of pages.
+   */
+  TableDictionary(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, uint32_t column_count);
+
+  /**
+   * @return code of a value of a column, the value is added if it is new; -1 if it can not be added, the value
+   * is longer than a page or no page can be had
+   */
+  int32_t Encode(uint32_t column_id, const char *data, uint32_t length);
+
+  /**
+   * @return code of a value of a column, -1 if the value is not in the dictionary
+   */
+  int32_t Lookup(uint32_t column_id, const char *data, uint32_t length);
+
+  /**
+   * @return the value of a code of a column
+   */
+  std::string Decode(uint32_t column_id, int32_t code);
+
+  /** @return number of values of a column */
+  uint32_t GetSize(uint32_t column_id);
+
+  inline page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  /**
+   * Delete the pages of the dictionary.
+   */
+  void FreePages();
+
+ private:
+  /** Append an entry to the last page, a new page is linked when it is full */
+  bool AppendEntry(uint32_t column_id, const std::string &value);
+
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 0;
+  static constexpr size_t OFFSET_USED_BYTES = 4;
+  static constexpr size_t SIZE_HEADER = 8;
+  static constexpr size_t SIZE_ENTRY_HEADER = 4;
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_{INVALID_PAGE_ID};
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  // a deque so that the values already there stay in place as values are added
+  std::vector<std::deque<std::string>> values_;
+  std::vector<std::unordered_map<std::string, int32_t>> codes_;
+  std::shared_mutex latch_;
+};
+
+#endif  // MINISQL_TABLE_DICTIONARY_H
@@ -4,26 +4,42 @@
 #include "buffer/buffer_pool_manager.h"
 #include "page/header_page.h"
 #include "page/table_page.h"
+#include "storage/table_dictionary.h"
 #include "storage/table_iterator.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
-#include <unordered_map>
+#include "transaction/version_store.h"
+
+class Index;
 
 class TableHeap {
   friend class TableIterator;
 
  public:
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           VersionStore *version_store = nullptr, TableLayout layout = TableLayout::kRow,
+                           bool dictionary_encoded = false) {
+    return new TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, version_store, layout,
+                         dictionary_encoded);
   }
 
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager) {
-    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+                           LogManager *log_manager, LockManager *lock_manager,
+                           VersionStore *version_store = nullptr, TableLayout layout = TableLayout::kRow,
+                           page_id_t dictionary_page_id = INVALID_PAGE_ID) {
+    return new TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, version_store,
+                         layout, dictionary_page_id);
   }
 
-  ~TableHeap() {}
+  ~TableHeap() {
+    if (version_store_ != nullptr) {
+      version_store_->RemoveTable(this);
+    }
+    if (storage_schema_ != schema_) {
+      delete storage_schema_;
+    }
+  }
 
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
@@ -33,6 +49,15 @@ class TableHeap {
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Insert tuples in one pass over the pages, each page is latched and pinned once for all the tuples
+   * it takes.
+   * @param[in/out] rows Tuples to insert, the rids of the inserted tuples are wrapped in the rows
+   * @param[in] txn The transaction performing the insert
+   * @return true iff all the tuples were inserted, the ones inserted before a failure stay in txn's write set
+   */
+  bool InsertTuples(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
@@ -42,8 +67,9 @@ class TableHeap {
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
-   * @param[in] row Tuple of new row
+   * if the new tuple is too large to fit in the old page, the old tuple is deleted and the new one is inserted
+   * elsewhere, the new rid is wrapped in row
+   * @param[in/out] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
    * @return true is update is successful.
@@ -65,14 +91,31 @@ class TableHeap {
   void RollbackDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * Read a tuple from the table.
+   * Called on abort to write the tuple as it was before an update. The update kept the space of the old tuple,
+   * so it is written back in place and keeps its rid.
+   * @param[in] row The tuple before the update
+   */
+  void RollbackUpdate(Row &row, const RowId &rid, Transaction *txn);
+
+  /**
+   * Called on commit/abort to give back the space an updated tuple kept for its undo.
+   */
+  void TrimTuple(const RowId &rid);
+
+  /**
+   * Read a tuple from the table. A snapshot transaction reads the version visible to its snapshot
+   * without taking a lock.
    * @param[in/out] row Output variable for the tuple, row id of the tuple is wrapped in row
    * @param[in] txn transaction performing the read
+   * @param[in] decode false to leave the codes of the dictionary encoded columns in the row, see DecodeRow
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  bool GetTuple(Row *row, Transaction *txn);
+  bool GetTuple(Row *row, Transaction *txn, bool decode = true);
 
   void FreeTableHeap() {
+    if (dictionary_ != nullptr) {
+      dictionary_->FreePages();
+    }
     auto next_page_id = first_page_id_;
     while (next_page_id != INVALID_PAGE_ID) {
       auto old_page_id = next_page_id;
@@ -90,48 +133,199 @@ class TableHeap {
   void DeleteTable(page_id_t page_id = INVALID_PAGE_ID);
 
   /**
+   * @param decode false for an iterator whose rows keep the codes of the dictionary encoded columns
    * @return the begin iterator of this table
    */
-  TableIterator Begin(Transaction *txn);
+  TableIterator Begin(Transaction *txn, bool decode = true);
 
   /**
    * @return the end iterator of this table
    */
   TableIterator End();
 
+  /**
+   * @return the ids of the pages of this table in chain order, the unit of work handed out to parallel scans
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  /**
+   * Read the tuples of one page visible to txn, the page is latched and pinned once for all of them.
+   * Only for reads which take no locks, i.e. snapshot reads or no transaction at all.
+   * @param[out] rows The visible tuples are appended here
+   * @param[in] decode false to leave the codes of the dictionary encoded columns in the rows
+   */
+  void ScanPage(page_id_t page_id, Transaction *txn, std::vector<Row> *rows, bool decode = true);
+
+  /**
+   * Read some columns of the tuples of one page visible to txn into vectors, a page of a columnar table reads
+   * only the minipages of these columns. Only for reads which take no locks, as ScanPage. A snapshot reads whole
+   * only the tuples with a version chain, which may see another version than the page holds.
+   * @param[in] column_ids Indexes of the columns in the schema of the table
+   * @param[out] columns One vector per column id, the values are appended in tuple order
+   * @param[out] rids The rids of the tuples read are appended here unless it is null
+   * @param[in] decode false to read the codes of the dictionary encoded columns
+   */
+  void ScanColumns(page_id_t page_id, Transaction *txn, const std::vector<uint32_t> &column_ids,
+                   std::vector<std::vector<Field>> *columns, std::vector<RowId> *rids = nullptr,
+                   bool decode = true);
+
+  /**
+   * Replace the codes of the dictionary encoded columns of a row read without decoding by their values.
+   */
+  void DecodeRow(Row *row);
+
+  /**
+   * Replace the codes in a row made of some columns read by ScanColumns without decoding by their values.
+   * @param column_ids Indexes in the schema of the table of the columns the fields of row hold
+   */
+  void DecodeRow(Row *row, const std::vector<uint32_t> &column_ids);
+
+  /**
+   * @return the dictionary of the encoded columns, nullptr if the table has none
+   */
+  inline TableDictionary *GetDictionary() const { return dictionary_.get(); }
+
+  /**
+   * @return whether the values of a column are stored as codes of the dictionary
+   */
+  inline bool IsEncoded(uint32_t column_id) const {
+    return storage_schema_->GetColumn(column_id)->GetType() != schema_->GetColumn(column_id)->GetType();
+  }
+
   /**
    * @return the id of the first page of this table
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return whether writes of txn keep the replaced versions for snapshot readers. Such writes leave the index
+   *         entries of the replaced versions in place, the garbage collection removes them with the versions.
+   */
+  inline bool IsVersioned(Transaction *txn) const { return txn != nullptr && version_store_ != nullptr; }
+
+  /**
+   * Let the garbage collection remove the entries of old versions from an index of this table.
+   */
+  void AttachIndex(Index *index);
+
+  void DetachIndex(Index *index);
+
+  /**
+   * @return whether the garbage collection has index entries to remove with the versions of this table
+   */
+  bool HasIndexes();
+
+  /**
+   * Called by the garbage collection once no snapshot sees the dropped versions of the tuple at rid. The index
+   * entries of keys no remaining version has are removed, and the tuple itself is freed if its delete is seen
+   * by everyone.
+   * @param dropped the versions dropped
+   * @param kept the older versions still kept
+   * @param deleted whether the tuple is deleted
+   */
+  void ReclaimVersions(const RowId &rid, const std::vector<Row> &dropped, const std::vector<Row> &kept,
+                       bool deleted);
+
+  /**
+   * An entry of key the garbage collection has not removed yet may still point at a tuple which no longer has
+   * the key, point it at rid instead. The removal of the old entry goes to the index write set of txn.
+   * @return true if the entry of key points at rid now
+   */
+  bool ReplaceStaleEntry(Index *index, const Row &key, const RowId &rid, Transaction *txn);
+
+  inline TableLayout GetLayout() const { return layout_; }
+
 private:
+  /**
+   * @return whether row can be stored in the pages of this table
+   */
+  bool Fits(const Row &row) const;
+
+  /**
+   * Set up the dictionary encoding, the char columns are encoded if the table has a dictionary.
+   * @param dictionary_page_id the first page of the dictionary of an existing table, INVALID_PAGE_ID if none
+   */
+  void InitEncoding(bool dictionary_encoded, page_id_t dictionary_page_id);
+
+  /**
+   * Make the row stored for a row, the values of the encoded columns replaced by their codes.
+   * @param add false to only look the values up, for a row which was stored before
+   * @return false if a value could not be added to the dictionary, or is not in it
+   */
+  bool EncodeRow(const Row &row, Row *encoded, bool add = true);
+
+  /** Replace the code of an encoded column in *field by a new field holding its value */
+  void DecodeField(uint32_t column_id, Field **field);
+
+  /**
+   * Read some columns of the tuples of a latched page visible to txn, as ScanColumns, the values of the tuples with
+   * a version chain are taken from their visible versions and those of the others from the page. The encoded columns
+   * are read as codes.
+   * @param chained The rids of the tuples of the page with a version chain, in slot order
+   */
+  void ScanVersionedColumns(TablePage *page, Transaction *txn, const std::vector<uint32_t> &column_ids,
+                            const std::vector<RowId> &chained, std::vector<std::vector<Field>> *columns,
+                            std::vector<RowId> *rids);
+
+  /**
+   * Init a new page of this table in its layout.
+   */
+  void InitPage(TablePage *page, page_id_t page_id, page_id_t prev_id, Transaction *txn) {
+    if (layout_ == TableLayout::kColumnar) {
+      page->InitColumnar(page_id, prev_id, storage_schema_, log_manager_, txn);
+    } else {
+      page->Init(page_id, prev_id, log_manager_, txn);
+    }
+  }
+
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
+                     LogManager *log_manager, LockManager *lock_manager, VersionStore *version_store,
+                     TableLayout layout, bool dictionary_encoded) :
           buffer_pool_manager_(buffer_pool_manager),
           schema_(schema),
           log_manager_(log_manager),
-          lock_manager_(lock_manager) {
-          //ASSERT(false, "Not implemented yet.");
+          lock_manager_(lock_manager),
+          version_store_(version_store),
+          layout_(layout) {
+    InitEncoding(dictionary_encoded, INVALID_PAGE_ID);
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageNear(first_page_id_, INVALID_PAGE_ID));
+    ASSERT(page != nullptr, "first page allocation failed.");
+    page->WLatch();
+    InitPage(page, first_page_id_, INVALID_PAGE_ID, txn);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
   };
 
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
+                     LogManager *log_manager, LockManager *lock_manager, VersionStore *version_store,
+                     TableLayout layout, page_id_t dictionary_page_id)
       : buffer_pool_manager_(buffer_pool_manager),
         first_page_id_(first_page_id),
         schema_(schema),
         log_manager_(log_manager),
-        lock_manager_(lock_manager) {}
+        lock_manager_(lock_manager),
+        version_store_(version_store),
+        layout_(layout) {
+    InitEncoding(dictionary_page_id != INVALID_PAGE_ID, dictionary_page_id);
+  }
 
  private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_ {INVALID_PAGE_ID};
   Schema *schema_;
-  std::unordered_map<page_id_t,bool> tableheap;
+  // schema of the rows the pages hold, the encoded columns are int codes; schema_ if no column is encoded
+  Schema *storage_schema_{nullptr};
+  std::unique_ptr<TableDictionary> dictionary_;
   [[maybe_unused]] LogManager *log_manager_;
-  [[maybe_unused]] LockManager *lock_manager_;
+  LockManager *lock_manager_;
+  VersionStore *version_store_;
+  TableLayout layout_;
+  // indexes whose entries of old versions the garbage collection removes
+  std::mutex index_latch_;
+  std::vector<Index *> indexes_;
 };
 
 #endif  // MINISQL_TABLE_HEAP_H
@@ -4,15 +4,23 @@
 #include "common/rowid.h"
 #include "record/row.h"
 #include "transaction/transaction.h"
-#include <unordered_map>
 
 class TableHeap;
 
 class TableIterator {
 public:
-  // you may define your own constructor based on your member variables
+  /**
+   * Construct an end iterator
+   */
   explicit TableIterator();
 
+  /**
+   * Construct an iterator positioned at rid, the tuple is read on behalf of txn.
+   * If the tuple can not be read (deleted in the meantime) the iterator moves forward.
+   * With decode false the rows keep the codes of the dictionary encoded columns.
+   */
+  TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn, bool decode = true);
+
   TableIterator(const TableIterator &other);
 
   virtual ~TableIterator();
@@ -25,16 +33,27 @@ public:
 
   Row *operator->();
 
-  TableIterator operator=(const TableIterator &itr) noexcept;
+  TableIterator &operator=(const TableIterator &itr) noexcept;
 
   TableIterator &operator++();
 
   TableIterator operator++(int);
 
 private:
- std::unordered_map<page_id_t,bool> is_record_full;
- std::unordered_map<page_id_t,bool>::iterator iter;
-  // add your own private member variables here
+  /**
+   * Read the tuple at row_'s rid, skipping forward until a readable tuple or the end is reached.
+   */
+  void ReadCurrent();
+
+  /**
+   * Move row_'s rid to the next tuple slot in the table, or INVALID_ROWID at the end.
+   */
+  void AdvanceRowId();
+
+  TableHeap *table_heap_{nullptr};
+  Transaction *txn_{nullptr};
+  bool decode_{true};
+  Row row_{INVALID_ROWID};
 };
 
 #endif  // MINISQL_TABLE_ITERATOR_H
@@ -1,11 +1,164 @@
 #ifndef MINISQL_LOCK_MANAGER_H
 #define MINISQL_LOCK_MANAGER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "transaction/transaction.h"
+
 /**
- * LockManager handles transactions asking for locks on records.
+ * LockManager handles transactions asking for locks on records under strict two-phase locking.
  *
- * Implemented by student self.
+ * Shared and exclusive locks are kept per RowId. The lock table is split into shards by the hash
+ * of the RowId so that unrelated rows do not contend on a single latch. Requests on a row are
+ * granted in FIFO order, a shared lock may be upgraded to an exclusive one in place.
+ *
+ * Deadlocks are resolved by a background thread which periodically builds the wait-for graph
+ * and aborts the youngest transaction of every cycle it finds.
  */
-class LockManager {};
+class LockManager {
+ public:
+  enum class LockMode { kShared, kExclusive };
+
+  /**
+   * @param enable_cycle_detection start the background deadlock detection thread
+   * @param cycle_detection_interval period between two runs of the detection
+   */
+  explicit LockManager(bool enable_cycle_detection = true,
+                       std::chrono::milliseconds cycle_detection_interval = DEFAULT_CYCLE_DETECTION_INTERVAL);
+
+  ~LockManager();
+
+  DISALLOW_COPY_AND_MOVE(LockManager);
+
+  /**
+   * Acquire a shared lock on rid, blocks until the lock is granted.
+   * @return false if the transaction was aborted instead (the transaction is in aborted state)
+   */
+  bool LockShared(Transaction *txn, const RowId &rid);
+
+  /**
+   * Acquire an exclusive lock on rid, blocks until the lock is granted.
+   * @return false if the transaction was aborted instead (the transaction is in aborted state)
+   */
+  bool LockExclusive(Transaction *txn, const RowId &rid);
+
+  /**
+   * Acquire an exclusive lock on rid only if no other transaction holds or waits for it, never blocks. Used while
+   * a page latch is held, where a wait would be invisible to the deadlock detection.
+   * @return false if the lock is taken by another transaction, or if txn is aborted (then in aborted state)
+   */
+  bool TryLockExclusive(Transaction *txn, const RowId &rid);
+
+  /**
+   * Upgrade a shared lock held by txn on rid to an exclusive lock.
+   * @return false if the transaction was aborted instead (the transaction is in aborted state)
+   */
+  bool LockUpgrade(Transaction *txn, const RowId &rid);
+
+  /**
+   * Release the lock held by txn on rid. Under repeatable read the transaction enters its shrinking
+   * phase, read committed is allowed to drop shared locks early.
+   * @return false if txn does not hold a lock on rid
+   */
+  bool Unlock(Transaction *txn, const RowId &rid);
+
+  /**
+   * Release every lock held by txn, called on commit/abort.
+   */
+  void UnlockAll(Transaction *txn);
+
+  /**
+   * Run a single pass of deadlock detection, aborting victims if any.
+   * @return number of transactions aborted
+   */
+  size_t RunCycleDetectionOnce();
+
+  /** @return the edges of the current wait-for graph, for testing */
+  std::vector<std::pair<txn_id_t, txn_id_t>> GetEdgeList();
+
+ private:
+  struct LockRequest {
+    LockRequest(Transaction *txn, LockMode mode) : txn_(txn), mode_(mode) {}
+
+    Transaction *txn_;
+    LockMode mode_;
+    bool granted_{false};
+  };
+
+  struct LockRequestQueue {
+    std::list<LockRequest> request_queue_;
+    std::condition_variable cv_;
+    /** whether a transaction is waiting to upgrade on this row, at most one at a time */
+    bool upgrading_{false};
+  };
+
+  struct LockTableShard {
+    std::mutex latch_;
+    std::unordered_map<RowId, LockRequestQueue> lock_table_;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  inline LockTableShard &GetShard(const RowId &rid) { return shards_[std::hash<RowId>()(rid) % kNumShards]; }
+
+  /**
+   * Check the request can be started, abort the transaction if it is in shrinking phase.
+   */
+  bool CheckLockable(Transaction *txn, LockMode mode);
+
+  /**
+   * Whether the request of txn in queue is compatible with all requests ahead of it.
+   */
+  static bool IsGrantable(const LockRequestQueue &queue, Transaction *txn, LockMode mode);
+
+  /**
+   * Wait until the request of txn is grantable or txn is aborted, called with shard latch held.
+   */
+  bool WaitForGrant(std::unique_lock<std::mutex> &guard, LockRequestQueue &queue, Transaction *txn, LockMode mode);
+
+  /**
+   * Remove the request of txn from the queue and wake up the waiters, called with shard latch held.
+   */
+  static bool RemoveRequest(LockRequestQueue &queue, Transaction *txn);
+
+  using WaitsForGraph = std::map<txn_id_t, std::set<txn_id_t>>;
+
+  /**
+   * Build the wait-for graph from the lock table, called with all shards latched.
+   * @param[out] graph edges from a waiting transaction to the transactions it waits for
+   * @param[out] waiting the waiting transactions and the queue they wait in
+   */
+  void BuildWaitsForGraph(WaitsForGraph *graph,
+                          std::unordered_map<txn_id_t, std::pair<Transaction *, LockRequestQueue *>> *waiting);
+
+  /**
+   * Find a cycle in graph by depth-first search from the lowest transaction id.
+   * @param[out] victim the youngest transaction in the cycle
+   * @return true if a cycle exists
+   */
+  static bool FindCycle(const WaitsForGraph &graph, txn_id_t *victim);
+
+  void RunCycleDetection();
+
+ private:
+  LockTableShard shards_[kNumShards];
+
+  std::atomic<bool> enable_cycle_detection_;
+  std::chrono::milliseconds cycle_detection_interval_;
+  std::mutex detection_latch_;
+  std::condition_variable detection_cv_;
+  std::thread cycle_detection_thread_;
+};
 
 #endif  // MINISQL_LOCK_MANAGER_H
@@ -1,11 +1,191 @@
 #ifndef MINISQL_TRANSACTION_H
 #define MINISQL_TRANSACTION_H
 
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <string>
+#include <unordered_set>
+
+#include "common/config.h"
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/row.h"
+
+class TableHeap;
+class Index;
+
 /**
- * Transaction tracks information related to a transaction.
+ * Transaction states for 2PL:
  *
- * Implemented by student self
+ *     _________________________
+ *    |                         v
+ * GROWING -> SHRINKING -> COMMITTED   ABORTED
+ *    |__________|________________________^
+ */
+enum class TxnState { kGrowing, kShrinking, kCommitted, kAborted };
+
+/**
+ * Isolation levels. The first three are implemented by locking, snapshot isolation reads the versions
+ * committed before the transaction began without taking any lock and only locks the rows it writes.
+ */
+enum class IsolationLevel { kReadUncommitted, kReadCommitted, kRepeatableRead, kSnapshotIsolation };
+
+enum class WType { kInsert = 0, kDelete, kUpdate };
+
+/**
+ * TableWriteRecord tracks a change to the table heap, it is replayed on commit/abort.
+ * For updates the old image of the tuple is kept so that abort can restore it.
+ */
+struct TableWriteRecord {
+  TableWriteRecord(RowId rid, WType wtype, const Row &row, TableHeap *table_heap)
+      : rid_(rid), wtype_(wtype), row_(row), table_heap_(table_heap) {}
+
+  RowId rid_;
+  WType wtype_;
+  Row row_;
+  TableHeap *table_heap_;
+};
+
+/**
+ * IndexWriteRecord tracks a single entry inserted into/removed from an index, an update of
+ * the indexed columns is recorded as a delete of the old key followed by an insert of the new one.
+ */
+struct IndexWriteRecord {
+  IndexWriteRecord(RowId rid, WType wtype, const Row &key, Index *index)
+      : rid_(rid), wtype_(wtype), key_(key), index_(index) {}
+
+  RowId rid_;
+  WType wtype_;
+  Row key_;
+  Index *index_;
+};
+
+/**
+ * Reason to an abort of a transaction.
+ */
+enum class AbortReason {
+  kDeadlock,
+  kLockOnShrinking,
+  kUpgradeConflict,
+  kLockSharedOnReadUncommitted,
+  kWriteConflict
+};
+
+/**
+ * TxnAbortException is thrown by the executors when the running transaction has been aborted,
+ * e.g. it was chosen as the victim of a deadlock.
+ */
+class TxnAbortException : public std::exception {
+ public:
+  TxnAbortException(txn_id_t txn_id, AbortReason reason)
+      : txn_id_(txn_id), reason_(reason), message_("Transaction " + std::to_string(txn_id) + " aborted: " + GetInfo()) {}
+
+  txn_id_t GetTxnId() const { return txn_id_; }
+
+  AbortReason GetAbortReason() const { return reason_; }
+
+  std::string GetInfo() const {
+    switch (reason_) {
+      case AbortReason::kDeadlock:
+        return "deadlock detected";
+      case AbortReason::kLockOnShrinking:
+        return "lock requested on shrinking phase";
+      case AbortReason::kUpgradeConflict:
+        return "another transaction is upgrading its lock";
+      case AbortReason::kLockSharedOnReadUncommitted:
+        return "shared lock requested on read uncommitted";
+      case AbortReason::kWriteConflict:
+        return "row was modified after the snapshot was taken";
+    }
+    return "";
+  }
+
+  const char *what() const noexcept override { return message_.c_str(); }
+
+ private:
+  txn_id_t txn_id_;
+  AbortReason reason_;
+  std::string message_;
+};
+
+/**
+ * Transaction tracks information related to a transaction.
  */
-class Transaction {};
+class Transaction {
+ public:
+  explicit Transaction(txn_id_t txn_id = INVALID_TXN_ID,
+                       IsolationLevel isolation_level = IsolationLevel::kRepeatableRead)
+      : txn_id_(txn_id), isolation_level_(isolation_level) {}
+
+  ~Transaction() = default;
+
+  DISALLOW_COPY(Transaction);
+
+  inline txn_id_t GetTxnId() const { return txn_id_; }
+
+  inline IsolationLevel GetIsolationLevel() const { return isolation_level_; }
+
+  /** @return true if reads of this transaction are served from its snapshot without locking */
+  inline bool IsSnapshotRead() const { return isolation_level_ == IsolationLevel::kSnapshotIsolation; }
+
+  /** @return the timestamp of the snapshot, versions committed after it are invisible */
+  inline timestamp_t GetReadTs() const { return read_ts_; }
+
+  inline void SetReadTs(timestamp_t read_ts) { read_ts_ = read_ts; }
+
+  inline timestamp_t GetCommitTs() const { return commit_ts_; }
+
+  inline void SetCommitTs(timestamp_t commit_ts) { commit_ts_ = commit_ts; }
+
+  /** @return the state of the transaction, the deadlock detector may change it from another thread */
+  inline TxnState GetState() const { return state_.load(); }
+
+  inline void SetState(TxnState state) { state_.store(state); }
+
+  inline AbortReason GetAbortReason() const { return abort_reason_; }
+
+  /** Abort the transaction from the lock manager, the owner notices it on the next failed access */
+  inline void SetAborted(AbortReason reason) {
+    abort_reason_ = reason;
+    state_.store(TxnState::kAborted);
+  }
+
+  inline std::unordered_set<RowId> *GetSharedLockSet() { return &shared_lock_set_; }
+
+  inline std::unordered_set<RowId> *GetExclusiveLockSet() { return &exclusive_lock_set_; }
+
+  inline bool IsSharedLocked(const RowId &rid) const { return shared_lock_set_.count(rid) != 0; }
+
+  inline bool IsExclusiveLocked(const RowId &rid) const { return exclusive_lock_set_.count(rid) != 0; }
+
+  inline std::deque<TableWriteRecord> *GetTableWriteSet() { return &table_write_set_; }
+
+  inline std::deque<IndexWriteRecord> *GetIndexWriteSet() { return &index_write_set_; }
+
+  /**
+   * Throw TxnAbortException if this transaction was aborted while it was running, executors
+   * call this after a heap access failed so that a deadlock victim stops as soon as possible.
+   */
+  inline void ThrowIfAborted() const {
+    if (GetState() == TxnState::kAborted) {
+      throw TxnAbortException(txn_id_, abort_reason_);
+    }
+  }
+
+ private:
+  txn_id_t txn_id_;
+  IsolationLevel isolation_level_;
+  std::atomic<TxnState> state_{TxnState::kGrowing};
+  AbortReason abort_reason_{AbortReason::kDeadlock};
+  timestamp_t read_ts_{0};
+  timestamp_t commit_ts_{0};
+  /** Rows this transaction holds a lock on */
+  std::unordered_set<RowId> shared_lock_set_;
+  std::unordered_set<RowId> exclusive_lock_set_;
+  /** Undo information, replayed in reverse order on abort */
+  std::deque<TableWriteRecord> table_write_set_;
+  std::deque<IndexWriteRecord> index_write_set_;
+};
 
 #endif  // MINISQL_TRANSACTION_H
@@ -0,0 +1,97 @@
+#ifndef MINISQL_TXN_MANAGER_H
+#define MINISQL_TXN_MANAGER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+#include "transaction/version_store.h"
+
+/**
+ * TxnManager keeps track of the running transactions of a database and drives commit/abort.
+ *
+ * Transactions are owned by the manager: the pointer returned by Begin is valid until the
+ * transaction is passed to Commit or Abort.
+ *
+ * With a version store every transaction gets a read timestamp when it begins and a commit timestamp
+ * when it commits. A background thread reclaims the versions older than the oldest running snapshot.
+ */
+class TxnManager {
+ public:
+  /**
+   * @param version_store keeps old versions for snapshot readers, nullptr if only locking is used
+   * @param gc_interval period between two runs of the garbage collection
+   */
+  explicit TxnManager(LockManager *lock_manager, VersionStore *version_store = nullptr,
+                      LogManager *log_manager = nullptr, std::chrono::milliseconds gc_interval = DEFAULT_GC_INTERVAL);
+
+  /** Abort the transactions still running */
+  ~TxnManager();
+
+  DISALLOW_COPY_AND_MOVE(TxnManager);
+
+  /**
+   * Start a new transaction.
+   * @param isolation_level the isolation level of the new transaction
+   */
+  Transaction *Begin(IsolationLevel isolation_level = IsolationLevel::kRepeatableRead);
+
+  /**
+   * Commit txn, the deletes it marked are applied and all its locks are released.
+   */
+  void Commit(Transaction *txn);
+
+  /**
+   * Abort txn, its writes are undone in reverse order and all its locks are released.
+   */
+  void Abort(Transaction *txn);
+
+  /** @return number of the running transactions */
+  size_t GetActiveTxnCount();
+
+  /**
+   * @return the oldest read timestamp of the running transactions, or the last commit timestamp if
+   * none is running. Versions replaced before it are visible to nobody.
+   */
+  timestamp_t GetWatermark();
+
+  /**
+   * Run a single pass of garbage collection.
+   * @return number of versions reclaimed
+   */
+  size_t GarbageCollect();
+
+ private:
+  /** Release txn and forget about it */
+  void Release(Transaction *txn);
+
+  /** Give back the space the tuples updated by txn kept for their undo */
+  void TrimUpdates(Transaction *txn);
+
+  void RunGarbageCollection();
+
+  LockManager *lock_manager_;
+  VersionStore *version_store_;
+  [[maybe_unused]] LogManager *log_manager_;
+  std::atomic<txn_id_t> next_txn_id_{0};
+  /** taking a snapshot and publishing a commit are mutually exclusive */
+  std::mutex commit_latch_;
+  timestamp_t last_commit_ts_{0};
+  std::mutex latch_;
+  std::unordered_map<txn_id_t, Transaction *> txn_map_;
+
+  std::atomic<bool> enable_gc_{false};
+  std::chrono::milliseconds gc_interval_;
+  std::mutex gc_latch_;
+  std::condition_variable gc_cv_;
+  std::thread gc_thread_;
+};
+
+#endif  // MINISQL_TXN_MANAGER_H
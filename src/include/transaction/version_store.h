@@ -0,0 +1,171 @@
+#ifndef MINISQL_VERSION_STORE_H
+#define MINISQL_VERSION_STORE_H
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/rowid.h"
+#include "record/row.h"
+#include "transaction/transaction.h"
+
+class TableHeap;
+
+/**
+ * VersionStore keeps the undo information snapshot readers need to see past versions of tuples.
+ *
+ * The table page always holds the newest version of a tuple. Whenever a transaction overwrites or
+ * deletes a tuple the version it replaces is pushed to the version chain of the RowId, together with
+ * the commit timestamp of that version. A tuple without a chain is visible to every snapshot.
+ *
+ * Writers record versions while holding the write latch of the table page and readers look up the
+ * chain while holding the read latch, so a reader always sees the page and the chain in agreement.
+ * The chains are split into shards by the hash of the RowId, as the lock table of LockManager is, so
+ * that readers of unrelated rows do not contend on a single latch, and a reader looks no chain up at
+ * all while the store holds none.
+ *
+ * Deleted tuples stay on their page, marked deleted, until no snapshot can see them any more; the
+ * garbage collection then frees the slot and drops the chains no running transaction needs. The index
+ * entries of deleted tuples and of keys an update replaced stay as long as their versions do.
+ */
+class VersionStore {
+ public:
+  VersionStore() = default;
+
+  ~VersionStore() = default;
+
+  DISALLOW_COPY_AND_MOVE(VersionStore);
+
+  /**
+   * Check txn may overwrite the tuple at rid, called with the row locked exclusively. A snapshot
+   * transaction can not write a tuple whose newest version it does not see (first updater wins).
+   * @return false if txn was aborted because of a write-write conflict
+   */
+  bool CheckWrite(const RowId &rid, Transaction *txn);
+
+  /**
+   * Record txn inserted a tuple at rid, called with the page latched.
+   */
+  void RecordInsert(const RowId &rid, Transaction *txn, TableHeap *table_heap);
+
+  /**
+   * Record txn updated or deleted the tuple at rid, called with the page latched.
+   * @param prior the version being replaced
+   * @param is_delete whether the tuple is deleted by txn
+   */
+  void RecordWrite(const RowId &rid, Transaction *txn, const Row &prior, bool is_delete, TableHeap *table_heap);
+
+  /**
+   * Forget about rid, its slot is freed. Called with the page latched.
+   */
+  void Remove(const RowId &rid);
+
+  /**
+   * Find the version of the tuple at row's rid visible to txn, called with the page latched.
+   * @param[in/out] row holds the newest version of the tuple if it exists on the page, replaced by
+   *                    the visible version if that is an older one
+   * @param exists whether the newest version exists, i.e. is not deleted
+   * @param[out] older set to whether row was replaced by an older version
+   * @return true if a version is visible to txn
+   */
+  bool GetVisible(Row *row, bool exists, Transaction *txn, bool *older = nullptr);
+
+  /**
+   * Check whether the tuple at rid has a chain, called with the page latched. A tuple without one is
+   * read from the page as it is by every snapshot.
+   */
+  bool HasChain(const RowId &rid);
+
+  /**
+   * Stamp the versions written by txn with its commit timestamp.
+   */
+  void Commit(Transaction *txn, timestamp_t commit_ts);
+
+  /**
+   * Drop the versions written by txn, called after its writes were undone on the table pages.
+   */
+  void Abort(Transaction *txn);
+
+  /**
+   * Reclaim the versions no snapshot taken at or after watermark can see, together with their index
+   * entries, and free the slots of tuples whose delete committed before it.
+   * @param watermark the oldest read timestamp of the running transactions
+   * @return number of versions reclaimed
+   */
+  size_t GarbageCollect(timestamp_t watermark);
+
+  /**
+   * Drop every chain of table_heap, called when the table heap goes away.
+   */
+  void RemoveTable(TableHeap *table_heap);
+
+  /** @return number of old versions kept, for testing */
+  size_t GetVersionCount();
+
+ private:
+  struct UndoVersion {
+    UndoVersion(const Row &row, timestamp_t ts, bool deleted) : row_(row), ts_(ts), deleted_(deleted) {}
+
+    /** image of the version, empty if the tuple did not exist */
+    Row row_;
+    /** commit timestamp of the version */
+    timestamp_t ts_;
+    bool deleted_;
+  };
+
+  struct VersionChain {
+    explicit VersionChain(TableHeap *table_heap) : table_heap_(table_heap) {}
+
+    TableHeap *table_heap_;
+    /** transaction which wrote the newest version and has not committed yet */
+    txn_id_t writer_{INVALID_TXN_ID};
+    /** commit timestamp of the newest version */
+    timestamp_t ts_{0};
+    /** whether the newest version is a delete */
+    bool deleted_{false};
+    /** older versions, newest first */
+    std::deque<UndoVersion> undo_;
+  };
+
+  /** Versions of a tuple the garbage collection dropped, reclaimed after the store latch is released */
+  struct Reclaim {
+    Reclaim(TableHeap *table_heap, const RowId &rid, bool deleted)
+        : table_heap_(table_heap), rid_(rid), deleted_(deleted) {}
+
+    TableHeap *table_heap_;
+    RowId rid_;
+    /** whether the tuple is deleted and its slot is freed */
+    bool deleted_;
+    /** images of the dropped versions and of the older versions kept, for the index entries */
+    std::vector<Row> dropped_;
+    std::vector<Row> kept_;
+  };
+
+  /** Append the images of the versions in [begin, end) to rows */
+  static void CopyImages(std::deque<UndoVersion>::const_iterator begin,
+                         std::deque<UndoVersion>::const_iterator end, std::vector<Row> *rows);
+
+  struct ChainShard {
+    std::mutex latch_;
+    std::unordered_map<RowId, VersionChain> chains_;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  inline ChainShard &GetShard(const RowId &rid) { return shards_[std::hash<RowId>()(rid) % kNumShards]; }
+
+  /** Erase a chain of shard, called with the shard latch held */
+  std::unordered_map<RowId, VersionChain>::iterator EraseChain(
+      ChainShard &shard, std::unordered_map<RowId, VersionChain>::iterator it);
+
+  ChainShard shards_[kNumShards];
+  /** number of chains in all shards, changed with a shard latched and a page latched as the chain is */
+  std::atomic<size_t> chain_count_{0};
+  /** serializes freeing deleted tuples with dropping a table heap */
+  std::mutex gc_latch_;
+};
+
+#endif  // MINISQL_VERSION_STORE_H
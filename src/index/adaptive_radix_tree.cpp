@@ -0,0 +1,648 @@
+#include "index/adaptive_radix_tree.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+enum class NodeType : uint8_t { kLeaf, kNode4, kNode16, kNode48, kNode256 };
+
+inline uint8_t ByteAt(const std::string &key, size_t i) { return static_cast<uint8_t>(key[i]); }
+
+}  // namespace
+
+struct AdaptiveRadixTree::Node {
+  explicit Node(NodeType type) : type_(type) {}
+
+  NodeType type_;
+};
+
+struct AdaptiveRadixTree::Leaf : AdaptiveRadixTree::Node {
+  Leaf(const std::string &key, const RowId &value) : Node(NodeType::kLeaf), key_(key), value_(value) {}
+
+  std::string key_;
+  RowId value_;
+};
+
+struct AdaptiveRadixTree::InnerNode : AdaptiveRadixTree::Node {
+  explicit InnerNode(NodeType type) : Node(type) {}
+
+  /** Take the children count and prefix of the node this one replaces */
+  void CopyHeader(const InnerNode *other) {
+    count_ = other->count_;
+    prefix_length_ = other->prefix_length_;
+    memcpy(prefix_, other->prefix_, std::min(prefix_length_, MAX_PREFIX_LENGTH));
+  }
+
+  uint16_t count_{0};
+  uint32_t prefix_length_{0};
+  uint8_t prefix_[MAX_PREFIX_LENGTH]{};
+};
+
+struct AdaptiveRadixTree::Node4 : AdaptiveRadixTree::InnerNode {
+  Node4() : InnerNode(NodeType::kNode4) {}
+
+  uint8_t keys_[4]{};
+  Node *children_[4]{};
+};
+
+struct AdaptiveRadixTree::Node16 : AdaptiveRadixTree::InnerNode {
+  Node16() : InnerNode(NodeType::kNode16) {}
+
+  uint8_t keys_[16]{};
+  Node *children_[16]{};
+};
+
+struct AdaptiveRadixTree::Node48 : AdaptiveRadixTree::InnerNode {
+  Node48() : InnerNode(NodeType::kNode48) {}
+
+  // slot of the child of each byte plus one, 0 for no child
+  uint8_t child_index_[256]{};
+  Node *children_[48]{};
+};
+
+struct AdaptiveRadixTree::Node256 : AdaptiveRadixTree::InnerNode {
+  Node256() : InnerNode(NodeType::kNode256) {}
+
+  Node *children_[256]{};
+};
+
+template <typename F>
+bool AdaptiveRadixTree::ForEachChild(const InnerNode *node, F &&f) {
+  switch (node->type_) {
+    case NodeType::kNode4: {
+      auto n = static_cast<const Node4 *>(node);
+      for (uint32_t i = 0; i < n->count_; i++) {
+        if (!f(n->keys_[i], n->children_[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case NodeType::kNode16: {
+      auto n = static_cast<const Node16 *>(node);
+      for (uint32_t i = 0; i < n->count_; i++) {
+        if (!f(n->keys_[i], n->children_[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case NodeType::kNode48: {
+      auto n = static_cast<const Node48 *>(node);
+      for (uint32_t byte = 0; byte < 256; byte++) {
+        if (n->child_index_[byte] != 0 && !f(static_cast<uint8_t>(byte), n->children_[n->child_index_[byte] - 1])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    case NodeType::kNode256: {
+      auto n = static_cast<const Node256 *>(node);
+      for (uint32_t byte = 0; byte < 256; byte++) {
+        if (n->children_[byte] != nullptr && !f(static_cast<uint8_t>(byte), n->children_[byte])) {
+          return false;
+        }
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() { Free(root_); }
+
+void AdaptiveRadixTree::Free(Node *node) {
+  if (node == nullptr) {
+    return;
+  }
+  switch (node->type_) {
+    case NodeType::kLeaf:
+      delete static_cast<Leaf *>(node);
+      return;
+    case NodeType::kNode4:
+      ForEachChild(static_cast<InnerNode *>(node), [](uint8_t, Node *child) { return Free(child), true; });
+      delete static_cast<Node4 *>(node);
+      return;
+    case NodeType::kNode16:
+      ForEachChild(static_cast<InnerNode *>(node), [](uint8_t, Node *child) { return Free(child), true; });
+      delete static_cast<Node16 *>(node);
+      return;
+    case NodeType::kNode48:
+      ForEachChild(static_cast<InnerNode *>(node), [](uint8_t, Node *child) { return Free(child), true; });
+      delete static_cast<Node48 *>(node);
+      return;
+    case NodeType::kNode256:
+      ForEachChild(static_cast<InnerNode *>(node), [](uint8_t, Node *child) { return Free(child), true; });
+      delete static_cast<Node256 *>(node);
+      return;
+  }
+}
+
+void AdaptiveRadixTree::Clear() {
+  Free(root_);
+  root_ = nullptr;
+  size_ = 0;
+}
+
+AdaptiveRadixTree::Node **AdaptiveRadixTree::FindChild(InnerNode *node, uint8_t byte) {
+  switch (node->type_) {
+    case NodeType::kNode4: {
+      auto n = static_cast<Node4 *>(node);
+      for (uint32_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == byte) {
+          return &n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::kNode16: {
+      auto n = static_cast<Node16 *>(node);
+      for (uint32_t i = 0; i < n->count_; i++) {
+        if (n->keys_[i] == byte) {
+          return &n->children_[i];
+        }
+      }
+      return nullptr;
+    }
+    case NodeType::kNode48: {
+      auto n = static_cast<Node48 *>(node);
+      return n->child_index_[byte] == 0 ? nullptr : &n->children_[n->child_index_[byte] - 1];
+    }
+    case NodeType::kNode256: {
+      auto n = static_cast<Node256 *>(node);
+      return n->children_[byte] == nullptr ? nullptr : &n->children_[byte];
+    }
+    default:
+      return nullptr;
+  }
+}
+
+void AdaptiveRadixTree::AddChild(Node *&ref, uint8_t byte, Node *child) {
+  switch (ref->type_) {
+    case NodeType::kNode4: {
+      auto n = static_cast<Node4 *>(ref);
+      if (n->count_ < 4) {
+        uint32_t pos = 0;
+        while (pos < n->count_ && n->keys_[pos] < byte) {
+          pos++;
+        }
+        memmove(n->keys_ + pos + 1, n->keys_ + pos, n->count_ - pos);
+        memmove(n->children_ + pos + 1, n->children_ + pos, (n->count_ - pos) * sizeof(Node *));
+        n->keys_[pos] = byte;
+        n->children_[pos] = child;
+        n->count_++;
+        return;
+      }
+      auto grown = new Node16();
+      grown->CopyHeader(n);
+      memcpy(grown->keys_, n->keys_, sizeof(n->keys_));
+      memcpy(grown->children_, n->children_, sizeof(n->children_));
+      delete n;
+      ref = grown;
+      AddChild(ref, byte, child);
+      return;
+    }
+    case NodeType::kNode16: {
+      auto n = static_cast<Node16 *>(ref);
+      if (n->count_ < 16) {
+        uint32_t pos = 0;
+        while (pos < n->count_ && n->keys_[pos] < byte) {
+          pos++;
+        }
+        memmove(n->keys_ + pos + 1, n->keys_ + pos, n->count_ - pos);
+        memmove(n->children_ + pos + 1, n->children_ + pos, (n->count_ - pos) * sizeof(Node *));
+        n->keys_[pos] = byte;
+        n->children_[pos] = child;
+        n->count_++;
+        return;
+      }
+      auto grown = new Node48();
+      grown->CopyHeader(n);
+      for (uint32_t i = 0; i < n->count_; i++) {
+        grown->child_index_[n->keys_[i]] = i + 1;
+        grown->children_[i] = n->children_[i];
+      }
+      delete n;
+      ref = grown;
+      AddChild(ref, byte, child);
+      return;
+    }
+    case NodeType::kNode48: {
+      auto n = static_cast<Node48 *>(ref);
+      if (n->count_ < 48) {
+        // removals leave holes among the slots
+        uint32_t pos = 0;
+        while (n->children_[pos] != nullptr) {
+          pos++;
+        }
+        n->children_[pos] = child;
+        n->child_index_[byte] = pos + 1;
+        n->count_++;
+        return;
+      }
+      auto grown = new Node256();
+      grown->CopyHeader(n);
+      for (uint32_t i = 0; i < 256; i++) {
+        if (n->child_index_[i] != 0) {
+          grown->children_[i] = n->children_[n->child_index_[i] - 1];
+        }
+      }
+      delete n;
+      ref = grown;
+      AddChild(ref, byte, child);
+      return;
+    }
+    case NodeType::kNode256: {
+      auto n = static_cast<Node256 *>(ref);
+      n->children_[byte] = child;
+      n->count_++;
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+void AdaptiveRadixTree::RemoveChild(Node *&ref, uint8_t byte) {
+  switch (ref->type_) {
+    case NodeType::kNode4: {
+      auto n = static_cast<Node4 *>(ref);
+      uint32_t pos = 0;
+      while (n->keys_[pos] != byte) {
+        pos++;
+      }
+      memmove(n->keys_ + pos, n->keys_ + pos + 1, n->count_ - pos - 1);
+      memmove(n->children_ + pos, n->children_ + pos + 1, (n->count_ - pos - 1) * sizeof(Node *));
+      n->count_--;
+      if (n->count_ > 1) {
+        return;
+      }
+      // a node with one child is folded into the prefix of the child
+      Node *child = n->children_[0];
+      if (child->type_ != NodeType::kLeaf) {
+        auto c = static_cast<InnerNode *>(child);
+        uint32_t length = n->prefix_length_;
+        if (length < MAX_PREFIX_LENGTH) {
+          n->prefix_[length++] = n->keys_[0];
+        }
+        if (length < MAX_PREFIX_LENGTH) {
+          uint32_t child_length = std::min(c->prefix_length_, MAX_PREFIX_LENGTH - length);
+          memcpy(n->prefix_ + length, c->prefix_, child_length);
+          length += child_length;
+        }
+        memcpy(c->prefix_, n->prefix_, std::min(length, MAX_PREFIX_LENGTH));
+        c->prefix_length_ += n->prefix_length_ + 1;
+      }
+      delete n;
+      ref = child;
+      return;
+    }
+    case NodeType::kNode16: {
+      auto n = static_cast<Node16 *>(ref);
+      uint32_t pos = 0;
+      while (n->keys_[pos] != byte) {
+        pos++;
+      }
+      memmove(n->keys_ + pos, n->keys_ + pos + 1, n->count_ - pos - 1);
+      memmove(n->children_ + pos, n->children_ + pos + 1, (n->count_ - pos - 1) * sizeof(Node *));
+      n->count_--;
+      if (n->count_ > 3) {
+        return;
+      }
+      auto shrunk = new Node4();
+      shrunk->CopyHeader(n);
+      memcpy(shrunk->keys_, n->keys_, n->count_);
+      memcpy(shrunk->children_, n->children_, n->count_ * sizeof(Node *));
+      delete n;
+      ref = shrunk;
+      return;
+    }
+    case NodeType::kNode48: {
+      auto n = static_cast<Node48 *>(ref);
+      n->children_[n->child_index_[byte] - 1] = nullptr;
+      n->child_index_[byte] = 0;
+      n->count_--;
+      if (n->count_ > 12) {
+        return;
+      }
+      auto shrunk = new Node16();
+      shrunk->CopyHeader(n);
+      uint32_t pos = 0;
+      for (uint32_t i = 0; i < 256; i++) {
+        if (n->child_index_[i] != 0) {
+          shrunk->keys_[pos] = static_cast<uint8_t>(i);
+          shrunk->children_[pos++] = n->children_[n->child_index_[i] - 1];
+        }
+      }
+      delete n;
+      ref = shrunk;
+      return;
+    }
+    case NodeType::kNode256: {
+      auto n = static_cast<Node256 *>(ref);
+      n->children_[byte] = nullptr;
+      n->count_--;
+      if (n->count_ > 37) {
+        return;
+      }
+      auto shrunk = new Node48();
+      shrunk->CopyHeader(n);
+      uint32_t pos = 0;
+      for (uint32_t i = 0; i < 256; i++) {
+        if (n->children_[i] != nullptr) {
+          shrunk->children_[pos] = n->children_[i];
+          shrunk->child_index_[i] = ++pos;
+        }
+      }
+      delete n;
+      ref = shrunk;
+      return;
+    }
+    default:
+      return;
+  }
+}
+
+const AdaptiveRadixTree::Leaf *AdaptiveRadixTree::Minimum(const Node *node) {
+  while (node->type_ != NodeType::kLeaf) {
+    ForEachChild(static_cast<const InnerNode *>(node), [&node](uint8_t, const Node *child) {
+      node = child;
+      return false;
+    });
+  }
+  return static_cast<const Leaf *>(node);
+}
+
+uint32_t AdaptiveRadixTree::PrefixMismatch(const InnerNode *node, const std::string &key, uint32_t depth) {
+  uint32_t length = std::min(node->prefix_length_, static_cast<uint32_t>(key.size()) - depth);
+  uint32_t i = 0;
+  for (; i < std::min(length, MAX_PREFIX_LENGTH); i++) {
+    if (node->prefix_[i] != ByteAt(key, depth + i)) {
+      return i;
+    }
+  }
+  if (length > MAX_PREFIX_LENGTH) {
+    // the rest of the prefix is only kept in the leaves
+    const std::string &leaf_key = Minimum(node)->key_;
+    for (; i < length; i++) {
+      if (leaf_key[depth + i] != key[depth + i]) {
+        return i;
+      }
+    }
+  }
+  return i;
+}
+
+bool AdaptiveRadixTree::Insert(const std::string &key, const RowId &value) {
+  if (!InsertAt(root_, key, value, 0)) {
+    return false;
+  }
+  size_++;
+  return true;
+}
+
+bool AdaptiveRadixTree::InsertAt(Node *&ref, const std::string &key, const RowId &value, uint32_t depth) {
+  if (ref == nullptr) {
+    ref = new Leaf(key, value);
+    return true;
+  }
+  if (ref->type_ == NodeType::kLeaf) {
+    auto leaf = static_cast<Leaf *>(ref);
+    if (leaf->key_ == key) {
+      return false;
+    }
+    // the leaf and the key part at the first byte they differ in
+    size_t length = std::min(leaf->key_.size(), key.size());
+    uint32_t common = 0;
+    while (depth + common < length && leaf->key_[depth + common] == key[depth + common]) {
+      common++;
+    }
+    auto node = new Node4();
+    node->prefix_length_ = common;
+    memcpy(node->prefix_, key.data() + depth, std::min(common, MAX_PREFIX_LENGTH));
+    Node *split = node;
+    AddChild(split, ByteAt(leaf->key_, depth + common), leaf);
+    AddChild(split, ByteAt(key, depth + common), new Leaf(key, value));
+    ref = node;
+    return true;
+  }
+  auto inner = static_cast<InnerNode *>(ref);
+  if (inner->prefix_length_ > 0) {
+    uint32_t matched = PrefixMismatch(inner, key, depth);
+    if (matched < inner->prefix_length_) {
+      // the key leaves the prefix, a new node takes the matched part
+      auto node = new Node4();
+      node->prefix_length_ = matched;
+      memcpy(node->prefix_, inner->prefix_, std::min(matched, MAX_PREFIX_LENGTH));
+      uint8_t byte;
+      if (inner->prefix_length_ <= MAX_PREFIX_LENGTH) {
+        byte = inner->prefix_[matched];
+        inner->prefix_length_ -= matched + 1;
+        memmove(inner->prefix_, inner->prefix_ + matched + 1, std::min(inner->prefix_length_, MAX_PREFIX_LENGTH));
+      } else {
+        const std::string &leaf_key = Minimum(inner)->key_;
+        byte = ByteAt(leaf_key, depth + matched);
+        inner->prefix_length_ -= matched + 1;
+        memcpy(inner->prefix_, leaf_key.data() + depth + matched + 1,
+               std::min(inner->prefix_length_, MAX_PREFIX_LENGTH));
+      }
+      Node *split = node;
+      AddChild(split, byte, inner);
+      AddChild(split, ByteAt(key, depth + matched), new Leaf(key, value));
+      ref = node;
+      return true;
+    }
+    depth += inner->prefix_length_;
+  }
+  Node **child = FindChild(inner, ByteAt(key, depth));
+  if (child != nullptr) {
+    return InsertAt(*child, key, value, depth + 1);
+  }
+  AddChild(ref, ByteAt(key, depth), new Leaf(key, value));
+  return true;
+}
+
+bool AdaptiveRadixTree::Remove(const std::string &key) {
+  if (!RemoveAt(root_, key, 0)) {
+    return false;
+  }
+  size_--;
+  return true;
+}
+
+bool AdaptiveRadixTree::RemoveAt(Node *&ref, const std::string &key, uint32_t depth) {
+  if (ref == nullptr) {
+    return false;
+  }
+  if (ref->type_ == NodeType::kLeaf) {
+    // only the root is removed here, other leaves are removed by their parent
+    if (static_cast<Leaf *>(ref)->key_ != key) {
+      return false;
+    }
+    delete static_cast<Leaf *>(ref);
+    ref = nullptr;
+    return true;
+  }
+  auto inner = static_cast<InnerNode *>(ref);
+  if (inner->prefix_length_ > 0) {
+    if (PrefixMismatch(inner, key, depth) != inner->prefix_length_) {
+      return false;
+    }
+    depth += inner->prefix_length_;
+  }
+  if (depth >= key.size()) {
+    return false;
+  }
+  uint8_t byte = ByteAt(key, depth);
+  Node **child = FindChild(inner, byte);
+  if (child == nullptr) {
+    return false;
+  }
+  if ((*child)->type_ == NodeType::kLeaf) {
+    auto leaf = static_cast<Leaf *>(*child);
+    if (leaf->key_ != key) {
+      return false;
+    }
+    delete leaf;
+    RemoveChild(ref, byte);
+    return true;
+  }
+  return RemoveAt(*child, key, depth + 1);
+}
+
+bool AdaptiveRadixTree::GetValue(const std::string &key, RowId &value) const {
+  Node *node = root_;
+  uint32_t depth = 0;
+  while (node != nullptr) {
+    if (node->type_ == NodeType::kLeaf) {
+      auto leaf = static_cast<Leaf *>(node);
+      if (leaf->key_ != key) {
+        return false;
+      }
+      value = leaf->value_;
+      return true;
+    }
+    auto inner = static_cast<InnerNode *>(node);
+    if (inner->prefix_length_ > 0) {
+      // only the kept bytes of the prefix are checked, the leaf is compared in full
+      uint32_t kept = std::min(inner->prefix_length_, MAX_PREFIX_LENGTH);
+      if (depth + kept > key.size() || memcmp(inner->prefix_, key.data() + depth, kept) != 0) {
+        return false;
+      }
+      depth += inner->prefix_length_;
+    }
+    if (depth >= key.size()) {
+      return false;
+    }
+    Node **child = FindChild(inner, ByteAt(key, depth));
+    node = child == nullptr ? nullptr : *child;
+    depth++;
+  }
+  return false;
+}
+
+void AdaptiveRadixTree::Scan(const std::string *low, bool low_inclusive,
+                             const std::function<bool(const std::string &, const RowId &)> &visit) const {
+  if (root_ != nullptr) {
+    ScanAt(root_, 0, low, low_inclusive, visit);
+  }
+}
+
+bool AdaptiveRadixTree::ScanAt(const Node *node, uint32_t depth, const std::string *low, bool low_inclusive,
+                               const std::function<bool(const std::string &, const RowId &)> &visit) {
+  if (node->type_ == NodeType::kLeaf) {
+    auto leaf = static_cast<const Leaf *>(node);
+    if (low != nullptr) {
+      int cmp = leaf->key_.compare(*low);
+      if (cmp < 0 || (cmp == 0 && !low_inclusive)) {
+        return true;
+      }
+    }
+    return visit(leaf->key_, leaf->value_);
+  }
+  auto inner = static_cast<const InnerNode *>(node);
+  // low only bounds the subtree while the path so far equals its first bytes
+  if (low != nullptr && inner->prefix_length_ > 0) {
+    const uint8_t *prefix = inner->prefix_;
+    if (inner->prefix_length_ > MAX_PREFIX_LENGTH) {
+      prefix = reinterpret_cast<const uint8_t *>(Minimum(inner)->key_.data()) + depth;
+    }
+    for (uint32_t i = 0; i < inner->prefix_length_; i++) {
+      if (depth + i >= low->size() || prefix[i] > ByteAt(*low, depth + i)) {
+        low = nullptr;
+        break;
+      }
+      if (prefix[i] < ByteAt(*low, depth + i)) {
+        return true;
+      }
+    }
+  }
+  depth += inner->prefix_length_;
+  if (low != nullptr && depth >= low->size()) {
+    low = nullptr;
+  }
+  return ForEachChild(inner, [&](uint8_t byte, const Node *child) {
+    if (low == nullptr) {
+      return ScanAt(child, depth + 1, nullptr, low_inclusive, visit);
+    }
+    uint8_t low_byte = ByteAt(*low, depth);
+    if (byte < low_byte) {
+      return true;
+    }
+    return ScanAt(child, depth + 1, byte == low_byte ? low : nullptr, low_inclusive, visit);
+  });
+}
+
+bool AdaptiveRadixTree::Verify() const {
+  const std::string *last = nullptr;
+  if (root_ != nullptr && !VerifyAt(root_, 0, &last)) {
+    return false;
+  }
+  size_t count = 0;
+  Scan(nullptr, true, [&count](const std::string &, const RowId &) { return ++count, true; });
+  return count == size_;
+}
+
+bool AdaptiveRadixTree::VerifyAt(const Node *node, uint32_t depth, const std::string **last) {
+  if (node->type_ == NodeType::kLeaf) {
+    auto leaf = static_cast<const Leaf *>(node);
+    if (*last != nullptr && !(**last < leaf->key_)) {
+      return false;
+    }
+    *last = &leaf->key_;
+    return true;
+  }
+  auto inner = static_cast<const InnerNode *>(node);
+  uint32_t children = 0;
+  ForEachChild(inner, [&children](uint8_t, const Node *) { return ++children, true; });
+  uint32_t low = 0, high = 0;
+  switch (inner->type_) {
+    case NodeType::kNode4:
+      low = 2, high = 4;
+      break;
+    case NodeType::kNode16:
+      low = 4, high = 16;
+      break;
+    case NodeType::kNode48:
+      low = 13, high = 48;
+      break;
+    default:
+      low = 38, high = 256;
+      break;
+  }
+  if (children != inner->count_ || children < low || children > high) {
+    return false;
+  }
+  // the kept prefix and the byte of each child agree with the keys below them
+  const std::string &min_key = Minimum(inner)->key_;
+  if (min_key.size() <= depth + inner->prefix_length_ ||
+      memcmp(inner->prefix_, min_key.data() + depth, std::min(inner->prefix_length_, MAX_PREFIX_LENGTH)) != 0) {
+    return false;
+  }
+  depth += inner->prefix_length_;
+  return ForEachChild(inner, [&](uint8_t byte, const Node *child) {
+    return ByteAt(Minimum(child)->key_, depth) == byte && VerifyAt(child, depth + 1, last);
+  });
+}
@@ -0,0 +1,121 @@
+#include "index/art_index.h"
+
+ArtIndex::ArtIndex(index_id_t index_id, IndexSchema *key_schema) : Index(index_id, key_schema) {}
+
+/** Append a number as 4 big endian bytes */
+static inline void AppendUint32(std::string &buf, uint32_t value) {
+  buf.push_back(static_cast<char>(value >> 24));
+  buf.push_back(static_cast<char>(value >> 16));
+  buf.push_back(static_cast<char>(value >> 8));
+  buf.push_back(static_cast<char>(value));
+}
+
+std::string ArtIndex::EncodeKey(const Row &key) const {
+  std::string buf;
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    Field *field = key.GetField(i);
+    if (field->IsNull()) {
+      buf.push_back('\0');
+      continue;
+    }
+    buf.push_back('\1');
+    switch (field->GetTypeId()) {
+      case TypeId::kTypeInt: {
+        int32_t value;
+        field->SerializeTo(reinterpret_cast<char *>(&value));
+        // flipping the sign bit orders negative numbers first
+        AppendUint32(buf, static_cast<uint32_t>(value) ^ 0x80000000u);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        float value;
+        field->SerializeTo(reinterpret_cast<char *>(&value));
+        if (value == 0) {
+          value = 0;  // -0 equals 0
+        }
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        // negative numbers have every bit flipped, so that a larger magnitude comes first
+        AppendUint32(buf, (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u);
+        break;
+      }
+      default: {
+        const char *data = field->GetData();
+        for (uint32_t j = 0; j < field->GetLength(); j++) {
+          buf.push_back(data[j]);
+          if (data[j] == '\0') {
+            buf.push_back('\1');
+          }
+        }
+        buf.append(2, '\0');
+        break;
+      }
+    }
+  }
+  return buf;
+}
+
+dberr_t ArtIndex::InsertEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  std::string index_key = EncodeKey(key);
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  return container_.Insert(index_key, row_id) ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t ArtIndex::RemoveEntry(const Row &key, RowId row_id, [[maybe_unused]] Transaction *txn) {
+  std::string index_key = EncodeKey(key);
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  RowId stored;
+  bool found = container_.GetValue(index_key, stored) && stored.Get() == row_id.Get();
+  if (found) {
+    container_.Remove(index_key);
+  }
+  return found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+dberr_t ArtIndex::ScanKey(const Row &key, std::vector<RowId> &result, [[maybe_unused]] Transaction *txn,
+                          std::string compare_operator) {
+  std::string index_key = EncodeKey(key);
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  auto append = [&result](const std::string &, const RowId &row_id) {
+    result.emplace_back(row_id);
+    return true;
+  };
+  if (compare_operator == "=") {
+    RowId row_id;
+    if (container_.GetValue(index_key, row_id)) {
+      result.emplace_back(row_id);
+    }
+  } else if (compare_operator == ">" || compare_operator == ">=") {
+    container_.Scan(&index_key, compare_operator == ">=", append);
+  } else if (compare_operator == "<" || compare_operator == "<=") {
+    bool inclusive = compare_operator == "<=";
+    container_.Scan(nullptr, true, [&](const std::string &entry_key, const RowId &row_id) {
+      int cmp = entry_key.compare(index_key);
+      return (cmp < 0 || (cmp == 0 && inclusive)) && append(entry_key, row_id);
+    });
+  } else if (compare_operator == "<>") {
+    container_.Scan(nullptr, true, [&](const std::string &entry_key, const RowId &row_id) {
+      return entry_key == index_key || append(entry_key, row_id);
+    });
+  }
+  return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+dberr_t ArtIndex::Destroy() {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  container_.Clear();
+  return DB_SUCCESS;
+}
+
+dberr_t ArtIndex::Rebuild(TableHeap *table_heap, Schema *table_schema) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  container_.Clear();
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    Row key_row;
+    it->GetKeyFromRow(table_schema, key_schema_, key_row);
+    if (!container_.Insert(EncodeKey(key_row), it->GetRowId())) {
+      return DB_FAILED;
+    }
+  }
+  return DB_SUCCESS;
+}
@@ -86,7 +86,7 @@ bool BPlusTree::Insert(GenericKey *key, const RowId &value, Transaction *transac
  * tree's root page id and insert entry directly into leaf page.
  */
 void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
-  Page *new_root_page = buffer_pool_manager_->NewPage(root_page_id_);
+  Page *new_root_page = NewTreePage(root_page_id_);
   LeafPage *leaf_page = reinterpret_cast<LeafPage *>(new_root_page->GetData());
   leaf_page->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), leaf_max_size_);
   leaf_page->Insert(key, value, processor_);
@@ -94,6 +94,18 @@ void BPlusTree::StartNewTree(GenericKey *key, const RowId &value) {
   UpdateRootPageId(1);
 }
 
+/*
+ * The pages of a tree are taken from runs of contiguous pages, so its leaves lie
+ * in file order as far as they were split in key order
+ */
+Page *BPlusTree::NewTreePage(page_id_t &page_id) {
+  Page *page = buffer_pool_manager_->NewPageNear(page_id, last_page_id_);
+  if (page != nullptr) {
+    last_page_id_ = page_id;
+  }
+  return page;
+}
+
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
@@ -115,17 +127,69 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction
       buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
       return true;
     } else {
-      BPlusTreeLeafPage *next_page = Split(node, transaction);  // 如果插入成功且满了
-      next_page->SetNextPageId(node->GetNextPageId());          // 设置next page id
-      node->SetNextPageId(next_page->GetPageId());
-      InsertIntoParent(node, next_page->KeyAt(0), next_page, transaction);
-      buffer_pool_manager_->UnpinPage(next_page->GetPageId(), true);
+      SplitLeaf(node, transaction);  // 如果插入成功且满了
       buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
       return true;
     }
   }
 }
 
+/*
+ * Split a full leaf page and link the new page into the leaf list and the parent
+ */
+void BPlusTree::SplitLeaf(LeafPage *node, Transaction *transaction) {
+  BPlusTreeLeafPage *next_page = Split(node, transaction);
+  next_page->SetNextPageId(node->GetNextPageId());  // 设置next page id
+  node->SetNextPageId(next_page->GetPageId());
+  InsertIntoParent(node, next_page->KeyAt(0), next_page, transaction);
+  buffer_pool_manager_->UnpinPage(next_page->GetPageId(), true);
+}
+
+/*
+ * Insert key & value pairs sorted by key
+ * The tree is descended for the first pair, the following pairs are inserted
+ * into the same leaf as long as they are below the separator bounding the leaf
+ * on the right, so each leaf is found and pinned once per run of keys. The
+ * tree is descended again after a split.
+ * @return: number of pairs inserted, pairs with a duplicate key are skipped
+ */
+size_t BPlusTree::InsertBatch(const std::vector<std::pair<GenericKey *, RowId>> &entries, std::vector<bool> &inserted,
+                              Transaction *transaction) {
+  inserted.assign(entries.size(), false);
+  size_t count = 0;
+  GenericKey *upper_bound = processor_.InitKey();
+  size_t i = 0;
+  while (i < entries.size()) {
+    if (IsEmpty()) {
+      StartNewTree(entries[i].first, entries[i].second);
+      inserted[i++] = true;
+      count++;
+      continue;
+    }
+    bool has_upper_bound;
+    Page *leaf_page = FindLeafPage(entries[i].first, upper_bound, &has_upper_bound);
+    LeafPage *node = reinterpret_cast<LeafPage *>(leaf_page->GetData());
+    bool is_dirty = false;
+    do {
+      int size = node->GetSize();
+      if (node->Insert(entries[i].first, entries[i].second, processor_) != size) {
+        inserted[i] = true;
+        is_dirty = true;
+        count++;
+      }
+      i++;
+      if (node->GetSize() >= leaf_max_size_) {
+        SplitLeaf(node, transaction);
+        break;
+      }
+    } while (i < entries.size() &&
+             (!has_upper_bound || processor_.CompareKeys(entries[i].first, upper_bound) < 0));
+    buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), is_dirty);
+  }
+  free(upper_bound);
+  return count;
+}
+
 /*
  * Split input page and return newly created page.
  * Using template N to represent either internal page or leaf page.
@@ -135,7 +199,7 @@ bool BPlusTree::InsertIntoLeaf(GenericKey *key, const RowId &value, Transaction
  */
 BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transaction) {
   page_id_t t;
-  Page *new_page = buffer_pool_manager_->NewPage(t);
+  Page *new_page = NewTreePage(t);
   InternalPage *new_node = reinterpret_cast<InternalPage *>(new_page->GetData());
   new_node->Init(new_page->GetPageId(), node->GetParentPageId(), processor_.GetKeySize(), internal_max_size_);
   node->MoveHalfTo(new_node, buffer_pool_manager_);
@@ -145,7 +209,7 @@ BPlusTreeInternalPage *BPlusTree::Split(InternalPage *node, Transaction *transac
 
 BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
   page_id_t t;
-  Page *new_page = buffer_pool_manager_->NewPage(t);
+  Page *new_page = NewTreePage(t);
   LeafPage *new_node = reinterpret_cast<LeafPage *>(new_page->GetData());
   new_node->Init(new_page->GetPageId(), node->GetParentPageId(), processor_.GetKeySize(), leaf_max_size_);
   node->MoveHalfTo(new_node);
@@ -165,7 +229,7 @@ BPlusTreeLeafPage *BPlusTree::Split(LeafPage *node, Transaction *transaction) {
 void BPlusTree::InsertIntoParent(BPlusTreePage *old_node, GenericKey *key, BPlusTreePage *new_node,
                                  Transaction *transaction) {
   if (old_node->IsRootPage()) {
-    Page *new_root_page = buffer_pool_manager_->NewPage(root_page_id_);
+    Page *new_root_page = NewTreePage(root_page_id_);
     InternalPage *new_page = reinterpret_cast<InternalPage *>(new_root_page->GetData());
     new_page->Init(root_page_id_, INVALID_PAGE_ID, processor_.GetKeySize(), internal_max_size_);
     new_page->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
@@ -362,7 +426,15 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
     UpdateRootPageId(0); 
     return true;
   }
-  return old_root_node->IsLeafPage() && old_root_node->GetSize() == 1; // 只有一个pair，且是leaf
+  if (old_root_node->IsLeafPage() && old_root_node->GetSize() == 0) {  // the last pair was removed, the tree is empty
+    root_page_id_ = INVALID_PAGE_ID;
+    // the next insert starts a new tree and records its root again
+    auto *roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID));
+    roots_page->Delete(index_id_);
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+    return true;
+  }
+  return false;
 }
 
 /*****************************************************************************
@@ -376,7 +448,9 @@ bool BPlusTree::AdjustRoot(BPlusTreePage *old_root_node) {
 IndexIterator BPlusTree::Begin() {
   GenericKey *key;
   Page *leaf_page = FindLeafPage(key, root_page_id_, true); // 找到最左边的leaf
-  return IndexIterator(leaf_page->GetPageId(), buffer_pool_manager_, 0); 
+  IndexIterator iter(leaf_page->GetPageId(), buffer_pool_manager_, 0);
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);  // the iterator holds a pin of its own
+  return iter;
 }
 
 /*
@@ -388,7 +462,15 @@ IndexIterator BPlusTree::Begin(const GenericKey *key) {
   Page *leaf_page = FindLeafPage(key); // 找到包含key的leaf
   LeafPage *node = reinterpret_cast<LeafPage *>(leaf_page->GetData()); 
   int temp_index = node->KeyIndex(key, processor_); // 找到key在leaf中的index
-  return IndexIterator(leaf_page->GetPageId(), buffer_pool_manager_, 0);
+  page_id_t page_id = leaf_page->GetPageId();
+  // A key past the last one of the leaf starts the next leaf, so the iterator meets one advanced up to it.
+  if (temp_index == node->GetSize() && node->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id = node->GetNextPageId();
+    temp_index = 0;
+  }
+  IndexIterator iter(page_id, buffer_pool_manager_, temp_index);
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
+  return iter;
 }
 
 /*
@@ -407,7 +489,9 @@ IndexIterator BPlusTree::End() { // 找到最右边的leaf
     page = buffer_pool_manager_->FetchPage(child_id); 
     node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   }
-  return IndexIterator(page->GetPageId(), buffer_pool_manager_, node->GetSize()); // 返回最右边leaf的最后一个pair
+  IndexIterator iter(page->GetPageId(), buffer_pool_manager_, node->GetSize()); // 返回最右边leaf的最后一个pair
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  return iter;
 }
 
 /*****************************************************************************
@@ -438,6 +522,33 @@ Page *BPlusTree::FindLeafPage(const GenericKey *key, page_id_t page_id, bool lef
   return page;
 }
 
+/*
+ * Find leaf page containing particular key, upper_bound receives the smallest
+ * separator above the key met on the way down, keys below it belong to the
+ * same leaf. has_upper_bound is false for the right most leaf.
+ * Note: the leaf page is pinned, you need to unpin it after use.
+ */
+Page *BPlusTree::FindLeafPage(const GenericKey *key, GenericKey *upper_bound, bool *has_upper_bound) {
+  *has_upper_bound = false;
+  if (IsEmpty())
+    return nullptr;
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    InternalPage *internal_node = reinterpret_cast<InternalPage *>(page->GetData());
+    page_id_t child_id = internal_node->Lookup(key, processor_);
+    int index = internal_node->ValueIndex(child_id);
+    if (index + 1 < internal_node->GetSize()) {
+      memcpy(upper_bound, internal_node->KeyAt(index + 1), processor_.GetKeySize());
+      *has_upper_bound = true;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    page = buffer_pool_manager_->FetchPage(child_id);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  }
+  return page;
+}
+
 /*
  * Update/Insert root page id in header page(where page_id = 0, header_page is
  * defined under include/page/header_page.h)
@@ -10,6 +10,7 @@ BPlusTreeIndex::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, siz
       container_(index_id, buffer_pool_manager, processor_) {}
 
 dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
   // ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
@@ -27,16 +28,53 @@ dberr_t BPlusTreeIndex::InsertEntry(const Row &key, RowId row_id, Transaction *t
   return DB_SUCCESS;
 }
 
+dberr_t BPlusTreeIndex::InsertEntries(const std::vector<Row> &keys, const std::vector<RowId> &row_ids,
+                                      Transaction *txn, std::vector<bool> &inserted) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  std::vector<std::pair<GenericKey *, size_t>> sorted;
+  sorted.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    GenericKey *index_key = processor_.InitKey();
+    processor_.SerializeFromKey(index_key, keys[i], key_schema_);
+    sorted.emplace_back(index_key, i);
+  }
+  // Sorted keys land in the same leaf one after another, the tree is descended once per leaf.
+  std::stable_sort(sorted.begin(), sorted.end(), [this](const auto &a, const auto &b) {
+    return processor_.CompareKeys(a.first, b.first) < 0;
+  });
+  std::vector<std::pair<GenericKey *, RowId>> entries;
+  entries.reserve(sorted.size());
+  for (auto &entry : sorted) {
+    entries.emplace_back(entry.first, row_ids[entry.second]);
+  }
+  std::vector<bool> sorted_inserted;
+  container_.InsertBatch(entries, sorted_inserted, txn);
+  inserted.assign(keys.size(), false);
+  for (size_t i = 0; i < sorted.size(); i++) {
+    inserted[sorted[i].second] = sorted_inserted[i];
+    free(sorted[i].first);
+  }
+  return DB_SUCCESS;
+}
+
 dberr_t BPlusTreeIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
 
+  // The key may have been taken over by another row, the entry is only removed while it points at row_id.
+  std::vector<RowId> result;
+  if (!container_.GetValue(index_key, result, txn) || result[0].Get() != row_id.Get()) {
+    delete index_key;
+    return DB_KEY_NOT_FOUND;
+  }
   container_.Remove(index_key, txn);
   delete index_key;
   return DB_SUCCESS;
 }
 
 dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transaction *txn, string compare_operator) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
   GenericKey *index_key = processor_.InitKey();
   processor_.SerializeFromKey(index_key, key, key_schema_);
   if (compare_operator == "=") {
@@ -46,19 +84,22 @@ dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transacti
     if (container_.GetValue(index_key, result, txn))
       ++iter;
     result.clear();
-    for (; iter != GetEndIterator(); ++iter) {
+    for (auto end = GetEndIterator(); iter != end; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == ">=") {
-    for (auto iter = GetBeginIterator(index_key); iter != GetEndIterator(); ++iter) {
+    auto end = GetEndIterator();
+    for (auto iter = GetBeginIterator(index_key); iter != end; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<") {
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
+    auto end = GetBeginIterator(index_key);
+    for (auto iter = GetBeginIterator(); iter != end; ++iter) {
       result.emplace_back((*iter).second);
     }
   } else if (compare_operator == "<=") {
-    for (auto iter = GetBeginIterator(); iter != GetBeginIterator(index_key); ++iter) {
+    auto end = GetBeginIterator(index_key);
+    for (auto iter = GetBeginIterator(); iter != end; ++iter) {
       result.emplace_back((*iter).second);
     }
     container_.GetValue(index_key, result, txn);
@@ -78,6 +119,7 @@ dberr_t BPlusTreeIndex::ScanKey(const Row &key, vector<RowId> &result, Transacti
 }
 
 dberr_t BPlusTreeIndex::Destroy() {
+  std::unique_lock<std::shared_mutex> guard(latch_);
   container_.Destroy();
   return DB_SUCCESS;
 }
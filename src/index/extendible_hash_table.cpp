@@ -0,0 +1,259 @@
+#include "index/extendible_hash_table.h"
+
+#include "glog/logging.h"
+#include "page/index_roots_page.h"
+
+ExtendibleHashTable::ExtendibleHashTable(index_id_t index_id, BufferPoolManager *buffer_pool_manager,
+                                         const KeyManager &key_manager)
+    : index_id_(index_id),
+      buffer_pool_manager_(buffer_pool_manager),
+      key_size_(key_manager.GetKeySize()) {
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  if (roots_page->GetRootId(index_id_, &directory_page_id_)) {
+    buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    return;
+  }
+  page_id_t bucket_page_id;
+  Page *directory_page = buffer_pool_manager_->NewPage(directory_page_id_);
+  Page *bucket_page = buffer_pool_manager_->NewPageNear(bucket_page_id, directory_page_id_);
+  ASSERT(directory_page != nullptr && bucket_page != nullptr, "hash table page allocation failed.");
+  reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())->Init(directory_page_id_, bucket_page_id);
+  reinterpret_cast<HashTableBucketPage *>(bucket_page->GetData())->Init(bucket_page_id);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  roots_page->Insert(index_id_, directory_page_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+}
+
+uint32_t ExtendibleHashTable::Hash(const GenericKey *key) const {
+  // FNV-1a over the bytes, then the 64 bit finalizer of MurmurHash3 to spread them to the low bits
+  auto bytes = reinterpret_cast<const uint8_t *>(key);
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < key_size_; i++) {
+    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+bool ExtendibleHashTable::Insert(GenericKey *key, const RowId &value, [[maybe_unused]] Transaction *transaction) {
+  uint32_t hash = Hash(key);
+  HashTableDirectoryPage *directory = FetchDirectory();
+  bool directory_dirty = false;
+  bool inserted = false;
+  for (;;) {
+    uint32_t bucket_idx = hash & directory->GetGlobalDepthMask();
+    // the key may be in any page of the chain, the pair goes to the first page with room
+    page_id_t room_page_id = INVALID_PAGE_ID, last_page_id = INVALID_PAGE_ID;
+    bool duplicate = false;
+    for (page_id_t page_id = directory->GetBucketPageId(bucket_idx); page_id != INVALID_PAGE_ID && !duplicate;) {
+      HashTableBucketPage *bucket = FetchBucket(page_id);
+      duplicate = bucket->KeyIndex(key, key_size_) >= 0;
+      if (room_page_id == INVALID_PAGE_ID && !bucket->IsFull(key_size_)) {
+        room_page_id = page_id;
+      }
+      last_page_id = page_id;
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+    if (duplicate) {
+      break;
+    }
+    if (room_page_id != INVALID_PAGE_ID) {
+      FetchBucket(room_page_id)->Insert(key, value, key_size_);
+      buffer_pool_manager_->UnpinPage(room_page_id, true);
+      inserted = true;
+      break;
+    }
+    if (directory->GetLocalDepth(bucket_idx) < HashTableDirectoryPage::MAX_DEPTH) {
+      if (!SplitBucket(directory, bucket_idx)) {
+        break;
+      }
+      directory_dirty = true;
+      continue;
+    }
+    // the bucket can not split any more, an overflow page is linked behind the chain
+    page_id_t overflow_page_id;
+    Page *page = buffer_pool_manager_->NewPageNear(overflow_page_id, last_page_id);
+    if (page == nullptr) {
+      break;
+    }
+    auto overflow = reinterpret_cast<HashTableBucketPage *>(page->GetData());
+    overflow->Init(overflow_page_id);
+    overflow->Insert(key, value, key_size_);
+    buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+    FetchBucket(last_page_id)->SetNextPageId(overflow_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    inserted = true;
+    break;
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, directory_dirty);
+  return inserted;
+}
+
+bool ExtendibleHashTable::SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  page_id_t image_page_id;
+  Page *page = buffer_pool_manager_->NewPageNear(image_page_id, bucket_page_id);
+  if (page == nullptr) {
+    return false;
+  }
+  if (local_depth == directory->GetGlobalDepth()) {
+    directory->IncrGlobalDepth();
+  }
+  auto image = reinterpret_cast<HashTableBucketPage *>(page->GetData());
+  image->Init(image_page_id);
+  // the keys with the next bit of the hash set move to the image, from the last pair down so that the pair
+  // taking the place of a moved one was already looked at
+  uint32_t high_bit = 1U << local_depth;
+  HashTableBucketPage *bucket = FetchBucket(bucket_page_id);
+  for (int i = static_cast<int>(bucket->GetSize()) - 1; i >= 0; i--) {
+    GenericKey *key = bucket->KeyAt(i, key_size_);
+    if (Hash(key) & high_bit) {
+      image->Insert(key, bucket->ValueAt(i, key_size_), key_size_);
+      bucket->RemoveAt(i, key_size_);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == bucket_page_id) {
+      directory->SetLocalDepth(i, local_depth + 1);
+      if (i & high_bit) {
+        directory->SetBucketPageId(i, image_page_id);
+      }
+    }
+  }
+  return true;
+}
+
+bool ExtendibleHashTable::Remove(const GenericKey *key, [[maybe_unused]] Transaction *transaction) {
+  HashTableDirectoryPage *directory = FetchDirectory();
+  page_id_t head_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  for (page_id_t page_id = head_page_id; page_id != INVALID_PAGE_ID;) {
+    HashTableBucketPage *bucket = FetchBucket(page_id);
+    int index = bucket->KeyIndex(key, key_size_);
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (index < 0) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+    bucket->RemoveAt(index, key_size_);
+    bool emptied = bucket->GetSize() == 0;
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    // an emptied overflow page leaves the chain, the head page stays in the directory
+    if (emptied && prev_page_id != INVALID_PAGE_ID) {
+      FetchBucket(prev_page_id)->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    return true;
+  }
+  return false;
+}
+
+bool ExtendibleHashTable::GetValue(const GenericKey *key, std::vector<RowId> &result,
+                                   [[maybe_unused]] Transaction *transaction) {
+  HashTableDirectoryPage *directory = FetchDirectory();
+  page_id_t page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  while (page_id != INVALID_PAGE_ID) {
+    HashTableBucketPage *bucket = FetchBucket(page_id);
+    int index = bucket->KeyIndex(key, key_size_);
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (index >= 0) {
+      result.emplace_back(bucket->ValueAt(index, key_size_));
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (index >= 0) {
+      return true;
+    }
+    page_id = next_page_id;
+  }
+  return false;
+}
+
+void ExtendibleHashTable::ForEach(const std::function<void(GenericKey *, const RowId &)> &visit) {
+  HashTableDirectoryPage *directory = FetchDirectory();
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (!directory->IsFirstSlot(i)) {
+      continue;
+    }
+    for (page_id_t page_id = directory->GetBucketPageId(i); page_id != INVALID_PAGE_ID;) {
+      HashTableBucketPage *bucket = FetchBucket(page_id);
+      for (uint32_t j = 0; j < bucket->GetSize(); j++) {
+        visit(bucket->KeyAt(j, key_size_), bucket->ValueAt(j, key_size_));
+      }
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+}
+
+void ExtendibleHashTable::Destroy() {
+  if (directory_page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  HashTableDirectoryPage *directory = FetchDirectory();
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (!directory->IsFirstSlot(i)) {
+      continue;
+    }
+    for (page_id_t page_id = directory->GetBucketPageId(i); page_id != INVALID_PAGE_ID;) {
+      page_id_t next_page_id = FetchBucket(page_id)->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      buffer_pool_manager_->DeletePage(page_id);
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  buffer_pool_manager_->DeletePage(directory_page_id_);
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  roots_page->Delete(index_id_);
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+  directory_page_id_ = INVALID_PAGE_ID;
+}
+
+uint32_t ExtendibleHashTable::GetGlobalDepth() {
+  uint32_t global_depth = FetchDirectory()->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return global_depth;
+}
+
+bool ExtendibleHashTable::Verify() {
+  HashTableDirectoryPage *directory = FetchDirectory();
+  bool valid = directory->Verify();
+  for (uint32_t i = 0; i < directory->Size() && valid; i++) {
+    uint32_t local_mask = (1U << directory->GetLocalDepth(i)) - 1;
+    for (page_id_t page_id = directory->GetBucketPageId(i); page_id != INVALID_PAGE_ID && valid;) {
+      HashTableBucketPage *bucket = FetchBucket(page_id);
+      for (uint32_t j = 0; j < bucket->GetSize() && valid; j++) {
+        valid = (Hash(bucket->KeyAt(j, key_size_)) & local_mask) == (i & local_mask);
+      }
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  if (!valid) {
+    LOG(ERROR) << "hash table of index " << index_id_ << " is inconsistent";
+  }
+  bool all_unpinned = buffer_pool_manager_->CheckAllUnpinned();
+  if (!all_unpinned) {
+    LOG(ERROR) << "problem in page unpin";
+  }
+  return valid && all_unpinned;
+}
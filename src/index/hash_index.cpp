@@ -0,0 +1,58 @@
+#include "index/hash_index.h"
+
+HashIndex::HashIndex(index_id_t index_id, IndexSchema *key_schema, size_t key_size,
+                     BufferPoolManager *buffer_pool_manager)
+    : Index(index_id, key_schema),
+      processor_(key_schema_, key_size),
+      container_(index_id, buffer_pool_manager, processor_) {}
+
+dberr_t HashIndex::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  bool status = container_.Insert(index_key, row_id, txn);
+  free(index_key);
+  return status ? DB_SUCCESS : DB_FAILED;
+}
+
+dberr_t HashIndex::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  std::vector<RowId> result;
+  bool found = container_.GetValue(index_key, result, txn) && result[0].Get() == row_id.Get();
+  if (found) {
+    container_.Remove(index_key, txn);
+  }
+  free(index_key);
+  return found ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+}
+
+dberr_t HashIndex::ScanKey(const Row &key, std::vector<RowId> &result, Transaction *txn,
+                           std::string compare_operator) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  GenericKey *index_key = processor_.InitKey();
+  processor_.SerializeFromKey(index_key, key, key_schema_);
+  if (compare_operator == "=") {
+    container_.GetValue(index_key, result, txn);
+  } else if (compare_operator == ">" || compare_operator == ">=" || compare_operator == "<" ||
+             compare_operator == "<=" || compare_operator == "<>") {
+    // the hash keeps no order, every pair is compared with the key
+    container_.ForEach([&](GenericKey *entry_key, const RowId &row_id) {
+      int cmp = processor_.CompareKeys(entry_key, index_key);
+      if ((compare_operator == ">" && cmp > 0) || (compare_operator == ">=" && cmp >= 0) ||
+          (compare_operator == "<" && cmp < 0) || (compare_operator == "<=" && cmp <= 0) ||
+          (compare_operator == "<>" && cmp != 0)) {
+        result.emplace_back(row_id);
+      }
+    });
+  }
+  free(index_key);
+  return result.empty() ? DB_KEY_NOT_FOUND : DB_SUCCESS;
+}
+
+dberr_t HashIndex::Destroy() {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  container_.Destroy();
+  return DB_SUCCESS;
+}
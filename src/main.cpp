@@ -1,16 +1,20 @@
+#include <algorithm>
+#include <csignal>
 #include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
 
+#include "common/metrics.h"
 #include "executor/execute_engine.h"
 #include "glog/logging.h"
+#include "parser/parsed_statement.h"
 #include "parser/syntax_tree_printer.h"
+#include "server/server.h"
 #include "utils/tree_file_mgr.h"
 
-extern "C" {
-int yyparse(void);
-FILE *yyin;
-#include "parser/minisql_lex.h"
-#include "parser/parser.h"
-}
+static Server *server = nullptr;
 
 void InitGoogleLog(char *argv) {
   FLAGS_logtostderr = true;
@@ -19,63 +23,124 @@ void InitGoogleLog(char *argv) {
   // LOG(INFO) << "glog started!";
 }
 
-void InputCommand(char *input, const int len) {
-  memset(input, 0, len);
+/**
+ * Read one statement up to and including ';'.
+ * @return false at the end of the input
+ */
+bool InputCommand(std::string &input) {
+  input.clear();
   printf("minisql > ");
-  int i = 0;
-  char ch;
+  fflush(stdout);
+  int ch;
   while ((ch = getchar()) != ';') {
-    input[i++] = ch;
+    if (ch == EOF) {
+      return false;
+    }
+    input.push_back(static_cast<char>(ch));
+  }
+  input.push_back(';');
+  getchar();  // remove enter
+  return true;
+}
+
+void StopServer(int) {
+  if (server != nullptr) {
+    server->Shutdown();
   }
-  input[i] = ch;  // ;
-  getchar();      // remove enter
+}
+
+int RunServer(ExecuteEngine &engine, int port, const std::string &socket_path, size_t num_workers) {
+  Server instance(&engine, num_workers);
+  if (port >= 0 && instance.ListenTcp(static_cast<uint16_t>(port)) != DB_SUCCESS) {
+    return 1;
+  }
+  if (!socket_path.empty() && instance.ListenUnix(socket_path) != DB_SUCCESS) {
+    return 1;
+  }
+  server = &instance;
+  signal(SIGINT, StopServer);
+  signal(SIGTERM, StopServer);
+  LOG(INFO) << "minisql server listening on" << (port >= 0 ? " port " + std::to_string(instance.GetPort()) : "")
+            << (socket_path.empty() ? "" : " " + socket_path) << " with " << instance.GetWorkerCount() << " workers";
+  instance.Run();
+  server = nullptr;
+  return 0;
 }
 
 int main(int argc, char **argv) {
   InitGoogleLog(argv[0]);
+  // server options, the shell is run without them
+  int port = -1;
+  std::string socket_path;
+  size_t num_workers = 0;
+  size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE;
+  // metrics are written for a scraper if a file is given
+  std::string metrics_path;
+  long metrics_interval = 10;
+  // statements taking at least slow_query_ms are logged if a file is given
+  std::string slow_query_path;
+  long slow_query_ms = 100;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--port=", 7) == 0) {
+      port = atoi(argv[i] + 7);
+    } else if (strncmp(argv[i], "--socket=", 9) == 0) {
+      socket_path = argv[i] + 9;
+    } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+      num_workers = strtoul(argv[i] + 10, nullptr, 10);
+    } else if (strncmp(argv[i], "--buffer_pool_pages=", 20) == 0) {
+      buffer_pool_size = strtoul(argv[i] + 20, nullptr, 10);
+    } else if (strncmp(argv[i], "--metrics_file=", 15) == 0) {
+      metrics_path = argv[i] + 15;
+    } else if (strncmp(argv[i], "--metrics_interval=", 19) == 0) {
+      metrics_interval = std::max(1L, strtol(argv[i] + 19, nullptr, 10));
+    } else if (strncmp(argv[i], "--slow_query_log=", 17) == 0) {
+      slow_query_path = argv[i] + 17;
+    } else if (strncmp(argv[i], "--slow_query_ms=", 16) == 0) {
+      slow_query_ms = std::max(0L, strtol(argv[i] + 16, nullptr, 10));
+    } else {
+      fprintf(stderr,
+              "usage: %s [--port=N] [--socket=PATH] [--workers=N] [--buffer_pool_pages=N] [--metrics_file=PATH] "
+              "[--metrics_interval=SECONDS] [--slow_query_log=PATH] [--slow_query_ms=N]\n",
+              argv[0]);
+      return 1;
+    }
+  }
+  // executor engine, the buffer pool is shared by all databases
+  ExecuteEngine engine(buffer_pool_size);
+  if (!slow_query_path.empty() &&
+      engine.OpenSlowQueryLog(slow_query_path, std::chrono::milliseconds(slow_query_ms)) != DB_SUCCESS) {
+    fprintf(stderr, "can not open slow query log %s\n", slow_query_path.c_str());
+    return 1;
+  }
+  std::unique_ptr<MetricsFileWriter> metrics_writer;
+  if (!metrics_path.empty()) {
+    metrics_writer = std::make_unique<MetricsFileWriter>(metrics_path, std::chrono::seconds(metrics_interval),
+                                                         [&engine](std::ostream &out) { engine.WriteMetrics(out); });
+  }
+  if (port >= 0 || !socket_path.empty()) {
+    return RunServer(engine, port, socket_path, num_workers);
+  }
   // command buffer
-  const int buf_size = 1024;
-  char cmd[buf_size];
-  // executor engine
-  ExecuteEngine engine;
+  std::string cmd;
   // for print syntax tree
   TreeFileManagers syntax_tree_file_mgr("syntax_tree_");
   uint32_t syntax_tree_id = 0;
 
-  while (1) {
-    // read from buffer
-    InputCommand(cmd, buf_size);
-    // create buffer for sql input
-    YY_BUFFER_STATE bp = yy_scan_string(cmd);
-    if (bp == nullptr) {
-      LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
-      exit(1);
-    }
-    yy_switch_to_buffer(bp);
-
-    // init parser module
-    MinisqlParserInit();
-
-    // parse
-    yyparse();
+  while (InputCommand(cmd)) {
+    auto statement = ParsedStatement::Parse(cmd);
 
     // parse result handle
-    if (MinisqlParserGetError()) {
+    if (statement->HasError()) {
       // error
-      printf("%s\n", MinisqlParserGetErrorMessage());
+      printf("%s\n", statement->GetErrorMessage().c_str());
     } else {
       // Comment them out if you don't need to debug the syntax tree
       printf("[INFO] Sql syntax parse ok!\n");
-      SyntaxTreePrinter printer(MinisqlGetParserRootNode());
+      SyntaxTreePrinter printer(statement->GetRoot());
       printer.PrintTree(syntax_tree_file_mgr[syntax_tree_id++]);
     }
 
-    auto result = engine.Execute(MinisqlGetParserRootNode());
-
-    // clean memory after parse
-    MinisqlParserFinish();
-    yy_delete_buffer(bp);
-    yylex_destroy();
+    auto result = engine.Execute(*statement);
 
     // quit condition
     engine.ExecuteInformation(result);
@@ -84,4 +149,4 @@ int main(int argc, char **argv) {
     }
   }
   return 0;
-}
\ No newline at end of file
+}
@@ -3,6 +3,7 @@
 #include "glog/logging.h"
 
 #include<cmath>
+#include<cstring>
 /**
  * TODO: Student Implement
  */
@@ -12,13 +13,49 @@ bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset){
     bytes[next_free_page_/8] |= 1<<(next_free_page_%8);
     page_offset = next_free_page_;
     page_allocated_ += 1;
-    for(;next_free_page_<GetMaxSupportedSize();next_free_page_++){
-      if(!(bytes[next_free_page_/8]&(1<<(next_free_page_%8)))) break;
-    }
+    next_free_page_ = NextFreePage(page_offset + 1);
     return true;
   }else return false;
 }
 
+template <size_t PageSize>
+bool BitmapPage<PageSize>::AllocatePageAt(uint32_t page_offset) {
+  if(page_offset >= GetMaxSupportedSize() || !IsPageFree(page_offset)) return false;
+  bytes[page_offset/8] |= 1<<(page_offset%8);
+  page_allocated_ += 1;
+  if(page_offset == next_free_page_) next_free_page_ = NextFreePage(page_offset + 1);
+  return true;
+}
+
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::NextFreePage(uint32_t from) const {
+  // A word at a time, the pages below from count as allocated.
+  for(uint32_t run = from / RUN_SIZE; run < GetMaxSupportedSize() / RUN_SIZE; run++){
+    uint64_t bits = GetRunBits(run);
+    if(run == from / RUN_SIZE) bits |= (uint64_t{1} << (from % RUN_SIZE)) - 1;
+    if(~bits != 0) return run * RUN_SIZE + __builtin_ctzll(~bits);
+  }
+  return GetMaxSupportedSize();
+}
+
+template <size_t PageSize>
+uint32_t BitmapPage<PageSize>::NextFreeRun(uint32_t from) const {
+  for(uint32_t run = (from + RUN_SIZE - 1) / RUN_SIZE; run < GetMaxSupportedSize() / RUN_SIZE; run++){
+    if(GetRunBits(run) == 0) return run * RUN_SIZE;
+  }
+  return GetMaxSupportedSize();
+}
+
+template <size_t PageSize>
+uint64_t BitmapPage<PageSize>::GetRunBits(uint32_t run) const {
+  static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "bit i of a word loaded is bit i%8 of byte i/8");
+  static_assert(RUN_SIZE == 8 * sizeof(uint64_t) && MAX_CHARS % sizeof(uint64_t) == 0,
+                "the bitmap is a whole number of runs");
+  uint64_t bits;
+  memcpy(&bits, bytes + run * sizeof(uint64_t), sizeof(uint64_t));
+  return bits;
+}
+
 /**
  * TODO: Student Implement
  */
@@ -60,4 +97,9 @@ template class BitmapPage<1024>;
 
 template class BitmapPage<2048>;
 
-template class BitmapPage<4096>;
\ No newline at end of file
+template class BitmapPage<4096>;
+template class BitmapPage<8192>;
+
+template class BitmapPage<16384>;
+
+template class BitmapPage<32768>;
@@ -0,0 +1,33 @@
+#include "page/hash_table_bucket_page.h"
+
+#include <cstring>
+
+void HashTableBucketPage::Init(page_id_t page_id) {
+  page_id_ = page_id;
+  next_page_id_ = INVALID_PAGE_ID;
+  size_ = 0;
+}
+
+int HashTableBucketPage::KeyIndex(const GenericKey *key, uint32_t key_size) {
+  for (uint32_t i = 0; i < size_; i++) {
+    if (memcmp(KeyAt(i, key_size), key, key_size) == 0) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void HashTableBucketPage::Insert(const GenericKey *key, const RowId &value, uint32_t key_size) {
+  char *pair = data_ + size_ * (key_size + sizeof(RowId));
+  memcpy(pair, key, key_size);
+  memcpy(pair + key_size, &value, sizeof(RowId));
+  size_++;
+}
+
+void HashTableBucketPage::RemoveAt(uint32_t index, uint32_t key_size) {
+  uint32_t pair_size = key_size + sizeof(RowId);
+  size_--;
+  if (index != size_) {
+    memcpy(data_ + index * pair_size, data_ + size_ * pair_size, pair_size);
+  }
+}
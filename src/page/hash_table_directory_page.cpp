@@ -0,0 +1,31 @@
+#include "page/hash_table_directory_page.h"
+
+void HashTableDirectoryPage::Init(page_id_t page_id, page_id_t bucket_page_id) {
+  page_id_ = page_id;
+  global_depth_ = 0;
+  local_depths_[0] = 0;
+  bucket_page_ids_[0] = bucket_page_id;
+}
+
+void HashTableDirectoryPage::IncrGlobalDepth() {
+  uint32_t size = Size();
+  for (uint32_t i = 0; i < size; i++) {
+    bucket_page_ids_[size + i] = bucket_page_ids_[i];
+    local_depths_[size + i] = local_depths_[i];
+  }
+  global_depth_++;
+}
+
+bool HashTableDirectoryPage::Verify() const {
+  for (uint32_t i = 0; i < Size(); i++) {
+    uint32_t local_depth = local_depths_[i];
+    if (local_depth > global_depth_) {
+      return false;
+    }
+    uint32_t first = i & ((1U << local_depth) - 1);
+    if (bucket_page_ids_[first] != bucket_page_ids_[i] || local_depths_[first] != local_depth) {
+      return false;
+    }
+  }
+  return true;
+}
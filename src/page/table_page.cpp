@@ -1,5 +1,7 @@
 #include "page/table_page.h"
 
+#include <algorithm>
+
 void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn) {
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
@@ -8,23 +10,228 @@ void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr,
   SetTupleCount(0);
 }
 
+void TablePage::InitColumnar(page_id_t page_id, page_id_t prev_id, Schema *schema, LogManager *log_mgr,
+                             Transaction *txn) {
+  uint32_t capacity = GetColumnarCapacity(schema);
+  ASSERT(capacity > 0, "A tuple does not fit a columnar page.");
+  Init(page_id, prev_id, log_mgr, txn);
+  SetFreeSpacePointer(COLUMNAR_FLAG | capacity);
+}
+
+uint32_t TablePage::GetColumnarCapacity(Schema *schema) {
+  // bytes of a tuple in the slots and the minipages, the null bitmaps take a bit per column besides
+  uint32_t tuple_width = SIZE_TUPLE;
+  uint32_t column_count = schema->GetColumnCount();
+  for (auto column : schema->GetColumns()) {
+    tuple_width += GetColumnarWidth(column);
+  }
+  uint32_t capacity = (PAGE_SIZE - SIZE_TABLE_PAGE_HEADER) * 8 / (tuple_width * 8 + column_count);
+  // the bitmaps are rounded up to bytes
+  while (capacity > 0 &&
+         SIZE_TABLE_PAGE_HEADER + capacity * tuple_width + column_count * ((capacity + 7) / 8) > PAGE_SIZE) {
+    capacity--;
+  }
+  return capacity;
+}
+
+bool TablePage::FitsColumnar(const Row &row, Schema *schema) {
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    Field *field = row.GetField(i);
+    if (column->GetType() == TypeId::kTypeChar && !field->IsNull() && field->GetLength() > column->GetLength()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t TablePage::GetColumnarWidth(const Column *column) {
+  if (column->GetType() == TypeId::kTypeChar) {
+    return sizeof(uint16_t) + column->GetLength();
+  }
+  return Type::GetTypeSize(column->GetType());
+}
+
+uint32_t TablePage::GetMinipageOffset(Schema *schema, uint32_t column_id) {
+  uint32_t capacity = GetColumnarCapacity();
+  uint32_t offset = SIZE_TABLE_PAGE_HEADER + SIZE_TUPLE * capacity;
+  for (uint32_t i = 0; i < column_id; i++) {
+    offset += (capacity + 7) / 8 + capacity * GetColumnarWidth(schema->GetColumn(i));
+  }
+  return offset;
+}
+
+void TablePage::WriteColumnarTuple(uint32_t slot_num, const Row &row, Schema *schema) {
+  uint32_t capacity = GetColumnarCapacity();
+  uint32_t minipage_offset = GetMinipageOffset(schema, 0);
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    const Column *column = schema->GetColumn(i);
+    uint32_t width = GetColumnarWidth(column);
+    Field *field = row.GetField(i);
+    char *null_byte = GetData() + minipage_offset + slot_num / 8;
+    char *value = GetData() + minipage_offset + (capacity + 7) / 8 + slot_num * width;
+    if (field->IsNull()) {
+      *null_byte = static_cast<char>(*null_byte | (1 << (slot_num % 8)));
+    } else {
+      *null_byte = static_cast<char>(*null_byte & ~(1 << (slot_num % 8)));
+      if (column->GetType() == TypeId::kTypeChar) {
+        auto length = static_cast<uint16_t>(field->GetLength());
+        memcpy(value, &length, sizeof(uint16_t));
+        memcpy(value + sizeof(uint16_t), field->GetData(), length);
+      } else {
+        field->SerializeTo(value);
+      }
+    }
+    minipage_offset += (capacity + 7) / 8 + capacity * width;
+  }
+}
+
+template <typename Append>
+void TablePage::ReadColumnarField(uint32_t slot_num, const Column *column, uint32_t minipage_offset,
+                                  Append append) {
+  uint32_t capacity = GetColumnarCapacity();
+  TypeId type = column->GetType();
+  if ((GetData()[minipage_offset + slot_num / 8] >> (slot_num % 8)) & 1) {
+    append(type);
+    return;
+  }
+  char *value = GetData() + minipage_offset + (capacity + 7) / 8 + slot_num * GetColumnarWidth(column);
+  if (type == TypeId::kTypeInt) {
+    append(type, MACH_READ_FROM(int32_t, value));
+  } else if (type == TypeId::kTypeFloat) {
+    append(type, MACH_READ_FROM(float, value));
+  } else {
+    append(type, value + sizeof(uint16_t), static_cast<uint32_t>(MACH_READ_FROM(uint16_t, value)), true);
+  }
+}
+
+void TablePage::ReadColumnarTuple(uint32_t slot_num, Row *row, Schema *schema) {
+  uint32_t capacity = GetColumnarCapacity();
+  uint32_t minipage_offset = GetMinipageOffset(schema, 0);
+  row->GetFields().reserve(schema->GetColumnCount());
+  for (auto column : schema->GetColumns()) {
+    ReadColumnarField(slot_num, column, minipage_offset,
+                      [row](auto &&...args) { row->GetFields().push_back(new Field(args...)); });
+    minipage_offset += (capacity + 7) / 8 + capacity * GetColumnarWidth(column);
+  }
+}
+
+bool TablePage::InsertColumnarTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager) {
+  // Reuse a free slot or take the next one.
+  uint32_t i;
+  if (!FitsColumnar(row, schema) || !ClaimSlot(txn, lock_manager, GetColumnarCapacity(), &i)) {
+    return false;
+  }
+  WriteColumnarTuple(i, row, schema);
+  SetTupleOffsetAtSlot(i, 0);
+  SetTupleSize(i, COLUMNAR_TUPLE_SIZE);
+  row.SetRowId(RowId(GetTablePageId(), i));
+  if (i == GetTupleCount()) {
+    SetTupleCount(GetTupleCount() + 1);
+  }
+  return true;
+}
+
+TablePage::UpdateStatus TablePage::UpdateColumnarTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn,
+                                                       LockManager *lock_manager) {
+  uint32_t slot_num = old_row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return kUpdateInvalidSlot;
+  }
+  if (txn != nullptr && lock_manager != nullptr && !lock_manager->LockExclusive(txn, old_row->GetRowId())) {
+    return kUpdateLockFailed;
+  }
+  if (IsDeleted(GetTupleSize(slot_num))) {
+    return kUpdateDeleted;
+  }
+  if (!FitsColumnar(new_row, schema)) {
+    return kUpdateNoSpace;
+  }
+  // The values of a tuple have fixed places, it is always updated in place.
+  new_row.SetRowId(old_row->GetRowId());
+  ReadColumnarTuple(slot_num, old_row, schema);
+  WriteColumnarTuple(slot_num, new_row, schema);
+  return kUpdateSuccess;
+}
+
+void TablePage::GetColumns(Schema *schema, const std::vector<uint32_t> &column_ids,
+                           std::vector<std::vector<Field>> *columns, std::vector<RowId> *rids) {
+  if (columns->size() < column_ids.size()) {
+    columns->resize(column_ids.size());
+  }
+  if (!IsColumnar()) {
+    RowId rid;
+    for (bool found = GetFirstTupleRid(&rid); found; found = GetNextTupleRid(rid, &rid)) {
+      Row row(rid);
+      row.DeserializeFrom(GetData() + GetTupleOffsetAtSlot(rid.GetSlotNum()), schema);
+      for (size_t j = 0; j < column_ids.size(); j++) {
+        (*columns)[j].emplace_back(*row.GetField(column_ids[j]));
+      }
+      if (rids != nullptr) {
+        rids->push_back(rid);
+      }
+    }
+    return;
+  }
+  // Only the minipages of the columns asked for are read, column by column.
+  uint32_t tuple_count = GetTupleCount();
+  for (size_t j = 0; j < column_ids.size(); j++) {
+    const Column *column = schema->GetColumn(column_ids[j]);
+    uint32_t minipage_offset = GetMinipageOffset(schema, column_ids[j]);
+    auto &values = (*columns)[j];
+    for (uint32_t i = 0; i < tuple_count; i++) {
+      if (!IsDeleted(GetTupleSize(i))) {
+        ReadColumnarField(i, column, minipage_offset, [&values](auto &&...args) { values.emplace_back(args...); });
+      }
+    }
+  }
+  if (rids != nullptr) {
+    for (uint32_t i = 0; i < tuple_count; i++) {
+      if (!IsDeleted(GetTupleSize(i))) {
+        rids->emplace_back(GetTablePageId(), i);
+      }
+    }
+  }
+}
+
+bool TablePage::ClaimSlot(Transaction *txn, LockManager *lock_manager, uint32_t slot_limit, uint32_t *slot_num) {
+  auto try_lock = [&](uint32_t slot) {
+    return txn == nullptr || lock_manager == nullptr ||
+           lock_manager->TryLockExclusive(txn, RowId(GetTablePageId(), slot));
+  };
+  // A reader under repeatable read may keep a lock on a free slot it looked at, waiting for it here would hold
+  // the page latch the reader may ask for next.
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) == 0) {
+      if (try_lock(i)) {
+        *slot_num = i;
+        return true;
+      }
+      if (txn->GetState() == TxnState::kAborted) {
+        return false;
+      }
+    }
+  }
+  if (GetTupleCount() >= slot_limit || !try_lock(GetTupleCount())) {
+    return false;
+  }
+  *slot_num = GetTupleCount();
+  return true;
+}
+
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager,
                             LogManager *log_manager) {
+  if (IsColumnar()) {
+    return InsertColumnarTuple(row, schema, txn, lock_manager);
+  }
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
   if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
     return false;
   }
-  // Try to find a free slot to reuse.
+  // Find a free slot to reuse or take a new one, locked before the row becomes visible.
   uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
-    }
-  }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  if (!ClaimSlot(txn, lock_manager, UINT32_MAX, &i)) {
     return false;
   }
   // Otherwise we claim available free space..
@@ -49,6 +256,10 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   if (slot_num >= GetTupleCount()) {
     return false;
   }
+  // Acquire an exclusive lock, the table heap usually takes it before latching the page.
+  if (txn != nullptr && lock_manager != nullptr && !lock_manager->LockExclusive(txn, rid)) {
+    return false;
+  }
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is already deleted, abort.
   if (IsDeleted(tuple_size)) {
@@ -61,51 +272,87 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   return true;
 }
 
-bool TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn,
-                            LockManager *lock_manager, LogManager *log_manager) {
+TablePage::UpdateStatus TablePage::UpdateTuple(Row &new_row, Row *old_row, Schema *schema, Transaction *txn,
+                                               LockManager *lock_manager,
+                                               [[maybe_unused]] LogManager *log_manager) {
     ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "invalid old row.");
+    if (IsColumnar()) {
+        return UpdateColumnarTuple(new_row, old_row, schema, txn, lock_manager);
+    }
     uint32_t serialized_size = new_row.GetSerializedSize(schema);
     ASSERT(serialized_size > 0, "Can not have empty row.");
     uint32_t slot_num = old_row->GetRowId().GetSlotNum();
     // If the slot number is invalid, abort.
     if (slot_num >= GetTupleCount()) {
-        return 1;
+        return kUpdateInvalidSlot;
+    }
+    // Acquire an exclusive lock, the table heap usually takes it before latching the page.
+    if (txn != nullptr && lock_manager != nullptr && !lock_manager->LockExclusive(txn, old_row->GetRowId())) {
+        return kUpdateLockFailed;
     }
     uint32_t tuple_size = GetTupleSize(slot_num);
     // If the tuple is deleted, abort.
     if (IsDeleted(tuple_size)) {
-        return 2;
+        return kUpdateDeleted;
     }
+    // A transaction keeps the space of the old tuple until it ends, so that its undo always fits in place.
+    uint32_t allocated_size = txn != nullptr ? std::max(serialized_size, tuple_size) : serialized_size;
     // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
-    if (GetFreeSpaceRemaining() + tuple_size < serialized_size) {
-        return 3;
+    if (GetFreeSpaceRemaining() + tuple_size < allocated_size) {
+        return kUpdateNoSpace;
     }
     // Copy out the old value.
     new_row.SetRowId(old_row->GetRowId());
-    uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-    uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
-    ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-    uint32_t free_space_pointer = GetFreeSpacePointer();
-    ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-    memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-            tuple_offset - free_space_pointer);
-    SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-    new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-    SetTupleSize(slot_num, serialized_size);
-
-    // Update all tuple offsets.
-    for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-        uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-        if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-            SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
-        }
+    uint32_t __attribute__((unused)) read_bytes =
+        old_row->DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+    ASSERT(read_bytes <= tuple_size, "Unexpected behavior in tuple deserialize.");
+    ResizeTuple(slot_num, allocated_size);
+    new_row.SerializeTo(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+    return kUpdateSuccess;
+}
+
+void TablePage::TrimTuple(const RowId &rid, Schema *schema) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (IsColumnar() || slot_num >= GetTupleCount() || IsDeleted(GetTupleSize(slot_num))) {
+    return;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  Row row(rid);
+  uint32_t row_size = row.DeserializeFrom(GetData() + tuple_offset, schema);
+  if (row_size < tuple_size) {
+    // the row goes to the end of its space, which is kept when the space shrinks
+    memmove(GetData() + tuple_offset + tuple_size - row_size, GetData() + tuple_offset, row_size);
+    ResizeTuple(slot_num, row_size);
+  }
+}
+
+void TablePage::ResizeTuple(uint32_t slot_num, uint32_t new_size) {
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
+  // The tuples stored in front of this one move by the difference, the slot itself included.
+  memmove(GetData() + free_space_pointer + tuple_size - new_size, GetData() + free_space_pointer,
+          tuple_offset - free_space_pointer);
+  SetFreeSpacePointer(free_space_pointer + tuple_size - new_size);
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
+    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_size);
     }
-    return 0;
+  }
+  SetTupleSize(slot_num, new_size);
 }
 
 void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  if (IsColumnar()) {
+    // The values stay in the minipages until the slot is taken again.
+    SetTupleSize(slot_num, 0);
+    return;
+  }
 
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t tuple_size = GetTupleSize(slot_num);
@@ -151,6 +398,12 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   if (slot_num >= GetTupleCount()) {
     return false;
   }
+  // Read uncommitted and snapshot reads go without locks, otherwise take a shared lock if we do not hold one already.
+  if (txn != nullptr && lock_manager != nullptr && txn->GetIsolationLevel() != IsolationLevel::kReadUncommitted &&
+      !txn->IsSnapshotRead() && !txn->IsSharedLocked(row->GetRowId()) && !txn->IsExclusiveLocked(row->GetRowId()) &&
+      !lock_manager->LockShared(txn, row->GetRowId())) {
+    return false;
+  }
   // Otherwise get the current tuple size too.
   uint32_t tuple_size = GetTupleSize(slot_num);
   // If the tuple is deleted, abort the transaction.
@@ -158,16 +411,38 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
     return false;
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
+  if (IsColumnar()) {
+    ReadColumnarTuple(slot_num, row, schema);
+    return true;
+  }
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
-  ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  // an updated tuple may keep more space than it uses until its transaction ends
+  ASSERT(read_bytes <= tuple_size, "Unexpected behavior in tuple deserialize.");
+  return true;
+}
+
+bool TablePage::GetDeletedTuple(Row *row, Schema *schema) {
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (tuple_size == 0 || !IsDeleted(tuple_size)) {
+    return false;
+  }
+  if (IsColumnar()) {
+    ReadColumnarTuple(slot_num, row, schema);
+    return true;
+  }
+  row->DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
   return true;
 }
 
-bool TablePage::GetFirstTupleRid(RowId *first_rid) {
+bool TablePage::GetFirstTupleRid(RowId *first_rid, bool include_deleted) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (include_deleted ? GetTupleSize(i) != 0 : !IsDeleted(GetTupleSize(i))) {
       first_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -176,11 +451,11 @@ bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   return false;
 }
 
-bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid, bool include_deleted) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (include_deleted ? GetTupleSize(i) != 0 : !IsDeleted(GetTupleSize(i))) {
       next_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -1170,13 +1170,29 @@ YY_RULE_SETUP
 #line 208 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
+  /* keywords of prepared statements and explain, recognized here to keep them usable as identifiers elsewhere */
+  if (strcmp(yytext, "prepare") == 0) {
+    return PREPARE;
+  }
+  if (strcmp(yytext, "execute") == 0) {
+    return EXECUTE;
+  }
+  if (strcmp(yytext, "deallocate") == 0) {
+    return DEALLOCATE;
+  }
+  if (strcmp(yytext, "explain") == 0) {
+    return EXPLAIN;
+  }
+  if (strcmp(yytext, "analyze") == 0) {
+    return ANALYZE;
+  }
   yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
   return IDENTIFIER;
 }
 	YY_BREAK
 case 40:
 YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 224 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1185,7 +1201,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 41:
 YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 230 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1194,7 +1210,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 42:
 YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 236 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return EQ;
@@ -1202,7 +1218,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 43:
 YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 241 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return NE;
@@ -1210,7 +1226,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 44:
 YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 246 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return LE;
@@ -1218,7 +1234,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 45:
 YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 251 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return GE;
@@ -1226,7 +1242,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 46:
 YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 256 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (',');
@@ -1234,7 +1250,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 47:
 YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 261 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('*');
@@ -1242,7 +1258,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 48:
 YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 266 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (';');
@@ -1250,7 +1266,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 49:
 YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 271 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('\'');
@@ -1258,7 +1274,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 50:
 YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 276 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('<');
@@ -1266,7 +1282,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 51:
 YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 281 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('>');
@@ -1274,7 +1290,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 52:
 YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 286 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return ('(');
@@ -1282,7 +1298,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 53:
 YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 291 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
   return (')');
@@ -1291,15 +1307,20 @@ YY_RULE_SETUP
 case 54:
 /* rule 54 can match eol */
 YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 296 "minisql.l"
 {
   MinisqlParserMovePos(yylineno, yytext);
 }
 	YY_BREAK
 case 55:
 YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 300 "minisql.l"
 {
+  if (yytext[0] == '?') {
+    MinisqlParserMovePos(yylineno, yytext);
+    yylval.syntax_node = MinisqlParserCreateParameter();
+    return PARAM;
+  }
   char str[128] = {0};
   sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
   MinisqlParserSetError(str);
@@ -1307,7 +1328,7 @@ YY_RULE_SETUP
 	YY_BREAK
 case 56:
 YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 311 "minisql.l"
 ECHO;
 	YY_BREAK
 #line 1314 "../../parser/minisql_lex.c"
@@ -2319,7 +2340,7 @@ void yyfree (void * ptr )
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 311 "minisql.l"
 
 
 int yywrap() {
@@ -0,0 +1,42 @@
+#include "parser/parsed_statement.h"
+
+#include <mutex>
+
+#include "glog/logging.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+static std::mutex parser_latch;
+
+std::unique_ptr<ParsedStatement> ParsedStatement::Parse(const std::string &sql) {
+  auto start_time = std::chrono::steady_clock::now();
+  std::unique_ptr<ParsedStatement> statement(new ParsedStatement());
+  statement->sql_ = sql;
+  std::lock_guard<std::mutex> guard(parser_latch);
+  YY_BUFFER_STATE bp = yy_scan_string(sql.c_str());
+  if (bp == nullptr) {
+    LOG(ERROR) << "Failed to create yy buffer state." << std::endl;
+    statement->has_error_ = true;
+    statement->error_message_ = "Failed to create yy buffer state.";
+    return statement;
+  }
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  if (MinisqlParserGetError()) {
+    statement->has_error_ = true;
+    char *message = MinisqlParserGetErrorMessage();
+    statement->error_message_ = message == nullptr ? "" : message;
+  } else {
+    statement->root_ = MinisqlGetParserRootNode();
+  }
+  statement->nodes_ = DetachSyntaxTree();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  statement->parse_time_ = std::chrono::steady_clock::now() - start_time;
+  return statement;
+}
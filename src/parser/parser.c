@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 #include "parser/parser.h"
 #include "parser/syntax_tree.h"
 
@@ -9,6 +10,9 @@ int minisql_parser_column_no_ = 0;
 int minisql_parser_error_ = 0;
 char *minisql_parser_error_message_ = NULL;
 int minisql_parser_debug_node_count_ = 0;
+int minisql_parser_param_count_ = 0;
+/* the lexer passes its messages in a buffer on the stack */
+static char minisql_parser_error_buffer_[256];
 
 void MinisqlParserMovePos(int line, char *text) {
   size_t i = 0;
@@ -43,7 +47,8 @@ void MinisqlParserSetError(char *msg) {
   }
   printf("Minisql parse error at line %d, col %d, message: %s\n", minisql_parser_line_no_, minisql_parser_column_no_,
          msg);
-  minisql_parser_error_message_ = msg;
+  strncpy(minisql_parser_error_buffer_, msg, sizeof(minisql_parser_error_buffer_) - 1);
+  minisql_parser_error_message_ = minisql_parser_error_buffer_;
 }
 
 pSyntaxNode MinisqlGetParserRootNode() {
@@ -57,6 +62,7 @@ void MinisqlParserInit() {
   minisql_parser_error_ = 0;
   minisql_parser_error_message_ = NULL;
   minisql_parser_debug_node_count_ = 0;
+  minisql_parser_param_count_ = 0;
 }
 
 void MinisqlParserFinish() {
@@ -69,4 +75,10 @@ int MinisqlParserGetError() {
 
 char *MinisqlParserGetErrorMessage() {
   return minisql_parser_error_message_;
-}
\ No newline at end of file
+}
+
+pSyntaxNode MinisqlParserCreateParameter() {
+  char val[16];
+  sprintf(val, "%d", minisql_parser_param_count_++);
+  return CreateSyntaxNode(kNodeParameter, val);
+}
@@ -26,7 +26,6 @@ pSyntaxNode CreateSyntaxNode(SyntaxNodeType type, char *val) {
       size_t len = strlen(val) + 1;
       node->val_ = (char *) malloc(len);
       strcpy(node->val_, val);
-      node->val_[len] = '\0';
     }
   } else {
     node->val_ = NULL;
@@ -61,13 +60,24 @@ void FreeSyntaxNode(pSyntaxNode node) {
 }
 
 void DestroySyntaxTree() {
-  pSyntaxNodeList p = minisql_parser_syntax_node_list_;
+  DestroySyntaxNodeList(minisql_parser_syntax_node_list_);
+  minisql_parser_syntax_node_list_ = NULL;
+}
+
+pSyntaxNodeList DetachSyntaxTree() {
+  pSyntaxNodeList list = minisql_parser_syntax_node_list_;
+  minisql_parser_syntax_node_list_ = NULL;
+  return list;
+}
+
+void DestroySyntaxNodeList(pSyntaxNodeList list) {
+  pSyntaxNodeList p = list;
   while (p != NULL) {
     pSyntaxNodeList next = p->next_;
     FreeSyntaxNode(p->node_);
+    free(p);
     p = next;
   }
-  minisql_parser_syntax_node_list_ = NULL;
 }
 
 void SyntaxNodeAddChildren(pSyntaxNode parent, pSyntaxNode child) {
@@ -169,6 +179,22 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeParameter:
+      return "kNodeParameter";
+    case kNodePrepare:
+      return "kNodePrepare";
+    case kNodeExecute:
+      return "kNodeExecute";
+    case kNodeDeallocate:
+      return "kNodeDeallocate";
+    case kNodeSet:
+      return "kNodeSet";
+    case kNodeExplain:
+      return "kNodeExplain";
+    case kNodeShowStatus:
+      return "kNodeShowStatus";
+    case kNodeTableOption:
+      return "kNodeTableOption";
     default:
       return "error type";
   }
@@ -10,30 +10,41 @@ void Planner::PlanQuery(pSyntaxNode ast) {
       auto statement = make_shared<SelectStatement>(ast, context_);
       statement->SyntaxTree2Statement(ast->child_);
       plan_ = PlanSelect(statement);
+      CollectParameters(statement.get());
       return;
     }
     case kNodeInsert: {
       auto statement = make_shared<InsertStatement>(ast, context_);
       statement->SyntaxTree2Statement(ast->child_);
       plan_ = PlanInsert(statement);
+      CollectParameters(statement.get());
       return;
     }
     case kNodeDelete: {
       auto statement = make_shared<DeleteStatement>(ast, context_);
       statement->SyntaxTree2Statement(ast->child_);
       plan_ = PlanDelete(statement);
+      CollectParameters(statement.get());
       return;
     }
     case kNodeUpdate: {
       auto statement = make_shared<UpdateStatement>(ast, context_);
       statement->SyntaxTree2Statement(ast->child_);
       plan_ = PlanUpdate(statement);
+      CollectParameters(statement.get());
       return;
     }
     default:
       throw std::logic_error("the statement is not supported in planner yet");
   }
 }
+void Planner::CollectParameters(AbstractStatement *statement) {
+  params_ = statement->params_;
+  std::sort(params_.begin(), params_.end(), [](const auto &a, const auto &b) {
+    return a->GetParamIdx() < b->GetParamIdx();
+  });
+}
+
 AbstractPlanNodeRef Planner::PlanSelect(std::shared_ptr<SelectStatement> statement) {
   auto out_schema = MakeOutputSchema(statement->column_list_);
   vector<IndexInfo *> indexes;
@@ -101,12 +101,9 @@ uint32_t Column::DeserializeFrom(char *buf, Column *&column) {
   buf += sizeof(uint32_t);
   offset += sizeof(uint32_t);
 
-  char* p = new char[length];
-  memcpy(p,buf,sizeof(char)*length);
-  std::string name = p;
+  std::string name(buf,length);
   buf += sizeof(char)*length;
   offset += sizeof(char)*length;
-  delete[] p;
 
   TypeId type;
   memcpy(&type,buf,sizeof(TypeId));
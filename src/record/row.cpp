@@ -32,8 +32,8 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   buf += sizeof(uint32_t);
   offset += sizeof(uint32_t);
   for(int i=0;i<size;i++){
-    Field* temp = new Field;
-    uint32_t length = fields_[i]->DeserializeFrom(buf,schema->GetColumns()[i]->GetType(),&temp,false);
+    Field* temp = nullptr;
+    uint32_t length = Field::DeserializeFrom(buf,schema->GetColumns()[i]->GetType(),&temp,false);
     fields_.push_back(temp);
     buf += length;
     offset += length;
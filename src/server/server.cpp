@@ -0,0 +1,256 @@
+#include "server/server.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include "glog/logging.h"
+#include "parser/parsed_statement.h"
+
+/** milliseconds the poller waits before checking for a shutdown */
+static constexpr int POLL_TIMEOUT = 100;
+static constexpr size_t READ_BUFFER_SIZE = 4096;
+
+static bool SetNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * Cut the first complete statement off buffer.
+ * @return false if buffer holds no ';' outside of a quoted string
+ */
+static bool NextStatement(std::string &buffer, std::string *statement) {
+  char quote = 0;
+  for (size_t i = 0; i < buffer.size(); i++) {
+    char ch = buffer[i];
+    if (quote != 0) {
+      if (ch == quote) quote = 0;
+    } else if (ch == '\'' || ch == '"') {
+      quote = ch;
+    } else if (ch == ';') {
+      *statement = buffer.substr(0, i + 1);
+      buffer.erase(0, i + 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+Server::Server(ExecuteEngine *engine, size_t num_workers) : engine_(engine), num_workers_(num_workers) {
+  // A statement waiting for a row lock keeps its worker, so there are more workers than cores.
+  if (num_workers_ == 0) {
+    num_workers_ = std::max<size_t>(8, 2 * std::thread::hardware_concurrency());
+  }
+  epoll_fd_ = epoll_create1(0);
+  if (epoll_fd_ < 0) {
+    LOG(ERROR) << "epoll_create1 failed: " << strerror(errno);
+  }
+}
+
+Server::~Server() {
+  for (int fd : listen_fds_) {
+    close(fd);
+  }
+  if (!unix_path_.empty()) {
+    unlink(unix_path_.c_str());
+  }
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+}
+
+dberr_t Server::ListenTcp(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return DB_FAILED;
+  }
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(port);
+  socklen_t len = sizeof(addr);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+      getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len) != 0 || !SetNonBlocking(fd)) {
+    LOG(ERROR) << "Failed to listen on port " << port << ": " << strerror(errno);
+    close(fd);
+    return DB_FAILED;
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  listen_fds_.push_back(fd);
+  port_ = ntohs(addr.sin_port);
+  return DB_SUCCESS;
+}
+
+dberr_t Server::ListenUnix(const std::string &path) {
+  sockaddr_un addr{};
+  if (path.size() >= sizeof(addr.sun_path)) {
+    return DB_FAILED;
+  }
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return DB_FAILED;
+  }
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  unlink(path.c_str());
+  if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+      !SetNonBlocking(fd)) {
+    LOG(ERROR) << "Failed to listen on " << path << ": " << strerror(errno);
+    close(fd);
+    return DB_FAILED;
+  }
+  epoll_event event{};
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  listen_fds_.push_back(fd);
+  unix_path_ = path;
+  return DB_SUCCESS;
+}
+
+void Server::Run() {
+  {
+    ThreadPool workers(num_workers_);
+    std::vector<epoll_event> events(64);
+    while (!stop_) {
+      int n = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), POLL_TIMEOUT);
+      for (int i = 0; i < n; i++) {
+        int fd = events[i].data.fd;
+        if (std::find(listen_fds_.begin(), listen_fds_.end(), fd) != listen_fds_.end()) {
+          Accept(fd);
+          continue;
+        }
+        Connection *conn;
+        {
+          std::lock_guard<std::mutex> guard(latch_);
+          auto it = connections_.find(fd);
+          if (it == connections_.end()) continue;
+          conn = it->second.get();
+        }
+        // The connection is armed for one event, nobody else serves it until the worker re-arms it.
+        workers.Submit([this, conn] { Serve(conn); });
+      }
+    }
+    // Leaving the scope waits for the statements being run.
+  }
+  std::lock_guard<std::mutex> guard(latch_);
+  for (auto &entry : connections_) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, entry.first, nullptr);
+    close(entry.first);
+    engine_->CloseSession(&entry.second->session_);
+  }
+  connections_.clear();
+}
+
+void Server::Accept(int listen_fd) {
+  while (true) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    SetNonBlocking(fd);
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      connections_[fd] = std::make_unique<Connection>(fd);
+    }
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+  }
+}
+
+void Server::Serve(Connection *conn) {
+  char buf[READ_BUFFER_SIZE];
+  // A client which shut down its side still reads the responses to the statements it sent before.
+  bool hung_up = false;
+  bool closed = false;
+  while (true) {
+    ssize_t n = recv(conn->fd_, buf, sizeof(buf), 0);
+    if (n > 0) {
+      conn->buffer_.append(buf, n);
+      continue;
+    }
+    if (n == 0) {
+      hung_up = true;
+    } else if (errno == EINTR) {
+      continue;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      closed = true;
+    }
+    break;
+  }
+  std::string sql;
+  while (!closed && NextStatement(conn->buffer_, &sql)) {
+    std::ostringstream out;
+    conn->session_.SetOut(out);
+    auto statement = ParsedStatement::Parse(sql);
+    dberr_t result = DB_FAILED;
+    if (statement->HasError()) {
+      out << statement->GetErrorMessage() << std::endl;
+    } else {
+      result = engine_->Execute(*statement, &conn->session_);
+      engine_->ExecuteInformation(result, &conn->session_);
+    }
+    out << '\0';
+    if (!SendAll(conn->fd_, out.str()) || result == DB_QUIT) {
+      closed = true;
+    }
+  }
+  if (closed || hung_up) {
+    Close(conn);
+    return;
+  }
+  epoll_event event{};
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.fd = conn->fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn->fd_, &event);
+}
+
+void Server::Close(Connection *conn) {
+  int fd = conn->fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  // The open transaction of a client which went away is rolled back.
+  engine_->CloseSession(&conn->session_);
+  std::lock_guard<std::mutex> guard(latch_);
+  close(fd);
+  connections_.erase(fd);
+}
+
+bool Server::SendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += n;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      pollfd pfd{fd, POLLOUT, 0};
+      poll(&pfd, 1, POLL_TIMEOUT);
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,210 @@
+#include "storage/compressed_page_store.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+#include "glog/logging.h"
+#include "storage/page_codec.h"
+
+CompressedPageStore::CompressedPageStore(const std::string &pack_file, const std::string &map_file) {
+  pack_fd_ = open(pack_file.c_str(), O_RDWR | O_CREAT, 0644);
+  map_fd_ = open(map_file.c_str(), O_RDWR | O_CREAT, 0644);
+  if (pack_fd_ < 0 || map_fd_ < 0) {
+    if (pack_fd_ >= 0) {
+      close(pack_fd_);
+    }
+    if (map_fd_ >= 0) {
+      close(map_fd_);
+    }
+    throw std::runtime_error("failed to open " + pack_file + " or " + map_file);
+  }
+  struct stat stat_buf;
+  if (fstat(map_fd_, &stat_buf) == 0 && stat_buf.st_size > 0) {
+    entries_.resize(stat_buf.st_size / sizeof(PageMapEntry));
+    if (pread(map_fd_, entries_.data(), entries_.size() * sizeof(PageMapEntry), 0) < 0) {
+      LOG(ERROR) << "failed to read " << map_file;
+      entries_.clear();
+    }
+  }
+  // the gaps between the slots in use are free
+  std::vector<std::pair<uint64_t, uint32_t>> slots;
+  for (const auto &entry : entries_) {
+    if (entry.slot_size_ != 0) {
+      slots.emplace_back(entry.offset_, entry.slot_size_);
+      stored_bytes_ += entry.slot_size_;
+    }
+  }
+  std::sort(slots.begin(), slots.end());
+  for (const auto &slot : slots) {
+    if (pack_end_ < slot.first) {
+      FreeSlot(pack_end_, slot.first - pack_end_);
+    }
+    pack_end_ = std::max(pack_end_, slot.first + slot.second);
+  }
+}
+
+CompressedPageStore::~CompressedPageStore() {
+  close(pack_fd_);
+  close(map_fd_);
+}
+
+bool CompressedPageStore::ReadPage(page_id_t page_id, char *page_data, size_t &bytes_read) {
+  bytes_read = 0;
+  if (static_cast<size_t>(page_id) >= entries_.size() || entries_[page_id].slot_size_ == 0) {
+    memset(page_data, 0, PAGE_SIZE);
+    return true;
+  }
+  const auto &entry = entries_[page_id];
+  if (entry.data_size_ == PAGE_SIZE) {
+    ssize_t read_count = pread(pack_fd_, page_data, PAGE_SIZE, entry.offset_);
+    bytes_read = std::max<ssize_t>(read_count, 0);
+    if (read_count < PAGE_SIZE) {
+      LOG(ERROR) << "page " << page_id << " is cut short in the pack file";
+      return false;
+    }
+    return true;
+  }
+  // the last slot of the pack file may end past the end of the file, the length says how much of it is data
+  char slot[PAGE_SIZE];
+  ssize_t read_count = pread(pack_fd_, slot, entry.slot_size_, entry.offset_);
+  bytes_read = std::max<ssize_t>(read_count, 0);
+  DataLength data_size = 0;
+  if (read_count >= static_cast<ssize_t>(sizeof(DataLength))) {
+    memcpy(&data_size, slot, sizeof(DataLength));
+  }
+  auto &counters = GetCounters();
+  auto start_time = std::chrono::steady_clock::now();
+  bool decompressed = data_size > 0 && data_size <= bytes_read - sizeof(DataLength) &&
+                      PageCodec::Decompress(slot + sizeof(DataLength), data_size, page_data, PAGE_SIZE);
+  counters.decompress_ns_.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count(),
+      std::memory_order_relaxed);
+  counters.pages_decompressed_.fetch_add(1, std::memory_order_relaxed);
+  if (!decompressed) {
+    LOG(ERROR) << "page " << page_id << " does not decompress";
+    return false;
+  }
+  return true;
+}
+
+size_t CompressedPageStore::WritePage(page_id_t page_id, const char *page_data) {
+  auto &counters = GetCounters();
+  auto start_time = std::chrono::steady_clock::now();
+  // the data is compressed if that saves a unit at least
+  char compressed[PAGE_SIZE];
+  DataLength data_size = PageCodec::Compress(page_data, PAGE_SIZE, compressed + sizeof(DataLength),
+                                             PAGE_SIZE - SLOT_UNIT - sizeof(DataLength));
+  counters.compress_ns_.fetch_add(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count(),
+      std::memory_order_relaxed);
+  counters.pages_compressed_.fetch_add(1, std::memory_order_relaxed);
+  const char *data = compressed;
+  uint32_t write_size = data_size + sizeof(DataLength);
+  if (data_size == 0) {
+    data_size = PAGE_SIZE;
+    data = page_data;
+    write_size = PAGE_SIZE;
+  } else {
+    memcpy(compressed, &data_size, sizeof(DataLength));
+  }
+  counters.bytes_in_.fetch_add(PAGE_SIZE, std::memory_order_relaxed);
+  counters.bytes_out_.fetch_add(write_size, std::memory_order_relaxed);
+  uint32_t slot_size = (write_size + SLOT_UNIT - 1) / SLOT_UNIT * SLOT_UNIT;
+
+  if (static_cast<size_t>(page_id) >= entries_.size()) {
+    entries_.resize(page_id + 1, PageMapEntry{0, 0, 0});
+  }
+  auto &entry = entries_[page_id];
+  if (entry.slot_size_ < slot_size || (entry.data_size_ == PAGE_SIZE) != (data_size == PAGE_SIZE)) {
+    // the page moves, its former slot is free once the entry points to the new one
+    uint64_t former_offset = entry.offset_;
+    uint32_t former_size = entry.slot_size_;
+    uint64_t offset = AllocateSlot(slot_size);
+    if (pwrite(pack_fd_, data, write_size, offset) != static_cast<ssize_t>(write_size)) {
+      LOG(ERROR) << "I/O error while writing page " << page_id << " to the pack file";
+    }
+    entry = PageMapEntry{offset, slot_size, data_size};
+    WriteEntry(page_id);
+    stored_bytes_ += slot_size;
+    if (former_size != 0) {
+      FreeSlot(former_offset, former_size);
+      stored_bytes_ -= former_size;
+    }
+    return write_size;
+  }
+  // the length is in the slot, the map entry stays valid whatever part of the slot is written before a crash
+  if (pwrite(pack_fd_, data, write_size, entry.offset_) != static_cast<ssize_t>(write_size)) {
+    LOG(ERROR) << "I/O error while writing page " << page_id << " to the pack file";
+  }
+  return write_size;
+}
+
+void CompressedPageStore::FreePage(page_id_t page_id) {
+  if (static_cast<size_t>(page_id) >= entries_.size() || entries_[page_id].slot_size_ == 0) {
+    return;
+  }
+  auto &entry = entries_[page_id];
+  uint64_t offset = entry.offset_;
+  uint32_t size = entry.slot_size_;
+  entry = PageMapEntry{0, 0, 0};
+  WriteEntry(page_id);
+  FreeSlot(offset, size);
+  stored_bytes_ -= size;
+}
+
+CompressionCounters &CompressedPageStore::GetCounters() {
+  static CompressionCounters counters;
+  return counters;
+}
+
+uint64_t CompressedPageStore::AllocateSlot(uint32_t size) {
+  // the smallest free slot the data fits in, the rest of it stays free
+  auto iter = free_slots_by_size_.lower_bound({size, 0});
+  if (iter != free_slots_by_size_.end()) {
+    uint64_t slot_size = iter->first;
+    uint64_t offset = iter->second;
+    free_slots_by_size_.erase(iter);
+    free_slots_.erase(offset);
+    if (slot_size > size) {
+      FreeSlot(offset + size, slot_size - size);
+    }
+    return offset;
+  }
+  uint64_t offset = pack_end_;
+  pack_end_ += size;
+  return offset;
+}
+
+void CompressedPageStore::FreeSlot(uint64_t offset, uint64_t size) {
+  auto next = free_slots_.lower_bound(offset);
+  if (next != free_slots_.end() && next->first == offset + size) {
+    size += next->second;
+    free_slots_by_size_.erase({next->second, next->first});
+    next = free_slots_.erase(next);
+  }
+  if (next != free_slots_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == offset) {
+      offset = prev->first;
+      size += prev->second;
+      free_slots_by_size_.erase({prev->second, prev->first});
+      free_slots_.erase(prev);
+    }
+  }
+  free_slots_.emplace(offset, size);
+  free_slots_by_size_.emplace(size, offset);
+}
+
+void CompressedPageStore::WriteEntry(page_id_t page_id) {
+  if (pwrite(map_fd_, &entries_[page_id], sizeof(PageMapEntry), static_cast<off_t>(page_id) * sizeof(PageMapEntry)) !=
+      sizeof(PageMapEntry)) {
+    LOG(ERROR) << "I/O error while writing the map entry of page " << page_id;
+  }
+}
@@ -1,166 +1,430 @@
 #include "storage/disk_manager.h"
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <stdexcept>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file, bool compressed) : file_name_(db_file) {
     std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-    db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
     // directory or file does not exist
-    if (!db_io_.is_open()) {
-        db_io_.clear();
-        // create a new file
-        std::filesystem::path p = db_file;
-        if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
-        db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
-        db_io_.close();
-        // reopen with original mode
-        db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-        if (!db_io_.is_open()) {
-            throw std::exception();
+    std::filesystem::path p = db_file;
+    if(p.has_parent_path()) std::filesystem::create_directories(p.parent_path());
+    int fd = GetSegmentFd(0);
+    if (fd < 0) {
+        throw std::exception();
+    }
+    struct stat stat_buf;
+    bool is_new = fstat(fd, &stat_buf) == 0 && stat_buf.st_size == 0;
+    uint32_t page_size = is_new ? PAGE_SIZE : ReadFilePageSize(fd);
+    if (page_size != PAGE_SIZE) {
+        close(fd);
+        segment_fds_.clear();
+        closed = true;
+        throw std::runtime_error(db_file + " has pages of " + std::to_string(page_size) +
+                                 " bytes, this build reads pages of " + std::to_string(PAGE_SIZE) + " bytes");
+    }
+    ReadPhysicalPage(0, META_PAGE_ID, meta_data_);
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+    if (is_new) {
+        // a new database is split into segments
+        meta_page->extent_used_page_[META_PAGE_EXTENTS] = compressed ? META_FLAG_COMPRESSED : 0;
+        meta_page->extent_used_page_[META_PAGE_EXTENTS + 1] = PAGE_SIZE;
+        meta_page->extent_used_page_[META_PAGE_EXTENTS + 2] = SEGMENTED_FILE_MAGIC;
+    }
+    segmented_ = meta_page->IsSegmented();
+    if (meta_page->GetFlags() & META_FLAG_COMPRESSED) {
+        try {
+            page_store_ = std::make_unique<CompressedPageStore>(GetHiddenFileName(db_file, "pack"),
+                                                                GetHiddenFileName(db_file, "map"));
+        } catch (const std::exception &) {
+            close(fd);
+            segment_fds_.clear();
+            closed = true;
+            throw;
+        }
+    }
+    max_extents_ = segmented_ ? MAX_EXTENTS : SINGLE_FILE_MAX_EXTENTS;
+    num_allocated_pages_ = meta_page->num_allocated_pages_;
+    extent_used_pages_.resize(meta_page->num_extents_);
+    uint32_t meta_page_extents = segmented_ ? META_PAGE_EXTENTS : SINGLE_FILE_MAX_EXTENTS;
+    std::copy(meta_page->extent_used_page_,
+              meta_page->extent_used_page_ + std::min(meta_page->num_extents_, meta_page_extents),
+              extent_used_pages_.begin());
+    // the counts of the other extents are in the meta directory
+    char directory_page[PAGE_SIZE];
+    for (uint32_t i = meta_page_extents; i < meta_page->num_extents_; i++) {
+        uint32_t index = i - meta_page_extents;
+        if (index % (PAGE_SIZE / sizeof(uint32_t)) == 0) {
+            ReadPhysicalPage(0, 1 + index / (PAGE_SIZE / sizeof(uint32_t)), directory_page);
         }
+        memcpy(&extent_used_pages_[i], directory_page + index % (PAGE_SIZE / sizeof(uint32_t)) * sizeof(uint32_t),
+               sizeof(uint32_t));
+    }
+    extent_bitmaps_.resize(max_extents_);
+    free_extents_.resize((max_extents_ + 63) / 64);
+    free_extent_words_.resize((free_extents_.size() + 63) / 64);
+    for (uint32_t i = 0; i < extent_used_pages_.size(); i++) {
+        UpdateFreeExtents(i);
     }
-    ReadPhysicalPage(META_PAGE_ID, meta_data_);
 }
 
 void DiskManager::Close() {
     std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
-    WritePhysicalPage(META_PAGE_ID, meta_data_);
     if (!closed) {
-        db_io_.close();
+        GetMetaData();
+        WritePhysicalPage(0, META_PAGE_ID, meta_data_);
+        if (segmented_ && extent_used_pages_.size() > META_PAGE_EXTENTS) {
+            const uint32_t counts_per_page = PAGE_SIZE / sizeof(uint32_t);
+            char directory_page[PAGE_SIZE];
+            for (uint32_t i = META_PAGE_EXTENTS; i < extent_used_pages_.size(); i += counts_per_page) {
+                uint32_t count = std::min<uint32_t>(counts_per_page, extent_used_pages_.size() - i);
+                memset(directory_page, 0, PAGE_SIZE);
+                memcpy(directory_page, &extent_used_pages_[i], count * sizeof(uint32_t));
+                WritePhysicalPage(0, 1 + (i - META_PAGE_EXTENTS) / counts_per_page, directory_page);
+            }
+        }
+        for (int fd : segment_fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        segment_fds_.clear();
+        page_store_.reset();
         closed = true;
     }
 }
 
-void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+char *DiskManager::GetMetaData() {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+    meta_page->num_allocated_pages_ = num_allocated_pages_;
+    meta_page->num_extents_ = extent_used_pages_.size();
+    uint32_t meta_page_extents = segmented_ ? META_PAGE_EXTENTS : SINGLE_FILE_MAX_EXTENTS;
+    std::copy(extent_used_pages_.begin(),
+              extent_used_pages_.begin() + std::min<size_t>(extent_used_pages_.size(), meta_page_extents),
+              meta_page->extent_used_page_);
+    return meta_data_;
+}
+
+uint32_t DiskManager::GetSegmentCount() {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    if (!segmented_ || extent_used_pages_.empty()) {
+        return 1;
+    }
+    return (extent_used_pages_.size() - 1) / EXTENTS_PER_SEGMENT + 1;
+}
+
+bool DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
     ASSERT(logical_page_id >= 0, "Invalid page id.");
-    ReadPhysicalPage(MapPageId(logical_page_id), page_data);
+    if (page_store_ != nullptr) {
+        auto &counters = GetIoCounters();
+        auto start_time = std::chrono::steady_clock::now();
+        size_t bytes_read;
+        bool read = page_store_->ReadPage(logical_page_id, page_data, bytes_read);
+        counters.bytes_read_.fetch_add(bytes_read, std::memory_order_relaxed);
+        counters.reads_.fetch_add(1, std::memory_order_relaxed);
+        counters.read_latency_.Record(std::chrono::steady_clock::now() - start_time);
+        return read;
+    }
+    uint32_t segment;
+    page_id_t physical_page_id = MapPageId(logical_page_id, &segment);
+    ReadPhysicalPage(segment, physical_page_id, page_data);
+    return true;
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
     ASSERT(logical_page_id >= 0, "Invalid page id.");
-    WritePhysicalPage(MapPageId(logical_page_id), page_data);
+    if (page_store_ != nullptr) {
+        auto &counters = GetIoCounters();
+        auto start_time = std::chrono::steady_clock::now();
+        counters.bytes_written_.fetch_add(page_store_->WritePage(logical_page_id, page_data),
+                                          std::memory_order_relaxed);
+        counters.writes_.fetch_add(1, std::memory_order_relaxed);
+        counters.write_latency_.Record(std::chrono::steady_clock::now() - start_time);
+        return;
+    }
+    uint32_t segment;
+    page_id_t physical_page_id = MapPageId(logical_page_id, &segment);
+    WritePhysicalPage(segment, physical_page_id, page_data);
 }
 
 /**
  * TODO: Student Implement
  */
 page_id_t DiskManager::AllocatePage() {
-    //ASSERT(false, "Not implemented yet.");
-    auto *page0=reinterpret_cast<DiskFileMetaPage*> (meta_data_);
-    uint32_t extend_num=page0->num_extents_;
-    uint32_t i;
-    for(i=0;page0->extent_used_page_[i]==DiskManager::BITMAP_SIZE&&i<extend_num;i++){
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    uint32_t extent_id = max_extents_;
+    for (uint32_t i = 0; i < free_extent_words_.size(); i++) {
+        if (free_extent_words_[i] != 0) {
+            uint32_t word = i * 64 + __builtin_ctzll(free_extent_words_[i]);
+            extent_id = word * 64 + __builtin_ctzll(free_extents_[word]);
+            break;
+        }
+    }
+    if (extent_id == max_extents_ && (extent_id = AddExtent()) == max_extents_) {
+        return INVALID_PAGE_ID;
+    }
+    // the first free slot of the bitmap, pages freed before are reused
+    uint32_t offset = GetExtentBitmap(extent_id)->NextFreePage(0);
+    if (offset == DiskManager::BITMAP_SIZE) {
+        LOG(ERROR) << "extent " << extent_id << " is counted as having a free page but has none";
+        return INVALID_PAGE_ID;
+    }
+    return AllocatePageAt(extent_id, offset);
+}
 
+page_id_t DiskManager::AllocatePageNear(page_id_t last_page_id) {
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    uint32_t num_extents = extent_used_pages_.size();
+    uint32_t start_extent = 0;
+    uint32_t start_offset = 0;
+    if (last_page_id != INVALID_PAGE_ID && last_page_id / DiskManager::BITMAP_SIZE < num_extents) {
+        start_extent = last_page_id / DiskManager::BITMAP_SIZE;
+        start_offset = last_page_id % DiskManager::BITMAP_SIZE + 1;
+        // the rest of the run of the last page
+        uint32_t offset = GetExtentBitmap(start_extent)->NextFreePage(start_offset);
+        if (offset < DiskManager::BITMAP_SIZE && offset / RUN_SIZE == (start_offset - 1) / RUN_SIZE) {
+            return AllocatePageAt(start_extent, offset);
+        }
+    }
+    // A new run, looked for behind the last one first so the runs of an object follow each other.
+    for (uint32_t pass = 0; pass < 2; pass++) {
+        uint32_t end_extent = pass == 0 ? num_extents : std::min(start_extent + 1, num_extents);
+        for (uint32_t extent_id = pass == 0 ? start_extent : 0; extent_id < end_extent; extent_id++) {
+            if (extent_used_pages_[extent_id] + RUN_SIZE > DiskManager::BITMAP_SIZE) {
+                continue;
+            }
+            uint32_t from = pass == 0 && extent_id == start_extent ? start_offset : 0;
+            uint32_t offset = GetExtentBitmap(extent_id)->NextFreeRun(from);
+            if (offset < DiskManager::BITMAP_SIZE) {
+                PreallocateRun(extent_id * DiskManager::BITMAP_SIZE + offset);
+                return AllocatePageAt(extent_id, offset);
+            }
+        }
+        uint32_t extent_id;
+        if (pass == 0 && (extent_id = AddExtent()) != max_extents_) {
+            PreallocateRun(extent_id * DiskManager::BITMAP_SIZE);
+            return AllocatePageAt(extent_id, 0);
+        }
     }
-    char buff[PAGE_SIZE];
-    if(i==extend_num && i>=(PAGE_SIZE-8)/4){
+    // no run is free any more, the object takes any page
+    return AllocatePage();
+}
+
+page_id_t DiskManager::AllocatePageAt(uint32_t extent_id, uint32_t offset) {
+    auto *bitmap = GetExtentBitmap(extent_id);
+    if (!bitmap->AllocatePageAt(offset)) {
         return INVALID_PAGE_ID;
-    }else if(i==extend_num && i<(PAGE_SIZE-8)/4){
-        page0->num_extents_++;
-        page0->extent_used_page_[i]=1;
-        page0->num_allocated_pages_++;
-        memset(buff,0,PAGE_SIZE);
-        auto *mp=reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buff);
-        uint32_t t=0;
-        mp->AllocatePage(t);
-    } else{
-        page0->num_allocated_pages_++;
-        page0->extent_used_page_[i]++;
-        ReadPhysicalPage(1+(1+DiskManager::BITMAP_SIZE)*i,buff);
-        auto *mp=reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buff);
-        uint32_t j;
-        for(j=0;!mp->IsPageFree(j);j++){}
-        mp->AllocatePage(j);
-    }
-    WritePhysicalPage(1+(1+DiskManager::BITMAP_SIZE)*i,buff);
-    return page0->num_allocated_pages_-1;
+    }
+    num_allocated_pages_++;
+    extent_used_pages_[extent_id]++;
+    UpdateFreeExtents(extent_id);
+    uint32_t segment;
+    page_id_t bitmap_page_id = GetBitmapPageId(extent_id, &segment);
+    WritePhysicalPage(segment, bitmap_page_id, reinterpret_cast<char *>(bitmap));
+    return extent_id * DiskManager::BITMAP_SIZE + offset;
+}
+
+uint32_t DiskManager::AddExtent() {
+    if (extent_used_pages_.size() == max_extents_) {
+        return max_extents_;
+    }
+    // every extent is full, a new one is initialized behind them
+    uint32_t extent_id = extent_used_pages_.size();
+    extent_used_pages_.push_back(0);
+    extent_bitmaps_[extent_id].reset(new char[PAGE_SIZE]());
+    UpdateFreeExtents(extent_id);
+    return extent_id;
+}
+
+void DiskManager::PreallocateRun(page_id_t logical_page_id) {
+#ifdef __linux__
+    // Best effort, a file system without fallocate still gets the pages of the run in order. The data pages of
+    // a compressed database are not in the segments.
+    if (page_store_ != nullptr) {
+        return;
+    }
+    uint32_t segment;
+    off_t offset = static_cast<off_t>(MapPageId(logical_page_id, &segment)) * PAGE_SIZE;
+    int fd = GetSegmentFd(segment);
+    if (fd >= 0) {
+        fallocate(fd, 0, offset, static_cast<off_t>(RUN_SIZE) * PAGE_SIZE);
+    }
+#endif
 }
 
 /**
  * TODO: Student Implement
  */
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-    //ASSERT(false, "Not implemented yet.");
-    uint32_t t=logical_page_id/(DiskManager::BITMAP_SIZE);
-    char buff[PAGE_SIZE];
-    ReadPhysicalPage(1+(1+DiskManager::BITMAP_SIZE)*t,buff);
-    auto *mp=reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buff);
-    if(mp->IsPageFree(logical_page_id%DiskManager::BITMAP_SIZE)){
-        return ;
-    } else {
-        auto *page0=reinterpret_cast<DiskFileMetaPage*> (meta_data_);
-        page0->num_allocated_pages_--;
-        page0->extent_used_page_[t]--;
-        if(page0->extent_used_page_[t]==0){
-            page0->num_extents_--;
-        }
-        mp->DeAllocatePage(logical_page_id%DiskManager::BITMAP_SIZE);
-        WritePhysicalPage(1+(1+DiskManager::BITMAP_SIZE)*t,buff);
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    uint32_t extent_id = logical_page_id / DiskManager::BITMAP_SIZE;
+    if (extent_id >= extent_used_pages_.size()) {
+        return;
+    }
+    auto *bitmap = GetExtentBitmap(extent_id);
+    if (!bitmap->DeAllocatePage(logical_page_id % DiskManager::BITMAP_SIZE)) {
+        return;
+    }
+    num_allocated_pages_--;
+    if (page_store_ != nullptr) {
+        page_store_->FreePage(logical_page_id);
     }
+    // an empty extent is kept, the extents ever initialized are counted
+    extent_used_pages_[extent_id]--;
+    UpdateFreeExtents(extent_id);
+    uint32_t segment;
+    page_id_t bitmap_page_id = GetBitmapPageId(extent_id, &segment);
+    WritePhysicalPage(segment, bitmap_page_id, reinterpret_cast<char *>(bitmap));
 }
 
 /**
  * TODO: Student Implement
  */
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-    uint32_t t=logical_page_id/(DiskManager::BITMAP_SIZE);
-    char buff[PAGE_SIZE];
-    ReadPhysicalPage(1+(1+DiskManager::BITMAP_SIZE)*t,buff);
-    auto *mp=reinterpret_cast<BitmapPage<PAGE_SIZE>*>(buff);
-    return mp->IsPageFree(logical_page_id%DiskManager::BITMAP_SIZE);
+    std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+    uint32_t extent_id = logical_page_id / DiskManager::BITMAP_SIZE;
+    if (extent_id >= extent_used_pages_.size()) {
+        return true;
+    }
+    return GetExtentBitmap(extent_id)->IsPageFree(logical_page_id % DiskManager::BITMAP_SIZE);
+}
+
+BitmapPage<PAGE_SIZE> *DiskManager::GetExtentBitmap(uint32_t extent_id) {
+    auto &bitmap = extent_bitmaps_[extent_id];
+    if (bitmap == nullptr) {
+        bitmap.reset(new char[PAGE_SIZE]);
+        uint32_t segment;
+        page_id_t bitmap_page_id = GetBitmapPageId(extent_id, &segment);
+        ReadPhysicalPage(segment, bitmap_page_id, bitmap.get());
+    }
+    return reinterpret_cast<BitmapPage<PAGE_SIZE> *>(bitmap.get());
+}
+
+void DiskManager::UpdateFreeExtents(uint32_t extent_id) {
+    uint32_t word = extent_id / 64;
+    uint64_t bit = uint64_t{1} << (extent_id % 64);
+    if (extent_used_pages_[extent_id] < DiskManager::BITMAP_SIZE) {
+        free_extents_[word] |= bit;
+    } else {
+        free_extents_[word] &= ~bit;
+    }
+    if (free_extents_[word] != 0) {
+        free_extent_words_[word / 64] |= uint64_t{1} << (word % 64);
+    } else {
+        free_extent_words_[word / 64] &= ~(uint64_t{1} << (word % 64));
+    }
+}
+
+page_id_t DiskManager::GetBitmapPageId(uint32_t extent_id, uint32_t *segment) {
+    if (!segmented_) {
+        *segment = 0;
+        return 1 + (1 + DiskManager::BITMAP_SIZE) * extent_id;
+    }
+    *segment = extent_id / EXTENTS_PER_SEGMENT;
+    // the first segment starts with the meta page and the meta directory
+    page_id_t header_pages = *segment == 0 ? 1 + META_DIRECTORY_PAGES : 0;
+    return header_pages + (1 + DiskManager::BITMAP_SIZE) * (extent_id % EXTENTS_PER_SEGMENT);
 }
 
 /**
  * TODO: Student Implement
  */
-page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-    return logical_page_id+logical_page_id/DiskManager::BITMAP_SIZE+2;
+page_id_t DiskManager::MapPageId(page_id_t logical_page_id, uint32_t *segment) {
+    return GetBitmapPageId(logical_page_id / DiskManager::BITMAP_SIZE, segment) + 1 +
+           logical_page_id % DiskManager::BITMAP_SIZE;
 }
 
-int DiskManager::GetFileSize(const std::string &file_name) {
-    struct stat stat_buf;
-    int rc = stat(file_name.c_str(), &stat_buf);
-    return rc == 0 ? stat_buf.st_size : -1;
+DiskIoCounters &DiskManager::GetIoCounters() {
+    static DiskIoCounters counters;
+    return counters;
 }
 
-void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-    int offset = physical_page_id * PAGE_SIZE;
-    // check if read beyond file length
-    if (offset >= GetFileSize(file_name_)) {
+void DiskManager::RemoveFiles(const std::string &db_file) {
+    remove(db_file.c_str());
+    remove(GetHiddenFileName(db_file, "pack").c_str());
+    remove(GetHiddenFileName(db_file, "map").c_str());
+    // the segments of a database are numbered without gaps
+    for (uint32_t segment = 1; remove(GetSegmentFileName(db_file, segment).c_str()) == 0; segment++) {
+    }
+}
+
+std::string DiskManager::GetSegmentFileName(const std::string &db_file, uint32_t segment) {
+    if (segment == 0) {
+        return db_file;
+    }
+    return GetHiddenFileName(db_file, std::to_string(segment));
+}
+
+std::string DiskManager::GetHiddenFileName(const std::string &db_file, const std::string &suffix) {
+    std::filesystem::path path = db_file;
+    return (path.parent_path() / ("." + path.filename().string() + "." + suffix)).string();
+}
+
+uint32_t DiskManager::ReadFilePageSize(int fd) {
+    // the last 8 bytes of the meta page of a segmented database are its page size and the magic
+    for (uint32_t page_size = 4096; page_size <= 32768; page_size *= 2) {
+        uint32_t words[2];
+        if (pread(fd, words, sizeof(words), page_size - sizeof(words)) == sizeof(words) && words[0] == page_size &&
+            words[1] == SEGMENTED_FILE_MAGIC) {
+            return page_size;
+        }
+    }
+    return 4096;
+}
+
+int DiskManager::GetSegmentFd(uint32_t segment) {
+    if (segment >= segment_fds_.size()) {
+        segment_fds_.resize(segment + 1, -1);
+    }
+    int &fd = segment_fds_[segment];
+    if (fd < 0) {
+        fd = open(GetSegmentFileName(file_name_, segment).c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            LOG(ERROR) << "failed to open " << GetSegmentFileName(file_name_, segment);
+        }
+    }
+    return fd;
+}
+
+void DiskManager::ReadPhysicalPage(uint32_t segment, page_id_t physical_page_id, char *page_data) {
+    auto &counters = GetIoCounters();
+    auto start_time = std::chrono::steady_clock::now();
+    off_t offset = static_cast<off_t>(physical_page_id) * PAGE_SIZE;
+    ssize_t read_count = pread(GetSegmentFd(segment), page_data, PAGE_SIZE, offset);
+    // if file ends before reading PAGE_SIZE
+    if (read_count < PAGE_SIZE) {
 #ifdef ENABLE_BPM_DEBUG
         LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-        memset(page_data, 0, PAGE_SIZE);
-    } else {
-        // set read cursor to offset
-        db_io_.seekp(offset);
-        db_io_.read(page_data, PAGE_SIZE);
-        // if file ends before reading PAGE_SIZE
-        int read_count = db_io_.gcount();
-        if (read_count < PAGE_SIZE) {
-#ifdef ENABLE_BPM_DEBUG
-            LOG(INFO) << "Read less than a page" << std::endl;
-#endif
-            memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-        }
+        read_count = std::max<ssize_t>(read_count, 0);
+        memset(page_data + read_count, 0, PAGE_SIZE - read_count);
     }
+    // reads beyond the end of the file are not counted as bytes read
+    counters.bytes_read_.fetch_add(read_count, std::memory_order_relaxed);
+    counters.reads_.fetch_add(1, std::memory_order_relaxed);
+    counters.read_latency_.Record(std::chrono::steady_clock::now() - start_time);
 }
 
-void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-    size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
-    // set write cursor to offset
-    db_io_.seekp(offset);
-    db_io_.write(page_data, PAGE_SIZE);
+void DiskManager::WritePhysicalPage(uint32_t segment, page_id_t physical_page_id, const char *page_data) {
+    auto &counters = GetIoCounters();
+    auto start_time = std::chrono::steady_clock::now();
+    off_t offset = static_cast<off_t>(physical_page_id) * PAGE_SIZE;
     // check for I/O error
-    if (db_io_.bad()) {
+    if (pwrite(GetSegmentFd(segment), page_data, PAGE_SIZE, offset) != PAGE_SIZE) {
         LOG(ERROR) << "I/O error while writing";
         return;
     }
-    // needs to flush to keep disk file in sync
-    db_io_.flush();
-}
\ No newline at end of file
+    counters.writes_.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes_written_.fetch_add(PAGE_SIZE, std::memory_order_relaxed);
+    counters.write_latency_.Record(std::chrono::steady_clock::now() - start_time);
+}
@@ -0,0 +1,162 @@
+#include "storage/page_codec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+constexpr int HASH_BITS = 12;
+
+inline uint32_t Read32(const uint8_t *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - HASH_BITS); }
+
+/** Write the part of a length beyond its nibble, the caller made sure there is room */
+inline uint8_t *WriteLength(uint8_t *op, size_t length) {
+  for (; length >= 255; length -= 255) {
+    *op++ = 255;
+  }
+  *op++ = static_cast<uint8_t>(length);
+  return op;
+}
+
+/** Read the part of a length beyond its nibble, false if the input ends first */
+inline bool ReadLength(const uint8_t *&ip, const uint8_t *end, size_t &length) {
+  uint8_t byte;
+  do {
+    if (ip >= end) {
+      return false;
+    }
+    byte = *ip++;
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+}  // namespace
+
+size_t PageCodec::Compress(const char *src, size_t size, char *dst, size_t capacity) {
+  const auto *base = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *ip = base;
+  const uint8_t *anchor = base;
+  const uint8_t *end = base + size;
+  auto *op = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *op_end = op + capacity;
+
+  if (size >= MIN_MATCH + LAST_LITERALS) {
+    // positions modulo 2^16 of the last sequences seen with each hash, which is as far as an offset reaches, a
+    // candidate is checked before it is taken
+    uint16_t table[1 << HASH_BITS] = {};
+    const uint8_t *match_limit = end - LAST_LITERALS;
+    while (ip + MIN_MATCH <= match_limit) {
+      uint32_t sequence = Read32(ip);
+      uint16_t &slot = table[Hash(sequence)];
+      const uint8_t *ref = ip - static_cast<uint16_t>(ip - base - slot);
+      slot = static_cast<uint16_t>(ip - base);
+      if (ref >= ip || static_cast<size_t>(ip - ref) > MAX_OFFSET || Read32(ref) != sequence) {
+        // skip faster through data without matches
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        ip--;
+        ref--;
+      }
+      size_t match_length = MIN_MATCH;
+      while (ip + match_length < match_limit && ip[match_length] == ref[match_length]) {
+        match_length++;
+      }
+      size_t literals = ip - anchor;
+      if (static_cast<size_t>(op_end - op) < 1 + literals / 255 + 1 + literals + 2 + match_length / 255 + 1) {
+        return 0;
+      }
+      uint8_t *token = op++;
+      *token = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+      if (literals >= 15) {
+        op = WriteLength(op, literals - 15);
+      }
+      memcpy(op, anchor, literals);
+      op += literals;
+      size_t offset = ip - ref;
+      *op++ = static_cast<uint8_t>(offset);
+      *op++ = static_cast<uint8_t>(offset >> 8);
+      size_t extra = match_length - MIN_MATCH;
+      *token |= static_cast<uint8_t>(std::min<size_t>(extra, 15));
+      if (extra >= 15) {
+        op = WriteLength(op, extra - 15);
+      }
+      ip += match_length;
+      anchor = ip;
+    }
+  }
+
+  size_t literals = end - anchor;
+  if (static_cast<size_t>(op_end - op) < 1 + literals / 255 + 1 + literals) {
+    return 0;
+  }
+  *op++ = static_cast<uint8_t>(std::min<size_t>(literals, 15) << 4);
+  if (literals >= 15) {
+    op = WriteLength(op, literals - 15);
+  }
+  memcpy(op, anchor, literals);
+  op += literals;
+  return op - reinterpret_cast<uint8_t *>(dst);
+}
+
+bool PageCodec::Decompress(const char *src, size_t compressed_size, char *dst, size_t size) {
+  const auto *ip = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *end = ip + compressed_size;
+  auto *base = reinterpret_cast<uint8_t *>(dst);
+  uint8_t *op = base;
+  const uint8_t *op_end = base + size;
+  for (;;) {
+    if (ip >= end) {
+      return false;
+    }
+    uint8_t token = *ip++;
+    size_t literals = token >> 4;
+    if (literals == 15 && !ReadLength(ip, end, literals)) {
+      return false;
+    }
+    if (literals > static_cast<size_t>(end - ip) || literals > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+    memcpy(op, ip, literals);
+    op += literals;
+    ip += literals;
+    if (ip == end) {
+      // the last sequence
+      return op == op_end;
+    }
+    if (end - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > static_cast<size_t>(op - base)) {
+      return false;
+    }
+    size_t match_length = token & 15;
+    if (match_length == 15 && !ReadLength(ip, end, match_length)) {
+      return false;
+    }
+    match_length += MIN_MATCH;
+    if (match_length > static_cast<size_t>(op_end - op)) {
+      return false;
+    }
+    // A match overlapping the bytes it produces repeats them, it is copied in pieces which do not overlap and
+    // double in length.
+    const uint8_t *ref = op - offset;
+    while (match_length > 0) {
+      size_t length = std::min<size_t>(op - ref, match_length);
+      memcpy(op, ref, length);
+      op += length;
+      match_length -= length;
+    }
+  }
+}
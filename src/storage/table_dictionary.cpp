@@ -0,0 +1,137 @@
+#include "storage/table_dictionary.h"
+
+#include <mutex>
+
+#include "common/macros.h"
+#include "glog/logging.h"
+
+TableDictionary::TableDictionary(BufferPoolManager *buffer_pool_manager, uint32_t column_count)
+    : buffer_pool_manager_(buffer_pool_manager), values_(column_count), codes_(column_count) {
+  Page *page = buffer_pool_manager_->NewPage(first_page_id_);
+  ASSERT(page != nullptr, "dictionary page allocation failed.");
+  MACH_WRITE_TO(page_id_t, page->GetData() + OFFSET_NEXT_PAGE_ID, INVALID_PAGE_ID);
+  MACH_WRITE_UINT32(page->GetData() + OFFSET_USED_BYTES, SIZE_HEADER);
+  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  last_page_id_ = first_page_id_;
+}
+
+TableDictionary::TableDictionary(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id,
+                                 uint32_t column_count)
+    : buffer_pool_manager_(buffer_pool_manager),
+      first_page_id_(first_page_id),
+      values_(column_count),
+      codes_(column_count) {
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      LOG(ERROR) << "failed to read dictionary page " << page_id;
+      break;
+    }
+    last_page_id_ = page_id;
+    char *data = page->GetData();
+    uint32_t used_bytes = MACH_READ_UINT32(data + OFFSET_USED_BYTES);
+    for (uint32_t offset = SIZE_HEADER; offset + SIZE_ENTRY_HEADER <= used_bytes;) {
+      uint32_t column_id = MACH_READ_FROM(uint16_t, data + offset);
+      uint32_t length = MACH_READ_FROM(uint16_t, data + offset + 2);
+      if (column_id < values_.size()) {
+        codes_[column_id].emplace(std::string(data + offset + SIZE_ENTRY_HEADER, length),
+                                  static_cast<int32_t>(values_[column_id].size()));
+        values_[column_id].emplace_back(data + offset + SIZE_ENTRY_HEADER, length);
+      }
+      offset += SIZE_ENTRY_HEADER + length;
+    }
+    page_id_t next_page_id = MACH_READ_FROM(page_id_t, data + OFFSET_NEXT_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+int32_t TableDictionary::Encode(uint32_t column_id, const char *data, uint32_t length) {
+  std::string value(data, length);
+  {
+    std::shared_lock<std::shared_mutex> guard(latch_);
+    auto it = codes_[column_id].find(value);
+    if (it != codes_[column_id].end()) {
+      return it->second;
+    }
+  }
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  auto it = codes_[column_id].find(value);
+  if (it != codes_[column_id].end()) {
+    return it->second;
+  }
+  // the entry is in a page before the code is given
+  if (!AppendEntry(column_id, value)) {
+    return -1;
+  }
+  auto code = static_cast<int32_t>(values_[column_id].size());
+  codes_[column_id].emplace(value, code);
+  values_[column_id].push_back(std::move(value));
+  return code;
+}
+
+int32_t TableDictionary::Lookup(uint32_t column_id, const char *data, uint32_t length) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  auto it = codes_[column_id].find(std::string(data, length));
+  return it == codes_[column_id].end() ? -1 : it->second;
+}
+
+std::string TableDictionary::Decode(uint32_t column_id, int32_t code) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  ASSERT(code >= 0 && static_cast<size_t>(code) < values_[column_id].size(), "Unknown dictionary code.");
+  return values_[column_id][code];
+}
+
+uint32_t TableDictionary::GetSize(uint32_t column_id) {
+  std::shared_lock<std::shared_mutex> guard(latch_);
+  return static_cast<uint32_t>(values_[column_id].size());
+}
+
+void TableDictionary::FreePages() {
+  std::unique_lock<std::shared_mutex> guard(latch_);
+  for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+    Page *page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      break;
+    }
+    page_id_t next_page_id = MACH_READ_FROM(page_id_t, page->GetData() + OFFSET_NEXT_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+  first_page_id_ = last_page_id_ = INVALID_PAGE_ID;
+}
+
+bool TableDictionary::AppendEntry(uint32_t column_id, const std::string &value) {
+  uint32_t entry_size = SIZE_ENTRY_HEADER + value.size();
+  if (SIZE_HEADER + entry_size > PAGE_SIZE) {
+    return false;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(last_page_id_);
+  if (page == nullptr) {
+    return false;
+  }
+  uint32_t used_bytes = MACH_READ_UINT32(page->GetData() + OFFSET_USED_BYTES);
+  if (used_bytes + entry_size > PAGE_SIZE) {
+    // the last page is full, link a new one behind it
+    page_id_t new_page_id;
+    Page *new_page = buffer_pool_manager_->NewPageNear(new_page_id, last_page_id_);
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id_, false);
+      return false;
+    }
+    MACH_WRITE_TO(page_id_t, new_page->GetData() + OFFSET_NEXT_PAGE_ID, INVALID_PAGE_ID);
+    MACH_WRITE_TO(page_id_t, page->GetData() + OFFSET_NEXT_PAGE_ID, new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id_, true);
+    last_page_id_ = new_page_id;
+    page = new_page;
+    used_bytes = SIZE_HEADER;
+  }
+  char *entry = page->GetData() + used_bytes;
+  MACH_WRITE_TO(uint16_t, entry, static_cast<uint16_t>(column_id));
+  MACH_WRITE_TO(uint16_t, entry + 2, static_cast<uint16_t>(value.size()));
+  memcpy(entry + SIZE_ENTRY_HEADER, value.data(), value.size());
+  MACH_WRITE_UINT32(page->GetData() + OFFSET_USED_BYTES, used_bytes + entry_size);
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+  return true;
+}
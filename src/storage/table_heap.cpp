@@ -1,55 +1,252 @@
 #include "storage/table_heap.h"
 
-/**
- * TODO: Student Implement
- */
-bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-  bool insert_success= false;
-  if(row.GetSerializedSize(schema_)>TablePage::SIZE_MAX_ROW) return false;
-  if(first_page_id_==INVALID_PAGE_ID){
-    auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(first_page_id_));
-    ASSERT(page!= nullptr,"first page allocation failed.");
+#include <algorithm>
+
+#include "index/index.h"
+
+namespace {
+
+/** @return the code held by an int field */
+int32_t GetCode(const Field &field) {
+  int32_t code;
+  field.SerializeTo(reinterpret_cast<char *>(&code));
+  return code;
+}
+
+bool IsSameKey(const Row &a, const Row &b) {
+  for (uint32_t i = 0; i < a.GetFieldCount(); i++) {
+    if (a.GetField(i)->CompareEquals(*b.GetField(i)) != CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+bool TableHeap::Fits(const Row &row) const {
+  if (layout_ == TableLayout::kColumnar) {
+    return TablePage::FitsColumnar(row, storage_schema_);
+  }
+  return row.GetSerializedSize(storage_schema_) <= TablePage::SIZE_MAX_ROW;
+}
+
+void TableHeap::InitEncoding(bool dictionary_encoded, page_id_t dictionary_page_id) {
+  storage_schema_ = schema_;
+  if (!dictionary_encoded) {
+    return;
+  }
+  uint32_t column_count = schema_->GetColumnCount();
+  if (dictionary_page_id == INVALID_PAGE_ID) {
+    dictionary_ = std::make_unique<TableDictionary>(buffer_pool_manager_, column_count);
+  } else {
+    dictionary_ = std::make_unique<TableDictionary>(buffer_pool_manager_, dictionary_page_id, column_count);
+  }
+  std::vector<Column *> columns;
+  for (auto column : schema_->GetColumns()) {
+    if (column->GetType() == TypeId::kTypeChar) {
+      columns.push_back(new Column(column->GetName(), TypeId::kTypeInt, column->GetTableInd(),
+                                   column->IsNullable(), column->IsUnique()));
+    } else {
+      columns.push_back(new Column(column));
+    }
+  }
+  storage_schema_ = new Schema(columns);
+}
+
+bool TableHeap::EncodeRow(const Row &row, Row *encoded, bool add) {
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    Field *field = row.GetField(i);
+    if (!IsEncoded(i)) {
+      fields.emplace_back(*field);
+    } else if (field->IsNull()) {
+      fields.emplace_back(TypeId::kTypeInt);
+    } else {
+      int32_t code = add ? dictionary_->Encode(i, field->GetData(), field->GetLength())
+                         : dictionary_->Lookup(i, field->GetData(), field->GetLength());
+      if (code < 0) {
+        return false;
+      }
+      fields.emplace_back(TypeId::kTypeInt, code);
+    }
+  }
+  *encoded = Row(fields);
+  encoded->SetRowId(row.GetRowId());
+  return true;
+}
+
+void TableHeap::DecodeRow(Row *row) {
+  if (dictionary_ == nullptr || row->GetFieldCount() == 0) {
+    return;
+  }
+  auto &fields = row->GetFields();
+  for (uint32_t i = 0; i < schema_->GetColumnCount(); i++) {
+    if (IsEncoded(i)) {
+      DecodeField(i, &fields[i]);
+    }
+  }
+}
+
+void TableHeap::DecodeRow(Row *row, const std::vector<uint32_t> &column_ids) {
+  if (dictionary_ == nullptr || row->GetFieldCount() == 0) {
+    return;
+  }
+  auto &fields = row->GetFields();
+  for (size_t j = 0; j < column_ids.size(); j++) {
+    if (IsEncoded(column_ids[j])) {
+      DecodeField(column_ids[j], &fields[j]);
+    }
+  }
+}
+
+void TableHeap::DecodeField(uint32_t column_id, Field **field) {
+  Field *code = *field;
+  if (code->IsNull()) {
+    *field = new Field(TypeId::kTypeChar);
+  } else {
+    std::string value = dictionary_->Decode(column_id, GetCode(*code));
+    *field = new Field(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true);
+  }
+  delete code;
+}
+
+bool TableHeap::InsertTuple(Row &logical_row, Transaction *txn) {
+  // the pages hold the encoded row, its rid is handed back to the caller's row at the end
+  Row encoded;
+  if (dictionary_ != nullptr && !EncodeRow(logical_row, &encoded)) {
+    return false;
+  }
+  Row &row = dictionary_ != nullptr ? encoded : logical_row;
+  if (!Fits(row)) {
+    return false;
+  }
+  page_id_t page_id = first_page_id_;
+  while (true) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      return false;
+    }
     page->WLatch();
-    page->Init(first_page_id_,INVALID_PAGE_ID,log_manager_,txn);
-    insert_success = page->InsertTuple(row,schema_,txn, lock_manager_,log_manager_);
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(first_page_id_, insert_success);
-  }else{
-    page_id_t page_id = first_page_id_;
-    TablePage* page;
-    while(page_id!=INVALID_PAGE_ID){
-      page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(page_id));
-      ASSERT(page!= nullptr,"page fetch failed.");
-      page->WLatch();
-      insert_success = page->InsertTuple(row,schema_,txn,lock_manager_,log_manager_);
-      if(!insert_success) {
-        if(page->GetNextPageId()==INVALID_PAGE_ID){
-          page_id_t new_page_id;
-          //cout<<"need to allocate a new page"<<endl;
-          auto new_page = reinterpret_cast<TablePage*>(buffer_pool_manager_->NewPage(new_page_id));
-          ASSERT(new_page!= nullptr,"new page allocation failed.");
-          new_page->WLatch();
-          new_page->Init(new_page_id,page_id,log_manager_,txn);
-          page->SetNextPageId(new_page_id);
-          insert_success = new_page->InsertTuple(row,schema_,txn,lock_manager_,log_manager_);
-          new_page->WUnlatch();
-          page->WUnlatch();
-          buffer_pool_manager_->UnpinPage(new_page_id,insert_success);
-          break;
-        }else page_id = page->GetNextPageId();
-        page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(page_id,insert_success);
-      }else{
+    if (page->InsertTuple(row, storage_schema_, txn, lock_manager_, log_manager_)) {
+      if (IsVersioned(txn)) {
+        version_store_->RecordInsert(row.GetRowId(), txn, this);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      if (txn != nullptr) {
+        txn->GetTableWriteSet()->emplace_back(row.GetRowId(), WType::kInsert, Row(), this);
+      }
+      logical_row.SetRowId(row.GetRowId());
+      return true;
+    }
+    if (txn != nullptr && txn->GetState() == TxnState::kAborted) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return false;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      // Last page is full, link a new one behind it and retry there.
+      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageNear(next_page_id, page_id));
+      if (new_page == nullptr) {
         page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(page_id,insert_success);
-        break;
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        return false;
       }
+      new_page->WLatch();
+      InitPage(new_page, next_page_id, page_id, txn);
+      new_page->WUnlatch();
+      page->SetNextPageId(next_page_id);
+      buffer_pool_manager_->UnpinPage(next_page_id, true);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, true);
+    } else {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
     }
+    page_id = next_page_id;
   }
-  return insert_success;
+}
+
+bool TableHeap::InsertTuples(std::vector<Row> &logical_rows, Transaction *txn) {
+  std::vector<Row> encoded;
+  if (dictionary_ != nullptr) {
+    encoded.resize(logical_rows.size());
+    for (size_t i = 0; i < logical_rows.size(); i++) {
+      if (!EncodeRow(logical_rows[i], &encoded[i])) {
+        return false;
+      }
+    }
+  }
+  std::vector<Row> &rows = dictionary_ != nullptr ? encoded : logical_rows;
+  for (auto &row : rows) {
+    if (!Fits(row)) {
+      return false;
+    }
+  }
+  // the rids of the rows inserted are handed back to the caller's rows
+  auto return_rids = [&]() {
+    for (size_t i = 0; dictionary_ != nullptr && i < rows.size(); i++) {
+      logical_rows[i].SetRowId(rows[i].GetRowId());
+    }
+  };
+  size_t next = 0;
+  page_id_t page_id = first_page_id_;
+  while (next < rows.size()) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      return_rids();
+      return false;
+    }
+    page->WLatch();
+    // Fill the page as far as the rows fit, it is latched and pinned once for all of them.
+    size_t first = next;
+    while (next < rows.size() && page->InsertTuple(rows[next], storage_schema_, txn, lock_manager_, log_manager_)) {
+      if (IsVersioned(txn)) {
+        version_store_->RecordInsert(rows[next].GetRowId(), txn, this);
+      }
+      next++;
+    }
+    bool failed = txn != nullptr && txn->GetState() == TxnState::kAborted;
+    bool is_dirty = next > first;
+    page_id_t next_page_id = page->GetNextPageId();
+    if (!failed && next < rows.size() && next_page_id == INVALID_PAGE_ID) {
+      // Last page is full, link a new one behind it and go on there.
+      auto new_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPageNear(next_page_id, page_id));
+      if (new_page == nullptr) {
+        failed = true;
+      } else {
+        new_page->WLatch();
+        InitPage(new_page, next_page_id, page_id, txn);
+        new_page->WUnlatch();
+        page->SetNextPageId(next_page_id);
+        buffer_pool_manager_->UnpinPage(next_page_id, true);
+        is_dirty = true;
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, is_dirty);
+    if (txn != nullptr) {
+      for (size_t i = first; i < next; i++) {
+        txn->GetTableWriteSet()->emplace_back(rows[i].GetRowId(), WType::kInsert, Row(), this);
+      }
+    }
+    if (failed) {
+      return_rids();
+      return false;
+    }
+    page_id = next_page_id;
+  }
+  return_rids();
+  return true;
 }
 
 bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
+  // Take the row lock before latching the page, a blocked lock request must never hold a latch.
+  if (txn != nullptr && lock_manager_ != nullptr && !lock_manager_->LockExclusive(txn, rid)) {
+    return false;
+  }
   // Find the page which contains the tuple.
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   // If the page could not be found, then abort the transaction.
@@ -58,50 +255,80 @@ bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  bool is_marked = false;
+  if (!IsVersioned(txn)) {
+    is_marked = page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  } else if (version_store_->CheckWrite(rid, txn)) {
+    // Keep the deleted version for the snapshots which still see it.
+    Row prior(rid);
+    if (page->GetTuple(&prior, storage_schema_, nullptr, nullptr)) {
+      is_marked = page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+      DecodeRow(&prior);
+    }
+    if (is_marked) {
+      version_store_->RecordWrite(rid, txn, prior, true, this);
+    }
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return true;
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_marked);
+  if (is_marked && txn != nullptr) {
+    txn->GetTableWriteSet()->emplace_back(rid, WType::kDelete, Row(), this);
+  }
+  return is_marked;
 }
 
-/**
- * TODO: Student Implement
- */
-bool TableHeap::UpdateTuple(Row &row, const RowId &rid, Transaction *txn) {
+bool TableHeap::UpdateTuple(Row &logical_row, const RowId &rid, Transaction *txn) {
+  Row encoded;
+  if (dictionary_ != nullptr && !EncodeRow(logical_row, &encoded)) {
+    return false;
+  }
+  Row &row = dictionary_ != nullptr ? encoded : logical_row;
+  if (!Fits(row)) {
+    return false;
+  }
+  if (txn != nullptr && lock_manager_ != nullptr && !lock_manager_->LockExclusive(txn, rid)) {
+    return false;
+  }
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
-  if (page == nullptr) // 没有数据页
+  if (page == nullptr) {
     return false;
+  }
   page->WLatch();
-  Row old_row(rid);
-  int insert_success = page->UpdateTuple(row, &old_row, this->schema_, txn, lock_manager_, log_manager_);
-  if(insert_success == 0){
+  if (IsVersioned(txn) && !version_store_->CheckWrite(rid, txn)) {
     page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    return false;
+  }
+  Row old_row(rid);
+  auto status = page->UpdateTuple(row, &old_row, storage_schema_, txn, lock_manager_, log_manager_);
+  if (status == TablePage::kUpdateSuccess) {
+    DecodeRow(&old_row);
+    logical_row.SetRowId(row.GetRowId());
+  }
+  if (status == TablePage::kUpdateSuccess && IsVersioned(txn)) {
+    version_store_->RecordWrite(rid, txn, old_row, false, this);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), status == TablePage::kUpdateSuccess);
+  if (status == TablePage::kUpdateSuccess) {
+    if (txn != nullptr) {
+      txn->GetTableWriteSet()->emplace_back(rid, WType::kUpdate, old_row, this);
+    }
     return true;
   }
-  else if(insert_success == 1){ // slotId越界，没有该记录, 返回错误, 不更新
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  if (status != TablePage::kUpdateNoSpace) {
     return false;
   }
-  else if(insert_success == 2){ // 标记删除 or 物理删除, 不更新
-    page->ApplyDelete(rid, txn, log_manager_);
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  // Not enough space in the page, delete the old tuple and insert the new one, the new rid is wrapped in row.
+  if (!MarkDelete(rid, txn)) {
     return false;
   }
-  else if(insert_success == 3){ // 数据页空间不够, 先删除再插入, 自然RowId会变
-    page->ApplyDelete(rid, txn, log_manager_);
-    page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
-    this->InsertTuple(row, txn);
-    return true;
+  if (txn == nullptr) {
+    ApplyDelete(rid, txn);
   }
+  return InsertTuple(logical_row, txn);
 }
 
-/**
- * TODO: Student Implement
- */
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   // Step1: Find the page which contains the tuple.
   // Step2: Delete the tuple from the page.
@@ -109,6 +336,10 @@ void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
   if(page!= nullptr){
     page->WLatch();
     page->ApplyDelete(rid,txn,log_manager_);
+    // The slot may be reused from now on, the versions of the freed tuple must go with it.
+    if (version_store_ != nullptr) {
+      version_store_->Remove(rid);
+    }
     page->WUnlatch();
     buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
   }
@@ -125,22 +356,170 @@ void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
-/**
- * TODO: Student Implement
- */
-bool TableHeap::GetTuple(Row *row, Transaction *txn) {
-  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId()));
+void TableHeap::RollbackUpdate(Row &logical_row, const RowId &rid, Transaction *txn) {
+  // the values of the old tuple are all in the dictionary already
+  Row encoded;
+  if (dictionary_ != nullptr) {
+    EncodeRow(logical_row, &encoded);
+  }
+  Row &row = dictionary_ != nullptr ? encoded : logical_row;
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  assert(page != nullptr);
+  page->WLatch();
+  Row current(rid);
+  // the lock is held already
+  auto __attribute__((unused)) status = page->UpdateTuple(row, &current, storage_schema_, txn, nullptr, log_manager_);
+  ASSERT(status == TablePage::kUpdateSuccess, "The undo of an update must fit in place.");
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+}
+
+void TableHeap::TrimTuple(const RowId &rid) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return;
+  }
+  page->WLatch();
+  page->TrimTuple(rid, storage_schema_);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+}
+
+void TableHeap::AttachIndex(Index *index) {
+  std::lock_guard<std::mutex> guard(index_latch_);
+  indexes_.push_back(index);
+}
+
+void TableHeap::DetachIndex(Index *index) {
+  std::lock_guard<std::mutex> guard(index_latch_);
+  indexes_.erase(std::remove(indexes_.begin(), indexes_.end(), index), indexes_.end());
+}
+
+bool TableHeap::HasIndexes() {
+  std::lock_guard<std::mutex> guard(index_latch_);
+  return !indexes_.empty();
+}
+
+void TableHeap::ReclaimVersions(const RowId &rid, const std::vector<Row> &dropped, const std::vector<Row> &kept,
+                                bool deleted) {
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return;
+  }
+  // The page stays latched until the entries are gone, a writer giving the tuple one of the removed keys again
+  // either did so before, and the key is kept, or inserts its entry after.
+  page->WLatch();
+  std::vector<Row> stale(dropped);
+  std::vector<Row> live(kept);
+  Row newest(rid);
+  if (deleted ? page->GetDeletedTuple(&newest, storage_schema_)
+              : page->GetTuple(&newest, storage_schema_, nullptr, nullptr)) {
+    DecodeRow(&newest);
+    (deleted ? stale : live).push_back(newest);
+  }
+  {
+    std::lock_guard<std::mutex> guard(index_latch_);
+    for (auto index : indexes_) {
+      std::vector<Row> live_keys(live.size());
+      for (size_t i = 0; i < live.size(); i++) {
+        live[i].GetKeyFromRow(schema_, index->GetKeySchema(), live_keys[i]);
+      }
+      for (auto &row : stale) {
+        Row key;
+        row.GetKeyFromRow(schema_, index->GetKeySchema(), key);
+        if (std::none_of(live_keys.begin(), live_keys.end(), [&](const Row &k) { return IsSameKey(k, key); })) {
+          index->RemoveEntry(key, rid, nullptr);
+        }
+      }
+    }
+  }
+  if (deleted) {
+    page->ApplyDelete(rid, nullptr, log_manager_);
+    version_store_->Remove(rid);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), deleted);
+}
+
+bool TableHeap::ReplaceStaleEntry(Index *index, const Row &key, const RowId &rid, Transaction *txn) {
+  std::vector<RowId> owners;
+  if (!IsVersioned(txn) || index->ScanKey(key, owners, nullptr) != DB_SUCCESS || owners.empty() ||
+      owners[0].Get() == rid.Get()) {
+    return false;
+  }
+  // The newest version of the owner decides, an older one is only seen by snapshots which do not see rid.
+  Row owner(owners[0]);
+  if (GetTuple(&owner, nullptr)) {
+    Row owner_key;
+    owner.GetKeyFromRow(schema_, index->GetKeySchema(), owner_key);
+    if (IsSameKey(owner_key, key)) {
+      return false;
+    }
+  }
+  if (index->RemoveEntry(key, owners[0], nullptr) != DB_SUCCESS) {
+    return false;
+  }
+  txn->GetIndexWriteSet()->emplace_back(owners[0], WType::kDelete, key, index);
+  return index->InsertEntry(key, rid, txn) == DB_SUCCESS;
+}
+
+bool TableHeap::GetTuple(Row *row, Transaction *txn, bool decode) {
+  RowId rid = row->GetRowId();
+  if (txn != nullptr && txn->IsSnapshotRead()) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+    if (page == nullptr) {
+      return false;
+    }
+    page->RLatch();
+    bool exists = page->GetTuple(row, storage_schema_, txn, lock_manager_);
+    bool visible = exists;
+    if (version_store_ != nullptr) {
+      // the versions kept are decoded rows, the row read keeps its codes unless an older version replaces it
+      bool older;
+      visible = version_store_->GetVisible(row, exists, txn, &older);
+      if (visible && older && !decode && dictionary_ != nullptr) {
+        Row encoded;
+        visible = EncodeRow(*row, &encoded, false);
+        *row = encoded;
+      } else if (visible && !older && decode) {
+        DecodeRow(row);
+      }
+    } else if (exists && decode) {
+      DecodeRow(row);
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+    return visible;
+  }
+  // Lock before latching, the page only checks that the lock is held.
+  bool lock_row = txn != nullptr && lock_manager_ != nullptr &&
+                  txn->GetIsolationLevel() != IsolationLevel::kReadUncommitted && !txn->IsSharedLocked(rid) &&
+                  !txn->IsExclusiveLocked(rid);
+  if (lock_row && !lock_manager_->LockShared(txn, rid)) {
+    return false;
+  }
+  auto page = reinterpret_cast<TablePage*>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
   bool get_success = false;
   if(page!= nullptr){
     page->RLatch();
-    get_success = page->GetTuple(row,schema_,txn,lock_manager_);
+    get_success = page->GetTuple(row,storage_schema_,txn,lock_manager_);
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
   }
+  // Read committed only holds the shared lock while reading the tuple.
+  if (lock_row && txn->GetIsolationLevel() == IsolationLevel::kReadCommitted) {
+    lock_manager_->Unlock(txn, rid);
+  }
+  if (get_success && decode) {
+    DecodeRow(row);
+  }
   return get_success;
 }
 
 void TableHeap::DeleteTable(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID && dictionary_ != nullptr) {
+    dictionary_->FreePages();
+  }
   if (page_id != INVALID_PAGE_ID) {
     auto temp_table_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));  // 删除table_heap
     if (temp_table_page->GetNextPageId() != INVALID_PAGE_ID)
@@ -152,16 +531,173 @@ void TableHeap::DeleteTable(page_id_t page_id) {
   }
 }
 
-/**
- * TODO: Student Implement
- */
-TableIterator TableHeap::Begin(Transaction *txn) {
-  return TableIterator();
+TableIterator TableHeap::Begin(Transaction *txn, bool decode) {
+  RowId rid;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    bool found = page->GetFirstTupleRid(&rid, txn != nullptr && txn->IsSnapshotRead());
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    if (found) {
+      return TableIterator(this, rid, txn, decode);
+    }
+    page_id = next_page_id;
+  }
+  return End();
+}
+
+std::vector<page_id_t> TableHeap::GetPageIds() {
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page_ids.push_back(page_id);
+    page->RLatch();
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return page_ids;
+}
+
+void TableHeap::ScanPage(page_id_t page_id, Transaction *txn, std::vector<Row> *rows, bool decode) {
+  ASSERT(txn == nullptr || txn->IsSnapshotRead(), "Locking reads can not scan a page at once.");
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return;
+  }
+  bool versioned = txn != nullptr && version_store_ != nullptr;
+  page->RLatch();
+  RowId rid;
+  bool found = page->GetFirstTupleRid(&rid, txn != nullptr);
+  while (found) {
+    Row row(rid);
+    bool exists = page->GetTuple(&row, storage_schema_, txn, lock_manager_);
+    bool older = false;
+    if (versioned ? version_store_->GetVisible(&row, exists, txn, &older) : exists) {
+      // the versions kept are decoded rows, the row read keeps its codes unless an older version replaces it
+      if (older && !decode && dictionary_ != nullptr) {
+        rows->emplace_back();
+        EncodeRow(row, &rows->back(), false);
+      } else {
+        if (!older && decode) {
+          DecodeRow(&row);
+        }
+        rows->emplace_back(row);
+      }
+    }
+    found = page->GetNextTupleRid(rid, &rid, txn != nullptr);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+void TableHeap::ScanVersionedColumns(TablePage *page, Transaction *txn, const std::vector<uint32_t> &column_ids,
+                                     const std::vector<RowId> &chained, std::vector<std::vector<Field>> *columns,
+                                     std::vector<RowId> *rids) {
+  std::vector<std::vector<Field>> page_columns;
+  std::vector<RowId> page_rids;
+  page->GetColumns(storage_schema_, column_ids, &page_columns, &page_rids);
+  // Both lists of rids are in slot order, the tuples without a chain take their values from the page.
+  size_t next_chained = 0;
+  for (size_t i = 0; i < page_rids.size() || next_chained < chained.size();) {
+    if (next_chained == chained.size() || (i < page_rids.size() && page_rids[i].Get() < chained[next_chained].Get())) {
+      for (size_t j = 0; j < column_ids.size(); j++) {
+        (*columns)[j].emplace_back(page_columns[j][i]);
+      }
+      if (rids != nullptr) {
+        rids->push_back(page_rids[i]);
+      }
+      i++;
+      continue;
+    }
+    RowId rid = chained[next_chained++];
+    if (i < page_rids.size() && page_rids[i] == rid) {
+      i++;
+    }
+    Row row(rid);
+    bool exists = page->GetTuple(&row, storage_schema_, txn, lock_manager_);
+    bool older = false;
+    if (!version_store_->GetVisible(&row, exists, txn, &older)) {
+      continue;
+    }
+    // the versions kept are decoded rows, the values are read as codes as those of the page
+    Row encoded;
+    if (older && dictionary_ != nullptr) {
+      EncodeRow(row, &encoded, false);
+      encoded.SetRowId(rid);
+    }
+    Row &visible = older && dictionary_ != nullptr ? encoded : row;
+    for (size_t j = 0; j < column_ids.size(); j++) {
+      (*columns)[j].emplace_back(*visible.GetField(column_ids[j]));
+    }
+    if (rids != nullptr) {
+      rids->push_back(rid);
+    }
+  }
+}
+
+void TableHeap::ScanColumns(page_id_t page_id, Transaction *txn, const std::vector<uint32_t> &column_ids,
+                            std::vector<std::vector<Field>> *columns, std::vector<RowId> *rids, bool decode) {
+  ASSERT(txn == nullptr || txn->IsSnapshotRead(), "Locking reads can not scan a page at once.");
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    return;
+  }
+  if (columns->size() < column_ids.size()) {
+    columns->resize(column_ids.size());
+  }
+  std::vector<size_t> first_values;
+  for (size_t j = 0; j < column_ids.size(); j++) {
+    first_values.push_back((*columns)[j].size());
+  }
+  page->RLatch();
+  // A snapshot may see another version than the page holds only of the tuples with a version chain.
+  std::vector<RowId> chained;
+  if (txn != nullptr && version_store_ != nullptr) {
+    RowId rid;
+    for (bool found = page->GetFirstTupleRid(&rid, true); found; found = page->GetNextTupleRid(rid, &rid, true)) {
+      if (version_store_->HasChain(rid)) {
+        chained.push_back(rid);
+      }
+    }
+  }
+  if (chained.empty()) {
+    page->GetColumns(storage_schema_, column_ids, columns, rids);
+  } else {
+    ScanVersionedColumns(page, txn, column_ids, chained, columns, rids);
+  }
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (!decode || dictionary_ == nullptr) {
+    return;
+  }
+  for (size_t j = 0; j < column_ids.size(); j++) {
+    if (!IsEncoded(column_ids[j])) {
+      continue;
+    }
+    auto &values = (*columns)[j];
+    std::vector<Field> decoded;
+    decoded.reserve(values.size());
+    for (size_t i = 0; i < first_values[j]; i++) {
+      decoded.emplace_back(values[i]);
+    }
+    for (size_t i = first_values[j]; i < values.size(); i++) {
+      if (values[i].IsNull()) {
+        decoded.emplace_back(TypeId::kTypeChar);
+      } else {
+        std::string value = dictionary_->Decode(column_ids[j], GetCode(values[i]));
+        decoded.emplace_back(TypeId::kTypeChar, const_cast<char *>(value.data()), value.size(), true);
+      }
+    }
+    values.swap(decoded);
+  }
 }
 
-/**
- * TODO: Student Implement
- */
 TableIterator TableHeap::End() {
-  return TableIterator();
+  return TableIterator(this, INVALID_ROWID, nullptr);
 }
@@ -3,50 +3,98 @@
 #include "common/macros.h"
 #include "storage/table_heap.h"
 
-/**
- * TODO: Student Implement
- */
-TableIterator::TableIterator() {
+TableIterator::TableIterator() = default;
 
+TableIterator::TableIterator(TableHeap *table_heap, RowId rid, Transaction *txn, bool decode)
+    : table_heap_(table_heap), txn_(txn), decode_(decode), row_(rid) {
+  ReadCurrent();
 }
 
-TableIterator::TableIterator(const TableIterator &other) {
+TableIterator::TableIterator(const TableIterator &other)
+    : table_heap_(other.table_heap_), txn_(other.txn_), decode_(other.decode_), row_(other.row_) {}
 
-}
-
-TableIterator::~TableIterator() {
-
-}
+TableIterator::~TableIterator() = default;
 
 bool TableIterator::operator==(const TableIterator &itr) const {
-  return false;
+  return row_.GetRowId() == itr.row_.GetRowId();
 }
 
 bool TableIterator::operator!=(const TableIterator &itr) const {
-  return false;
+  return !(*this == itr);
 }
 
 const Row &TableIterator::operator*() {
-  ASSERT(false, "Not implemented yet.");
+  ASSERT(row_.GetRowId().GetPageId() != INVALID_PAGE_ID, "Dereference an end iterator.");
+  return row_;
 }
 
 Row *TableIterator::operator->() {
-  //return *(this->iter);
+  ASSERT(row_.GetRowId().GetPageId() != INVALID_PAGE_ID, "Dereference an end iterator.");
+  return &row_;
 }
 
-TableIterator TableIterator::operator=(const TableIterator &itr) noexcept {
-  return TableIterator(itr);
+TableIterator &TableIterator::operator=(const TableIterator &itr) noexcept {
+  table_heap_ = itr.table_heap_;
+  txn_ = itr.txn_;
+  decode_ = itr.decode_;
+  row_ = itr.row_;
+  return *this;
 }
 
 // ++iter
 TableIterator &TableIterator::operator++() {
-  this->iter++;
+  AdvanceRowId();
+  ReadCurrent();
   return *this;
 }
 
 // iter++
 TableIterator TableIterator::operator++(int) {
   TableIterator temp(*this);
-  this->iter++;
+  ++(*this);
   return temp;
 }
+
+void TableIterator::ReadCurrent() {
+  while (row_.GetRowId().GetPageId() != INVALID_PAGE_ID) {
+    Row row(row_.GetRowId());
+    if (table_heap_->GetTuple(&row, txn_, decode_)) {
+      row_ = row;
+      return;
+    }
+    // An aborted transaction stops scanning, the executor raises the abort.
+    if (txn_ != nullptr && txn_->GetState() == TxnState::kAborted) {
+      row_ = Row(INVALID_ROWID);
+      return;
+    }
+    AdvanceRowId();
+  }
+}
+
+void TableIterator::AdvanceRowId() {
+  RowId cur_rid = row_.GetRowId();
+  if (cur_rid.GetPageId() == INVALID_PAGE_ID) {
+    return;
+  }
+  RowId rid;
+  // A snapshot may still see tuples deleted after it was taken.
+  bool include_deleted = txn_ != nullptr && txn_->IsSnapshotRead();
+  auto bpm = table_heap_->buffer_pool_manager_;
+  page_id_t page_id = cur_rid.GetPageId();
+  auto page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+  page->RLatch();
+  bool found = page->GetNextTupleRid(cur_rid, &rid, include_deleted);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  bpm->UnpinPage(page_id, false);
+  while (!found && next_page_id != INVALID_PAGE_ID) {
+    page_id = next_page_id;
+    page = reinterpret_cast<TablePage *>(bpm->FetchPage(page_id));
+    page->RLatch();
+    found = page->GetFirstTupleRid(&rid, include_deleted);
+    next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    bpm->UnpinPage(page_id, false);
+  }
+  row_ = Row(found ? rid : INVALID_ROWID);
+}
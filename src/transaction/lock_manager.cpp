@@ -0,0 +1,324 @@
+#include "transaction/lock_manager.h"
+
+#include <algorithm>
+#include <functional>
+
+LockManager::LockManager(bool enable_cycle_detection, std::chrono::milliseconds cycle_detection_interval)
+    : enable_cycle_detection_(enable_cycle_detection), cycle_detection_interval_(cycle_detection_interval) {
+  if (enable_cycle_detection_) {
+    cycle_detection_thread_ = std::thread(&LockManager::RunCycleDetection, this);
+  }
+}
+
+LockManager::~LockManager() {
+  {
+    std::lock_guard<std::mutex> guard(detection_latch_);
+    enable_cycle_detection_ = false;
+  }
+  detection_cv_.notify_all();
+  if (cycle_detection_thread_.joinable()) {
+    cycle_detection_thread_.join();
+  }
+}
+
+bool LockManager::CheckLockable(Transaction *txn, LockMode mode) {
+  if (txn->GetState() == TxnState::kAborted) {
+    return false;
+  }
+  if (mode == LockMode::kShared && txn->GetIsolationLevel() == IsolationLevel::kReadUncommitted) {
+    txn->SetAborted(AbortReason::kLockSharedOnReadUncommitted);
+    return false;
+  }
+  if (txn->GetState() == TxnState::kShrinking) {
+    txn->SetAborted(AbortReason::kLockOnShrinking);
+    return false;
+  }
+  return true;
+}
+
+bool LockManager::IsGrantable(const LockRequestQueue &queue, Transaction *txn, LockMode mode) {
+  for (const auto &request : queue.request_queue_) {
+    if (request.txn_ == txn) {
+      return true;
+    }
+    // Exclusive lock is granted only to the head of the queue, a shared one waits behind any exclusive request.
+    if (mode == LockMode::kExclusive || request.mode_ == LockMode::kExclusive) {
+      return false;
+    }
+  }
+  ASSERT(false, "Lock request not in queue.");
+  return false;
+}
+
+bool LockManager::WaitForGrant(std::unique_lock<std::mutex> &guard, LockRequestQueue &queue, Transaction *txn,
+                               LockMode mode) {
+  while (txn->GetState() != TxnState::kAborted && !IsGrantable(queue, txn, mode)) {
+    queue.cv_.wait(guard);
+  }
+  if (txn->GetState() == TxnState::kAborted) {
+    RemoveRequest(queue, txn);
+    return false;
+  }
+  for (auto &request : queue.request_queue_) {
+    if (request.txn_ == txn) {
+      request.granted_ = true;
+      break;
+    }
+  }
+  return true;
+}
+
+bool LockManager::RemoveRequest(LockRequestQueue &queue, Transaction *txn) {
+  auto &requests = queue.request_queue_;
+  auto it = std::find_if(requests.begin(), requests.end(),
+                         [txn](const LockRequest &request) { return request.txn_ == txn; });
+  if (it == requests.end()) {
+    return false;
+  }
+  requests.erase(it);
+  queue.cv_.notify_all();
+  return true;
+}
+
+bool LockManager::LockShared(Transaction *txn, const RowId &rid) {
+  if (!CheckLockable(txn, LockMode::kShared)) {
+    return false;
+  }
+  if (txn->IsSharedLocked(rid) || txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  auto &shard = GetShard(rid);
+  std::unique_lock<std::mutex> guard(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  queue.request_queue_.emplace_back(txn, LockMode::kShared);
+  if (!WaitForGrant(guard, queue, txn, LockMode::kShared)) {
+    return false;
+  }
+  txn->GetSharedLockSet()->emplace(rid);
+  return true;
+}
+
+bool LockManager::LockExclusive(Transaction *txn, const RowId &rid) {
+  if (!CheckLockable(txn, LockMode::kExclusive)) {
+    return false;
+  }
+  if (txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  if (txn->IsSharedLocked(rid)) {
+    return LockUpgrade(txn, rid);
+  }
+  auto &shard = GetShard(rid);
+  std::unique_lock<std::mutex> guard(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  queue.request_queue_.emplace_back(txn, LockMode::kExclusive);
+  if (!WaitForGrant(guard, queue, txn, LockMode::kExclusive)) {
+    return false;
+  }
+  txn->GetExclusiveLockSet()->emplace(rid);
+  return true;
+}
+
+bool LockManager::TryLockExclusive(Transaction *txn, const RowId &rid) {
+  if (!CheckLockable(txn, LockMode::kExclusive)) {
+    return false;
+  }
+  if (txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto &requests = shard.lock_table_[rid].request_queue_;
+  for (const auto &request : requests) {
+    if (request.txn_ != txn) {
+      return false;
+    }
+  }
+  if (requests.empty()) {
+    requests.emplace_back(txn, LockMode::kExclusive);
+    requests.back().granted_ = true;
+  } else {
+    // txn is the only holder of a shared lock, upgrade it in place
+    requests.front().mode_ = LockMode::kExclusive;
+    txn->GetSharedLockSet()->erase(rid);
+  }
+  txn->GetExclusiveLockSet()->emplace(rid);
+  return true;
+}
+
+bool LockManager::LockUpgrade(Transaction *txn, const RowId &rid) {
+  if (!CheckLockable(txn, LockMode::kExclusive)) {
+    return false;
+  }
+  if (txn->IsExclusiveLocked(rid)) {
+    return true;
+  }
+  auto &shard = GetShard(rid);
+  std::unique_lock<std::mutex> guard(shard.latch_);
+  auto &queue = shard.lock_table_[rid];
+  if (queue.upgrading_) {
+    txn->SetAborted(AbortReason::kUpgradeConflict);
+    return false;
+  }
+  // Drop the shared request and queue the exclusive one in front of all waiting requests.
+  auto &requests = queue.request_queue_;
+  auto it = std::find_if(requests.begin(), requests.end(),
+                         [txn](const LockRequest &request) { return request.txn_ == txn; });
+  ASSERT(it != requests.end() && it->granted_, "Upgrade a lock which is not held.");
+  requests.erase(it);
+  txn->GetSharedLockSet()->erase(rid);
+  auto pos = std::find_if(requests.begin(), requests.end(), [](const LockRequest &request) { return !request.granted_; });
+  requests.emplace(pos, txn, LockMode::kExclusive);
+  queue.upgrading_ = true;
+  bool granted = WaitForGrant(guard, queue, txn, LockMode::kExclusive);
+  queue.upgrading_ = false;
+  if (!granted) {
+    return false;
+  }
+  txn->GetExclusiveLockSet()->emplace(rid);
+  return true;
+}
+
+bool LockManager::Unlock(Transaction *txn, const RowId &rid) {
+  bool shared = txn->GetSharedLockSet()->erase(rid) != 0;
+  bool exclusive = txn->GetExclusiveLockSet()->erase(rid) != 0;
+  if (!shared && !exclusive) {
+    return false;
+  }
+  {
+    auto &shard = GetShard(rid);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto it = shard.lock_table_.find(rid);
+    if (it != shard.lock_table_.end()) {
+      RemoveRequest(it->second, txn);
+      if (it->second.request_queue_.empty()) {
+        shard.lock_table_.erase(it);
+      }
+    }
+  }
+  if (txn->GetState() == TxnState::kGrowing &&
+      !(shared && txn->GetIsolationLevel() == IsolationLevel::kReadCommitted)) {
+    txn->SetState(TxnState::kShrinking);
+  }
+  return true;
+}
+
+void LockManager::UnlockAll(Transaction *txn) {
+  std::vector<RowId> rids(txn->GetSharedLockSet()->begin(), txn->GetSharedLockSet()->end());
+  rids.insert(rids.end(), txn->GetExclusiveLockSet()->begin(), txn->GetExclusiveLockSet()->end());
+  for (const auto &rid : rids) {
+    Unlock(txn, rid);
+  }
+}
+
+void LockManager::BuildWaitsForGraph(
+    WaitsForGraph *graph, std::unordered_map<txn_id_t, std::pair<Transaction *, LockRequestQueue *>> *waiting) {
+  for (auto &shard : shards_) {
+    for (auto &entry : shard.lock_table_) {
+      auto &queue = entry.second;
+      for (auto it = queue.request_queue_.begin(); it != queue.request_queue_.end(); ++it) {
+        if (it->granted_ || it->txn_->GetState() == TxnState::kAborted) {
+          continue;
+        }
+        auto waiter = it->txn_->GetTxnId();
+        waiting->emplace(waiter, std::make_pair(it->txn_, &queue));
+        // The waiter waits for every holder ahead of it and every conflicting request queued before it.
+        for (auto ahead = queue.request_queue_.begin(); ahead != it; ++ahead) {
+          if (ahead->txn_ == it->txn_ || ahead->txn_->GetState() == TxnState::kAborted) {
+            continue;
+          }
+          if (ahead->granted_ || ahead->mode_ == LockMode::kExclusive || it->mode_ == LockMode::kExclusive) {
+            (*graph)[waiter].insert(ahead->txn_->GetTxnId());
+          }
+        }
+      }
+    }
+  }
+}
+
+bool LockManager::FindCycle(const WaitsForGraph &graph, txn_id_t *victim) {
+  // 0: unvisited, 1: on the dfs stack, 2: done
+  std::unordered_map<txn_id_t, int> color;
+  std::vector<txn_id_t> path;
+  std::function<bool(txn_id_t)> dfs = [&](txn_id_t u) -> bool {
+    color[u] = 1;
+    path.push_back(u);
+    auto it = graph.find(u);
+    if (it != graph.end()) {
+      for (auto v : it->second) {
+        if (color[v] == 1) {
+          *victim = *std::max_element(std::find(path.begin(), path.end(), v), path.end());
+          return true;
+        }
+        if (color[v] == 0 && dfs(v)) {
+          return true;
+        }
+      }
+    }
+    color[u] = 2;
+    path.pop_back();
+    return false;
+  };
+  for (const auto &entry : graph) {
+    if (color[entry.first] == 0 && dfs(entry.first)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t LockManager::RunCycleDetectionOnce() {
+  std::vector<std::unique_lock<std::mutex>> guards;
+  guards.reserve(kNumShards);
+  for (auto &shard : shards_) {
+    guards.emplace_back(shard.latch_);
+  }
+  WaitsForGraph graph;
+  std::unordered_map<txn_id_t, std::pair<Transaction *, LockRequestQueue *>> waiting;
+  BuildWaitsForGraph(&graph, &waiting);
+  size_t aborted = 0;
+  txn_id_t victim;
+  while (FindCycle(graph, &victim)) {
+    // Only a waiting transaction can be on a cycle, so the victim is always found in waiting.
+    auto &target = waiting.at(victim);
+    target.first->SetAborted(AbortReason::kDeadlock);
+    target.second->cv_.notify_all();
+    graph.erase(victim);
+    for (auto &edges : graph) {
+      edges.second.erase(victim);
+    }
+    aborted++;
+  }
+  return aborted;
+}
+
+std::vector<std::pair<txn_id_t, txn_id_t>> LockManager::GetEdgeList() {
+  std::vector<std::unique_lock<std::mutex>> guards;
+  guards.reserve(kNumShards);
+  for (auto &shard : shards_) {
+    guards.emplace_back(shard.latch_);
+  }
+  WaitsForGraph graph;
+  std::unordered_map<txn_id_t, std::pair<Transaction *, LockRequestQueue *>> waiting;
+  BuildWaitsForGraph(&graph, &waiting);
+  std::vector<std::pair<txn_id_t, txn_id_t>> edges;
+  for (const auto &entry : graph) {
+    for (auto to : entry.second) {
+      edges.emplace_back(entry.first, to);
+    }
+  }
+  return edges;
+}
+
+void LockManager::RunCycleDetection() {
+  std::unique_lock<std::mutex> guard(detection_latch_);
+  while (enable_cycle_detection_) {
+    detection_cv_.wait_for(guard, cycle_detection_interval_, [this] { return !enable_cycle_detection_; });
+    if (!enable_cycle_detection_) {
+      break;
+    }
+    guard.unlock();
+    RunCycleDetectionOnce();
+    guard.lock();
+  }
+}
@@ -0,0 +1,161 @@
+#include "transaction/txn_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "index/index.h"
+#include "storage/table_heap.h"
+
+TxnManager::TxnManager(LockManager *lock_manager, VersionStore *version_store, LogManager *log_manager,
+                       std::chrono::milliseconds gc_interval)
+    : lock_manager_(lock_manager), version_store_(version_store), log_manager_(log_manager), gc_interval_(gc_interval) {
+  if (version_store_ != nullptr) {
+    enable_gc_ = true;
+    gc_thread_ = std::thread(&TxnManager::RunGarbageCollection, this);
+  }
+}
+
+TxnManager::~TxnManager() {
+  {
+    std::lock_guard<std::mutex> guard(gc_latch_);
+    enable_gc_ = false;
+  }
+  gc_cv_.notify_all();
+  if (gc_thread_.joinable()) {
+    gc_thread_.join();
+  }
+  std::vector<Transaction *> running;
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    for (auto &entry : txn_map_) {
+      running.push_back(entry.second);
+    }
+  }
+  for (auto txn : running) {
+    Abort(txn);
+  }
+}
+
+Transaction *TxnManager::Begin(IsolationLevel isolation_level) {
+  auto txn = new Transaction(next_txn_id_++, isolation_level);
+  // The snapshot is registered before the commit latch is released so that the garbage collection
+  // never misses it when computing the watermark.
+  std::lock_guard<std::mutex> commit_guard(commit_latch_);
+  txn->SetReadTs(last_commit_ts_);
+  std::lock_guard<std::mutex> guard(latch_);
+  txn_map_.emplace(txn->GetTxnId(), txn);
+  return txn;
+}
+
+void TxnManager::Commit(Transaction *txn) {
+  txn->SetState(TxnState::kCommitted);
+  if (version_store_ != nullptr) {
+    // Deleted tuples are freed by the garbage collection once no snapshot sees them.
+    {
+      std::lock_guard<std::mutex> commit_guard(commit_latch_);
+      txn->SetCommitTs(last_commit_ts_ + 1);
+      version_store_->Commit(txn, txn->GetCommitTs());
+      last_commit_ts_ = txn->GetCommitTs();
+    }
+    TrimUpdates(txn);
+    lock_manager_->UnlockAll(txn);
+    Release(txn);
+    return;
+  }
+  for (auto &record : *txn->GetTableWriteSet()) {
+    if (record.wtype_ == WType::kDelete) {
+      record.table_heap_->ApplyDelete(record.rid_, txn);
+      // The slot can be reused by an insert as soon as it is freed, which locks the new row while
+      // holding the page latch, so the lock must not outlive the tuple.
+      lock_manager_->Unlock(txn, record.rid_);
+    }
+  }
+  TrimUpdates(txn);
+  lock_manager_->UnlockAll(txn);
+  Release(txn);
+}
+
+void TxnManager::Abort(Transaction *txn) {
+  txn->SetState(TxnState::kAborted);
+  auto table_write_set = txn->GetTableWriteSet();
+  for (auto it = table_write_set->rbegin(); it != table_write_set->rend(); ++it) {
+    switch (it->wtype_) {
+      case WType::kInsert:
+        it->table_heap_->ApplyDelete(it->rid_, txn);
+        lock_manager_->Unlock(txn, it->rid_);
+        break;
+      case WType::kDelete:
+        it->table_heap_->RollbackDelete(it->rid_, txn);
+        break;
+      case WType::kUpdate:
+        // in place, an update which relocated the tuple was recorded as a delete and an insert
+        it->table_heap_->RollbackUpdate(it->row_, it->rid_, txn);
+        break;
+    }
+  }
+  TrimUpdates(txn);
+  if (version_store_ != nullptr) {
+    version_store_->Abort(txn);
+  }
+  auto index_write_set = txn->GetIndexWriteSet();
+  for (auto it = index_write_set->rbegin(); it != index_write_set->rend(); ++it) {
+    if (it->wtype_ == WType::kInsert) {
+      it->index_->RemoveEntry(it->key_, it->rid_, nullptr);
+    } else if (it->wtype_ == WType::kDelete) {
+      it->index_->InsertEntry(it->key_, it->rid_, nullptr);
+    }
+  }
+  lock_manager_->UnlockAll(txn);
+  Release(txn);
+}
+
+void TxnManager::TrimUpdates(Transaction *txn) {
+  for (auto &record : *txn->GetTableWriteSet()) {
+    if (record.wtype_ == WType::kUpdate) {
+      record.table_heap_->TrimTuple(record.rid_);
+    }
+  }
+}
+
+size_t TxnManager::GetActiveTxnCount() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return txn_map_.size();
+}
+
+void TxnManager::Release(Transaction *txn) {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    txn_map_.erase(txn->GetTxnId());
+  }
+  delete txn;
+}
+
+timestamp_t TxnManager::GetWatermark() {
+  std::lock_guard<std::mutex> commit_guard(commit_latch_);
+  std::lock_guard<std::mutex> guard(latch_);
+  timestamp_t watermark = last_commit_ts_;
+  for (auto &entry : txn_map_) {
+    watermark = std::min(watermark, entry.second->GetReadTs());
+  }
+  return watermark;
+}
+
+size_t TxnManager::GarbageCollect() {
+  if (version_store_ == nullptr) {
+    return 0;
+  }
+  return version_store_->GarbageCollect(GetWatermark());
+}
+
+void TxnManager::RunGarbageCollection() {
+  std::unique_lock<std::mutex> guard(gc_latch_);
+  while (enable_gc_) {
+    gc_cv_.wait_for(guard, gc_interval_, [this] { return !enable_gc_; });
+    if (!enable_gc_) {
+      break;
+    }
+    guard.unlock();
+    GarbageCollect();
+    guard.lock();
+  }
+}
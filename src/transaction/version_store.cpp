@@ -0,0 +1,237 @@
+#include "transaction/version_store.h"
+
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "storage/table_heap.h"
+
+bool VersionStore::CheckWrite(const RowId &rid, Transaction *txn) {
+  if (!txn->IsSnapshotRead()) {
+    return true;
+  }
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto it = shard.chains_.find(rid);
+  if (it == shard.chains_.end() || it->second.writer_ == txn->GetTxnId()) {
+    return true;
+  }
+  if (it->second.writer_ == INVALID_TXN_ID && it->second.ts_ > txn->GetReadTs()) {
+    txn->SetAborted(AbortReason::kWriteConflict);
+    return false;
+  }
+  return true;
+}
+
+void VersionStore::RecordInsert(const RowId &rid, Transaction *txn, TableHeap *table_heap) {
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  // The slot may have held a tuple freed by the garbage collection, its chain is gone by now.
+  auto inserted = shard.chains_.insert_or_assign(rid, VersionChain(table_heap));
+  if (inserted.second) {
+    chain_count_.fetch_add(1, std::memory_order_release);
+  }
+  auto &chain = inserted.first->second;
+  chain.writer_ = txn->GetTxnId();
+  chain.undo_.emplace_front(Row(rid), 0, true);
+}
+
+void VersionStore::RecordWrite(const RowId &rid, Transaction *txn, const Row &prior, bool is_delete,
+                               TableHeap *table_heap) {
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto inserted = shard.chains_.try_emplace(rid, table_heap);
+  if (inserted.second) {
+    chain_count_.fetch_add(1, std::memory_order_release);
+  }
+  auto &chain = inserted.first->second;
+  // Only the last committed version is needed, the intermediate ones of txn are never visible to others.
+  if (chain.writer_ != txn->GetTxnId()) {
+    chain.undo_.emplace_front(prior, chain.ts_, false);
+    chain.writer_ = txn->GetTxnId();
+  }
+  chain.deleted_ = is_delete;
+}
+
+void VersionStore::Remove(const RowId &rid) {
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto it = shard.chains_.find(rid);
+  if (it != shard.chains_.end()) {
+    EraseChain(shard, it);
+  }
+}
+
+bool VersionStore::GetVisible(Row *row, bool exists, Transaction *txn, bool *older) {
+  if (older != nullptr) {
+    *older = false;
+  }
+  // A chain of this tuple is made under the latch of its page, which the caller holds.
+  if (chain_count_.load(std::memory_order_acquire) == 0) {
+    return exists;
+  }
+  auto &shard = GetShard(row->GetRowId());
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  auto it = shard.chains_.find(row->GetRowId());
+  if (it == shard.chains_.end()) {
+    return exists;
+  }
+  auto &chain = it->second;
+  if (chain.writer_ == txn->GetTxnId() || (chain.writer_ == INVALID_TXN_ID && chain.ts_ <= txn->GetReadTs())) {
+    return exists;
+  }
+  for (auto &version : chain.undo_) {
+    if (version.ts_ <= txn->GetReadTs()) {
+      if (version.deleted_) {
+        return false;
+      }
+      RowId rid = row->GetRowId();
+      *row = version.row_;
+      row->SetRowId(rid);
+      if (older != nullptr) {
+        *older = true;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool VersionStore::HasChain(const RowId &rid) {
+  if (chain_count_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  auto &shard = GetShard(rid);
+  std::lock_guard<std::mutex> guard(shard.latch_);
+  return shard.chains_.count(rid) != 0;
+}
+
+void VersionStore::Commit(Transaction *txn, timestamp_t commit_ts) {
+  for (auto &record : *txn->GetTableWriteSet()) {
+    auto &shard = GetShard(record.rid_);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto it = shard.chains_.find(record.rid_);
+    if (it != shard.chains_.end() && it->second.writer_ == txn->GetTxnId()) {
+      it->second.writer_ = INVALID_TXN_ID;
+      it->second.ts_ = commit_ts;
+    }
+  }
+}
+
+void VersionStore::Abort(Transaction *txn) {
+  std::unordered_set<RowId> rolled_back;
+  for (auto &record : *txn->GetTableWriteSet()) {
+    if (!rolled_back.insert(record.rid_).second) {
+      continue;
+    }
+    auto &shard = GetShard(record.rid_);
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    auto it = shard.chains_.find(record.rid_);
+    // A chain of an aborted insert is removed together with the tuple.
+    if (it == shard.chains_.end() || it->second.writer_ != txn->GetTxnId()) {
+      continue;
+    }
+    auto &chain = it->second;
+    chain.writer_ = INVALID_TXN_ID;
+    chain.ts_ = chain.undo_.front().ts_;
+    chain.deleted_ = false;
+    chain.undo_.pop_front();
+    if (chain.undo_.empty() && chain.ts_ == 0) {
+      EraseChain(shard, it);
+    }
+  }
+}
+
+size_t VersionStore::GarbageCollect(timestamp_t watermark) {
+  std::lock_guard<std::mutex> gc_guard(gc_latch_);
+  size_t reclaimed = 0;
+  std::vector<Reclaim> reclaims;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    for (auto it = shard.chains_.begin(); it != shard.chains_.end();) {
+      auto &chain = it->second;
+      bool indexed = chain.table_heap_->HasIndexes();
+      if (chain.writer_ == INVALID_TXN_ID && chain.ts_ <= watermark) {
+        // Every snapshot sees the newest version.
+        reclaimed += chain.undo_.size();
+        std::vector<Row> dropped;
+        if (indexed) {
+          CopyImages(chain.undo_.begin(), chain.undo_.end(), &dropped);
+        }
+        if (chain.deleted_ || !dropped.empty()) {
+          reclaims.emplace_back(chain.table_heap_, it->first, chain.deleted_);
+          reclaims.back().dropped_ = std::move(dropped);
+        }
+        it = EraseChain(shard, it);
+        continue;
+      }
+      // Keep the versions down to the first one visible at the watermark.
+      auto keep = chain.undo_.begin();
+      while (keep != chain.undo_.end() && keep->ts_ > watermark) {
+        ++keep;
+      }
+      if (keep != chain.undo_.end() && keep + 1 != chain.undo_.end()) {
+        reclaimed += chain.undo_.end() - keep - 1;
+        std::vector<Row> dropped;
+        if (indexed) {
+          CopyImages(keep + 1, chain.undo_.end(), &dropped);
+        }
+        if (!dropped.empty()) {
+          reclaims.emplace_back(chain.table_heap_, it->first, false);
+          reclaims.back().dropped_ = std::move(dropped);
+          CopyImages(chain.undo_.begin(), keep + 1, &reclaims.back().kept_);
+        }
+        chain.undo_.erase(keep + 1, chain.undo_.end());
+      }
+      ++it;
+    }
+  }
+  // The dropped versions are invisible to everyone now, nobody can write a deleted tuple either, so their index
+  // entries and the slots of deleted tuples are reclaimed outside of the shard latches, which must not be held
+  // while latching a page.
+  for (auto &reclaim : reclaims) {
+    reclaim.table_heap_->ReclaimVersions(reclaim.rid_, reclaim.dropped_, reclaim.kept_, reclaim.deleted_);
+  }
+  return reclaimed;
+}
+
+void VersionStore::CopyImages(std::deque<UndoVersion>::const_iterator begin,
+                              std::deque<UndoVersion>::const_iterator end, std::vector<Row> *rows) {
+  for (auto it = begin; it != end; ++it) {
+    // the version before an insert has no image
+    if (!it->deleted_) {
+      rows->push_back(it->row_);
+    }
+  }
+}
+
+void VersionStore::RemoveTable(TableHeap *table_heap) {
+  std::lock_guard<std::mutex> gc_guard(gc_latch_);
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    for (auto it = shard.chains_.begin(); it != shard.chains_.end();) {
+      if (it->second.table_heap_ == table_heap) {
+        it = EraseChain(shard, it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+size_t VersionStore::GetVersionCount() {
+  size_t count = 0;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard.latch_);
+    for (auto &entry : shard.chains_) {
+      count += entry.second.undo_.size();
+    }
+  }
+  return count;
+}
+
+std::unordered_map<RowId, VersionStore::VersionChain>::iterator VersionStore::EraseChain(
+    ChainShard &shard, std::unordered_map<RowId, VersionChain>::iterator it) {
+  chain_count_.fetch_sub(1, std::memory_order_release);
+  return shard.chains_.erase(it);
+}
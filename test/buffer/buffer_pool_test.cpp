@@ -0,0 +1,193 @@
+#include "buffer/buffer_pool.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+TEST(BufferPoolTest, SharedPoolTest) {
+  const std::string db_names[2] = {"bp_test_0.db", "bp_test_1.db"};
+  const size_t buffer_pool_size = 8;
+
+  BufferPool pool(buffer_pool_size);
+  DiskManager *disk_managers[2];
+  BufferPoolManager *bpms[2];
+  for (int i = 0; i < 2; i++) {
+    remove(db_names[i].c_str());
+    disk_managers[i] = new DiskManager(db_names[i]);
+    bpms[i] = new BufferPoolManager(&pool, disk_managers[i]);
+  }
+  ASSERT_EQ(2, pool.GetFileCount());
+
+  // Scenario: both files get page 0, the pages are told apart by file.
+  page_id_t page_ids[2];
+  for (int i = 0; i < 2; i++) {
+    auto page = bpms[i]->NewPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, page_ids[i]);
+    snprintf(page->GetData(), PAGE_SIZE, "file %d", i);
+    bpms[i]->UnpinPage(page_ids[i], true);
+  }
+
+  // Scenario: the frames are shared, pages of the second file evict the dirty page of the first.
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; i++) {
+    ASSERT_NE(nullptr, bpms[1]->NewPage(page_id));
+    bpms[1]->UnpinPage(page_id, false);
+  }
+  EXPECT_EQ(buffer_pool_size, pool.GetPageCount());
+  for (int i = 0; i < 2; i++) {
+    auto page = bpms[i]->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("file " + std::to_string(i), std::string(page->GetData()));
+    bpms[i]->UnpinPage(0, false);
+  }
+
+  // Scenario: once a file is closed its frames go back to the pool.
+  delete bpms[1];
+  delete disk_managers[1];
+  EXPECT_EQ(1, pool.GetFileCount());
+  EXPECT_EQ(1, pool.GetPageCount());
+
+  delete bpms[0];
+  delete disk_managers[0];
+  EXPECT_EQ(0, pool.GetPageCount());
+  for (auto &db_name : db_names) {
+    remove(db_name.c_str());
+  }
+}
+
+TEST(BufferPoolTest, BulkReadRingTest) {
+  const std::string db_name = "bp_ring_test.db";
+  const size_t buffer_pool_size = 64;
+  const page_id_t hot_pages = 16;
+  const page_id_t table_pages = 256;
+
+  remove(db_name.c_str());
+  BufferPool pool(buffer_pool_size);
+  auto disk_manager = new DiskManager(db_name);
+  auto bpm = new BufferPoolManager(&pool, disk_manager);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < table_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(page_id));
+    ASSERT_EQ(i, page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+  auto touch_hot_pages = [&]() {
+    for (page_id_t i = 0; i < hot_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      bpm->UnpinPage(i, false);
+    }
+  };
+  touch_hot_pages();
+
+  // Scenario: a scan through a ring reads the whole file but keeps the hot pages cached.
+  {
+    BufferAccessStrategy strategy;
+    BufferAccessScope scope(&strategy);
+    for (page_id_t i = hot_pages; i < table_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      bpm->UnpinPage(i, false);
+    }
+  }
+  EXPECT_LT(0, pool.GetCounters().ring_reuses_);
+  BufferPoolStats start = BufferPool::GetThreadStats();
+  touch_hot_pages();
+  EXPECT_EQ(0, (BufferPool::GetThreadStats() - start).misses_);
+
+  // Scenario: the same scan without a ring flushes them.
+  for (page_id_t i = hot_pages; i < table_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  start = BufferPool::GetThreadStats();
+  touch_hot_pages();
+  EXPECT_EQ(hot_pages, (BufferPool::GetThreadStats() - start).misses_);
+
+  // Scenario: with the whole pool hot a scan through a ring pushes out no more pages than the ring holds.
+  const page_id_t ring_size = buffer_pool_size / 8;
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  {
+    BufferAccessStrategy strategy;
+    BufferAccessScope scope(&strategy);
+    for (page_id_t i = buffer_pool_size; i < table_pages; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      bpm->UnpinPage(i, false);
+    }
+  }
+  start = BufferPool::GetThreadStats();
+  for (page_id_t i = ring_size; i < static_cast<page_id_t>(buffer_pool_size); i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  EXPECT_EQ(0, (BufferPool::GetThreadStats() - start).misses_);
+
+  delete bpm;
+  delete disk_manager;
+  remove(db_name.c_str());
+}
+
+TEST(BufferPoolTest, ConcurrentFetchTest) {
+  const std::string db_name = "bp_concurrent_test.db";
+  const size_t buffer_pool_size = 8;
+  const page_id_t file_pages = 64;
+  const int thread_count = 4;
+
+  remove(db_name.c_str());
+  BufferPool pool(buffer_pool_size);
+  auto disk_manager = new DiskManager(db_name);
+  auto bpm = new BufferPoolManager(&pool, disk_manager);
+  page_id_t page_id;
+  for (page_id_t i = 0; i < file_pages; i++) {
+    auto page = bpm->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id);
+    bpm->UnpinPage(page_id, true);
+  }
+
+  // Scenario: the pages are read and written back while other threads hit and miss on the same pages, each
+  // fetch sees the page it asked for.
+  std::vector<std::thread> threads;
+  std::vector<int> wrong(thread_count, 0);
+  for (int t = 0; t < thread_count; t++) {
+    threads.emplace_back([&, t]() {
+      for (int round = 0; round < 200; round++) {
+        page_id_t id = (round * 7 + t * 13) % file_pages;
+        auto page = bpm->FetchPage(id);
+        if (page == nullptr) {
+          continue;
+        }
+        wrong[t] += std::string(page->GetData()) != "page " + std::to_string(id);
+        bpm->UnpinPage(id, round % 3 == 0);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int t = 0; t < thread_count; t++) {
+    EXPECT_EQ(0, wrong[t]);
+  }
+  EXPECT_TRUE(bpm->CheckAllUnpinned());
+  EXPECT_EQ(buffer_pool_size, pool.GetPageCount());
+
+  // Scenario: only the dirty pages are written back when the file is closed.
+  for (page_id_t i = 0; i < file_pages; i++) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    bpm->UnpinPage(i, false);
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(file_pages - 1));
+  bpm->UnpinPage(file_pages - 1, true);
+  auto writes = DiskManager::GetIoCounters().writes_.load();
+  delete bpm;
+  EXPECT_EQ(writes + 1, DiskManager::GetIoCounters().writes_.load());
+  delete disk_manager;
+  remove(db_name.c_str());
+}
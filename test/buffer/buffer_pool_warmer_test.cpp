@@ -0,0 +1,67 @@
+#include "buffer/buffer_pool_warmer.h"
+
+#include <cstdio>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(BufferPoolWarmerTest, WarmUpTest) {
+  const std::string db_name = "bp_warmer_test.db";
+  const std::string manifest = "bp_warmer_test.hot";
+  const page_id_t table_pages = 200;
+  remove(db_name.c_str());
+  remove(manifest.c_str());
+
+  // Scenario: the pages used last are listed first when the warmer goes away.
+  {
+    auto disk_manager = new DiskManager(db_name);
+    auto bpm = new BufferPoolManager(64, disk_manager);
+    auto warmer = new BufferPoolWarmer(bpm, manifest, false);
+    page_id_t page_id;
+    for (page_id_t i = 0; i < table_pages; i++) {
+      ASSERT_NE(nullptr, bpm->NewPage(page_id));
+      snprintf(bpm->FetchPage(page_id)->GetData(), PAGE_SIZE, "page %d", page_id);
+      bpm->UnpinPage(page_id, true);
+      bpm->UnpinPage(page_id, true);
+    }
+    for (page_id_t i = 100; i < 110; i++) {
+      ASSERT_NE(nullptr, bpm->FetchPage(i));
+      bpm->UnpinPage(i, false);
+    }
+    delete warmer;
+    delete bpm;
+    delete disk_manager;
+  }
+  std::vector<page_id_t> page_ids;
+  ASSERT_TRUE(BufferPoolWarmer::ReadManifest(manifest, &page_ids));
+  ASSERT_EQ(64, page_ids.size());
+  std::set<page_id_t> hottest(page_ids.begin(), page_ids.begin() + 10);
+  for (page_id_t i = 100; i < 110; i++) {
+    EXPECT_EQ(1, hottest.count(i));
+  }
+
+  // Scenario: reopened with a smaller pool, the hottest pages are read back before they are asked for.
+  {
+    auto disk_manager = new DiskManager(db_name);
+    auto bpm = new BufferPoolManager(16, disk_manager);
+    auto warmer = new BufferPoolWarmer(bpm, manifest, true);
+    warmer->WaitForWarmUp();
+    EXPECT_EQ(16, warmer->GetPagesWarmed());
+    EXPECT_EQ(0, bpm->GetFreeFrameCount());
+    BufferPoolStats start = BufferPool::GetThreadStats();
+    for (page_id_t i = 100; i < 110; i++) {
+      auto page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      bpm->UnpinPage(i, false);
+    }
+    EXPECT_EQ(0, (BufferPool::GetThreadStats() - start).misses_);
+    delete warmer;
+    delete bpm;
+    delete disk_manager;
+  }
+  remove(db_name.c_str());
+  remove(manifest.c_str());
+}
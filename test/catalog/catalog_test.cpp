@@ -125,4 +125,87 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+
+TEST(CatalogTest, CatalogLazyLoadTest) {
+  /** Stage 1: Enough tables for the catalog meta data to span several pages */
+  const int table_nums = 600;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  for (int i = 0; i < table_nums; i++) {
+    TableInfo *table_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-" + std::to_string(i), schema.get(), &txn, table_info));
+    IndexInfo *index_info = nullptr;
+    ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-" + std::to_string(i), "index-" + std::to_string(i), {"id"},
+                                                  &txn, index_info, "bptree"));
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->DropTable("table-0"));
+  delete db_01;
+  /** Stage 2: Nothing is loaded until asked for */
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  auto &catalog_02 = db_02->catalog_mgr_;
+  ASSERT_EQ(0, catalog_02->GetLoadedTableCount());
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetIndex("table-300", "index-300", index_info));
+  ASSERT_EQ("table-300", index_info->GetTableInfo()->GetTableName());
+  ASSERT_EQ(1, catalog_02->GetLoadedTableCount());
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_02->GetTable("table-0", table_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTable("table-599", table_info));
+  ASSERT_EQ("table-599", table_info->GetTableName());
+  // A table created after reopening gets an id of its own.
+  ASSERT_EQ(DB_SUCCESS, catalog_02->CreateTable("table-new", schema.get(), &txn, table_info));
+  ASSERT_EQ(table_nums, table_info->GetTableId());
+  std::vector<TableInfo *> tables;
+  ASSERT_EQ(DB_SUCCESS, catalog_02->GetTables(tables));
+  ASSERT_EQ(table_nums, tables.size());
+  delete db_02;
+}
+
+TEST(CatalogTest, CatalogUpgradeTest) {
+  /** Stage 1: Write the catalog meta data of a database in the single page layout, which has no names */
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-0", schema.get(), &txn, table_info));
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-0", "index-0", {"id"}, &txn, index_info, "bptree"));
+  delete db_01;
+  auto disk_manager = new DiskManager("./databases/" + db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_manager);
+  char *buf = bpm->FetchPage(CATALOG_META_PAGE_ID)->GetData();
+  CatalogMeta *meta = CatalogMeta::DeserializeFrom(buf + sizeof(page_id_t));
+  memset(buf, 0, PAGE_SIZE);
+  MACH_WRITE_UINT32(buf, 89849);
+  MACH_WRITE_UINT32(buf + 4, meta->GetTableMetaPages()->size());
+  MACH_WRITE_UINT32(buf + 8, meta->GetIndexMetaPages()->size());
+  char *pos = buf + 12;
+  for (auto &it : *meta->GetTableMetaPages()) {
+    MACH_WRITE_TO(table_id_t, pos, it.first);
+    MACH_WRITE_TO(page_id_t, pos + 4, it.second);
+    pos += 8;
+  }
+  for (auto &it : *meta->GetIndexMetaPages()) {
+    MACH_WRITE_TO(index_id_t, pos, it.first);
+    MACH_WRITE_TO(page_id_t, pos + 4, it.second);
+    pos += 8;
+  }
+  delete meta;
+  bpm->UnpinPage(CATALOG_META_PAGE_ID, true);
+  delete bpm;
+  disk_manager->Close();
+  delete disk_manager;
+  /** Stage 2: The names are read from the meta pages, and the meta data is chained when the database is closed */
+  for (int i = 0; i < 2; i++) {
+    auto db_02 = new DBStorageEngine(db_file_name, false);
+    ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-0", table_info));
+    ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-0", "index-0", index_info));
+    ASSERT_EQ("index-0", index_info->GetIndexName());
+    delete db_02;
+  }
+}
@@ -0,0 +1,59 @@
+#include "common/metrics.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+TEST(MetricsTest, LatencyHistogramTest) {
+  LatencyHistogram histogram;
+  ASSERT_EQ(0, histogram.GetQuantile(0.99));
+  // Up to 8 us a bucket holds one value, above that a power of two is split into 8 buckets.
+  ASSERT_EQ(8, LatencyHistogram::GetBucketBound(LatencyHistogram::GetBucketIndex(8)));
+  ASSERT_EQ(9, LatencyHistogram::GetBucketBound(LatencyHistogram::GetBucketIndex(9)));
+  ASSERT_EQ(18, LatencyHistogram::GetBucketBound(LatencyHistogram::GetBucketIndex(17)));
+  ASSERT_EQ(1152, LatencyHistogram::GetBucketBound(LatencyHistogram::GetBucketIndex(1025)));
+  ASSERT_EQ(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::GetBucketIndex(uint64_t{1} << 28));
+
+  histogram.Record(std::chrono::nanoseconds(500));
+  histogram.Record(std::chrono::microseconds(1));
+  histogram.Record(std::chrono::microseconds(3));
+  histogram.Record(std::chrono::microseconds(4));
+  histogram.Record(std::chrono::hours(1));
+  ASSERT_EQ(5, histogram.GetCount());
+  ASSERT_EQ(2, histogram.GetBucketCount(1));
+  ASSERT_EQ(1, histogram.GetBucketCount(LatencyHistogram::BUCKET_COUNT - 1));
+  ASSERT_EQ(std::chrono::nanoseconds(std::chrono::hours(1)).count(), histogram.GetMaxNanos());
+  ASSERT_EQ(1, histogram.GetQuantile(0.4));
+  ASSERT_EQ(3, histogram.GetQuantile(0.6));
+  ASSERT_EQ(4, histogram.GetQuantile(0.8));
+
+  std::stringstream out;
+  histogram.WritePrometheus(out, "latency_seconds", "Latency.");
+  std::string text = out.str();
+  ASSERT_NE(std::string::npos, text.find("# TYPE latency_seconds histogram\n"));
+  ASSERT_NE(std::string::npos, text.find("latency_seconds_bucket{le=\"1e-06\"} 2\n"));
+  ASSERT_NE(std::string::npos, text.find("latency_seconds_bucket{le=\"4e-06\"} 4\n"));
+  ASSERT_NE(std::string::npos, text.find("latency_seconds_bucket{le=\"+Inf\"} 5\n"));
+  ASSERT_NE(std::string::npos, text.find("latency_seconds_count 5\n"));
+}
+
+TEST(MetricsTest, MetricsFileWriterTest) {
+  const std::string path = "metrics_test.prom";
+  remove(path.c_str());
+  uint64_t value = 1;
+  {
+    MetricsFileWriter writer(path, std::chrono::hours(1), [&value](std::ostream &out) {
+      WritePrometheusMetric(out, "value_total", "counter", "A value.", value);
+    });
+    ASSERT_TRUE(writer.WriteFile());
+    value = 12345678;
+  }
+  // The file is written once more when the writer goes away.
+  std::ifstream in(path);
+  std::stringstream text;
+  text << in.rdbuf();
+  ASSERT_EQ("# HELP value_total A value.\n# TYPE value_total counter\nvalue_total 12345678\n", text.str());
+  remove(path.c_str());
+}
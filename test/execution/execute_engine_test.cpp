@@ -0,0 +1,180 @@
+#include "executor/execute_engine.h"
+
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "parser/parsed_statement.h"
+
+/** Run one statement in session, @return what it wrote */
+static std::string RunSql(ExecuteEngine *engine, Session *session, const std::string &sql) {
+  std::ostringstream out;
+  session->SetOut(out);
+  auto statement = ParsedStatement::Parse(sql);
+  EXPECT_FALSE(statement->HasError()) << sql;
+  engine->ExecuteInformation(engine->Execute(*statement, session), session);
+  return out.str();
+}
+
+TEST(ExecuteEngineTest, DropDatabaseInUseTest) {
+  ExecuteEngine engine;
+  Session owner;
+  Session other;
+  RunSql(&engine, &owner, "drop database engine_test_db;");
+  RunSql(&engine, &owner, "create database engine_test_db;");
+  RunSql(&engine, &owner, "use engine_test_db;");
+  RunSql(&engine, &owner, "create table t(id int);");
+  RunSql(&engine, &other, "use engine_test_db;");
+  RunSql(&engine, &owner, "begin;");
+  RunSql(&engine, &owner, "insert into t values(1);");
+
+  // A failed drop leaves the session in its database and its transaction running.
+  ASSERT_NE(std::string::npos, RunSql(&engine, &owner, "drop database engine_test_db;").find("is in use"));
+  ASSERT_EQ("engine_test_db", owner.current_db_);
+  ASSERT_NE(nullptr, owner.current_txn_);
+  RunSql(&engine, &owner, "commit;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &other, "select * from t;").find("1 row in set"));
+
+  engine.CloseSession(&other);
+  RunSql(&engine, &owner, "begin;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &owner, "drop database engine_test_db;").find("Drop database success"));
+  ASSERT_TRUE(owner.current_db_.empty());
+  ASSERT_EQ(nullptr, owner.current_txn_);
+  engine.CloseSession(&owner);
+}
+
+TEST(ExecuteEngineTest, CreateIndexOnPrimaryKeyTest) {
+  {
+    ExecuteEngine engine;
+    Session session;
+    // left over by a failed run
+    RunSql(&engine, &session, "drop database engine_pk_db;");
+    RunSql(&engine, &session, "create database engine_pk_db;");
+    RunSql(&engine, &session, "use engine_pk_db;");
+    ASSERT_NE(std::string::npos,
+              RunSql(&engine, &session, "create table t(id int, v int, primary key(id));").find("Create table success"));
+    // The primary key is unique without a unique constraint of its own, other columns are not.
+    ASSERT_EQ(std::string::npos, RunSql(&engine, &session, "create index t_id on t(id);").find("not unique"));
+    ASSERT_NE(std::string::npos, RunSql(&engine, &session, "create index t_v on t(v);").find("not unique"));
+    RunSql(&engine, &session, "insert into t values(1, 2);");
+    ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t where id = 1;").find("1 row in set"));
+    engine.CloseSession(&session);
+  }
+
+  // Reopened, the catalog only knows the primary key from the column marked unique.
+  ExecuteEngine engine;
+  Session session;
+  RunSql(&engine, &session, "use engine_pk_db;");
+  RunSql(&engine, &session, "drop index t_id;");
+  ASSERT_EQ(std::string::npos, RunSql(&engine, &session, "create index t_id on t(id);").find("not unique"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "create index t_v on t(v);").find("not unique"));
+  RunSql(&engine, &session, "insert into t values(3, 4);");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t where id = 3;").find("1 row in set"));
+  RunSql(&engine, &session, "drop database engine_pk_db;");
+  engine.CloseSession(&session);
+}
+
+TEST(ExecuteEngineTest, SelectColumnsTest) {
+  ExecuteEngine engine;
+  Session session;
+  // left over by a failed run
+  RunSql(&engine, &session, "drop database engine_select_db;");
+  RunSql(&engine, &session, "create database engine_select_db;");
+  RunSql(&engine, &session, "use engine_select_db;");
+  RunSql(&engine, &session, "create table t(a int, b int, c int);");
+  RunSql(&engine, &session, "insert into t values(111, 222, 333);");
+  // The projected columns are looked up in the table schema, not by their place in the output.
+  auto out = RunSql(&engine, &session, "select a, c from t;");
+  ASSERT_NE(std::string::npos, out.find("333"));
+  ASSERT_EQ(std::string::npos, out.find("222"));
+  out = RunSql(&engine, &session, "select c from t;");
+  ASSERT_NE(std::string::npos, out.find("333"));
+  ASSERT_EQ(std::string::npos, out.find("111"));
+  RunSql(&engine, &session, "drop database engine_select_db;");
+  engine.CloseSession(&session);
+}
+
+TEST(ExecuteEngineTest, ColumnarProjectionTest) {
+  ExecuteEngine engine;
+  Session reader;
+  Session writer;
+  // left over by a failed run
+  RunSql(&engine, &reader, "drop database engine_columnar_db;");
+  RunSql(&engine, &reader, "create database engine_columnar_db;");
+  RunSql(&engine, &reader, "use engine_columnar_db;");
+  RunSql(&engine, &writer, "use engine_columnar_db;");
+  RunSql(&engine, &reader, "create table t(a int, b char(8), c int) with (layout = columnar);");
+  RunSql(&engine, &reader, R"(insert into t values(1, "one", 100), (2, "two", 200), (3, "three", 300);)");
+  // The predicate reads a column the output does not.
+  auto out = RunSql(&engine, &reader, "select b from t where c = 200;");
+  ASSERT_NE(std::string::npos, out.find("two"));
+  ASSERT_NE(std::string::npos, out.find("1 row in set"));
+  // A row updated after the snapshot was taken is read from its old version, the others from the page.
+  RunSql(&engine, &reader, "begin;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &reader, "select a from t;").find("3 row in set"));
+  RunSql(&engine, &writer, R"(update t set b = "deux" where a = 2;)");
+  for (const std::string parallelism : {"1", "4"}) {
+    RunSql(&engine, &reader, "set parallelism = " + parallelism + ";");
+    out = RunSql(&engine, &reader, "select b from t where c >= 200;");
+    ASSERT_NE(std::string::npos, out.find("two")) << parallelism;
+    ASSERT_NE(std::string::npos, out.find("three")) << parallelism;
+    ASSERT_EQ(std::string::npos, out.find("deux")) << parallelism;
+  }
+  RunSql(&engine, &reader, "commit;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &reader, "select b from t where a = 2;").find("deux"));
+  engine.CloseSession(&writer);
+  RunSql(&engine, &reader, "drop database engine_columnar_db;");
+  engine.CloseSession(&reader);
+}
+
+TEST(ExecuteEngineTest, NoDatabaseSelectedTest) {
+  ExecuteEngine engine;
+  Session session;
+  for (const std::string sql : {"drop table t;", "show indexes;", "create index t_a on t(a);", "drop index t_a;"}) {
+    ASSERT_NE(std::string::npos, RunSql(&engine, &session, sql).find("No database selected.")) << sql;
+  }
+  engine.CloseSession(&session);
+}
+
+TEST(ExecuteEngineTest, InsertDuplicateKeyTest) {
+  ExecuteEngine engine;
+  Session session;
+  RunSql(&engine, &session, "drop database engine_dup_db;");
+  RunSql(&engine, &session, "create database engine_dup_db;");
+  RunSql(&engine, &session, "use engine_dup_db;");
+  RunSql(&engine, &session, "create table t(a int, b int, primary key(a));");
+  RunSql(&engine, &session, "create index ia on t(a);");
+  RunSql(&engine, &session, "insert into t values(1, 10);");
+  // across statements
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "insert into t values(1, 20);").find("Duplicate key"));
+  // within one statement, the row inserted before the duplicate is undone as well
+  ASSERT_NE(std::string::npos,
+            RunSql(&engine, &session, "insert into t values(3, 1), (2, 1), (2, 2);").find("Duplicate key"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t;").find("1 row in set"));
+  ASSERT_EQ(std::string::npos, RunSql(&engine, &session, "select * from t where a = 2;").find("row in set"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "insert into t values(2, 1), (3, 1);").find("2 row affected"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t;").find("3 row in set"));
+  RunSql(&engine, &session, "drop database engine_dup_db;");
+  engine.CloseSession(&session);
+}
+
+TEST(ExecuteEngineTest, ParallelScanOnlyForSelectTest) {
+  ExecuteEngine engine;
+  Session session;
+  RunSql(&engine, &session, "drop database engine_parallel_db;");
+  RunSql(&engine, &session, "create database engine_parallel_db;");
+  RunSql(&engine, &session, "use engine_parallel_db;");
+  RunSql(&engine, &session, "create table t(a int, b int);");
+  RunSql(&engine, &session, "insert into t values(1, 10), (2, 20);");
+  RunSql(&engine, &session, "set parallelism = 4;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "explain select * from t;").find("Gather"));
+  // the workers take no locks, the rows an update or a delete writes are found by a serial scan
+  ASSERT_EQ(std::string::npos, RunSql(&engine, &session, "explain update t set b = 0 where a = 1;").find("Gather"));
+  ASSERT_EQ(std::string::npos, RunSql(&engine, &session, "explain delete from t;").find("Gather"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "update t set b = 0 where a = 1;").find("1 row affected"));
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t where b = 0;").find("1 row in set"));
+  RunSql(&engine, &session, "delete from t;");
+  ASSERT_NE(std::string::npos, RunSql(&engine, &session, "select * from t;").find("Empty set"));
+  RunSql(&engine, &session, "drop database engine_parallel_db;");
+  engine.CloseSession(&session);
+}
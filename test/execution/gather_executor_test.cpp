@@ -0,0 +1,90 @@
+#include "executor/executors/gather_executor.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "gather_executor_test.db";
+
+class GatherExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    db_ = new DBStorageEngine(db_name, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+    schema_ = std::make_shared<Schema>(columns);
+    TableInfo *table_info = nullptr;
+    db_->catalog_mgr_->CreateTable("t", schema_.get(), nullptr, table_info);
+    // Enough rows for a few hundred pages, whatever their size.
+    for (int i = 0; i < 20000 * (PAGE_SIZE / 4096); i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                                Field(TypeId::kTypeChar, const_cast<char *>("a row of some length"), 20, true)};
+      Row row(fields);
+      ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+    exec_ctx_ = std::make_unique<ExecuteContext>(nullptr, db_->catalog_mgr_, db_->bpm_);
+    exec_ctx_->SetParallelism(4, &pool_);
+    // SELECT id FROM t WHERE id < 15000
+    auto col_id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+    auto predicate = std::make_shared<ComparisonExpression>(
+        col_id, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 15000)), "<");
+    out_schema_ = std::make_unique<Schema>(std::vector<Column *>{new Column("id", TypeId::kTypeInt, 0, false, false)});
+    plan_ = std::make_shared<SeqScanPlanNode>(out_schema_.get(), "t", predicate);
+  }
+
+  void TearDown() override {
+    exec_ctx_.reset();
+    delete db_;
+    remove(db_name.c_str());
+  }
+
+  static int32_t GetId(const Row &row) {
+    int32_t id;
+    row.GetField(0)->SerializeTo(reinterpret_cast<char *>(&id));
+    return id;
+  }
+
+  DBStorageEngine *db_;
+  std::shared_ptr<Schema> schema_;
+  std::unique_ptr<Schema> out_schema_;
+  ThreadPool pool_{4};
+  std::unique_ptr<ExecuteContext> exec_ctx_;
+  std::shared_ptr<SeqScanPlanNode> plan_;
+};
+
+TEST_F(GatherExecutorTest, ParallelScanTest) {
+  GatherExecutor gather(exec_ctx_.get(), plan_.get());
+  gather.Init();
+  ASSERT_EQ(4, gather.GetWorkerCount());
+  std::vector<int32_t> ids;
+  Row row;
+  RowId rid;
+  while (gather.Next(&row, &rid)) {
+    ids.push_back(GetId(row));
+    ASSERT_NE(INVALID_PAGE_ID, rid.GetPageId());
+  }
+  // Every matching row comes out once, in any order.
+  std::sort(ids.begin(), ids.end());
+  ASSERT_EQ(15000, ids.size());
+  for (int32_t i = 0; i < 15000; i++) {
+    ASSERT_EQ(i, ids[i]);
+  }
+}
+
+TEST_F(GatherExecutorTest, EarlyStopTest) {
+  // Workers blocked on a full queue are released when the consumer goes away.
+  for (int i = 0; i < 10; i++) {
+    GatherExecutor gather(exec_ctx_.get(), plan_.get());
+    gather.Init();
+    Row row;
+    RowId rid;
+    for (int j = 0; j < 100; j++) {
+      ASSERT_TRUE(gather.Next(&row, &rid));
+    }
+  }
+}
@@ -0,0 +1,151 @@
+#include "executor/executors/index_scan_executor.h"
+
+#include <memory>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/executors/delete_executor.h"
+#include "executor/plans/delete_plan.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "index_scan_executor_test.db";
+
+class IndexScanExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    db_ = new DBStorageEngine(db_name, true);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("value", TypeId::kTypeInt, 1, false, false)};
+    schema_ = std::make_shared<Schema>(columns);
+    db_->catalog_mgr_->CreateTable("t", schema_.get(), nullptr, table_info_);
+    std::vector<std::string> index_keys{"id"};
+    db_->catalog_mgr_->CreateIndex("t", "t_id", index_keys, nullptr, index_info_, "bptree");
+    for (int32_t i = 0; i < 10; i++) {
+      Row row = MakeRow(i, i * 10);
+      ASSERT_TRUE(table_info_->GetTableHeap()->InsertTuple(row, nullptr));
+      ASSERT_EQ(DB_SUCCESS, index_info_->GetIndex()->InsertEntry(MakeKey(i), row.GetRowId(), nullptr));
+    }
+    // SELECT id, value FROM t WHERE id = 5
+    auto col_id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+    auto predicate = std::make_shared<ComparisonExpression>(
+        col_id, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 5)), "=");
+    plan_ = std::make_shared<IndexScanPlanNode>(schema_.get(), "t", std::vector<IndexInfo *>{index_info_}, false,
+                                                predicate);
+  }
+
+  void TearDown() override {
+    delete db_;
+    remove(db_name.c_str());
+  }
+
+  static Row MakeRow(int32_t id, int32_t value) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeInt, value)};
+    return Row(fields);
+  }
+
+  static Row MakeKey(int32_t id) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    return Row(fields);
+  }
+
+  /** @return the rows of id 5 txn finds through the index */
+  std::vector<Row> LookUp(Transaction *txn) {
+    auto exec_ctx = db_->MakeExecuteContext(txn);
+    IndexScanExecutor scan(exec_ctx.get(), plan_.get());
+    scan.Init();
+    std::vector<Row> rows;
+    Row row;
+    RowId rid;
+    while (scan.Next(&row, &rid)) {
+      rows.push_back(row);
+    }
+    return rows;
+  }
+
+  DBStorageEngine *db_;
+  std::shared_ptr<Schema> schema_;
+  TableInfo *table_info_{nullptr};
+  IndexInfo *index_info_{nullptr};
+  std::shared_ptr<IndexScanPlanNode> plan_;
+};
+
+TEST_F(IndexScanExecutorTest, SnapshotLookUpAfterDeleteTest) {
+  auto txn_mgr = db_->txn_mgr_;
+  auto reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_EQ(1, LookUp(reader).size());
+
+  // DELETE FROM t WHERE id = 5, committed while the reader runs
+  auto writer = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  {
+    auto exec_ctx = db_->MakeExecuteContext(writer);
+    DeletePlanNode delete_plan(schema_.get(), plan_, "t");
+    DeleteExecutor deleter(exec_ctx.get(), &delete_plan,
+                           std::make_unique<IndexScanExecutor>(exec_ctx.get(), plan_.get()));
+    deleter.Init();
+    Row count;
+    RowId rid;
+    deleter.Next(&count, &rid);
+    ASSERT_TRUE(count.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 1)));
+  }
+  txn_mgr->Commit(writer);
+
+  // The reader still finds the row through the index, a later snapshot does not.
+  auto rows = LookUp(reader);
+  ASSERT_EQ(1, rows.size());
+  ASSERT_TRUE(rows[0].GetField(1)->CompareEquals(Field(TypeId::kTypeInt, 50)));
+  auto late_reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_TRUE(LookUp(late_reader).empty());
+  txn_mgr->Commit(late_reader);
+  txn_mgr->GarbageCollect();
+  ASSERT_EQ(1, LookUp(reader).size());
+  txn_mgr->Commit(reader);
+
+  // The key is taken over by a new row before the garbage collection removes the entry of the deleted one.
+  auto inserter = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  Row row = MakeRow(5, 500);
+  auto table_heap = table_info_->GetTableHeap();
+  auto index = index_info_->GetIndex();
+  ASSERT_TRUE(table_heap->InsertTuple(row, inserter));
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeKey(5), row.GetRowId(), inserter));
+  ASSERT_TRUE(table_heap->ReplaceStaleEntry(index, MakeKey(5), row.GetRowId(), inserter));
+  txn_mgr->Commit(inserter);
+  txn_mgr->GarbageCollect();
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(5), result, nullptr));
+  ASSERT_EQ(row.GetRowId().Get(), result[0].Get());
+  auto txn = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  rows = LookUp(txn);
+  ASSERT_EQ(1, rows.size());
+  ASSERT_TRUE(rows[0].GetField(1)->CompareEquals(Field(TypeId::kTypeInt, 500)));
+  txn_mgr->Commit(txn);
+}
+
+TEST_F(IndexScanExecutorTest, GarbageCollectRemovesOldKeysTest) {
+  auto txn_mgr = db_->txn_mgr_;
+  auto table_heap = table_info_->GetTableHeap();
+  auto index = index_info_->GetIndex();
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(5), result, nullptr));
+  RowId rid = result[0];
+
+  // UPDATE t SET id = 50 WHERE id = 5 keeps the entry of the old key until no snapshot sees the old version.
+  auto reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  auto writer = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  Row row = MakeRow(50, 50);
+  ASSERT_TRUE(table_heap->UpdateTuple(row, rid, writer));
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeKey(50), rid, writer));
+  txn_mgr->Commit(writer);
+  auto late_reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_TRUE(LookUp(late_reader).empty());
+  txn_mgr->Commit(late_reader);
+  txn_mgr->GarbageCollect();
+  ASSERT_EQ(1, LookUp(reader).size());
+  txn_mgr->Commit(reader);
+  txn_mgr->GarbageCollect();
+  result.clear();
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(MakeKey(5), result, nullptr));
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(50), result, nullptr));
+}
@@ -0,0 +1,54 @@
+#include "executor/plan_cache.h"
+
+#include "executor/plans/values_plan.h"
+#include "gtest/gtest.h"
+
+static std::unique_ptr<CachedPlan> MakePlan(uint64_t version) {
+  auto cached = std::make_unique<CachedPlan>();
+  auto param = std::make_shared<ParameterValueExpression>(0, TypeId::kTypeInt);
+  cached->plan_ = std::make_shared<ValuesPlanNode>(nullptr, std::vector<std::vector<AbstractExpressionRef>>{{param}});
+  cached->params_.push_back(param);
+  cached->version_ = version;
+  return cached;
+}
+
+TEST(PlanCacheTest, NormalizeTest) {
+  ASSERT_EQ("select * from t where a = ?;", PlanCache::Normalize("  select *\n  from t\twhere a =  ?;"));
+  ASSERT_EQ("select * from t where b = \"a  b\";", PlanCache::Normalize("select * from t where b = \"a  b\"; "));
+}
+
+TEST(PlanCacheTest, AcquireReleaseTest) {
+  PlanCache cache(2);
+  const std::string sql = "select * from t where a = ?;";
+  ASSERT_EQ(nullptr, cache.Acquire(sql, 0));
+  cache.Release(sql, MakePlan(0));
+  cache.Release(sql, MakePlan(0));
+  ASSERT_EQ(2, cache.GetPlanCount());
+
+  // A plan is handed to one user at a time, the parameters bound by it stay with the plan.
+  auto plan1 = cache.Acquire(sql, 0);
+  auto plan2 = cache.Acquire(sql, 0);
+  ASSERT_NE(nullptr, plan1);
+  ASSERT_NE(nullptr, plan2);
+  ASSERT_EQ(nullptr, cache.Acquire(sql, 0));
+  plan1->params_[0]->Bind(Field(TypeId::kTypeInt, 1));
+  plan2->params_[0]->Bind(Field(TypeId::kTypeInt, 2));
+  auto values = std::dynamic_pointer_cast<const ValuesPlanNode>(plan1->plan_)->GetValues();
+  ASSERT_EQ(kTrue, values[0][0]->Evaluate(nullptr).CompareEquals(Field(TypeId::kTypeInt, 1)));
+  cache.Release(sql, std::move(plan1));
+  cache.Release(sql, std::move(plan2));
+  ASSERT_EQ(2, cache.GetHitCount());
+  ASSERT_EQ(2, cache.GetMissCount());
+
+  // Plans made before a catalog change are dropped.
+  ASSERT_EQ(nullptr, cache.Acquire(sql, 1));
+  ASSERT_EQ(0, cache.GetPlanCount());
+
+  // The least recently used statement is evicted.
+  cache.Release(sql, MakePlan(1));
+  cache.Release("a;", MakePlan(1));
+  ASSERT_NE(nullptr, cache.Acquire(sql, 1));
+  cache.Release("b;", MakePlan(1));
+  ASSERT_EQ(nullptr, cache.Acquire("a;", 1));
+  ASSERT_NE(nullptr, cache.Acquire("b;", 1));
+}
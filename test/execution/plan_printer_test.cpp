@@ -0,0 +1,61 @@
+#include "executor/plan_printer.h"
+
+#include <sstream>
+#include <vector>
+
+#include "common/instance.h"
+#include "executor/executors/analyze_executor.h"
+#include "executor/executors/seq_scan_executor.h"
+#include "gtest/gtest.h"
+#include "planner/expressions/column_value_expression.h"
+#include "planner/expressions/comparison_expression.h"
+#include "planner/expressions/constant_value_expression.h"
+
+static const std::string db_name = "plan_printer_test.db";
+
+TEST(PlanPrinterTest, ExplainAnalyzeTest) {
+  auto db = new DBStorageEngine(db_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db->catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, const_cast<char *>("a row"), 5, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+
+  // SELECT id FROM t WHERE id < 100
+  auto col_id = std::make_shared<ColumnValueExpression>(0, 0, TypeId::kTypeInt);
+  auto predicate = std::make_shared<ComparisonExpression>(
+      col_id, std::make_shared<ConstantValueExpression>(Field(TypeId::kTypeInt, 100)), "<");
+  Schema out_schema(std::vector<Column *>{new Column("id", TypeId::kTypeInt, 0, false, false)});
+  SeqScanPlanNode plan(&out_schema, "t", predicate);
+
+  // Scenario: a plan which did not run is printed without counters.
+  ExecuteContext exec_ctx(nullptr, db->catalog_mgr_, db->bpm_);
+  std::ostringstream explain;
+  PlanPrinter(&exec_ctx).Print(&plan, explain);
+  ASSERT_EQ("SeqScan on t (filter: id < 100)\n", explain.str());
+
+  // Scenario: the counters collected while the plan ran follow the operator.
+  exec_ctx.EnableAnalyze();
+  AnalyzeExecutor executor(&exec_ctx, &plan, std::make_unique<SeqScanExecutor>(&exec_ctx, &plan));
+  executor.Init();
+  Row row;
+  RowId rid;
+  while (executor.Next(&row, &rid)) {
+  }
+  ASSERT_TRUE(exec_ctx.HasExecutorStats(&plan));
+  const auto &stats = exec_ctx.GetExecutorStats(&plan);
+  ASSERT_EQ(100, stats.rows_);
+  ASSERT_GT(stats.buffer_.hits_ + stats.buffer_.misses_, 0);
+  explain.str("");
+  PlanPrinter(&exec_ctx).Print(&plan, explain);
+  ASSERT_EQ(0, explain.str().find("SeqScan on t (filter: id < 100) (actual rows=100 time="));
+
+  delete db;
+  remove(db_name.c_str());
+}
@@ -0,0 +1,44 @@
+#include "executor/statement_stats.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(StatementStatsTest, FingerprintTest) {
+  ASSERT_EQ("select * from t1 where id = ? and name = ?;",
+            StatementStats::Fingerprint("select *  from t1\n where id = 42 and name = \"a b\";"));
+  ASSERT_EQ("select * from t where v > -?;", StatementStats::Fingerprint("select * from t where v > -1.5;"));
+  // Inserts of any number of rows share a fingerprint.
+  ASSERT_EQ("insert into t values (?, ?);", StatementStats::Fingerprint("insert into t values (1, \"a\");"));
+  ASSERT_EQ("insert into t values (?, ?);",
+            StatementStats::Fingerprint("insert into t values (1, \"a\"), (2, 'b'),(3, \"c\");"));
+  ASSERT_EQ("execute q using (?);", StatementStats::Fingerprint("execute q using (7);"));
+}
+
+TEST(StatementStatsTest, RecordTest) {
+  StatementStats stats(2);
+  StatementProfile profile;
+  profile.plan_ = std::chrono::milliseconds(1);
+  profile.execute_ = std::chrono::milliseconds(4);
+  stats.Record("a;", profile);
+  stats.Record("a;", profile);
+  profile.execute_ = std::chrono::milliseconds(1);
+  stats.Record("b;", profile);
+  // Past the limit the statements are counted together.
+  stats.Record("c;", profile);
+  stats.Record("d;", profile);
+
+  std::vector<std::string> fingerprints;
+  stats.ForEach([&](const std::string &fingerprint, const StatementLatency &latency) {
+    fingerprints.push_back(fingerprint);
+    if (fingerprint == "a;") {
+      ASSERT_EQ(2, latency.total_.GetCount());
+      ASSERT_EQ(2000000, latency.plan_ns_);
+      ASSERT_EQ(8000000, latency.execute_ns_);
+      ASSERT_EQ(5000, latency.total_.GetQuantile(0.99));
+    }
+  });
+  ASSERT_EQ((std::vector<std::string>{"a;", StatementStats::OTHER_FINGERPRINT, "b;"}), fingerprints);
+  ASSERT_EQ(5, stats.GetTotalLatency().GetCount());
+}
@@ -0,0 +1,152 @@
+#include "index/art_index.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+
+static const std::string db_name = "art_index_test.db";
+
+static Row MakeKey(int32_t id, const std::string &name) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+  return Row(fields);
+}
+
+TEST(ArtIndexTests, AdaptiveRadixTreeTest) {
+  // keys of a few groups share prefixes longer than the tree keeps, groups of many keys fill every node size
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, false, false)};
+  TableSchema schema(columns);
+  ArtIndex index(0, &schema);
+  std::map<std::string, RowId> expected;
+  std::mt19937 random(0);
+  const int n = 30000;
+  for (int i = 0; i < n; i++) {
+    std::string name = "a rather long common prefix " + std::to_string(random() % 7);
+    name.append(random() % 3, '\0');
+    name.push_back(static_cast<char>(random() % 256));
+    name += std::to_string(random() % 1000);
+    std::string key = index.EncodeKey(MakeKey(static_cast<int32_t>(random() % 5) - 2, name));
+    RowId row_id(i, 0);
+    ASSERT_EQ(expected.emplace(key, row_id).second, index.GetContainer().Insert(key, row_id));
+  }
+  auto &tree = index.GetContainer();
+  ASSERT_EQ(expected.size(), tree.Size());
+  ASSERT_TRUE(tree.Verify());
+  for (auto &entry : expected) {
+    RowId row_id;
+    ASSERT_TRUE(tree.GetValue(entry.first, row_id));
+    ASSERT_EQ(entry.second.Get(), row_id.Get());
+  }
+
+  // scans start at the first key at or after the bound and run in key order
+  std::vector<std::string> keys;
+  for (auto &entry : expected) {
+    keys.push_back(entry.first);
+  }
+  for (int i = 0; i < 100; i++) {
+    size_t start = random() % keys.size();
+    std::string low = keys[start];
+    bool inclusive = i % 2 == 0;
+    if (i % 4 == 1) {
+      low.pop_back();  // a bound which is no key
+    }
+    auto it = inclusive ? expected.lower_bound(low) : expected.upper_bound(low);
+    int visited = 0;
+    tree.Scan(&low, inclusive, [&](const std::string &key, const RowId &) {
+      EXPECT_EQ(it->first, key);
+      ++it;
+      return ++visited < 50;
+    });
+    ASSERT_EQ(std::min<int>(50, std::distance(inclusive ? expected.lower_bound(low) : expected.upper_bound(low),
+                                              expected.end())),
+              visited);
+  }
+
+  // nodes shrink and fold back as keys are removed
+  std::shuffle(keys.begin(), keys.end(), random);
+  for (size_t i = 0; i < keys.size(); i++) {
+    ASSERT_TRUE(tree.Remove(keys[i]));
+    ASSERT_FALSE(tree.Remove(keys[i]));
+    if (i % 1000 == 0) {
+      ASSERT_TRUE(tree.Verify());
+    }
+  }
+  ASSERT_EQ(0, tree.Size());
+  ASSERT_TRUE(tree.Verify());
+}
+
+TEST(ArtIndexTests, ArtIndexScanKeyTest) {
+  std::vector<Column *> columns = {new Column("score", TypeId::kTypeFloat, 0, false, false),
+                                   new Column("id", TypeId::kTypeInt, 1, false, false)};
+  TableSchema schema(columns);
+  std::vector<uint32_t> key_map{0};
+  auto *key_schema = Schema::ShallowCopySchema(&schema, key_map);
+  ArtIndex index(0, key_schema);
+  // negative and positive scores, the order of the keys must be the order of the floats
+  std::vector<float> scores;
+  for (int i = -500; i < 500; i++) {
+    scores.push_back(i * 0.75f);
+  }
+  std::shuffle(scores.begin(), scores.end(), std::mt19937(1));
+  for (float score : scores) {
+    std::vector<Field> fields{Field(TypeId::kTypeFloat, score)};
+    ASSERT_EQ(DB_SUCCESS, index.InsertEntry(Row(fields), RowId(static_cast<int32_t>(score * 4), 0), nullptr));
+  }
+  std::vector<Field> zero_fields{Field(TypeId::kTypeFloat, -0.0f)};
+  Row zero(zero_fields);
+  ASSERT_EQ(DB_FAILED, index.InsertEntry(zero, RowId(0, 0), nullptr));
+
+  std::vector<Field> bound_fields{Field(TypeId::kTypeFloat, -3.0f)};
+  Row bound(bound_fields);
+  std::map<std::string, int> expected_counts{{"=", 1}, {"<", 496}, {"<=", 497}, {">", 503}, {">=", 504}, {"<>", 999}};
+  for (auto &entry : expected_counts) {
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index.ScanKey(bound, result, nullptr, entry.first));
+    ASSERT_EQ(entry.second, result.size()) << entry.first;
+    if (entry.first != "<>") {
+      for (size_t i = 1; i < result.size(); i++) {
+        ASSERT_LT(static_cast<int32_t>(result[i - 1].GetPageId()), static_cast<int32_t>(result[i].GetPageId()));
+      }
+    }
+  }
+  // an entry is only removed for the row it points to
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.RemoveEntry(bound, RowId(-12, 1), nullptr));
+  ASSERT_EQ(DB_SUCCESS, index.RemoveEntry(bound, RowId(-12, 0), nullptr));
+  std::vector<RowId> result;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.ScanKey(bound, result, nullptr));
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index.RemoveEntry(bound, RowId(-12, 0), nullptr));
+  delete key_schema;
+}
+
+TEST(ArtIndexTests, ArtIndexRebuildTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, false, false)};
+  TableSchema schema(columns);
+  auto table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr);
+  std::vector<RowId> row_ids;
+  for (int i = 0; i < 1000; i++) {
+    Row row = MakeKey(i, "name " + std::to_string(i));
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    row_ids.push_back(row.GetRowId());
+  }
+  std::vector<uint32_t> key_map{1};
+  auto *key_schema = Schema::ShallowCopySchema(&schema, key_map);
+  ArtIndex index(0, key_schema);
+  ASSERT_EQ(DB_SUCCESS, index.Rebuild(table_heap, &schema));
+  ASSERT_EQ(1000, index.GetContainer().Size());
+  for (int i = 0; i < 1000; i++) {
+    std::string name = "name " + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    std::vector<RowId> result;
+    ASSERT_EQ(DB_SUCCESS, index.ScanKey(Row(fields), result, nullptr));
+    ASSERT_EQ(row_ids[i].Get(), result[0].Get());
+  }
+  delete key_schema;
+  delete table_heap;
+}
@@ -1,5 +1,7 @@
 #include "index/b_plus_tree_index.h"
 
+#include <algorithm>
+#include <random>
 #include <string>
 
 #include "common/instance.h"
@@ -66,4 +68,90 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     i++;
   }
   delete index;
-}
\ No newline at end of file
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexInsertEntriesTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_);
+  // Keys in random order, enough of them to split leaves and internal pages.
+  const int n = 5000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  std::vector<Row> keys;
+  std::vector<RowId> rids;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, ids[i])};
+    keys.emplace_back(fields);
+    rids.emplace_back(1000, ids[i]);
+  }
+  // The second batch repeats some keys of the first one and one of its own.
+  std::vector<bool> inserted;
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntries({keys.begin(), keys.begin() + n / 2},
+                                             {rids.begin(), rids.begin() + n / 2}, nullptr, inserted));
+  ASSERT_EQ(std::vector<bool>(n / 2, true), inserted);
+  std::vector<Row> second(keys.begin() + n / 2 - 10, keys.end());
+  std::vector<RowId> second_rids(rids.begin() + n / 2 - 10, rids.end());
+  second.push_back(keys.back());
+  second_rids.push_back(rids.back());
+  ASSERT_EQ(DB_SUCCESS, index->InsertEntries(second, second_rids, nullptr, inserted));
+  for (size_t i = 0; i < second.size(); i++) {
+    ASSERT_EQ(i >= 10 && i + 1 < second.size(), inserted[i]);
+  }
+  // Every key is found and the leaves are in key order.
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(keys[i], ret, nullptr));
+    ASSERT_EQ(rids[i].Get(), ret[0].Get());
+  }
+  uint32_t i = 0;
+  for (auto iter = index->GetBeginIterator(); iter != index->GetEndIterator(); ++iter) {
+    ASSERT_EQ(i, (*iter).second.GetSlotNum());
+    i++;
+  }
+  ASSERT_EQ(n, i);
+  delete index;
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexRangeScanTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  auto *index = new BPlusTreeIndex(0, index_schema, 16, engine.bpm_);
+  const int n = 1000;
+  for (int i = 0; i < n; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(Row(fields), RowId(1000, i), nullptr));
+  }
+  // Every bound, the first and last key and one in the middle of a leaf, returns exactly its range.
+  for (int bound : {0, 1, n / 2, n - 1}) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, bound)};
+    Row key(fields);
+    for (const std::string op : {"<", "<=", ">", ">="}) {
+      std::vector<RowId> ret;
+      index->ScanKey(key, ret, nullptr, op);
+      std::vector<uint32_t> slots;
+      for (auto &rid : ret) {
+        slots.push_back(rid.GetSlotNum());
+      }
+      std::sort(slots.begin(), slots.end());
+      int first = op[0] == '<' ? 0 : (op == ">" ? bound + 1 : bound);
+      int last = op[0] == '>' ? n : (op == "<" ? bound : bound + 1);
+      ASSERT_EQ(static_cast<size_t>(last - first), slots.size()) << op << " " << bound;
+      for (size_t i = 0; i < slots.size(); i++) {
+        ASSERT_EQ(first + i, slots[i]) << op << " " << bound;
+      }
+    }
+  }
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  delete index;
+}
@@ -0,0 +1,107 @@
+#include "index/hash_index.h"
+
+#include <algorithm>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/generic_key.h"
+#include "page/index_roots_page.h"
+
+static const std::string db_name = "hash_index_test.db";
+
+static Row MakeKey(int32_t id) {
+  std::string name = "key number " + std::to_string(id);
+  std::vector<Field> fields{Field(TypeId::kTypeInt, id),
+                            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+  return Row(fields);
+}
+
+TEST(HashIndexTests, HashIndexInsertRemoveTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  std::vector<uint32_t> index_key_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map);
+  // keys of 128 bytes, 30 to a bucket, so many that the full directory links overflow pages
+  auto *index = new HashIndex(0, index_schema, 128, engine.bpm_);
+  const int n = 20000;
+  std::vector<int> ids(n);
+  for (int i = 0; i < n; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(0));
+  for (int id : ids) {
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(MakeKey(id), RowId(1000, id), nullptr));
+  }
+  ASSERT_EQ(DB_FAILED, index->InsertEntry(MakeKey(ids[0]), RowId(1000, 0), nullptr));
+  ASSERT_EQ(HashTableDirectoryPage::MAX_DEPTH, index->GetContainer().GetGlobalDepth());
+  ASSERT_TRUE(index->GetContainer().Verify());
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> ret;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(i), ret, nullptr));
+    ASSERT_EQ(1, ret.size());
+    ASSERT_EQ(RowId(1000, i).Get(), ret[0].Get());
+  }
+  // the other operators compare every key
+  std::vector<RowId> ret;
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(n - 100), ret, nullptr, ">="));
+  ASSERT_EQ(100, ret.size());
+
+  // remove the even keys
+  for (int id : ids) {
+    if (id % 2 == 0) {
+      ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(MakeKey(id), RowId(1000, id), nullptr));
+    }
+  }
+  ASSERT_TRUE(index->GetContainer().Verify());
+  for (int i = 0; i < n; i++) {
+    ret.clear();
+    ASSERT_EQ(i % 2 == 0 ? DB_KEY_NOT_FOUND : DB_SUCCESS, index->ScanKey(MakeKey(i), ret, nullptr));
+  }
+  delete index;
+
+  // the directory is found again through the index roots page
+  index = new HashIndex(0, index_schema, 128, engine.bpm_);
+  ret.clear();
+  ASSERT_EQ(DB_SUCCESS, index->ScanKey(MakeKey(n - 1), ret, nullptr));
+  ASSERT_EQ(RowId(1000, n - 1).Get(), ret[0].Get());
+  ASSERT_EQ(DB_SUCCESS, index->Destroy());
+  page_id_t directory_page_id;
+  auto roots = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  ASSERT_FALSE(roots->GetRootId(0, &directory_page_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  delete index;
+  delete index_schema;
+}
+
+TEST(HashIndexTests, HashIndexDropAfterReopenTest) {
+  page_id_t directory_page_id;
+  {
+    DBStorageEngine engine(db_name);
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+    auto schema = std::make_shared<Schema>(columns);
+    TableInfo *table_info;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateTable("t", schema.get(), nullptr, table_info));
+    IndexInfo *index_info;
+    ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->CreateIndex("t", "t_hash", {"id", "name"}, nullptr, index_info, "hash"));
+    for (int i = 0; i < 1000; i++) {
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(MakeKey(i), RowId(1000, i), nullptr));
+    }
+    auto roots = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    ASSERT_TRUE(roots->GetRootId(0, &directory_page_id));
+    engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
+
+  // Dropped before it is used again, the index is loaded so that its pages are freed.
+  DBStorageEngine engine(db_name, false);
+  ASSERT_EQ(DB_SUCCESS, engine.catalog_mgr_->DropIndex("t", "t_hash"));
+  page_id_t root_id;
+  auto roots = reinterpret_cast<IndexRootsPage *>(engine.bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  ASSERT_FALSE(roots->GetRootId(0, &root_id));
+  engine.bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  ASSERT_TRUE(engine.bpm_->IsPageFree(directory_page_id));
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree.h"
@@ -53,3 +55,36 @@ TEST(BPlusTreeTests, IndexIteratorTest) {
     EXPECT_EQ(RowId((2 * i - 1) * 100), (*iter).second);
   }
 }
+
+TEST(BPlusTreeTests, IndexIteratorBeginKeyTest) {
+  DBStorageEngine engine(db_name);
+  std::vector<Column *> columns = {
+      new Column("int", TypeId::kTypeInt, 0, false, false),
+  };
+  Schema *table_schema = new Schema(columns);
+  KeyManager KP(table_schema, 16);
+  // Small pages, so the keys span many leaves.
+  BPlusTree tree(0, engine.bpm_, KP, 4, 4);
+  auto make_key = [&](int i) {
+    GenericKey *key = KP.InitKey();
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    KP.SerializeFromKey(key, Row(fields), table_schema);
+    return key;
+  };
+  for (int i = 2; i <= 100; i += 2) {
+    tree.Insert(make_key(i), RowId(i), nullptr);
+  }
+  // Begin(key) starts at the first key not less than key, also when that key is on the next leaf.
+  for (int i = 0; i <= 101; i++) {
+    int expected = std::max(2, i + i % 2);
+    for (auto iter = tree.Begin(make_key(i)); iter != tree.End(); ++iter) {
+      ASSERT_EQ(RowId(expected), (*iter).second);
+      expected += 2;
+    }
+    ASSERT_EQ(102, expected);
+  }
+  // The iterators leave no page pinned behind them.
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+  }
+  ASSERT_TRUE(tree.Check());
+}
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <malloc.h>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
@@ -100,4 +101,23 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowDeserializeLeakTest) {
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  std::vector<Field> fields = {Field(TypeId::kTypeInt, 188),
+                               Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+                               Field(TypeId::kTypeFloat, 19.99f)};
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  row.SerializeTo(buffer, schema.get());
+  // The fields a row is read into are freed with the row, the heap does not grow with the rows read.
+  size_t in_use = mallinfo2().uordblks;
+  for (int i = 0; i < 100000; i++) {
+    Row read;
+    read.DeserializeFrom(buffer, schema.get());
+  }
+  ASSERT_GT(in_use + (1 << 20), mallinfo2().uordblks);
+}
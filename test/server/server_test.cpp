@@ -0,0 +1,89 @@
+#include "server/server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+static int Connect(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  EXPECT_EQ(0, connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)));
+  return fd;
+}
+
+/** @return the responses received until the server closes the connection */
+static std::vector<std::string> ReadResponses(int fd) {
+  std::vector<std::string> responses;
+  std::string response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    for (ssize_t i = 0; i < n; i++) {
+      if (buf[i] == '\0') {
+        responses.push_back(response);
+        response.clear();
+      } else {
+        response.push_back(buf[i]);
+      }
+    }
+  }
+  return responses;
+}
+
+class ServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_EQ(DB_SUCCESS, server_.ListenTcp(0));
+    server_thread_ = std::thread([this] { server_.Run(); });
+  }
+
+  void TearDown() override {
+    server_.Shutdown();
+    server_thread_.join();
+  }
+
+  ExecuteEngine engine_;
+  Server server_{&engine_, 2};
+  std::thread server_thread_;
+};
+
+TEST_F(ServerTest, HalfClosedClientTest) {
+  // The statements are sent together with the end of the stream, each one is still run and answered.
+  int fd = Connect(server_.GetPort());
+  std::string sql =
+      "create database server_test_db;use server_test_db;create table t(id int, name char(8));"
+      "insert into t values(7, \"a;b\");select * from t;";
+  ASSERT_EQ(static_cast<ssize_t>(sql.size()), send(fd, sql.data(), sql.size(), MSG_NOSIGNAL));
+  ASSERT_EQ(0, shutdown(fd, SHUT_WR));
+  auto responses = ReadResponses(fd);
+  close(fd);
+  ASSERT_EQ(5, responses.size());
+  ASSERT_NE(std::string::npos, responses[4].find("a;b"));
+
+  // A statement cut off by the end of the stream is not run.
+  fd = Connect(server_.GetPort());
+  sql = "use server_test_db;drop table t";
+  ASSERT_EQ(static_cast<ssize_t>(sql.size()), send(fd, sql.data(), sql.size(), MSG_NOSIGNAL));
+  ASSERT_EQ(0, shutdown(fd, SHUT_WR));
+  ASSERT_EQ(1, ReadResponses(fd).size());
+  close(fd);
+
+  fd = Connect(server_.GetPort());
+  sql = "use server_test_db;select * from t;drop database server_test_db;";
+  ASSERT_EQ(static_cast<ssize_t>(sql.size()), send(fd, sql.data(), sql.size(), MSG_NOSIGNAL));
+  ASSERT_EQ(0, shutdown(fd, SHUT_WR));
+  responses = ReadResponses(fd);
+  close(fd);
+  ASSERT_EQ(3, responses.size());
+  ASSERT_NE(std::string::npos, responses[1].find("a;b"));
+}
@@ -1,6 +1,13 @@
 #include "storage/disk_manager.h"
 
+#include <sys/stat.h>
+
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <stdexcept>
 #include <unordered_set>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -56,4 +63,285 @@ TEST(DiskManagerTest, FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, FreePageReuseTest) {
+  std::string db_name = "disk_reuse_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  const page_id_t extent_pages = DiskManager::BITMAP_SIZE;
+  for (page_id_t i = 0; i < 3 * extent_pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  const page_id_t holes[] = {2 * extent_pages + 7, extent_pages + 64, extent_pages + 63, 5};
+  for (auto page_id : holes) {
+    disk_mgr->DeAllocatePage(page_id);
+    ASSERT_TRUE(disk_mgr->IsPageFree(page_id));
+  }
+  disk_mgr->Close();
+  delete disk_mgr;
+
+  // Scenario: reopened, the holes are found lowest first before the file grows.
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_FALSE(disk_mgr->IsPageFree(6));
+  ASSERT_TRUE(disk_mgr->IsPageFree(5));
+  ASSERT_TRUE(disk_mgr->IsPageFree(10 * extent_pages));
+  for (auto page_id : {5, extent_pages + 63, extent_pages + 64, 2 * extent_pages + 7, 3 * extent_pages}) {
+    ASSERT_EQ(page_id, disk_mgr->AllocatePage());
+  }
+  DiskFileMetaPage *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(4, meta_page->GetExtentNums());
+  EXPECT_EQ(3 * extent_pages + 1, meta_page->GetAllocatedPages());
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, PageRunTest) {
+  std::string db_name = "disk_run_test.db";
+  remove(db_name.c_str());
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  const page_id_t run = DiskManager::RUN_SIZE;
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+
+  // Scenario: two objects growing at the same time get runs of their own, one after the other.
+  std::vector<page_id_t> pages[2];
+  page_id_t last[2] = {INVALID_PAGE_ID, INVALID_PAGE_ID};
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 2; j++) {
+      last[j] = disk_mgr->AllocatePageNear(last[j]);
+      pages[j].push_back(last[j]);
+    }
+  }
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ((i < run ? run : 3 * run) + i % run, pages[0][i]);
+    EXPECT_EQ((i < run ? 2 * run : 4 * run) + i % run, pages[1][i]);
+  }
+  // Scenario: other pages are taken lowest first and the runs go on where they were.
+  ASSERT_EQ(1, disk_mgr->AllocatePage());
+  disk_mgr->DeAllocatePage(pages[0][10]);
+  ASSERT_EQ(pages[0][10], disk_mgr->AllocatePageNear(pages[0][5]));
+  ASSERT_EQ(pages[1].back() + 1, disk_mgr->AllocatePageNear(pages[1].back()));
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, SegmentTest) {
+  std::string db_name = "disk_segment_test.db";
+  std::string segment_name = ".disk_segment_test.db.1";
+  DiskManager::RemoveFiles(db_name);
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  ASSERT_TRUE(disk_mgr->IsSegmented());
+  const page_id_t pages = DiskManager::EXTENTS_PER_SEGMENT * DiskManager::BITMAP_SIZE + 10;
+  for (page_id_t i = 0; i < pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  ASSERT_EQ(2, disk_mgr->GetSegmentCount());
+  char data[PAGE_SIZE] = "last page";
+  char buf[PAGE_SIZE];
+  disk_mgr->WritePage(pages - 1, data);
+  delete disk_mgr;
+
+  // Scenario: the pages past the first segment are in a file of their own and found again after a restart.
+  struct stat stat_buf;
+  ASSERT_EQ(0, stat(segment_name.c_str(), &stat_buf));
+  disk_mgr = new DiskManager(db_name);
+  disk_mgr->ReadPage(pages - 1, buf);
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  EXPECT_EQ(pages, disk_mgr->AllocatePage());
+  delete disk_mgr;
+  DiskManager::RemoveFiles(db_name);
+  EXPECT_NE(0, stat(db_name.c_str(), &stat_buf));
+  EXPECT_NE(0, stat(segment_name.c_str(), &stat_buf));
+}
+
+TEST(DiskManagerTest, SingleFileFormatTest) {
+  std::string db_name = "disk_single_file_test.db";
+  DiskManager::RemoveFiles(db_name);
+  // A database of the former format: one extent with 3 pages used, logical page p at physical page p + 2.
+  {
+    char page[PAGE_SIZE];
+    memset(page, 0, PAGE_SIZE);
+    auto meta_page = reinterpret_cast<DiskFileMetaPage *>(page);
+    meta_page->num_allocated_pages_ = 3;
+    meta_page->num_extents_ = 1;
+    meta_page->extent_used_page_[0] = 3;
+    std::ofstream out(db_name, std::ios::binary);
+    out.write(page, PAGE_SIZE);
+    memset(page, 0, PAGE_SIZE);
+    auto bitmap = reinterpret_cast<BitmapPage<PAGE_SIZE> *>(page);
+    uint32_t offset;
+    for (int i = 0; i < 3; i++) {
+      bitmap->AllocatePage(offset);
+    }
+    out.write(page, PAGE_SIZE);
+    for (int i = 0; i < 3; i++) {
+      memset(page, 0, PAGE_SIZE);
+      snprintf(page, PAGE_SIZE, "page %d", i);
+      out.write(page, PAGE_SIZE);
+    }
+  }
+  // Databases of the former format have pages of 4 KB.
+  if (PAGE_SIZE != 4096) {
+    EXPECT_THROW(new DiskManager(db_name), std::runtime_error);
+    DiskManager::RemoveFiles(db_name);
+    return;
+  }
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  ASSERT_FALSE(disk_mgr->IsSegmented());
+  char buf[PAGE_SIZE];
+  disk_mgr->ReadPage(2, buf);
+  EXPECT_STREQ("page 2", buf);
+  EXPECT_FALSE(disk_mgr->IsPageFree(2));
+  EXPECT_EQ(3, disk_mgr->AllocatePage());
+  delete disk_mgr;
+
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_FALSE(disk_mgr->IsSegmented());
+  EXPECT_EQ(4, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetAllocatedPages());
+  delete disk_mgr;
+  DiskManager::RemoveFiles(db_name);
+}
+
+TEST(DiskManagerTest, PageSizeTest) {
+  std::string db_name = "disk_page_size_test.db";
+  DiskManager::RemoveFiles(db_name);
+  DiskManager *disk_mgr = new DiskManager(db_name);
+  disk_mgr->AllocatePage();
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  EXPECT_EQ(PAGE_SIZE, reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData())->GetPageSize());
+  delete disk_mgr;
+
+  // A database created by a build with other pages is not opened.
+  uint32_t other_page_size = PAGE_SIZE == 4096 ? 8192 : 4096;
+  {
+    std::vector<char> page(other_page_size, 0);
+    uint32_t words[2] = {other_page_size, SEGMENTED_FILE_MAGIC};
+    memcpy(page.data() + other_page_size - sizeof(words), words, sizeof(words));
+    std::ofstream out(db_name, std::ios::binary | std::ios::trunc);
+    out.write(page.data(), other_page_size);
+  }
+  EXPECT_THROW(new DiskManager(db_name), std::runtime_error);
+  DiskManager::RemoveFiles(db_name);
+}
+
+TEST(DiskManagerTest, CompressedPagesTest) {
+  std::string db_name = "disk_compressed_test.db";
+  std::string pack_name = ".disk_compressed_test.db.pack";
+  DiskManager::RemoveFiles(db_name);
+  DiskManager *disk_mgr = new DiskManager(db_name, true);
+  ASSERT_TRUE(disk_mgr->IsCompressed());
+  const page_id_t pages = 200;
+  char data[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+  for (page_id_t i = 0; i < pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    memset(data, 0, PAGE_SIZE);
+    snprintf(data, PAGE_SIZE, "page %d, the same words on every page", i);
+    disk_mgr->WritePage(i, data);
+  }
+  EXPECT_LT(disk_mgr->GetPageStore()->GetStoredBytes(), pages * PAGE_SIZE / 8);
+  // A page which does not compress is stored as is, in a slot of its own.
+  std::mt19937 rng(3);
+  char random[PAGE_SIZE];
+  for (char &byte : random) {
+    byte = static_cast<char>(rng());
+  }
+  disk_mgr->WritePage(7, random);
+  disk_mgr->DeAllocatePage(8);
+  delete disk_mgr;
+
+  // Scenario: the database is compressed whatever it is opened with, its pages are found again after a restart.
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_TRUE(disk_mgr->IsCompressed());
+  for (page_id_t i = 0; i < pages; i++) {
+    disk_mgr->ReadPage(i, buf);
+    if (i == 7) {
+      EXPECT_EQ(0, memcmp(random, buf, PAGE_SIZE));
+    } else if (i != 8) {
+      memset(data, 0, PAGE_SIZE);
+      snprintf(data, PAGE_SIZE, "page %d, the same words on every page", i);
+      ASSERT_EQ(0, memcmp(data, buf, PAGE_SIZE)) << "page " << i;
+    }
+  }
+  // The slot of the page freed is taken again, the pack file does not grow.
+  uint64_t pack_size = disk_mgr->GetPageStore()->GetPackFileSize();
+  ASSERT_EQ(8, disk_mgr->AllocatePage());
+  disk_mgr->WritePage(8, data);
+  EXPECT_EQ(pack_size, disk_mgr->GetPageStore()->GetPackFileSize());
+  delete disk_mgr;
+
+  DiskManager::RemoveFiles(db_name);
+  struct stat stat_buf;
+  EXPECT_NE(0, stat(pack_name.c_str(), &stat_buf));
+}
+
+TEST(DiskManagerTest, CompressedPageSlotTest) {
+  std::string db_name = "disk_compressed_slot_test.db";
+  std::string pack_name = ".disk_compressed_slot_test.db.pack";
+  std::string map_name = ".disk_compressed_slot_test.db.map";
+  DiskManager::RemoveFiles(db_name);
+  DiskManager *disk_mgr = new DiskManager(db_name, true);
+  auto *store = disk_mgr->GetPageStore();
+  // Pages of one unit each, as many as take the room of a page which does not compress.
+  const page_id_t pages = PAGE_SIZE / CompressedPageStore::SLOT_UNIT;
+  char data[PAGE_SIZE];
+  char buf[PAGE_SIZE];
+  for (page_id_t i = 0; i < pages; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+    memset(data, 0, PAGE_SIZE);
+    snprintf(data, PAGE_SIZE, "page %d", i);
+    disk_mgr->WritePage(i, data);
+  }
+  ASSERT_EQ(PAGE_SIZE, store->GetPackFileSize());
+  // Freed in any order, the slots are merged and the page which does not compress fits in them.
+  for (page_id_t i = 0; i < pages; i += 2) {
+    disk_mgr->DeAllocatePage(i);
+  }
+  for (page_id_t i = pages - 1; i > 0; i -= 2) {
+    disk_mgr->DeAllocatePage(i);
+  }
+  std::mt19937 rng(5);
+  char random[PAGE_SIZE];
+  for (char &byte : random) {
+    byte = static_cast<char>(rng());
+  }
+  ASSERT_EQ(0, disk_mgr->AllocatePage());
+  disk_mgr->WritePage(0, random);
+  ASSERT_EQ(1, disk_mgr->AllocatePage());
+  memset(data, 0, PAGE_SIZE);
+  snprintf(data, PAGE_SIZE, "page 1");
+  disk_mgr->WritePage(1, data);
+  EXPECT_EQ(PAGE_SIZE + CompressedPageStore::SLOT_UNIT, store->GetPackFileSize());
+
+  // A page rewritten in its slot with data of another length leaves the map as is, the length is in the slot.
+  auto read_file = [](const std::string &name) {
+    std::ifstream in(name, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  };
+  std::string map = read_file(map_name);
+  memset(data, 0, PAGE_SIZE);
+  snprintf(data, PAGE_SIZE, "page 1 has a longer text now");
+  disk_mgr->WritePage(1, data);
+  EXPECT_EQ(map, read_file(map_name));
+  delete disk_mgr;
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_TRUE(disk_mgr->ReadPage(0, buf));
+  EXPECT_EQ(0, memcmp(random, buf, PAGE_SIZE));
+  ASSERT_TRUE(disk_mgr->ReadPage(1, buf));
+  EXPECT_EQ(0, memcmp(data, buf, PAGE_SIZE));
+  delete disk_mgr;
+
+  // Scenario: the slot of the compressed page is damaged, the page is reported as unreadable and not as zeros.
+  ASSERT_LT(PAGE_SIZE, read_file(pack_name).size());
+  {
+    std::fstream out(pack_name, std::ios::binary | std::ios::in | std::ios::out);
+    out.seekp(PAGE_SIZE);
+    std::string garbage(CompressedPageStore::SLOT_UNIT, '\xff');
+    out.write(garbage.data(), garbage.size());
+  }
+  disk_mgr = new DiskManager(db_name);
+  ASSERT_TRUE(disk_mgr->ReadPage(0, buf));
+  ASSERT_FALSE(disk_mgr->ReadPage(1, buf));
+  delete disk_mgr;
+  DiskManager::RemoveFiles(db_name);
+}
@@ -0,0 +1,60 @@
+#include "storage/page_codec.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "common/config.h"
+#include "gtest/gtest.h"
+
+static void ExpectRoundTrip(const std::vector<char> &data) {
+  std::vector<char> compressed(data.size() + data.size() / 255 + 16);
+  size_t compressed_size = PageCodec::Compress(data.data(), data.size(), compressed.data(), compressed.size());
+  ASSERT_NE(0, compressed_size);
+  std::vector<char> decompressed(data.size());
+  ASSERT_TRUE(PageCodec::Decompress(compressed.data(), compressed_size, decompressed.data(), data.size()));
+  EXPECT_EQ(data, decompressed);
+}
+
+TEST(PageCodecTest, RoundTripTest) {
+  // A page of rows with repetitive values, free space in the middle and the header at the start.
+  std::vector<char> page(PAGE_SIZE, 0);
+  for (int offset = PAGE_SIZE - 48, i = 0; offset > PAGE_SIZE / 2; offset -= 48, i++) {
+    snprintf(page.data() + offset, 48, "row %d of the table, status ACTIVE", i);
+  }
+  ExpectRoundTrip(page);
+  std::vector<char> compressed(PAGE_SIZE);
+  EXPECT_LT(PageCodec::Compress(page.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE), PAGE_SIZE / 2);
+
+  // Runs longer than the offset of their match, long literals and inputs too short to have a match.
+  ExpectRoundTrip(std::vector<char>(PAGE_SIZE, 'a'));
+  std::mt19937 rng(7);
+  std::vector<char> random(PAGE_SIZE);
+  for (auto &byte : random) {
+    byte = static_cast<char>(rng());
+  }
+  ExpectRoundTrip(random);
+  for (size_t size = 0; size < 16; size++) {
+    ExpectRoundTrip(std::vector<char>(random.begin(), random.begin() + size));
+  }
+  // Data which does not compress does not fit in less room than it takes.
+  EXPECT_EQ(0, PageCodec::Compress(random.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE - 1));
+}
+
+TEST(PageCodecTest, MalformedInputTest) {
+  std::vector<char> page(PAGE_SIZE, 0);
+  strcpy(page.data() + 100, "some text, some text, some text");
+  std::vector<char> compressed(PAGE_SIZE);
+  size_t compressed_size = PageCodec::Compress(page.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE);
+  ASSERT_NE(0, compressed_size);
+  std::vector<char> decompressed(PAGE_SIZE);
+  // Every truncation is rejected rather than read past the input or written past the output.
+  for (size_t size = 0; size < compressed_size; size++) {
+    EXPECT_FALSE(PageCodec::Decompress(compressed.data(), size, decompressed.data(), PAGE_SIZE));
+  }
+  // So is an output size which does not match.
+  EXPECT_FALSE(PageCodec::Decompress(compressed.data(), compressed_size, decompressed.data(), PAGE_SIZE - 1));
+  // And a match reaching before the start of the output.
+  char bad[] = {0x10, 'x', 0x05, 0x00, 0x00};
+  EXPECT_FALSE(PageCodec::Decompress(bad, sizeof(bad), decompressed.data(), 5));
+}
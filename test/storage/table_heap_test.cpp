@@ -13,7 +13,8 @@ static string db_file_name = "table_heap_test.db";
 using Fields = std::vector<Field>;
 
 TEST(TableHeapTest, TableHeapSampleTest) {
-  // init testing instance
+  // init testing instance, the file of a former run is never closed
+  DiskManager::RemoveFiles(db_file_name);
   auto disk_mgr_ = new DiskManager(db_file_name);
   auto bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
   const int row_nums = 10000;
@@ -60,3 +61,265 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
   ASSERT_EQ(size, 0);
 }
+
+TEST(TableHeapTest, ColumnarLayoutTest) {
+  DiskManager::RemoveFiles(db_file_name);
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  const int row_nums = 3000;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 16, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  // the scans, updates and deletes behave the same on both layouts
+  for (auto layout : {TableLayout::kRow, TableLayout::kColumnar}) {
+    // every third account of the columnar table is null, the row format keeps no nulls
+    auto is_null = [layout](int32_t id) { return layout == TableLayout::kColumnar && id % 3 == 0; };
+    auto make_row = [&is_null](int32_t id, const std::string &name) {
+      Fields fields{Field(TypeId::kTypeInt, id),
+                    Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                    is_null(id) ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, id * 0.5f)};
+      return Row(fields);
+    };
+    TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr, nullptr, layout);
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      Row row = make_row(i, "name" + std::to_string(i));
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    Row updated = make_row(5, "renamed");
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, rids[5], nullptr));
+    ASSERT_TRUE(table_heap->MarkDelete(rids[7], nullptr));
+    table_heap->ApplyDelete(rids[7], nullptr);
+
+    Row row(rids[5]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ("renamed", row.GetField(1)->toString());
+    int count = 0;
+    for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+      int32_t id = std::stoi(it->GetField(0)->toString());
+      ASSERT_NE(7, id);
+      ASSERT_EQ(is_null(id), it->GetField(2)->IsNull());
+      count++;
+    }
+    ASSERT_EQ(row_nums - 1, count);
+
+    // a page at once, only the columns asked for
+    std::vector<std::vector<Field>> values;
+    std::vector<RowId> scanned_rids;
+    for (auto page_id : table_heap->GetPageIds()) {
+      table_heap->ScanColumns(page_id, nullptr, {2, 0}, &values, &scanned_rids);
+    }
+    ASSERT_EQ(2, values.size());
+    ASSERT_EQ(row_nums - 1, values[0].size());
+    ASSERT_EQ(row_nums - 1, values[1].size());
+    ASSERT_EQ(row_nums - 1, scanned_rids.size());
+    for (size_t i = 0; i < values[1].size(); i++) {
+      int32_t id = std::stoi(values[1][i].toString());
+      ASSERT_EQ(rids[id].Get(), scanned_rids[i].Get());
+      if (is_null(id)) {
+        ASSERT_TRUE(values[0][i].IsNull());
+      } else {
+        ASSERT_EQ(CmpBool::kTrue, values[0][i].CompareEquals(Field(TypeId::kTypeFloat, id * 0.5f)));
+      }
+    }
+
+    // the pages tell their layout, a reopened heap reads them alike
+    auto reopened = TableHeap::Create(bpm, table_heap->GetFirstPageId(), schema.get(), nullptr, nullptr, nullptr,
+                                      layout);
+    count = 0;
+    for (auto it = reopened->Begin(nullptr); it != reopened->End(); ++it) {
+      count++;
+    }
+    ASSERT_EQ(row_nums - 1, count);
+    if (layout == TableLayout::kColumnar) {
+      // a char longer than its column does not fit the minipage
+      Row too_long = make_row(1, "a name longer than 16 chars");
+      ASSERT_FALSE(reopened->InsertTuple(too_long, nullptr));
+      ASSERT_FALSE(reopened->UpdateTuple(too_long, rids[1], nullptr));
+      // the freed slot is taken again
+      Row reinserted = make_row(7, "name7");
+      ASSERT_TRUE(reopened->InsertTuple(reinserted, nullptr));
+      ASSERT_EQ(rids[7].Get(), reinserted.GetRowId().Get());
+    }
+    delete reopened;
+    delete table_heap;
+  }
+  delete bpm;
+  delete disk_mgr;
+}
+
+TEST(TableHeapTest, DictionaryEncodingTest) {
+  DiskManager::RemoveFiles(db_file_name);
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  const int row_nums = 3000;
+  const int city_nums = 50;
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("city", TypeId::kTypeChar, 32, 1, true, false),
+                                   new Column("account", TypeId::kTypeFloat, 2, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  auto city = [](int32_t id) { return "a city called number " + std::to_string(id % city_nums); };
+  for (auto layout : {TableLayout::kRow, TableLayout::kColumnar}) {
+    // every fourth city of the columnar table is null, the row format keeps no nulls
+    auto is_null = [layout](int32_t id) { return layout == TableLayout::kColumnar && id % 4 == 0; };
+    auto make_row = [&is_null](int32_t id, const std::string &name) {
+      Fields fields{Field(TypeId::kTypeInt, id),
+                    is_null(id) ? Field(TypeId::kTypeChar)
+                                : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+                    Field(TypeId::kTypeFloat, id * 0.5f)};
+      return Row(fields);
+    };
+    TableHeap *raw = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr, nullptr, layout);
+    TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, nullptr, nullptr, layout, true);
+    ASSERT_EQ(nullptr, raw->GetDictionary());
+    ASSERT_TRUE(table_heap->IsEncoded(1));
+    ASSERT_FALSE(table_heap->IsEncoded(0));
+    std::vector<RowId> rids;
+    for (int i = 0; i < row_nums; i++) {
+      Row row = make_row(i, city(i));
+      Row raw_row = make_row(i, city(i));
+      ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+      ASSERT_TRUE(raw->InsertTuple(raw_row, nullptr));
+      rids.push_back(row.GetRowId());
+    }
+    // a code takes 4 bytes where the row took the whole value
+    ASSERT_EQ(city_nums, table_heap->GetDictionary()->GetSize(1));
+    ASSERT_LT(table_heap->GetPageIds().size(), raw->GetPageIds().size());
+
+    Row updated = make_row(5, "renamed");
+    ASSERT_TRUE(table_heap->UpdateTuple(updated, rids[5], nullptr));
+    ASSERT_TRUE(table_heap->MarkDelete(rids[7], nullptr));
+    table_heap->ApplyDelete(rids[7], nullptr);
+    ASSERT_EQ(city_nums + 1, table_heap->GetDictionary()->GetSize(1));
+
+    // the codes are read as they are and decoded later
+    Row row(rids[5]);
+    ASSERT_TRUE(table_heap->GetTuple(&row, nullptr, false));
+    ASSERT_EQ(TypeId::kTypeInt, row.GetField(1)->GetTypeId());
+    int32_t code = table_heap->GetDictionary()->Lookup(1, "renamed", 7);
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(Field(TypeId::kTypeInt, code)));
+    table_heap->DecodeRow(&row);
+    ASSERT_EQ("renamed", row.GetField(1)->toString());
+    ASSERT_EQ(-1, table_heap->GetDictionary()->Lookup(1, "nowhere", 7));
+
+    int count = 0;
+    for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+      int32_t id = std::stoi(it->GetField(0)->toString());
+      ASSERT_NE(7, id);
+      ASSERT_EQ(is_null(id), it->GetField(1)->IsNull());
+      if (id != 5 && !is_null(id)) {
+        ASSERT_EQ(city(id), it->GetField(1)->toString());
+      }
+      count++;
+    }
+    ASSERT_EQ(row_nums - 1, count);
+
+    std::vector<std::vector<Field>> values;
+    for (auto page_id : table_heap->GetPageIds()) {
+      table_heap->ScanColumns(page_id, nullptr, {0, 1}, &values);
+    }
+    ASSERT_EQ(row_nums - 1, values[1].size());
+    for (size_t i = 0; i < values[1].size(); i++) {
+      int32_t id = std::stoi(values[0][i].toString());
+      ASSERT_EQ(TypeId::kTypeChar, values[1][i].GetTypeId());
+      if (id != 5 && !is_null(id)) {
+        ASSERT_EQ(city(id), values[1][i].toString());
+      }
+    }
+
+    // the dictionary is read back from its pages
+    auto reopened = TableHeap::Create(bpm, table_heap->GetFirstPageId(), schema.get(), nullptr, nullptr, nullptr,
+                                      layout, table_heap->GetDictionary()->GetFirstPageId());
+    ASSERT_EQ(city_nums + 1, reopened->GetDictionary()->GetSize(1));
+    Row reread(rids[5]);
+    ASSERT_TRUE(reopened->GetTuple(&reread, nullptr));
+    ASSERT_EQ("renamed", reread.GetField(1)->toString());
+    Row again = make_row(9, city(9));
+    ASSERT_TRUE(reopened->InsertTuple(again, nullptr));
+    ASSERT_EQ(city_nums + 1, reopened->GetDictionary()->GetSize(1));
+    delete reopened;
+    delete table_heap;
+    delete raw;
+  }
+  delete bpm;
+  delete disk_mgr;
+}
+
+TEST(TableHeapTest, DictionarySnapshotReadTest) {
+  DBStorageEngine engine(db_file_name, true);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("city", TypeId::kTypeChar, 32, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  auto city = [](int32_t id) { return "city " + std::to_string(id); };
+  auto make_row = [](int32_t id, const std::string &name) {
+    Fields fields{Field(TypeId::kTypeInt, id),
+                  Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    return Row(fields);
+  };
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, engine.lock_mgr_,
+                                            engine.version_store_, TableLayout::kRow, true);
+  auto dictionary = table_heap->GetDictionary();
+  std::vector<RowId> rids;
+  for (int i = 0; i < 10; i++) {
+    Row row = make_row(i, city(i));
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  auto txn_mgr = engine.txn_mgr_;
+  auto reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  auto writer = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  Row renamed = make_row(5, "renamed");
+  ASSERT_TRUE(table_heap->UpdateTuple(renamed, rids[5], writer));
+  ASSERT_TRUE(table_heap->MarkDelete(rids[7], writer));
+  txn_mgr->Commit(writer);
+
+  // The reader gets the codes of the versions it sees, the row on the page and the older version alike.
+  auto code_of = [&](int32_t id) {
+    return Field(TypeId::kTypeInt, dictionary->Lookup(1, city(id).c_str(), city(id).size()));
+  };
+  for (int i : {5, 6}) {
+    Row coded(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&coded, reader, false));
+    ASSERT_EQ(CmpBool::kTrue, coded.GetField(1)->CompareEquals(code_of(i)));
+    Row decoded(rids[i]);
+    ASSERT_TRUE(table_heap->GetTuple(&decoded, reader));
+    ASSERT_EQ(city(i), decoded.GetField(1)->toString());
+  }
+  std::vector<Row> rows;
+  table_heap->ScanPage(rids[0].GetPageId(), reader, &rows, false);
+  ASSERT_EQ(10, rows.size());
+  for (auto &row : rows) {
+    ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(code_of(std::stoi(row.GetField(0)->toString()))));
+  }
+  rows.clear();
+  table_heap->ScanPage(rids[0].GetPageId(), reader, &rows);
+  ASSERT_EQ(city(5), rows[5].GetField(1)->toString());
+  // Only the rows with a version chain are read whole, the others from the page.
+  for (bool decode : {false, true}) {
+    std::vector<std::vector<Field>> values;
+    std::vector<RowId> scanned_rids;
+    table_heap->ScanColumns(rids[0].GetPageId(), reader, {1}, &values, &scanned_rids, decode);
+    ASSERT_EQ(10, values[0].size());
+    for (int i = 0; i < 10; i++) {
+      ASSERT_EQ(rids[i], scanned_rids[i]);
+      if (decode) {
+        ASSERT_EQ(city(i), values[0][i].toString());
+      } else {
+        ASSERT_EQ(CmpBool::kTrue, values[0][i].CompareEquals(code_of(i)));
+      }
+    }
+  }
+  txn_mgr->Commit(reader);
+
+  auto late_reader = txn_mgr->Begin(IsolationLevel::kSnapshotIsolation);
+  Row row(rids[5]);
+  ASSERT_TRUE(table_heap->GetTuple(&row, late_reader, false));
+  Field renamed_code(TypeId::kTypeInt, dictionary->Lookup(1, "renamed", 7));
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(1)->CompareEquals(renamed_code));
+  txn_mgr->Commit(late_reader);
+  // reading adds no value to the dictionary
+  ASSERT_EQ(11, dictionary->GetSize(1));
+  delete table_heap;
+}
@@ -0,0 +1,104 @@
+#include "transaction/lock_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+TEST(LockManagerTest, SharedCompatibleTest) {
+  LockManager lock_mgr(false);
+  Transaction txn0(0), txn1(1);
+  RowId rid(0, 0);
+  ASSERT_TRUE(lock_mgr.LockShared(&txn0, rid));
+  ASSERT_TRUE(lock_mgr.LockShared(&txn1, rid));
+  ASSERT_TRUE(txn0.IsSharedLocked(rid));
+  ASSERT_TRUE(txn1.IsSharedLocked(rid));
+  ASSERT_TRUE(lock_mgr.Unlock(&txn0, rid));
+  ASSERT_EQ(TxnState::kShrinking, txn0.GetState());
+  // No new lock may be taken in the shrinking phase.
+  ASSERT_FALSE(lock_mgr.LockShared(&txn0, RowId(0, 1)));
+  ASSERT_EQ(TxnState::kAborted, txn0.GetState());
+  ASSERT_EQ(AbortReason::kLockOnShrinking, txn0.GetAbortReason());
+  lock_mgr.UnlockAll(&txn1);
+  ASSERT_TRUE(txn1.GetSharedLockSet()->empty());
+}
+
+TEST(LockManagerTest, IsolationLevelTest) {
+  LockManager lock_mgr(false);
+  Transaction read_uncommitted(0, IsolationLevel::kReadUncommitted);
+  ASSERT_FALSE(lock_mgr.LockShared(&read_uncommitted, RowId(0, 0)));
+  ASSERT_EQ(TxnState::kAborted, read_uncommitted.GetState());
+  // Read committed drops shared locks without entering the shrinking phase.
+  Transaction read_committed(1, IsolationLevel::kReadCommitted);
+  ASSERT_TRUE(lock_mgr.LockShared(&read_committed, RowId(0, 0)));
+  ASSERT_TRUE(lock_mgr.Unlock(&read_committed, RowId(0, 0)));
+  ASSERT_EQ(TxnState::kGrowing, read_committed.GetState());
+  ASSERT_TRUE(lock_mgr.LockExclusive(&read_committed, RowId(0, 1)));
+}
+
+TEST(LockManagerTest, ExclusiveBlockTest) {
+  LockManager lock_mgr(false);
+  Transaction txn0(0), txn1(1);
+  RowId rid(0, 0);
+  ASSERT_TRUE(lock_mgr.LockExclusive(&txn0, rid));
+  std::atomic<bool> granted{false};
+  std::thread waiter([&] {
+    ASSERT_TRUE(lock_mgr.LockShared(&txn1, rid));
+    granted = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(granted);
+  ASSERT_EQ(1, lock_mgr.GetEdgeList().size());
+  lock_mgr.UnlockAll(&txn0);
+  waiter.join();
+  ASSERT_TRUE(granted);
+  ASSERT_TRUE(txn1.IsSharedLocked(rid));
+}
+
+TEST(LockManagerTest, UpgradeTest) {
+  LockManager lock_mgr(false);
+  Transaction txn0(0), txn1(1);
+  RowId rid(0, 0);
+  ASSERT_TRUE(lock_mgr.LockShared(&txn0, rid));
+  ASSERT_TRUE(lock_mgr.LockShared(&txn1, rid));
+  std::atomic<bool> upgraded{false};
+  std::thread upgrader([&] {
+    ASSERT_TRUE(lock_mgr.LockUpgrade(&txn0, rid));
+    upgraded = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_FALSE(upgraded);
+  // A second upgrade on the same row can never be granted.
+  ASSERT_FALSE(lock_mgr.LockUpgrade(&txn1, rid));
+  ASSERT_EQ(AbortReason::kUpgradeConflict, txn1.GetAbortReason());
+  lock_mgr.UnlockAll(&txn1);
+  upgrader.join();
+  ASSERT_TRUE(upgraded);
+  ASSERT_TRUE(txn0.IsExclusiveLocked(rid));
+  ASSERT_FALSE(txn0.IsSharedLocked(rid));
+}
+
+TEST(LockManagerTest, DeadlockDetectionTest) {
+  LockManager lock_mgr(true, std::chrono::milliseconds(10));
+  Transaction txn0(0), txn1(1);
+  RowId rid0(0, 0), rid1(1, 0);
+  ASSERT_TRUE(lock_mgr.LockExclusive(&txn0, rid0));
+  ASSERT_TRUE(lock_mgr.LockExclusive(&txn1, rid1));
+  std::thread t0([&] {
+    // txn0 is the older one and survives the deadlock
+    ASSERT_TRUE(lock_mgr.LockExclusive(&txn0, rid1));
+    lock_mgr.UnlockAll(&txn0);
+  });
+  std::thread t1([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_FALSE(lock_mgr.LockExclusive(&txn1, rid0));
+    ASSERT_EQ(TxnState::kAborted, txn1.GetState());
+    ASSERT_EQ(AbortReason::kDeadlock, txn1.GetAbortReason());
+    lock_mgr.UnlockAll(&txn1);
+  });
+  t1.join();
+  t0.join();
+  ASSERT_EQ(TxnState::kShrinking, txn0.GetState());
+  ASSERT_TRUE(lock_mgr.GetEdgeList().empty());
+}
@@ -0,0 +1,221 @@
+#include "transaction/txn_manager.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+#include "utils/utils.h"
+
+static string db_file_name = "txn_manager_test.db";
+using Fields = std::vector<Field>;
+
+static size_t CountRows(TableHeap *table_heap, Transaction *txn) {
+  size_t count = 0;
+  for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+    count++;
+  }
+  return count;
+}
+
+TEST(TxnManagerTest, CommitAndAbortTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  auto lock_mgr = new LockManager();
+  auto txn_mgr = new TxnManager(lock_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, lock_mgr);
+
+  // Committed inserts are visible, aborted ones are gone.
+  std::vector<RowId> rids;
+  auto txn = txn_mgr->Begin();
+  for (int i = 0; i < 1000; i++) {
+    char name[] = "minisql";
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, txn));
+    rids.push_back(row.GetRowId());
+  }
+  ASSERT_EQ(1000, txn->GetExclusiveLockSet()->size());
+  txn_mgr->Commit(txn);
+  txn = txn_mgr->Begin();
+  for (int i = 0; i < 100; i++) {
+    char name[] = "aborted";
+    Fields fields{Field(TypeId::kTypeInt, 1000 + i), Field(TypeId::kTypeChar, name, 7, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, txn));
+  }
+  txn_mgr->Abort(txn);
+  txn = txn_mgr->Begin();
+  ASSERT_EQ(1000, CountRows(table_heap, txn));
+  txn_mgr->Commit(txn);
+
+  // Deletes and updates are undone on abort.
+  txn = txn_mgr->Begin();
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], txn));
+  }
+  char name[] = "updated";
+  Fields fields{Field(TypeId::kTypeInt, -1), Field(TypeId::kTypeChar, name, 7, true)};
+  Row new_row(fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(new_row, rids[999], txn));
+  ASSERT_EQ(500, CountRows(table_heap, txn));
+  txn_mgr->Abort(txn);
+  txn = txn_mgr->Begin();
+  ASSERT_EQ(1000, CountRows(table_heap, txn));
+  Row row(rids[999]);
+  ASSERT_TRUE(table_heap->GetTuple(&row, txn));
+  ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 999)));
+  txn_mgr->Commit(txn);
+
+  // Committed deletes are applied.
+  txn = txn_mgr->Begin();
+  for (int i = 0; i < 500; i++) {
+    ASSERT_TRUE(table_heap->MarkDelete(rids[i], txn));
+  }
+  txn_mgr->Commit(txn);
+  txn = txn_mgr->Begin();
+  ASSERT_EQ(500, CountRows(table_heap, txn));
+  txn_mgr->Commit(txn);
+  ASSERT_EQ(0, txn_mgr->GetActiveTxnCount());
+
+  delete table_heap;
+  delete txn_mgr;
+  delete lock_mgr;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TxnManagerTest, InsertSkipsLockedSlotTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  auto lock_mgr = new LockManager();
+  auto txn_mgr = new TxnManager(lock_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, lock_mgr);
+  std::vector<RowId> rids;
+  auto txn = txn_mgr->Begin();
+  for (int i = 0; i < 3; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, txn));
+    rids.push_back(row.GetRowId());
+  }
+  txn_mgr->Commit(txn);
+  txn = txn_mgr->Begin();
+  ASSERT_TRUE(table_heap->MarkDelete(rids[1], txn));
+  txn_mgr->Commit(txn);
+
+  // The reader keeps a shared lock on the free slot it looked at.
+  auto reader = txn_mgr->Begin();
+  Row deleted(rids[1]);
+  ASSERT_FALSE(table_heap->GetTuple(&deleted, reader));
+  ASSERT_TRUE(reader->IsSharedLocked(rids[1]));
+
+  // The insert may not wait for that lock while it latches the page, it takes another slot.
+  auto writer = txn_mgr->Begin();
+  std::atomic<bool> inserted{false};
+  RowId new_rid;
+  std::thread insert([&] {
+    Fields fields{Field(TypeId::kTypeInt, 3)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, writer));
+    new_rid = row.GetRowId();
+    inserted = true;
+  });
+  for (int i = 0; i < 100 && !inserted; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bool inserted_in_time = inserted;
+  if (!inserted_in_time) {
+    lock_mgr->UnlockAll(reader);
+  }
+  insert.join();
+  ASSERT_TRUE(inserted_in_time);
+  ASSERT_NE(rids[1].Get(), new_rid.Get());
+  // and the reader can still latch the page
+  Row row(rids[0]);
+  ASSERT_TRUE(table_heap->GetTuple(&row, reader));
+  txn_mgr->Commit(writer);
+  txn_mgr->Commit(reader);
+
+  delete table_heap;
+  delete txn_mgr;
+  delete lock_mgr;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
+
+TEST(TxnManagerTest, UpdateRollbackInPlaceTest) {
+  remove(db_file_name.c_str());
+  auto disk_mgr = new DiskManager(db_file_name);
+  auto bpm = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr);
+  auto lock_mgr = new LockManager();
+  auto txn_mgr = new TxnManager(lock_mgr);
+  std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                   new Column("name", TypeId::kTypeChar, 64, 1, true, false)};
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(bpm, schema.get(), nullptr, nullptr, lock_mgr);
+  std::string long_name(60, 'x');
+  auto txn = txn_mgr->Begin();
+  Fields fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, const_cast<char *>(long_name.c_str()), 60, true)};
+  Row row(fields);
+  ASSERT_TRUE(table_heap->InsertTuple(row, txn));
+  RowId rid = row.GetRowId();
+  txn_mgr->Commit(txn);
+
+  // The update shrinks the tuple, another transaction then fills the page.
+  auto updater = txn_mgr->Begin();
+  char short_name[] = "x";
+  Fields short_fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, short_name, 1, true)};
+  Row short_row(short_fields);
+  ASSERT_TRUE(table_heap->UpdateTuple(short_row, rid, updater));
+  ASSERT_EQ(rid.Get(), short_row.GetRowId().Get());
+  auto filler = txn_mgr->Begin();
+  for (int i = 1; i < 1000; i++) {
+    char name[] = "fill";
+    Fields fill_fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, 4, true)};
+    Row fill_row(fill_fields);
+    ASSERT_TRUE(table_heap->InsertTuple(fill_row, filler));
+  }
+  txn_mgr->Commit(filler);
+
+  // The undo puts the old tuple back under its own rid.
+  txn_mgr->Abort(updater);
+  txn = txn_mgr->Begin();
+  Row restored(rid);
+  ASSERT_TRUE(table_heap->GetTuple(&restored, txn));
+  ASSERT_EQ(60, restored.GetField(1)->GetLength());
+  ASSERT_EQ(1000, CountRows(table_heap, txn));
+  txn_mgr->Commit(txn);
+
+  // A committed shrinking update gives its space back, the next insert fits the page again.
+  txn = txn_mgr->Begin();
+  ASSERT_TRUE(table_heap->UpdateTuple(short_row, rid, txn));
+  txn_mgr->Commit(txn);
+  txn = txn_mgr->Begin();
+  char name[] = "last";
+  Fields last_fields{Field(TypeId::kTypeInt, 1000), Field(TypeId::kTypeChar, name, 4, true)};
+  Row last(last_fields);
+  ASSERT_TRUE(table_heap->InsertTuple(last, txn));
+  ASSERT_EQ(rid.GetPageId(), last.GetRowId().GetPageId());
+  ASSERT_EQ(1001, CountRows(table_heap, txn));
+  txn_mgr->Commit(txn);
+
+  delete table_heap;
+  delete txn_mgr;
+  delete lock_mgr;
+  delete bpm;
+  delete disk_mgr;
+  remove(db_file_name.c_str());
+}
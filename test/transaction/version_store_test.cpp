@@ -0,0 +1,154 @@
+#include "transaction/version_store.h"
+
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "storage/table_heap.h"
+#include "transaction/txn_manager.h"
+#include "utils/utils.h"
+
+static string db_file_name = "version_store_test.db";
+using Fields = std::vector<Field>;
+
+static Row MakeRow(int32_t id, int32_t value) {
+  Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeInt, value)};
+  return Row(fields);
+}
+
+static int32_t GetValue(const Row &row) {
+  int32_t value;
+  row.GetField(1)->SerializeTo(reinterpret_cast<char *>(&value));
+  return value;
+}
+
+/** @return sum of the value column seen by txn */
+static int64_t SumValues(TableHeap *table_heap, Transaction *txn, size_t *count) {
+  int64_t sum = 0;
+  *count = 0;
+  for (auto iter = table_heap->Begin(txn); iter != table_heap->End(); ++iter) {
+    sum += GetValue(*iter);
+    (*count)++;
+  }
+  return sum;
+}
+
+class VersionStoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    remove(db_file_name.c_str());
+    disk_mgr_ = new DiskManager(db_file_name);
+    bpm_ = new BufferPoolManager(DEFAULT_BUFFER_POOL_SIZE, disk_mgr_);
+    lock_mgr_ = new LockManager();
+    version_store_ = new VersionStore();
+    // Garbage collection is run by hand.
+    txn_mgr_ = new TxnManager(lock_mgr_, version_store_, nullptr, std::chrono::hours(1));
+    std::vector<Column *> columns = {new Column("id", TypeId::kTypeInt, 0, false, false),
+                                     new Column("value", TypeId::kTypeInt, 1, false, false)};
+    schema_ = std::make_shared<Schema>(columns);
+    table_heap_ = TableHeap::Create(bpm_, schema_.get(), nullptr, nullptr, lock_mgr_, version_store_);
+    auto txn = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+    for (int i = 0; i < 100; i++) {
+      Row row = MakeRow(i, 1);
+      ASSERT_TRUE(table_heap_->InsertTuple(row, txn));
+      rids_.push_back(row.GetRowId());
+    }
+    txn_mgr_->Commit(txn);
+    ASSERT_EQ(100, txn_mgr_->GarbageCollect());
+  }
+
+  void TearDown() override {
+    delete table_heap_;
+    delete txn_mgr_;
+    delete version_store_;
+    delete lock_mgr_;
+    delete bpm_;
+    delete disk_mgr_;
+    remove(db_file_name.c_str());
+  }
+
+  DiskManager *disk_mgr_;
+  BufferPoolManager *bpm_;
+  LockManager *lock_mgr_;
+  VersionStore *version_store_;
+  TxnManager *txn_mgr_;
+  std::shared_ptr<Schema> schema_;
+  TableHeap *table_heap_;
+  std::vector<RowId> rids_;
+};
+
+TEST_F(VersionStoreTest, SnapshotReadTest) {
+  size_t count;
+  auto reader = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_EQ(100, SumValues(table_heap_, reader, &count));
+
+  // Updates, deletes and inserts of a concurrent writer, committed or not, are invisible to the reader.
+  auto writer = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  for (int i = 0; i < 10; i++) {
+    Row row = MakeRow(i, 10);
+    ASSERT_TRUE(table_heap_->UpdateTuple(row, rids_[i], writer));
+  }
+  for (int i = 10; i < 20; i++) {
+    ASSERT_TRUE(table_heap_->MarkDelete(rids_[i], writer));
+  }
+  Row row = MakeRow(100, 1000);
+  ASSERT_TRUE(table_heap_->InsertTuple(row, writer));
+  ASSERT_EQ(1000 + 100 + 80, SumValues(table_heap_, writer, &count));
+  ASSERT_EQ(91, count);
+  ASSERT_EQ(100, SumValues(table_heap_, reader, &count));
+  ASSERT_EQ(100, count);
+  txn_mgr_->Commit(writer);
+  ASSERT_EQ(100, SumValues(table_heap_, reader, &count));
+  ASSERT_EQ(100, count);
+  Row old_row(rids_[0]);
+  ASSERT_TRUE(table_heap_->GetTuple(&old_row, reader));
+  ASSERT_EQ(1, GetValue(old_row));
+  Row deleted_row(rids_[10]);
+  ASSERT_TRUE(table_heap_->GetTuple(&deleted_row, reader));
+  // The reader never locked anything.
+  ASSERT_TRUE(reader->GetSharedLockSet()->empty());
+  ASSERT_TRUE(reader->GetExclusiveLockSet()->empty());
+
+  // A new snapshot sees the committed changes.
+  auto late_reader = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_EQ(1000 + 100 + 80, SumValues(table_heap_, late_reader, &count));
+  ASSERT_EQ(91, count);
+  ASSERT_FALSE(table_heap_->GetTuple(&deleted_row, late_reader));
+  txn_mgr_->Commit(late_reader);
+
+  // Versions are kept as long as the first reader runs.
+  ASSERT_EQ(0, txn_mgr_->GarbageCollect());
+  ASSERT_EQ(100, SumValues(table_heap_, reader, &count));
+  txn_mgr_->Commit(reader);
+  ASSERT_EQ(21, txn_mgr_->GarbageCollect());
+  ASSERT_EQ(0, version_store_->GetVersionCount());
+  auto txn = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_EQ(1000 + 100 + 80, SumValues(table_heap_, txn, &count));
+  ASSERT_EQ(91, count);
+  txn_mgr_->Commit(txn);
+}
+
+TEST_F(VersionStoreTest, WriteConflictTest) {
+  auto txn1 = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  auto txn2 = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  Row row = MakeRow(0, 2);
+  ASSERT_TRUE(table_heap_->UpdateTuple(row, rids_[0], txn2));
+  txn_mgr_->Commit(txn2);
+
+  // txn1 did not see the update of txn2, the first updater wins.
+  Row lost_update = MakeRow(0, 3);
+  ASSERT_FALSE(table_heap_->UpdateTuple(lost_update, rids_[0], txn1));
+  ASSERT_EQ(TxnState::kAborted, txn1->GetState());
+  ASSERT_EQ(AbortReason::kWriteConflict, txn1->GetAbortReason());
+  txn_mgr_->Abort(txn1);
+
+  // An aborted write leaves the newest committed version in place.
+  auto txn3 = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  ASSERT_TRUE(table_heap_->MarkDelete(rids_[1], txn3));
+  txn_mgr_->Abort(txn3);
+  auto reader = txn_mgr_->Begin(IsolationLevel::kSnapshotIsolation);
+  size_t count;
+  ASSERT_EQ(101, SumValues(table_heap_, reader, &count));
+  ASSERT_EQ(100, count);
+  txn_mgr_->Commit(reader);
+}